@@ -3,6 +3,7 @@
 #include <system/platform.h>
 #include <graphics/primitive.h>
 #include <maths/math_utils.h>
+#include <graphics/mesh_optimiser.h>
 #include <vector>
 #include <math.h>
 
@@ -108,7 +109,7 @@ gef::Mesh* PrimitiveBuilder::CreateBoxMesh(const gef::Vector4& half_size, gef::V
 	};
 
 	const int kNumIndices = 6 * 6;
-	Int32 indices[kNumIndices] =
+	UInt16 indices[kNumIndices] =
 	{
 		// front
 		0, 1, 2,
@@ -145,7 +146,7 @@ gef::Mesh* PrimitiveBuilder::CreateBoxMesh(const gef::Vector4& half_size, gef::V
 	for (int primitive_num = 0; primitive_num < num_faces; ++primitive_num)
 	{
 		gef::Primitive* primitive = mesh->GetPrimitive(primitive_num);
-		primitive->InitIndexBuffer(platform_, &indices[primitive_num*6], 6, sizeof(Int32));
+		primitive->InitIndexBuffer(platform_, &indices[primitive_num*6], 6, sizeof(UInt16));
 		primitive->set_type(gef::TRIANGLE_LIST);
 
 		// if materials pointer is valid then assume we have an array of Material pointers
@@ -252,11 +253,9 @@ gef::Mesh* PrimitiveBuilder::CreateSphereMesh(const float radius, const int phi,
 	vert_idx++;
 
 
-	mesh->InitVertexBuffer(platform_, &vertices[0], kNumVertices, sizeof(gef::Mesh::Vertex));
-	mesh->AllocatePrimitives(2);
-
-	// side quads
-	std::vector<Int32> index_buffer;
+	// side quads, then top/bottom triangles
+	std::vector<std::vector<UInt32> > index_buffers(2);
+	std::vector<UInt32>& index_buffer = index_buffers[0];
 	index_buffer.resize((theta - 1)*phi * 6);
 
 	int idx = 0;
@@ -275,39 +274,49 @@ gef::Mesh* PrimitiveBuilder::CreateSphereMesh(const float radius, const int phi,
 		}
 	}
 
-	gef::Primitive* primitive;
-
-	// setup primitive for side quads
-	primitive = mesh->GetPrimitive(0);
-	primitive->set_type(gef::TRIANGLE_LIST);
-	primitive->set_material(material);
-	primitive->InitIndexBuffer(platform_, &index_buffer[0], (UInt32)index_buffer.size(), sizeof(Int32));
-
-	// top/bottom triangles
-	index_buffer.resize(phi * 3 + phi * 3);
+	std::vector<UInt32>& fan_index_buffer = index_buffers[1];
+	fan_index_buffer.resize(phi * 3 + phi * 3);
 
 	idx = 0;
 	// top fan
 	for (int j = 0; j<phi; ++j)
 	{
-		index_buffer.at(idx++) = 1 + (j + 1) % phi;
-		index_buffer.at(idx++) = 1 + (j + 0) % phi;
-		index_buffer.at(idx++) = 0;
+		fan_index_buffer.at(idx++) = 1 + (j + 1) % phi;
+		fan_index_buffer.at(idx++) = 1 + (j + 0) % phi;
+		fan_index_buffer.at(idx++) = 0;
 	}
 	
 	// bottom fan
 	for (int j = 0; j<phi; ++j)
 	{
-		index_buffer.at(idx++) = 1 + phi*(theta - 1) + (j + 0) % phi;
-		index_buffer.at(idx++) = 1 + phi*(theta - 1) + (j + 1) % phi;
-		index_buffer.at(idx++) = (int)kNumVertices - 1;
+		fan_index_buffer.at(idx++) = 1 + phi*(theta - 1) + (j + 0) % phi;
+		fan_index_buffer.at(idx++) = 1 + phi*(theta - 1) + (j + 1) % phi;
+		fan_index_buffer.at(idx++) = (int)kNumVertices - 1;
 	}
 
-	// setup primitive for top and bottom fans
-	primitive = mesh->GetPrimitive(1);
-	primitive->set_type(gef::TRIANGLE_LIST);
-	primitive->set_material(material);
-	primitive->InitIndexBuffer(platform_, &index_buffer[0], (UInt32)index_buffer.size(), sizeof(Int32));
+	// order the triangles for the vertex cache, then the vertices in the order they're drawn
+	for (size_t buffer_num = 0; buffer_num < index_buffers.size(); ++buffer_num)
+		gef::OptimiseVertexCache(&index_buffers[buffer_num][0], (Int32)index_buffers[buffer_num].size(), kNumVertices);
+	gef::OptimiseVertexFetch(&vertices[0], kNumVertices, sizeof(gef::Mesh::Vertex), index_buffers);
+
+	mesh->InitVertexBuffer(platform_, &vertices[0], kNumVertices, sizeof(gef::Mesh::Vertex));
+	mesh->AllocatePrimitives(2);
+
+	// 16 bit indices unless the sphere is too finely divided for them
+	for (int primitive_num = 0; primitive_num < 2; ++primitive_num)
+	{
+		const std::vector<UInt32>& indices = index_buffers[primitive_num];
+		gef::Primitive* primitive = mesh->GetPrimitive(primitive_num);
+		primitive->set_type(gef::TRIANGLE_LIST);
+		primitive->set_material(material);
+		if (kNumVertices <= 65536)
+		{
+			std::vector<UInt16> indices_16(indices.begin(), indices.end());
+			primitive->InitIndexBuffer(platform_, &indices_16[0], (UInt32)indices_16.size(), sizeof(UInt16));
+		}
+		else
+			primitive->InitIndexBuffer(platform_, &indices[0], (UInt32)indices.size(), sizeof(UInt32));
+	}
 
 	// bounds
 	gef::Aabb aabb(gef::Vector4(-radius, -radius, -radius) - origin, gef::Vector4(radius, radius, radius)+ origin);
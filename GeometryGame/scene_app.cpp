@@ -15,6 +15,7 @@
 #include <animation/skeleton.h>
 #include <animation/animation.h>
 #include <input/keyboard.h>
+#include <graphics/cached_sprite_layer.h>
 //#include <math.h>
 
 SceneApp::SceneApp(gef::Platform& platform) :
@@ -25,6 +26,8 @@ SceneApp::SceneApp(gef::Platform& platform) :
 	input_manager_(NULL),
 	audio_manager_(NULL),
 	font_(NULL),
+	menu_layer_(NULL),
+	hud_layer_(NULL),
 	world_(NULL),
 	player_body_(NULL),
 	sfx_id_(-1),
@@ -44,6 +47,7 @@ void SceneApp::Init()
 {
 	sprite_renderer_ = gef::SpriteRenderer::Create(platform_);
 	InitFont();
+	InitUILayers();
 
 	music_playing_ = false;
 
@@ -66,6 +70,7 @@ void SceneApp::CleanUp()
 	delete input_manager_;
 	input_manager_ = NULL;
 
+	CleanUpUILayers();
 	CleanUpFont();
 
 	delete sprite_renderer_;
@@ -653,13 +658,46 @@ void SceneApp::CleanUpFont()
 	font_ = NULL;
 }
 
+void SceneApp::InitUILayers()
+{
+	// menus cover the whole screen so their layer is cleared to the background colour,
+	// the HUD is drawn over the 3D scene so its layer needs to be transparent
+	menu_layer_ = new gef::CachedSpriteLayer(platform_, platform_.width(), platform_.height(), platform_.render_target_clear_colour());
+	hud_layer_ = new gef::CachedSpriteLayer(platform_, platform_.width(), platform_.height(), gef::Colour(0.0f, 0.0f, 0.0f, 0.0f));
+}
+
+void SceneApp::CleanUpUILayers()
+{
+	delete hud_layer_;
+	hud_layer_ = NULL;
+
+	delete menu_layer_;
+	menu_layer_ = NULL;
+}
+
+// the cached ui layers are only redrawn when the key for what they show changes
+static UInt32 UIStateKey(GAMESTATE state, UInt32 value)
+{
+	return (static_cast<UInt32>(state) << 24) ^ value;
+}
+
+// tenths of a second, rounded as "%.1f" rounds the time it displays
+static UInt32 TimeKey(float time)
+{
+	return static_cast<UInt32>(time*10.0f + 0.5f);
+}
+
 void SceneApp::DrawHUD()
 {
 	time += 1 / fps_;
 	if(font_)
 	{
-		// display frame rate
-		font_->RenderText(sprite_renderer_, gef::Vector4(810.0f, 510.0f, -0.9f), 1.0f, 0xffffffff, gef::TJ_LEFT, "TIME: %.1f", time);
+		if (hud_layer_->BeginRedraw(sprite_renderer_, UIStateKey(PLAY_GAME, TimeKey(time))))
+		{
+			// display frame rate
+			font_->RenderText(sprite_renderer_, gef::Vector4(810.0f, 510.0f, -0.9f), 1.0f, 0xffffffff, gef::TJ_LEFT, "TIME: %.1f", time);
+			hud_layer_->EndRedraw(sprite_renderer_);
+		}
 	}
 }
 
@@ -820,46 +858,52 @@ void SceneApp::FrontendUpdate(float frame_time)
 
 void SceneApp::FrontendRender()
 {
-	sprite_renderer_->Begin();
+	// only redraw the menu when what it shows changes
+	if (menu_layer_->BeginRedraw(sprite_renderer_, UIStateKey(FRONTEND, start_selected ? 1 : 0)))
+	{
+		if (start_selected == true) {
+		// render selected START THE GAME
+		font_->RenderText(
+			sprite_renderer_,
+			gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
+			1.5f,
+			0xffffffff,
+			gef::TJ_CENTRE,
+			"START THE GAME");
 
-	if (start_selected == true) {
-	// render selected START THE GAME
-	font_->RenderText(
-		sprite_renderer_,
-		gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
-		1.5f,
-		0xffffffff,
-		gef::TJ_CENTRE,
-		"START THE GAME");
-
-	// render unselected OPTIONS
-	font_->RenderText(
-		sprite_renderer_,
-		gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f + 32.0f, -0.99f),
-		1.0f,
-		0xff000000,
-		gef::TJ_CENTRE,
-		"OPTIONS");
+		// render unselected OPTIONS
+		font_->RenderText(
+			sprite_renderer_,
+			gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f + 32.0f, -0.99f),
+			1.0f,
+			0xff000000,
+			gef::TJ_CENTRE,
+			"OPTIONS");
+		}
+		else{
+				// render unselected START THE GAME
+				font_->RenderText(
+					sprite_renderer_,
+					gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
+					1.0f,
+					0xff000000,
+					gef::TJ_CENTRE,
+					"START THE GAME");
+
+				// render selected OPTIONS
+				font_->RenderText(
+					sprite_renderer_,
+					gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f + 32.0f, -0.99f),
+					1.5f,
+					0xffffffff,
+					gef::TJ_CENTRE,
+					"OPTIONS");
+			}
+		menu_layer_->EndRedraw(sprite_renderer_);
 	}
-	else{
-			// render unselected START THE GAME
-			font_->RenderText(
-				sprite_renderer_,
-				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
-				1.0f,
-				0xff000000,
-				gef::TJ_CENTRE,
-				"START THE GAME");
 
-			// render selected OPTIONS
-			font_->RenderText(
-				sprite_renderer_,
-				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f + 32.0f, -0.99f),
-				1.5f,
-				0xffffffff,
-				gef::TJ_CENTRE,
-				"OPTIONS");
-		}
+	sprite_renderer_->Begin();
+	menu_layer_->Draw(sprite_renderer_, -0.99f);
 	sprite_renderer_->End();
 }
 
@@ -1129,9 +1173,12 @@ void SceneApp::GameRender()
 
 	renderer_3d_->End();
 
+	// update the cached HUD before drawing sprites to the frame buffer
+	DrawHUD();
+
 	// start drawing sprites, but don't clear the frame buffer
 	sprite_renderer_->Begin(false);
-	DrawHUD();
+	hud_layer_->Draw(sprite_renderer_, -0.9f);
 	sprite_renderer_->End();
 }
 
@@ -1233,10 +1280,49 @@ void SceneApp::GameOptionsUpdate(float frame_time)
 
 void SceneApp::GameOptionsRender()
 {
-	sprite_renderer_->Begin();
-	if (is_paused == false) {
-		if (sound_selected == true) {
-
+	// only redraw the menu when what it shows changes
+	if (menu_layer_->BeginRedraw(sprite_renderer_, UIStateKey(GAME_OPTIONS, (is_paused ? 1 : 0) | (sound_selected ? 2 : 0) | (color[0] == 'R' ? 4 : 0) | (static_cast<UInt32>(fabs(sound_volume_ * 100.0f) + 0.5f) << 3))))
+	{
+		if (is_paused == false) {
+			if (sound_selected == true) {
+
+
+				font_->RenderText(
+					sprite_renderer_,
+					gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
+					1.5f,
+					0xffffffff,
+					gef::TJ_CENTRE,
+					"SOUND : %.0f", fabs(sound_volume_ * 10));
+
+
+				font_->RenderText(
+					sprite_renderer_,
+					gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 16.0f, -0.99f),
+					1.0f,
+					0xff000000,
+					gef::TJ_CENTRE,
+					"CUBE COLOR: %s", color);
+			}
+			else {
+				font_->RenderText(
+					sprite_renderer_,
+					gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
+					1.0f,
+					0xff000000,
+					gef::TJ_CENTRE,
+					"SOUND : %.0f", sound_volume_ * 10);
+
+				font_->RenderText(
+					sprite_renderer_,
+					gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 16.0f, -0.99f),
+					1.5f,
+					0xffffffff,
+					gef::TJ_CENTRE,
+					"CUBE COLOR: %s", color);
+			}
+		}
+		else {
 
 			font_->RenderText(
 				sprite_renderer_,
@@ -1245,61 +1331,29 @@ void SceneApp::GameOptionsRender()
 				0xffffffff,
 				gef::TJ_CENTRE,
 				"SOUND : %.0f", fabs(sound_volume_ * 10));
-
-
-			font_->RenderText(
-				sprite_renderer_,
-				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 16.0f, -0.99f),
-				1.0f,
-				0xff000000,
-				gef::TJ_CENTRE,
-				"CUBE COLOR: %s", color);
 		}
-		else {
-			font_->RenderText(
-				sprite_renderer_,
-				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
-				1.0f,
-				0xff000000,
-				gef::TJ_CENTRE,
-				"SOUND : %.0f", sound_volume_ * 10);
 
-			font_->RenderText(
-				sprite_renderer_,
-				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 16.0f, -0.99f),
-				1.5f,
-				0xffffffff,
-				gef::TJ_CENTRE,
-				"CUBE COLOR: %s", color);
-		}
-	}
-	else {
+		//render circle icon
+		gef::Sprite button_back;
+		button_back.set_texture(button_icon_circle);
+		button_back.set_position(gef::Vector4(platform_.width()*0.5f + 200.0f, platform_.height()*0.5f + 170.0f, -0.99f));
+		button_back.set_height(32.0f);
+		button_back.set_width(32.0f);
+		sprite_renderer_->DrawSprite(button_back);
 
 		font_->RenderText(
 			sprite_renderer_,
-			gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
-			1.5f,
+			gef::Vector4(platform_.width()*0.5f + 250.0f, platform_.height()*0.5f + 150.0f, -0.99f),
+			1.0f,
 			0xffffffff,
 			gef::TJ_CENTRE,
-			"SOUND : %.0f", fabs(sound_volume_ * 10));
-	}
+			"BACK");
 
-	//render circle icon
-	gef::Sprite button_back;
-	button_back.set_texture(button_icon_circle);
-	button_back.set_position(gef::Vector4(platform_.width()*0.5f + 200.0f, platform_.height()*0.5f + 170.0f, -0.99f));
-	button_back.set_height(32.0f);
-	button_back.set_width(32.0f);
-	sprite_renderer_->DrawSprite(button_back);
-
-	font_->RenderText(
-		sprite_renderer_,
-		gef::Vector4(platform_.width()*0.5f + 250.0f, platform_.height()*0.5f + 150.0f, -0.99f),
-		1.0f,
-		0xffffffff,
-		gef::TJ_CENTRE,
-		"BACK");
+		menu_layer_->EndRedraw(sprite_renderer_);
+	}
 
+	sprite_renderer_->Begin();
+	menu_layer_->Draw(sprite_renderer_, -0.99f);
 	sprite_renderer_->End();
 }
 
@@ -1361,94 +1415,101 @@ void SceneApp::FinishUpdate(float frame_time)
 
 void SceneApp::FinishRender()
 {
-	sprite_renderer_->Begin();
-	if (win == true)
+	// only redraw the menu when what it shows changes
+	if (menu_layer_->BeginRedraw(sprite_renderer_, UIStateKey(FINISH_SCREEN, (win ? 1 : 0) | (retry_selected ? 2 : 0) | (TimeKey(time) << 2))))
 	{
-		font_->RenderText(
-			sprite_renderer_,
-			gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
-			1.5f,
-			0xffffffff,
-			gef::TJ_CENTRE,
-			"You have reached the finish line in %.1fs, congratulations!", time);
-
-		font_->RenderText(
-			sprite_renderer_,
-			gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 16.0f, -0.99f),
-			1.5f,
-			0xffffffff,
-			gef::TJ_CENTRE,
-			"Developer's record is 30.8s, try to beat it !");
-
-		gef::Sprite button_continue;
-		button_continue.set_texture(button_icon_cross);
-		button_continue.set_position(gef::Vector4(platform_.width()*0.5f + 240.0f, platform_.height()*0.5f + 130.0f, -0.99f));
-		button_continue.set_height(32.0f);
-		button_continue.set_width(32.0f);
-		sprite_renderer_->DrawSprite(button_continue);
-
-		font_->RenderText(
-			sprite_renderer_,
-			gef::Vector4(platform_.width()*0.5f + 250.0f, platform_.height()*0.5f + 150.0f, -0.99f),
-			1.0f,
-			0xffffffff,
-			gef::TJ_CENTRE,
-			"Continue");
-	}
-	else if (win == false) {
-		if (retry_selected == true) {
-			font_->RenderText(
-				sprite_renderer_,
-				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 86.0f, -0.99f),
-				1.25f,
-				0xff000000,
-				gef::TJ_CENTRE,
-				"You have lost, too bad!");
-
+		if (win == true)
+		{
 			font_->RenderText(
 				sprite_renderer_,
-				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 25.0f, -0.99f),
+				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
 				1.5f,
 				0xffffffff,
 				gef::TJ_CENTRE,
-				"RETRY");
+				"You have reached the finish line in %.1fs, congratulations!", time);
 
 			font_->RenderText(
 				sprite_renderer_,
-				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f + 14.0f, -0.99f),
-				1.0f,
-				0xff000000,
+				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 16.0f, -0.99f),
+				1.5f,
+				0xffffffff,
 				gef::TJ_CENTRE,
-				"QUIT");
-		}
-		else if (retry_selected == false) {
+				"Developer's record is 30.8s, try to beat it !");
 
-			font_->RenderText(
-				sprite_renderer_,
-				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 86.0f, -0.99f),
-				1.25f,
-				0xff000000,
-				gef::TJ_CENTRE,
-				"You have lost, too bad!");
+			gef::Sprite button_continue;
+			button_continue.set_texture(button_icon_cross);
+			button_continue.set_position(gef::Vector4(platform_.width()*0.5f + 240.0f, platform_.height()*0.5f + 130.0f, -0.99f));
+			button_continue.set_height(32.0f);
+			button_continue.set_width(32.0f);
+			sprite_renderer_->DrawSprite(button_continue);
 
 			font_->RenderText(
 				sprite_renderer_,
-				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 25.0f, -0.99f),
+				gef::Vector4(platform_.width()*0.5f + 250.0f, platform_.height()*0.5f + 150.0f, -0.99f),
 				1.0f,
-				0xff000000,
-				gef::TJ_CENTRE,
-				"RETRY");
-
-			font_->RenderText(
-				sprite_renderer_,
-				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f + 14.0f, -0.99f),
-				1.5f,
 				0xffffffff,
 				gef::TJ_CENTRE,
-				"QUIT");
+				"Continue");
+		}
+		else if (win == false) {
+			if (retry_selected == true) {
+				font_->RenderText(
+					sprite_renderer_,
+					gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 86.0f, -0.99f),
+					1.25f,
+					0xff000000,
+					gef::TJ_CENTRE,
+					"You have lost, too bad!");
+
+				font_->RenderText(
+					sprite_renderer_,
+					gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 25.0f, -0.99f),
+					1.5f,
+					0xffffffff,
+					gef::TJ_CENTRE,
+					"RETRY");
+
+				font_->RenderText(
+					sprite_renderer_,
+					gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f + 14.0f, -0.99f),
+					1.0f,
+					0xff000000,
+					gef::TJ_CENTRE,
+					"QUIT");
+			}
+			else if (retry_selected == false) {
+
+				font_->RenderText(
+					sprite_renderer_,
+					gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 86.0f, -0.99f),
+					1.25f,
+					0xff000000,
+					gef::TJ_CENTRE,
+					"You have lost, too bad!");
+
+				font_->RenderText(
+					sprite_renderer_,
+					gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 25.0f, -0.99f),
+					1.0f,
+					0xff000000,
+					gef::TJ_CENTRE,
+					"RETRY");
+
+				font_->RenderText(
+					sprite_renderer_,
+					gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f + 14.0f, -0.99f),
+					1.5f,
+					0xffffffff,
+					gef::TJ_CENTRE,
+					"QUIT");
 
+			}
 		}
+		menu_layer_->EndRedraw(sprite_renderer_);
 	}
+
+	sprite_renderer_->Begin();
+	menu_layer_->Draw(sprite_renderer_, -0.99f);
 	sprite_renderer_->End();
 }
 
@@ -1520,90 +1581,97 @@ void SceneApp::PausescreenUpdate(float frame_time)
 void SceneApp::PausescreenRender()
 {
 
-	sprite_renderer_->Begin();
-	if (continue_selected == true) {
+	// only redraw the menu when what it shows changes
+	if (menu_layer_->BeginRedraw(sprite_renderer_, UIStateKey(PAUSE_SCREEN, (continue_selected ? 1 : 0) | (options_selected ? 2 : 0))))
+	{
+		if (continue_selected == true) {
 
 
-		font_->RenderText(
-			sprite_renderer_,
-			gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
-			1.5f,
-			0xffffffff,
-			gef::TJ_CENTRE,
-			"CONTINUE");
+			font_->RenderText(
+				sprite_renderer_,
+				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
+				1.5f,
+				0xffffffff,
+				gef::TJ_CENTRE,
+				"CONTINUE");
 
 
-		font_->RenderText(
-			sprite_renderer_,
-			gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 14.0f, -0.99f),
-			1.0f,
-			0xff000000,
-			gef::TJ_CENTRE,
-			"OPTIONS");
+			font_->RenderText(
+				sprite_renderer_,
+				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 14.0f, -0.99f),
+				1.0f,
+				0xff000000,
+				gef::TJ_CENTRE,
+				"OPTIONS");
 
-		font_->RenderText(
-			sprite_renderer_,
-			gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f + 20.0f, -0.99f),
-			1.0f,
-			0xff000000,
-			gef::TJ_CENTRE,
-			"QUIT");
+			font_->RenderText(
+				sprite_renderer_,
+				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f + 20.0f, -0.99f),
+				1.0f,
+				0xff000000,
+				gef::TJ_CENTRE,
+				"QUIT");
 
-	}
-	else if(options_selected == true) {
+		}
+		else if(options_selected == true) {
 
-		font_->RenderText(
-			sprite_renderer_,
-			gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
-			1.0f,
-			0xff000000,
-			gef::TJ_CENTRE,
-			"CONTINUE");
+			font_->RenderText(
+				sprite_renderer_,
+				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
+				1.0f,
+				0xff000000,
+				gef::TJ_CENTRE,
+				"CONTINUE");
 
-		font_->RenderText(
-			sprite_renderer_,
-			gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 25.0f, -0.99f),
-			1.5f,
-			0xffffffff,
-			gef::TJ_CENTRE,
-			"OPTIONS");
+			font_->RenderText(
+				sprite_renderer_,
+				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 25.0f, -0.99f),
+				1.5f,
+				0xffffffff,
+				gef::TJ_CENTRE,
+				"OPTIONS");
 
-		font_->RenderText(
-			sprite_renderer_,
-			gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f + 20.0f, -0.99f),
-			1.0f,
-			0xff000000,
-			gef::TJ_CENTRE,
-			"QUIT");
-	}
-	else if (options_selected == false && continue_selected == false)
-	{
-		font_->RenderText(
-			sprite_renderer_,
-			gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
-			1.0f,
-			0xff000000,
-			gef::TJ_CENTRE,
-			"CONTINUE");
+			font_->RenderText(
+				sprite_renderer_,
+				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f + 20.0f, -0.99f),
+				1.0f,
+				0xff000000,
+				gef::TJ_CENTRE,
+				"QUIT");
+		}
+		else if (options_selected == false && continue_selected == false)
+		{
+			font_->RenderText(
+				sprite_renderer_,
+				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 56.0f, -0.99f),
+				1.0f,
+				0xff000000,
+				gef::TJ_CENTRE,
+				"CONTINUE");
 
-		font_->RenderText(
-			sprite_renderer_,
-			gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 14.0f, -0.99f),
-			1.0f,
-			0xff000000,
-			gef::TJ_CENTRE,
-			"OPTIONS");
+			font_->RenderText(
+				sprite_renderer_,
+				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f - 14.0f, -0.99f),
+				1.0f,
+				0xff000000,
+				gef::TJ_CENTRE,
+				"OPTIONS");
 
-		font_->RenderText(
-			sprite_renderer_,
-			gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f + 20.0f, -0.99f),
-			1.5f,
-			0xffffffff,
-			gef::TJ_CENTRE,
-			"QUIT");
-	}
+			font_->RenderText(
+				sprite_renderer_,
+				gef::Vector4(platform_.width()*0.5f, platform_.height()*0.5f + 20.0f, -0.99f),
+				1.5f,
+				0xffffffff,
+				gef::TJ_CENTRE,
+				"QUIT");
+		}
 	
 
+		menu_layer_->EndRedraw(sprite_renderer_);
+	}
+
+	sprite_renderer_->Begin();
+	menu_layer_->Draw(sprite_renderer_, -0.99f);
 	sprite_renderer_->End();
 }
 
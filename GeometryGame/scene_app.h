@@ -30,6 +30,7 @@ namespace gef
 	class Font;
 	class InputManager;
 	class Renderer3D;
+	class CachedSpriteLayer;
 }
 
 class SceneApp : public gef::Application
@@ -47,12 +48,16 @@ private:
 	void InitPlatforms();
 	void InitTrampoline();
 	void CleanUpFont();
+	void InitUILayers();
+	void CleanUpUILayers();
 	void DrawHUD();
 	void SetupLights();
 	void UpdateSimulation(float frame_time);
     
 	gef::SpriteRenderer* sprite_renderer_;
 	gef::Font* font_;
+	gef::CachedSpriteLayer* menu_layer_;
+	gef::CachedSpriteLayer* hud_layer_;
 	gef::InputManager* input_manager_;
 	gef::AudioManager* audio_manager_;
 
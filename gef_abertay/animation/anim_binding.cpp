@@ -0,0 +1,58 @@
+#include <animation/anim_binding.h>
+#include <animation/skeleton.h>
+#include <animation/baked_animation.h>
+
+namespace gef
+{
+	AnimBinding::AnimBinding() :
+		skeleton_(NULL),
+		animation_(NULL)
+	{
+	}
+
+	void AnimBinding::Bind(const Skeleton& skeleton, const Animation& animation)
+	{
+		const BakedAnimation* baked = animation.baked();
+
+		joint_tracks_.resize(skeleton.joint_count());
+		for (Int32 joint_index = 0; joint_index < skeleton.joint_count(); ++joint_index)
+		{
+			JointTrack& joint_track = joint_tracks_[joint_index];
+
+			// nodes are found by joint name so they should always be transform nodes
+			const AnimNode* anim_node = animation.FindNode(skeleton.joint(joint_index).name_id);
+			if (anim_node && anim_node->type() == AnimNode::kTransform)
+				joint_track.node = static_cast<const TransformAnimNode*>(anim_node);
+			else
+				joint_track.node = NULL;
+			joint_track.cursor.Reset();
+
+			joint_track.baked_track = baked && joint_track.node ? baked->FindTrackIndex(joint_track.node->name_id()) : -1;
+		}
+
+		skeleton_ = &skeleton;
+		animation_ = &animation;
+	}
+
+	bool AnimBinding::Update(const Skeleton& skeleton, const Animation& animation)
+	{
+		if (IsBound(skeleton, animation))
+			return false;
+
+		Bind(skeleton, animation);
+		return true;
+	}
+
+	void AnimBinding::ResetCursors()
+	{
+		for (std::vector<JointTrack>::iterator joint_track = joint_tracks_.begin(); joint_track != joint_tracks_.end(); ++joint_track)
+			joint_track->cursor.Reset();
+	}
+
+	void AnimBinding::Clear()
+	{
+		joint_tracks_.clear();
+		skeleton_ = NULL;
+		animation_ = NULL;
+	}
+}
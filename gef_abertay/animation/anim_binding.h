@@ -0,0 +1,65 @@
+#ifndef _GEF_ANIM_BINDING_H
+#define _GEF_ANIM_BINDING_H
+
+#include <gef.h>
+#include <animation/animation.h>
+#include <vector>
+
+namespace gef
+{
+	class Skeleton;
+
+	/// @brief The animation node of every joint of a skeleton, resolved once for a skeleton and clip pair.
+	/// @note SkeletonPose::SetPoseFromAnim looks each joint up in the clip's node map every time it samples.
+	/// A binding does the lookups once, so each frame walks one flat array in joint order.
+	/// It also holds a key cursor per joint, so forward playback doesn't search the tracks either.
+	class AnimBinding
+	{
+	public:
+		/// @brief A joint's transform node, NULL if the clip doesn't animate the joint.
+		/// If the clip is baked, baked_track is the joint's track in the baked frames, or -1 if it has none.
+		struct JointTrack
+		{
+			const TransformAnimNode* node;
+			TransformAnimCursor cursor;
+			Int32 baked_track;
+		};
+
+		AnimBinding();
+
+		/// @brief Resolves every joint of a skeleton against the nodes of a clip.
+		/// @param[in] skeleton		The skeleton being animated.
+		/// @param[in] animation	The clip being sampled.
+		void Bind(const Skeleton& skeleton, const Animation& animation);
+
+		/// @brief Binds the skeleton and clip if the binding is for a different pair.
+		/// @note Call Bind directly if a clip's nodes change or it is baked, or a clip is freed and another is loaded at the same address.
+		/// @return true if the binding was rebuilt
+		bool Update(const Skeleton& skeleton, const Animation& animation);
+
+		/// @brief Moves the key cursors of every joint back to the start of the clip.
+		void ResetCursors();
+
+		/// @brief Forgets the bound skeleton and clip.
+		void Clear();
+
+		inline bool IsBound(const Skeleton& skeleton, const Animation& animation) const { return skeleton_ == &skeleton && animation_ == &animation; }
+
+		inline const Skeleton* skeleton() const { return skeleton_; }
+		inline const Animation* animation() const { return animation_; }
+
+		inline Int32 joint_count() const { return (Int32)joint_tracks_.size(); }
+		inline const std::vector<JointTrack>& joint_tracks() const { return joint_tracks_; }
+		inline std::vector<JointTrack>& joint_tracks()
+		{
+			return const_cast<std::vector<JointTrack>&>(static_cast<const AnimBinding&>(*this).joint_tracks());
+		}
+
+	private:
+		std::vector<JointTrack> joint_tracks_;	// one per joint, in skeleton joint order
+		const Skeleton* skeleton_;
+		const Animation* animation_;
+	};
+}
+
+#endif // _GEF_ANIM_BINDING_H
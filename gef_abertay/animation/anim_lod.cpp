@@ -0,0 +1,55 @@
+#include <animation/anim_lod.h>
+#include <animation/skeleton.h>
+
+namespace gef
+{
+	AnimLodSettings::AnimLodSettings() :
+		skeleton_(NULL)
+	{
+	}
+
+	void AnimLodSettings::Create(const Skeleton& skeleton)
+	{
+		skeleton_ = &skeleton;
+
+		// every joint raises the height of its ancestors, whatever order the joints are in
+		const Int32 joint_count = skeleton.joint_count();
+		joint_heights_.assign(joint_count, 0);
+		for (Int32 joint_num = 0; joint_num < joint_count; ++joint_num)
+		{
+			Int32 height = 1;
+			for (Int32 parent = skeleton.joint(joint_num).parent; parent != -1 && height <= joint_count; parent = skeleton.joint(parent).parent, ++height)
+			{
+				if (joint_heights_[parent] < height)
+					joint_heights_[parent] = height;
+			}
+		}
+
+		levels_.clear();
+		AddLevel(0.0f, 1, 0);
+	}
+
+	Int32 AnimLodSettings::AddLevel(const float min_distance, const Int32 update_interval, const Int32 num_skipped_leaf_levels)
+	{
+		AnimLodLevel level;
+		level.min_distance = min_distance;
+		level.update_interval = update_interval > 1 ? update_interval : 1;
+		level.num_skipped_leaf_levels = num_skipped_leaf_levels > 0 ? num_skipped_leaf_levels : 0;
+		for (Int32 joint_num = 0; joint_num < (Int32)joint_heights_.size(); ++joint_num)
+		{
+			if (joint_heights_[joint_num] >= level.num_skipped_leaf_levels)
+				level.joints.push_back(joint_num);
+		}
+
+		levels_.push_back(level);
+		return level_count() - 1;
+	}
+
+	Int32 AnimLodSettings::SelectLevel(const float distance) const
+	{
+		Int32 level_num = 0;
+		while (level_num + 1 < level_count() && distance >= levels_[level_num + 1].min_distance)
+			++level_num;
+		return level_num;
+	}
+}
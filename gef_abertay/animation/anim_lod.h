@@ -0,0 +1,58 @@
+#ifndef _GEF_ANIM_LOD_H
+#define _GEF_ANIM_LOD_H
+
+#include <gef.h>
+#include <vector>
+
+namespace gef
+{
+	class Skeleton;
+
+	/// @brief How much of a character's animation is updated at one level of detail.
+	struct AnimLodLevel
+	{
+		float min_distance;			// the distance from the camera the level starts at
+		Int32 update_interval;		// the number of frames between samples of the clips, the frames in between are interpolated
+		Int32 num_skipped_leaf_levels;	// how many levels of joints up from the leaves of the skeleton aren't sampled
+		std::vector<Int32> joints;	// the joints that are sampled, in joint order
+	};
+
+	/// @brief The animation levels of detail for a skeleton, chosen by the distance of a character from the camera.
+	/// @note Distant characters can sample their clips less often and interpolate between the samples,
+	/// and can skip the joints nearest the leaves of the skeleton, such as fingers, which hold their last pose.
+	/// Level 0 always updates every joint every frame.
+	class AnimLodSettings
+	{
+	public:
+		AnimLodSettings();
+
+		/// @brief Sets up level 0 for a skeleton, removing any other levels.
+		void Create(const Skeleton& skeleton);
+
+		/// @brief Adds a level, levels must be added in order of distance.
+		/// @param[in] min_distance				The distance from the camera the level starts at.
+		/// @param[in] update_interval			The number of frames between samples of the clips.
+		/// @param[in] num_skipped_leaf_levels	How many levels of joints up from the leaves aren't sampled,
+		/// e.g. 1 skips the finger tips and 2 also skips the joints they're attached to.
+		/// @return the index of the new level
+		Int32 AddLevel(const float min_distance, const Int32 update_interval, const Int32 num_skipped_leaf_levels);
+
+		/// @return the level to use at a distance from the camera
+		Int32 SelectLevel(const float distance) const;
+
+		inline Int32 level_count() const { return (Int32)levels_.size(); }
+		inline const AnimLodLevel& level(const Int32 index) const { return levels_[index]; }
+
+		/// @return whether a level samples every joint
+		inline bool SamplesAllJoints(const Int32 index) const { return (Int32)levels_[index].joints.size() == (Int32)joint_heights_.size(); }
+
+		inline const Skeleton* skeleton() const { return skeleton_; }
+
+	private:
+		std::vector<AnimLodLevel> levels_;
+		std::vector<Int32> joint_heights_;	// the number of joints between each joint and its furthest leaf, 0 for leaves
+		const Skeleton* skeleton_;
+	};
+}
+
+#endif // _GEF_ANIM_LOD_H
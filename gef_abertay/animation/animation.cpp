@@ -1,4 +1,5 @@
 #include <animation/animation.h>
+#include <animation/baked_animation.h>
 
 namespace gef
 {
@@ -44,97 +45,126 @@ namespace gef
 	{
 	}
 
+	// forward playback usually moves on by no more than a key or two each frame
+	static const UInt32 kMaxCursorSteps = 4;
+
+	// returns the index of the first key later than time, or the number of keys if there isn't one
+	template<typename Key>
+	static UInt32 FindNextKey(const std::vector<Key>& keys, const float time, const UInt32 first_key, const UInt32 last_key)
+	{
+		UInt32 low = first_key, high = last_key;
+		while (low < high)
+		{
+			const UInt32 middle = low + (high - low) / 2;
+			if (keys[middle].time > time)
+				high = middle;
+			else
+				low = middle + 1;
+		}
+		return low;
+	}
+
+	template<typename Key>
+	static UInt32 FindNextKey(const std::vector<Key>& keys, const float time)
+	{
+		return FindNextKey(keys, time, 0, static_cast<UInt32>(keys.size()));
+	}
+
+	// the cursor holds the next key found by the previous sample
+	// if time has moved forward a little the next key is a few steps on, otherwise fall back to a binary search
+	template<typename Key>
+	static UInt32 FindNextKey(const std::vector<Key>& keys, const float time, UInt32& cursor)
+	{
+		const UInt32 num_keys = static_cast<UInt32>(keys.size());
+		UInt32 key_index = cursor < num_keys ? cursor : num_keys;
+
+		if (key_index > 0 && keys[key_index - 1].time > time)
+		{
+			// time has gone backwards, e.g. the clip has looped
+			key_index = FindNextKey(keys, time, 0, key_index);
+		}
+		else
+		{
+			for (UInt32 step = 0; step < kMaxCursorSteps && key_index < num_keys && keys[key_index].time <= time; ++step)
+				++key_index;
+
+			if (key_index < num_keys && keys[key_index].time <= time)
+				key_index = FindNextKey(keys, time, key_index, num_keys);
+		}
+
+		cursor = key_index;
+		return key_index;
+	}
+
 	const Vector4 TransformAnimNode::GetTranslation(const float _time) const
 	{
-		return GetVector(_time, this->translation_keys_);
+		return InterpolateVector(_time, this->translation_keys_, FindNextKey(this->translation_keys_, _time));
 	}
 
 	const Vector4 TransformAnimNode::GetScale(const float _time) const
 	{
-		return GetVector(_time, this->scale_keys_);
+		return InterpolateVector(_time, this->scale_keys_, FindNextKey(this->scale_keys_, _time));
 	}
 
-	const Quaternion TransformAnimNode::GetRotation(const float _time) const
+	const Quaternion TransformAnimNode::GetRotation(const float _time, const QuaternionBlend blend) const
 	{
-		Quaternion result;
-		result.Identity();
+		return InterpolateRotation(_time, FindNextKey(this->rotation_keys_, _time), blend);
+	}
 
-		const QuaternionKey* pPrevKey = NULL;
-		const QuaternionKey* pNextKey = NULL;
-		UInt32 keyIndex;
-		for(keyIndex=0;keyIndex<this->rotation_keys_.size();keyIndex++)
-		{
+	const Vector4 TransformAnimNode::GetTranslation(const float _time, TransformAnimCursor& cursor) const
+	{
+		return InterpolateVector(_time, this->translation_keys_, FindNextKey(this->translation_keys_, _time, cursor.translation_key));
+	}
 
-			if(this->rotation_keys_[keyIndex].time > _time)
-			{
-				pNextKey = &this->rotation_keys_[keyIndex];
+	const Vector4 TransformAnimNode::GetScale(const float _time, TransformAnimCursor& cursor) const
+	{
+		return InterpolateVector(_time, this->scale_keys_, FindNextKey(this->scale_keys_, _time, cursor.scale_key));
+	}
 
-				if(keyIndex > 0)
-					pPrevKey = &this->rotation_keys_[keyIndex-1];
+	const Quaternion TransformAnimNode::GetRotation(const float _time, TransformAnimCursor& cursor, const QuaternionBlend blend) const
+	{
+		return InterpolateRotation(_time, FindNextKey(this->rotation_keys_, _time, cursor.rotation_key), blend);
+	}
 
-				break;
-			}
-		}
+	// before the first key the first key is used, after the last key the last key is used
+	const Quaternion TransformAnimNode::InterpolateRotation(const float _time, const UInt32 next_key, const QuaternionBlend blend) const
+	{
+		Quaternion result;
 
-		if(keyIndex == this->rotation_keys_.size())
+		if(next_key == this->rotation_keys_.size())
 		{
-			pNextKey =  &this->rotation_keys_[keyIndex-1];
+			result = this->rotation_keys_[next_key-1].value;
 		}
-
-		if(pPrevKey)
+		else if(next_key > 0)
 		{
-			if(pNextKey)
-			{
-				float t = (_time - pPrevKey->time) / (pNextKey->time - pPrevKey->time);
-				result.Slerp(pPrevKey->value, pNextKey->value, t);
-			}
-			else
-				result = pPrevKey->value;
+			const QuaternionKey* pPrevKey = &this->rotation_keys_[next_key-1];
+			const QuaternionKey* pNextKey = &this->rotation_keys_[next_key];
+			float t = (_time - pPrevKey->time) / (pNextKey->time - pPrevKey->time);
+			BlendQuaternion(pPrevKey->value, pNextKey->value, t, result, blend);
 		}
-		else if(pNextKey)
-				result = pNextKey->value;
+		else
+			result = this->rotation_keys_[next_key].value;
 
 		return result;
 	}
 
-	const Vector4 TransformAnimNode::GetVector(float _time, const std::vector<Vector3Key>& _keys) const
+	const Vector4 TransformAnimNode::InterpolateVector(const float _time, const std::vector<Vector3Key>& _keys, const UInt32 next_key) const
 	{
 		Vector4 result(0.f, 0.f, 0.f);
 
-		const Vector3Key* pPrevKey = NULL;
-		const Vector3Key* pNextKey = NULL;
-		UInt32 keyIndex;
-		for(keyIndex=0;keyIndex<_keys.size();keyIndex++)
+		if(next_key == _keys.size())
 		{
-
-			if(_keys[keyIndex].time > _time)
-			{
-				pNextKey = &_keys[keyIndex];
-
-				if(keyIndex > 0)
-					pPrevKey = &_keys[keyIndex-1];
-
-				break;
-			}
+			result = _keys[next_key-1].value;
 		}
-
-		if(keyIndex == _keys.size())
+		else if(next_key > 0)
 		{
-			pNextKey =  &_keys[keyIndex-1];
-		}
-
-		if(pPrevKey)
-		{
-			if(pNextKey)
-			{
-				float t = (_time - pPrevKey->time) / (pNextKey->time - pPrevKey->time);
-				result.Lerp(pPrevKey->value, pNextKey->value, t);
-			}
-			else
-				result = pPrevKey->value;
+			const Vector3Key* pPrevKey = &_keys[next_key-1];
+			const Vector3Key* pNextKey = &_keys[next_key];
+			float t = (_time - pPrevKey->time) / (pNextKey->time - pPrevKey->time);
+			result.Lerp(pPrevKey->value, pNextKey->value, t);
 		}
-		else if(pNextKey)
-			result = pNextKey->value;
+		else
+			result = _keys[next_key].value;
 
 		return result;
 	}
@@ -246,40 +276,20 @@ namespace gef
 	{
 		float result = 0.0f;
 
-		const ChannelKey* pPrevKey = NULL;
-		const ChannelKey* pNextKey = NULL;
-		UInt32 keyIndex;
-		for(keyIndex=0;keyIndex<keys_.size();keyIndex++)
-		{
-
-			if(keys_[keyIndex].time > time)
-			{
-				pNextKey = &keys_[keyIndex];
-
-				if(keyIndex > 0)
-					pPrevKey = &keys_[keyIndex-1];
-
-				break;
-			}
-		}
-
-		if(keyIndex == keys_.size())
+		const UInt32 next_key = FindNextKey(keys_, time);
+		if(next_key == keys_.size())
 		{
-			pNextKey =  &keys_[keyIndex-1];
+			result = keys_[next_key-1].value;
 		}
-
-		if(pPrevKey)
+		else if(next_key > 0)
 		{
-			if(pNextKey)
-			{
-				float t = (time - pPrevKey->time) / (pNextKey->time - pPrevKey->time);
-				result = (1.0f - t)*pPrevKey->value +t*pNextKey->value;
-			}
-			else
-				result = pPrevKey->value;
+			const ChannelKey* pPrevKey = &keys_[next_key-1];
+			const ChannelKey* pNextKey = &keys_[next_key];
+			float t = (time - pPrevKey->time) / (pNextKey->time - pPrevKey->time);
+			result = (1.0f - t)*pPrevKey->value +t*pNextKey->value;
 		}
-		else if(pNextKey)
-			result = pNextKey->value;
+		else
+			result = keys_[next_key].value;
 
 		return result;
 	}
@@ -310,7 +320,12 @@ namespace gef
 		return success;
 	}
 
+	// set in the node count of clips written with baked frames after their nodes
+	// older files never set it, so they still read
+	static const Int32 kAnimNodeCountBakedFlag = 0x40000000;
+
 	Animation::Animation():
+		baked_(NULL),
 		duration_(0.0f),
 		start_time_(0.0f),
 		end_time_(0.0f),
@@ -322,10 +337,14 @@ namespace gef
 	{
 		for(std::map<StringId, AnimNode*>::iterator anim_node_iter=anim_nodes_.begin(); anim_node_iter != anim_nodes_.end(); ++anim_node_iter)
 			delete anim_node_iter->second;
+		delete baked_;
 	}
 
-	Animation::Animation(const class Animation& animation)
+	Animation::Animation(const class Animation& animation) :
+		baked_(NULL)
 	{
+		if (animation.baked_)
+			baked_ = new BakedAnimation(*animation.baked_);
 		duration_ = animation.duration();
 		start_time_ = animation.start_time();
 		end_time_ = animation.end_time();
@@ -392,6 +411,25 @@ namespace gef
 		}
 	}
 
+	bool Animation::Bake(const float frame_rate)
+	{
+		CalculateDuration();
+		if (!baked_)
+			baked_ = new BakedAnimation();
+
+		const bool success = baked_->Bake(*this, frame_rate);
+		if (!success)
+			ClearBaked();
+
+		return success;
+	}
+
+	void Animation::ClearBaked()
+	{
+		delete baked_;
+		baked_ = NULL;
+	}
+
 	bool Animation::Read(std::istream& stream)
 	{
 		stream.read((char*)&name_id_, sizeof(StringId));
@@ -400,6 +438,8 @@ namespace gef
 
 		Int32 num_anim_nodes;
 		stream.read((char*)&num_anim_nodes, sizeof(Int32));
+		const bool has_baked_frames = (num_anim_nodes & kAnimNodeCountBakedFlag) != 0;
+		num_anim_nodes &= ~kAnimNodeCountBakedFlag;
 		bool success = true;
 
 		for(Int32 anim_node_num=0; anim_node_num < num_anim_nodes; ++anim_node_num)
@@ -429,6 +469,18 @@ namespace gef
 
 			AddNode(anim_node);
 		}
+
+		// a bake from before the animation was read doesn't match it any more
+		if(success && has_baked_frames)
+		{
+			if(!baked_)
+				baked_ = new BakedAnimation();
+			success = baked_->Read(stream);
+			if(!success)
+				ClearBaked();
+		}
+		else
+			ClearBaked();
 		
 		if(success)
 			CalculateDuration();
@@ -443,12 +495,17 @@ namespace gef
 		stream.write((char*)&end_time_, sizeof(float));
 
 		Int32 num_anim_nodes = (Int32)anim_nodes_.size();
+		if(baked_)
+			num_anim_nodes |= kAnimNodeCountBakedFlag;
 		stream.write((char*)&num_anim_nodes, sizeof(Int32));
 		for(std::map<StringId, AnimNode*>::const_iterator anim_node_iter=anim_nodes_.begin(); anim_node_iter != anim_nodes_.end(); ++anim_node_iter)
 		{
 			anim_node_iter->second->Write(stream);
 		}
 
+		if(baked_)
+			baked_->Write(stream);
+
 		return true;
 	}
 }
@@ -56,6 +56,26 @@ namespace gef
 		float time;
 	};
 
+	/// @brief The key indices a TransformAnimNode was last sampled at.
+	/// @note Keep one cursor per node and pass it to each sample. Forward playback then steps on from
+	/// the previous key instead of searching the whole track. Seeks use a binary search.
+	struct TransformAnimCursor
+	{
+		TransformAnimCursor() :
+			scale_key(0),
+			rotation_key(0),
+			translation_key(0)
+		{
+		}
+
+		/// @brief Moves the cursor back to the start of every track, e.g. when a new clip is played.
+		inline void Reset() { scale_key = rotation_key = translation_key = 0; }
+
+		UInt32 scale_key;
+		UInt32 rotation_key;
+		UInt32 translation_key;
+	};
+
 	class TransformAnimNode : public AnimNode
 	{
 	public:
@@ -64,7 +84,30 @@ namespace gef
 
 		const Vector4 GetTranslation(const float time) const;
 		const Vector4 GetScale(const float time) const;
-		const Quaternion GetRotation(const float time) const;
+
+		/// @brief Samples the rotation track.
+		/// @param[in] time		The time to sample the track at.
+		/// @param[in] blend	How accurately to blend between keys. Exact Slerp unless a faster blend is asked for.
+		const Quaternion GetRotation(const float time, const QuaternionBlend blend = QB_SLERP) const;
+
+		/// @brief Samples the translation track, starting the key search from the cursor.
+		/// @param[in] time		The time to sample the track at.
+		/// @param[in,out] cursor	The cursor for this node. It is updated to the key found.
+		/// @return The same value as GetTranslation(time).
+		const Vector4 GetTranslation(const float time, TransformAnimCursor& cursor) const;
+
+		/// @brief Samples the scale track, starting the key search from the cursor.
+		/// @param[in] time		The time to sample the track at.
+		/// @param[in,out] cursor	The cursor for this node. It is updated to the key found.
+		/// @return The same value as GetScale(time).
+		const Vector4 GetScale(const float time, TransformAnimCursor& cursor) const;
+
+		/// @brief Samples the rotation track, starting the key search from the cursor.
+		/// @param[in] time		The time to sample the track at.
+		/// @param[in,out] cursor	The cursor for this node. It is updated to the key found.
+		/// @param[in] blend	How accurately to blend between keys.
+		/// @return The same value as GetRotation(time, blend).
+		const Quaternion GetRotation(const float time, TransformAnimCursor& cursor, const QuaternionBlend blend = QB_SLERP) const;
 
 		inline const std::vector<Vector3Key>& scale_keys() const {return scale_keys_;}
 		inline std::vector<Vector3Key>& scale_keys() { return const_cast<std::vector<Vector3Key>&>(static_cast<const TransformAnimNode&>(*this).scale_keys()); }
@@ -79,7 +122,8 @@ namespace gef
 		bool Write(std::ostream& stream) const;
 
 	private:
-		const Vector4 GetVector(const float _time, const std::vector<Vector3Key>& keys) const;
+		const Vector4 InterpolateVector(const float _time, const std::vector<Vector3Key>& keys, const UInt32 next_key) const;
+		const Quaternion InterpolateRotation(const float _time, const UInt32 next_key, const QuaternionBlend blend) const;
 
 		std::vector<Vector3Key> scale_keys_;
 		std::vector<QuaternionKey> rotation_keys_;
@@ -106,6 +150,8 @@ namespace gef
 		std::vector<ChannelKey> keys_;
 	};
 
+	class BakedAnimation;
+
 	class Animation
 	{
 	public:
@@ -116,6 +162,16 @@ namespace gef
 		const AnimNode* FindNode(const StringId name) const;
 		void CalculateDuration();
 
+		/// @brief Resamples the transform nodes at a fixed frame rate, so the skeleton poses sample this clip without searching for keys.
+		/// @note Bake after the nodes are added and the start and end times are set. The baked frames are written with the clip.
+		/// Rebind any AnimBinding made before baking, or it goes on sampling the keys.
+		/// @param[in] frame_rate	The frames per second to bake at.
+		/// @return true if the clip was baked
+		bool Bake(const float frame_rate);
+
+		/// @brief Frees the baked frames, so the clip is sampled from its keys again.
+		void ClearBaked();
+
 		bool Read(std::istream& stream);
 		bool Write(std::ostream& stream) const;
 
@@ -128,8 +184,12 @@ namespace gef
 
 		inline void set_name_id(const StringId name_id) { name_id_ = name_id; }
 		inline StringId name_id() const { return name_id_; }
+
+		/// @return the baked frames, or NULL if the clip isn't baked
+		inline const BakedAnimation* baked() const { return baked_; }
 	protected:
 		std::map<StringId, AnimNode*> anim_nodes_;
+		BakedAnimation* baked_;
 		float duration_;
 		float start_time_;
 		float end_time_;
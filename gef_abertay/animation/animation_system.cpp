@@ -0,0 +1,335 @@
+#include <animation/animation_system.h>
+#include <animation/animation.h>
+#include <animation/anim_lod.h>
+#include <system/job_system.h>
+#include <maths/transform_batch.h>
+#include <algorithm>
+#include <math.h>
+
+namespace gef
+{
+	// characters take tens of microseconds each, a few per job keeps the job overhead small
+	static const Int32 kMinCharactersPerJob = 2;
+
+	AnimClipPlayback::AnimClipPlayback() :
+		clip(NULL),
+		anim_time(0.0f),
+		playback_speed(1.0f),
+		looping(false)
+	{
+	}
+
+	bool AnimClipPlayback::Advance(const float delta_time)
+	{
+		bool finished = false;
+
+		if (clip)
+		{
+			anim_time += delta_time*playback_speed;
+
+			// wrap the playback time round to the beginning of a looping clip,
+			// otherwise stop at the end of the clip
+			if (anim_time > clip->duration())
+			{
+				if (looping)
+					anim_time = fmodf(anim_time, clip->duration());
+				else
+				{
+					anim_time = clip->duration();
+					finished = true;
+				}
+			}
+		}
+
+		return finished;
+	}
+
+	float AnimClipPlayback::SampleTime() const
+	{
+		return anim_time + clip->start_time();
+	}
+
+	AnimCharacter::AnimCharacter() :
+		bind_pose_(NULL),
+		lod_settings_(NULL),
+		key_clip_(NULL),
+		key_blend_clip_(NULL),
+		position_(0.0f, 0.0f, 0.0f),
+		lod_level_(0),
+		lod_phase_(0),
+		frames_since_key_(0),
+		key_interval_(1),
+		key_frames_valid_(false),
+		front_buffer_(0),
+		blend_(0.0f),
+		active_(true),
+		back_buffer_updated_(false)
+	{
+	}
+
+	void AnimCharacter::Create(const SkeletonPoseSoA& bind_pose)
+	{
+		bind_pose_ = &bind_pose;
+		pose_ = bind_pose;
+		blend_pose_ = bind_pose;
+		next_key_pose_ = bind_pose;
+		key_matrices_.resize(bind_pose.joint_count());
+		next_key_matrices_.resize(bind_pose.joint_count());
+		binding_.Clear();
+		blend_binding_.Clear();
+		key_frames_valid_ = false;
+		front_buffer_ = 0;
+		back_buffer_updated_ = false;
+
+		for (Int32 buffer_num = 0; buffer_num < 2; ++buffer_num)
+		{
+			skinning_matrices_[buffer_num].resize(bind_pose.joint_count());
+			if (bind_pose.joint_count() > 0)
+				pose_.CalculateSkinningMatrices(&skinning_matrices_[buffer_num][0]);
+		}
+	}
+
+	void AnimCharacter::CleanUp()
+	{
+		pose_.CleanUp();
+		blend_pose_.CleanUp();
+		next_key_pose_.CleanUp();
+		key_matrices_.clear();
+		next_key_matrices_.clear();
+		key_frames_valid_ = false;
+		binding_.Clear();
+		blend_binding_.Clear();
+		skinning_matrices_[0].clear();
+		skinning_matrices_[1].clear();
+		bind_pose_ = NULL;
+	}
+
+	void AnimCharacter::Play(const Animation* clip, const bool looping)
+	{
+		if (playback_.clip != clip)
+		{
+			playback_.clip = clip;
+			playback_.anim_time = 0.0f;
+		}
+		playback_.looping = looping;
+	}
+
+	void AnimCharacter::set_lod_settings(const AnimLodSettings* lod_settings)
+	{
+		lod_settings_ = lod_settings;
+		lod_level_ = 0;
+		key_frames_valid_ = false;
+	}
+
+	void AnimCharacter::set_lod_level(const Int32 lod_level)
+	{
+		if (lod_level != lod_level_)
+		{
+			lod_level_ = lod_level;
+			key_frames_valid_ = false;
+		}
+	}
+
+	void AnimCharacter::SamplePose(SkeletonPoseSoA& pose, const AnimClipPlayback& playback, const AnimClipPlayback& blend_playback, const std::vector<Int32>* joints)
+	{
+		// sample the main clip, any joints it doesn't animate are left in the bind pose
+		if (!playback.clip)
+			pose = *bind_pose_;
+		else if (joints)
+			pose.SetPoseFromAnim(*playback.clip, *bind_pose_, playback.SampleTime(), binding_, *joints, false);
+		else
+			pose.SetPoseFromAnim(*playback.clip, *bind_pose_, playback.SampleTime(), binding_, false);
+
+		// blend in the second clip
+		if (blend_playback.clip && blend_ > 0.0f)
+		{
+			// only the sampled joints are blended, blend_pose_ holds stale values for the others
+			if (joints)
+			{
+				blend_pose_.SetPoseFromAnim(*blend_playback.clip, *bind_pose_, blend_playback.SampleTime(), blend_binding_, *joints, false);
+				pose.Linear2PoseBlend(pose, blend_pose_, blend_, *joints, false);
+			}
+			else
+			{
+				blend_pose_.SetPoseFromAnim(*blend_playback.clip, *bind_pose_, blend_playback.SampleTime(), blend_binding_, false);
+				pose.Linear2PoseBlend(pose, blend_pose_, blend_, false);
+			}
+		}
+	}
+
+	void AnimCharacter::UpdateKeyFrames(const float delta_time, const Int32 update_interval, const std::vector<Int32>* joints, std::vector<Matrix44>& skinning_matrices)
+	{
+		const Int32 num_joints = (Int32)skinning_matrices.size();
+		const Animation* blend_clip = blend_ > 0.0f ? blend_playback_.clip : NULL;
+		const bool same_clips = key_frames_valid_ && key_clip_ == playback_.clip && key_blend_clip_ == blend_clip;
+
+		if (same_clips && frames_since_key_ < key_interval_)
+		{
+			// between key frames only the skinning matrices are blended, changes to the blend amount show at the next key frame
+			BlendMatricesBatch(&key_matrices_[0], &next_key_matrices_[0], (float)frames_since_key_ / (float)key_interval_, &skinning_matrices[0], num_joints);
+		}
+		else
+		{
+			if (same_clips)
+			{
+				// the key frame sampled ahead at the last key frame
+				std::swap(pose_, next_key_pose_);
+				key_matrices_.swap(next_key_matrices_);
+				key_interval_ = update_interval;
+			}
+			else
+			{
+				// starting over, the phase spreads the first key frames of characters at the same level
+				SamplePose(pose_, playback_, blend_playback_, joints);
+				pose_.CalculateGlobalPose();
+				pose_.CalculateSkinningMatrices(&key_matrices_[0]);
+				key_interval_ = update_interval - lod_phase_ % update_interval;
+				key_clip_ = playback_.clip;
+				key_blend_clip_ = blend_clip;
+				key_frames_valid_ = true;
+
+				// the joints the level skips hold their last pose in both key frames, from here on the swap keeps them equal
+				if (joints)
+					next_key_pose_ = pose_;
+			}
+
+			// sample the clips where they will be at the next key frame, assuming the frame time stays the same
+			AnimClipPlayback next_playback = playback_, next_blend_playback = blend_playback_;
+			next_playback.Advance(delta_time*key_interval_);
+			next_blend_playback.Advance(delta_time*key_interval_);
+			SamplePose(next_key_pose_, next_playback, next_blend_playback, joints);
+			next_key_pose_.CalculateGlobalPose();
+			next_key_pose_.CalculateSkinningMatrices(&next_key_matrices_[0]);
+
+			skinning_matrices = key_matrices_;
+			frames_since_key_ = 0;
+		}
+
+		++frames_since_key_;
+	}
+
+	bool AnimCharacter::Update(const float delta_time)
+	{
+		if (!bind_pose_)
+			return false;
+
+		const bool finished = playback_.Advance(delta_time);
+		blend_playback_.Advance(delta_time);
+
+		// the level of detail's joints and how often to sample the clips
+		Int32 update_interval = 1;
+		const std::vector<Int32>* joints = NULL;
+		if (lod_settings_)
+		{
+			const AnimLodLevel& level = lod_settings_->level(lod_level_);
+			update_interval = level.update_interval;
+			if (!lod_settings_->SamplesAllJoints(lod_level_))
+				joints = &level.joints;
+		}
+
+		std::vector<Matrix44>& back_buffer = skinning_matrices_[front_buffer_ ^ 1];
+		if (update_interval > 1 && !back_buffer.empty())
+			UpdateKeyFrames(delta_time, update_interval, joints, back_buffer);
+		else
+		{
+			SamplePose(pose_, playback_, blend_playback_, joints);
+			pose_.CalculateGlobalPose();
+			if (!back_buffer.empty())
+				pose_.CalculateSkinningMatrices(&back_buffer[0]);
+		}
+		back_buffer_updated_ = true;
+
+		return finished;
+	}
+
+	void AnimCharacter::SwapBuffers()
+	{
+		// characters that weren't updated keep showing their last pose
+		if (back_buffer_updated_)
+		{
+			front_buffer_ ^= 1;
+			back_buffer_updated_ = false;
+		}
+	}
+
+	AnimationSystem::AnimationSystem()
+	{
+	}
+
+	void AnimationSystem::AddCharacter(AnimCharacter* character)
+	{
+		character->set_lod_phase(character_count());
+		characters_.push_back(character);
+		active_characters_.reserve(characters_.size());
+	}
+
+	void AnimationSystem::RemoveCharacter(AnimCharacter* character)
+	{
+		characters_.erase(std::remove(characters_.begin(), characters_.end(), character), characters_.end());
+		active_characters_.clear();
+	}
+
+	void AnimationSystem::RemoveAllCharacters()
+	{
+		characters_.clear();
+		active_characters_.clear();
+	}
+
+	void AnimationSystem::GatherActiveCharacters()
+	{
+		active_characters_.clear();
+		for (size_t character_num = 0; character_num < characters_.size(); ++character_num)
+		{
+			if (characters_[character_num]->active())
+				active_characters_.push_back(characters_[character_num]);
+		}
+	}
+
+	struct AnimUpdateJobData
+	{
+		AnimCharacter* const* characters;
+		float delta_time;
+
+		static void Run(void* data, const Int32 begin, const Int32 end)
+		{
+			const AnimUpdateJobData* job = static_cast<const AnimUpdateJobData*>(data);
+			for (Int32 character_num = begin; character_num < end; ++character_num)
+				job->characters[character_num]->Update(job->delta_time);
+		}
+	};
+
+	void AnimationSystem::Update(const float delta_time)
+	{
+		GatherActiveCharacters();
+		for (size_t character_num = 0; character_num < active_characters_.size(); ++character_num)
+			active_characters_[character_num]->Update(delta_time);
+	}
+
+	void AnimationSystem::Update(const float delta_time, JobSystem& job_system)
+	{
+		GatherActiveCharacters();
+		if (active_characters_.empty())
+			return;
+
+		AnimUpdateJobData job;
+		job.characters = &active_characters_[0];
+		job.delta_time = delta_time;
+		job_system.ParallelFor(active_character_count(), kMinCharactersPerJob, &AnimUpdateJobData::Run, &job);
+	}
+
+	void AnimationSystem::SelectLods(const Vector4& camera_position)
+	{
+		for (size_t character_num = 0; character_num < characters_.size(); ++character_num)
+		{
+			AnimCharacter* character = characters_[character_num];
+			if (character->lod_settings())
+				character->set_lod_level(character->lod_settings()->SelectLevel((character->position() - camera_position).Length()));
+		}
+	}
+
+	void AnimationSystem::SwapBuffers()
+	{
+		for (size_t character_num = 0; character_num < characters_.size(); ++character_num)
+			characters_[character_num]->SwapBuffers();
+	}
+}
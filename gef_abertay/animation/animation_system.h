@@ -0,0 +1,175 @@
+#ifndef _GEF_ANIMATION_SYSTEM_H
+#define _GEF_ANIMATION_SYSTEM_H
+
+#include <gef.h>
+#include <animation/skeleton_pose_soa.h>
+#include <animation/anim_binding.h>
+#include <maths/matrix44.h>
+#include <maths/vector4.h>
+#include <vector>
+
+namespace gef
+{
+	class Animation;
+	class JobSystem;
+	class AnimLodSettings;
+
+	/// @brief The playback state of one clip: how far through it is, how fast it plays and whether it loops.
+	struct AnimClipPlayback
+	{
+		AnimClipPlayback();
+
+		/// @brief Moves the playback time on, wrapping it round if the clip loops.
+		/// @return true if the playback has reached the end of a clip that doesn't loop
+		bool Advance(const float delta_time);
+
+		/// @return the time to sample the clip at, including the clip's start time
+		float SampleTime() const;
+
+		const Animation* clip;
+		float anim_time;		// the time since the start of the clip
+		float playback_speed;
+		bool looping;
+	};
+
+	/// @brief An animated character updated by an AnimationSystem.
+	/// @note Each update samples the character's clip, optionally blends in a second clip, calculates the global pose
+	/// and then the skinning matrices. The skinning matrices are double buffered: an update writes the back buffer
+	/// and AnimationSystem::SwapBuffers makes it the one skinning_matrices returns, so a renderer can
+	/// keep reading the last frame's matrices while the next frame is updated.
+	/// With AnimLodSettings, a character at a level with an update interval only samples its clips on key frames,
+	/// where the clips will be at the next key frame. The skinning matrices of the frames in between are blended
+	/// from those of the two key frames, and the pose is the pose of the last key frame.
+	class AnimCharacter
+	{
+	public:
+		AnimCharacter();
+
+		/// @brief Allocates the character's poses and skinning matrices, setting both buffers to the bind pose.
+		/// @param[in] bind_pose	The bind pose of the character's skeleton. It must outlive the character and
+		/// can be shared by every character with the same skeleton.
+		void Create(const SkeletonPoseSoA& bind_pose);
+		void CleanUp();
+
+		/// @brief Samples, blends and skins the character, writing the back buffer.
+		/// @return true if the playback of the main clip has reached its end, always false when it loops
+		bool Update(const float delta_time);
+
+		/// @brief Makes the last update's skinning matrices the ones the renderer reads.
+		/// @note Does nothing if the character hasn't been updated since the last swap.
+		void SwapBuffers();
+
+		/// @brief Starts a clip from the beginning, unless it's already playing.
+		void Play(const Animation* clip, const bool looping = true);
+
+		/// @return the skinning matrices from the last update before the last SwapBuffers, for Renderer3D::DrawSkinnedMesh
+		inline const std::vector<Matrix44>& skinning_matrices() const { return skinning_matrices_[front_buffer_]; }
+
+		/// @return the pose of the last update
+		inline const SkeletonPoseSoA& pose() const { return pose_; }
+		inline const SkeletonPoseSoA* bind_pose() const { return bind_pose_; }
+
+		inline AnimClipPlayback& playback() { return playback_; }
+		inline const AnimClipPlayback& playback() const { return playback_; }
+
+		/// @brief The clip blended with the main one, the blend amount is how much of it is used.
+		inline AnimClipPlayback& blend_playback() { return blend_playback_; }
+		inline const AnimClipPlayback& blend_playback() const { return blend_playback_; }
+		inline float blend() const { return blend_; }
+		inline void set_blend(const float blend) { blend_ = blend; }
+
+		/// @brief The levels of detail for the character's skeleton, or NULL to always update everything.
+		void set_lod_settings(const AnimLodSettings* lod_settings);
+		inline const AnimLodSettings* lod_settings() const { return lod_settings_; }
+
+		/// @brief Sets the level of detail, see AnimationSystem::SelectLods.
+		void set_lod_level(const Int32 lod_level);
+		inline Int32 lod_level() const { return lod_level_; }
+
+		/// @brief Offsets the frames the character samples its clips on at levels with an update interval,
+		/// so characters at the same level don't all sample on the same frame. AnimationSystem::AddCharacter sets it.
+		inline void set_lod_phase(const Int32 lod_phase) { lod_phase_ = lod_phase; }
+
+		/// @brief The position the distance to the camera is measured from.
+		inline const Vector4& position() const { return position_; }
+		inline void set_position(const Vector4& position) { position_ = position; }
+
+		/// @brief Inactive characters are skipped by AnimationSystem::Update.
+		inline bool active() const { return active_; }
+		inline void set_active(const bool active) { active_ = active; }
+
+	private:
+		void SamplePose(SkeletonPoseSoA& pose, const AnimClipPlayback& playback, const AnimClipPlayback& blend_playback, const std::vector<Int32>* joints);
+		void UpdateKeyFrames(const float delta_time, const Int32 update_interval, const std::vector<Int32>* joints, std::vector<Matrix44>& skinning_matrices);
+
+		SkeletonPoseSoA pose_;
+		SkeletonPoseSoA blend_pose_;
+		AnimBinding binding_;
+		AnimBinding blend_binding_;
+		AnimClipPlayback playback_;
+		AnimClipPlayback blend_playback_;
+		std::vector<Matrix44> skinning_matrices_[2];
+		const SkeletonPoseSoA* bind_pose_;
+
+		// level of detail
+		SkeletonPoseSoA next_key_pose_;		// the pose sampled ahead for the next key frame
+		std::vector<Matrix44> key_matrices_;		// the skinning matrices of the last key frame
+		std::vector<Matrix44> next_key_matrices_;	// and of the next one
+		const AnimLodSettings* lod_settings_;
+		const Animation* key_clip_;			// the clips the key frames were sampled from
+		const Animation* key_blend_clip_;
+		Vector4 position_;
+		Int32 lod_level_;
+		Int32 lod_phase_;
+		Int32 frames_since_key_;
+		Int32 key_interval_;				// the number of frames between the key frames
+		bool key_frames_valid_;
+
+		Int32 front_buffer_;
+		float blend_;
+		bool active_;
+		bool back_buffer_updated_;
+	};
+
+	/// @brief Updates every active character each frame, on the calling thread or spread across a job system's threads.
+	/// @note Characters don't share any state that changes during an update, so each job updates a range of characters
+	/// from sampling to skinning matrices, keeping each character's poses in one core's cache.
+	class AnimationSystem
+	{
+	public:
+		AnimationSystem();
+
+		/// @brief Adds a character to be updated. The character must outlive the system or be removed first.
+		void AddCharacter(AnimCharacter* character);
+		void RemoveCharacter(AnimCharacter* character);
+		void RemoveAllCharacters();
+
+		/// @brief Updates every active character on the calling thread.
+		void Update(const float delta_time);
+
+		/// @brief Updates every active character with the job system's threads.
+		/// @note The results are identical to updating on the calling thread.
+		void Update(const float delta_time, JobSystem& job_system);
+
+		/// @brief Sets the level of detail of every character with AnimLodSettings from its distance to the camera.
+		void SelectLods(const Vector4& camera_position);
+
+		/// @brief Makes the last update's skinning matrices of every character the ones the renderer reads.
+		/// @note Call this once the renderer has finished with the previous frame's matrices.
+		void SwapBuffers();
+
+		inline Int32 character_count() const { return (Int32)characters_.size(); }
+		inline AnimCharacter* character(const Int32 index) const { return characters_[index]; }
+
+		/// @return the number of characters updated by the last update
+		inline Int32 active_character_count() const { return (Int32)active_characters_.size(); }
+
+	private:
+		void GatherActiveCharacters();
+
+		std::vector<AnimCharacter*> characters_;
+		std::vector<AnimCharacter*> active_characters_;	// gathered at the start of each update, reusing its memory
+	};
+}
+
+#endif // _GEF_ANIMATION_SYSTEM_H
@@ -0,0 +1,211 @@
+#include <animation/baked_animation.h>
+#include <animation/animation.h>
+#include <algorithm>
+#include <cmath>
+
+namespace gef
+{
+	BakedAnimation::BakedAnimation() :
+		frame_count_(0),
+		frame_rate_(0.0f),
+		start_time_(0.0f)
+	{
+	}
+
+	bool BakedAnimation::Bake(const Animation& animation, const float frame_rate)
+	{
+		Clear();
+
+		if (frame_rate <= 0.0f)
+			return false;
+
+		for (std::map<StringId, AnimNode*>::const_iterator anim_node_iter = animation.anim_nodes().begin(); anim_node_iter != animation.anim_nodes().end(); ++anim_node_iter)
+		{
+			if (anim_node_iter->second->type() != AnimNode::kTransform)
+				continue;
+
+			const TransformAnimNode* transform_node = static_cast<const TransformAnimNode*>(anim_node_iter->second);
+			UInt32 flags = 0;
+			if (!transform_node->rotation_keys().empty())
+				flags |= kRotation;
+			if (!transform_node->translation_keys().empty())
+				flags |= kTranslation;
+
+			track_name_ids_.push_back(anim_node_iter->first);
+			track_flags_.push_back(flags);
+		}
+
+		// round the frame count up, then space the frames evenly so the last one lands on the end of the clip
+		const float duration = animation.end_time() - animation.start_time();
+		start_time_ = animation.start_time();
+		if (duration > 0.0f)
+		{
+			frame_count_ = (Int32)ceilf(duration*frame_rate - 0.001f) + 1;
+			frame_rate_ = (float)(frame_count_ - 1) / duration;
+		}
+		else
+		{
+			frame_count_ = 1;
+			frame_rate_ = frame_rate;
+		}
+
+		const Int32 num_tracks = track_count();
+		frames_.resize(frame_count_*num_tracks);
+		for (Int32 frame_index = 0; frame_index < frame_count_; ++frame_index)
+		{
+			const float time = frame_index == frame_count_ - 1 && frame_count_ > 1 ? animation.end_time() : start_time_ + (float)frame_index / frame_rate_;
+			TrackPose* frame_poses = &frames_[frame_index*num_tracks];
+
+			for (Int32 track_index = 0; track_index < num_tracks; ++track_index)
+			{
+				const TransformAnimNode* transform_node = static_cast<const TransformAnimNode*>(animation.FindNode(track_name_ids_[track_index]));
+				TrackPose& track_pose = frame_poses[track_index];
+
+				if (track_flags_[track_index] & kRotation)
+					track_pose.rotation = transform_node->GetRotation(time);
+				else
+					track_pose.rotation = Quaternion(0.0f, 0.0f, 0.0f, 1.0f);
+
+				if (track_flags_[track_index] & kTranslation)
+					track_pose.translation = transform_node->GetTranslation(time);
+				else
+					track_pose.translation = Vector4(0.0f, 0.0f, 0.0f);
+			}
+		}
+
+		return true;
+	}
+
+	void BakedAnimation::Clear()
+	{
+		track_name_ids_.clear();
+		track_flags_.clear();
+		frames_.clear();
+		frame_count_ = 0;
+		frame_rate_ = 0.0f;
+		start_time_ = 0.0f;
+	}
+
+	Int32 BakedAnimation::FindTrackIndex(const StringId name_id) const
+	{
+		std::vector<StringId>::const_iterator track = std::lower_bound(track_name_ids_.begin(), track_name_ids_.end(), name_id);
+		if (track != track_name_ids_.end() && *track == name_id)
+			return (Int32)(track - track_name_ids_.begin());
+		return -1;
+	}
+
+	const BakedAnimation::FrameBlend BakedAnimation::GetFrameBlend(const float time) const
+	{
+		FrameBlend frame_blend;
+		const Int32 last_frame = frame_count_ - 1;
+		const float frame_time = (time - start_time_)*frame_rate_;
+
+		if (frame_time <= 0.0f || last_frame <= 0)
+		{
+			frame_blend.frame = 0;
+			frame_blend.blend = 0.0f;
+		}
+		else if (frame_time >= (float)last_frame)
+		{
+			frame_blend.frame = last_frame - 1;
+			frame_blend.blend = 1.0f;
+		}
+		else
+		{
+			frame_blend.frame = (Int32)frame_time;
+			frame_blend.blend = frame_time - (float)frame_blend.frame;
+		}
+
+		return frame_blend;
+	}
+
+	void BakedAnimation::SampleTrack(const Int32 track_index, const FrameBlend& frame_blend, Quaternion& rotation, Vector4& translation) const
+	{
+		// a clip with no duration has a single frame
+		const size_t frame_stride = frame_count_ > 1 ? track_name_ids_.size() : 0;
+		const TrackPose& start = frames_[frame_blend.frame*track_name_ids_.size() + track_index];
+		const TrackPose& end = (&start)[frame_stride];
+		const UInt32 flags = track_flags_[track_index];
+
+		if (flags & kRotation)
+			rotation.FastSlerp(start.rotation, end.rotation, frame_blend.blend);
+		if (flags & kTranslation)
+			translation.Lerp(start.translation, end.translation, frame_blend.blend);
+	}
+
+	const Quaternion BakedAnimation::GetRotation(const Int32 track_index, const float time) const
+	{
+		Quaternion rotation(0.0f, 0.0f, 0.0f, 1.0f);
+		Vector4 translation(0.0f, 0.0f, 0.0f);
+		SampleTrack(track_index, GetFrameBlend(time), rotation, translation);
+		return rotation;
+	}
+
+	const Vector4 BakedAnimation::GetTranslation(const Int32 track_index, const float time) const
+	{
+		Quaternion rotation(0.0f, 0.0f, 0.0f, 1.0f);
+		Vector4 translation(0.0f, 0.0f, 0.0f);
+		SampleTrack(track_index, GetFrameBlend(time), rotation, translation);
+		return translation;
+	}
+
+	bool BakedAnimation::Read(std::istream& stream)
+	{
+		Clear();
+
+		Int32 num_tracks;
+		stream.read((char*)&num_tracks, sizeof(Int32));
+		stream.read((char*)&frame_count_, sizeof(Int32));
+		stream.read((char*)&frame_rate_, sizeof(float));
+		stream.read((char*)&start_time_, sizeof(float));
+		// tracks without frames would leave nothing for SampleTrack to read
+		if (!stream || num_tracks < 0 || frame_count_ < 0 || (num_tracks > 0 && frame_count_ == 0))
+		{
+			Clear();
+			return false;
+		}
+
+		if (num_tracks > 0)
+		{
+			track_name_ids_.resize(num_tracks);
+			stream.read((char*)&track_name_ids_.front(), sizeof(StringId)*num_tracks);
+			track_flags_.resize(num_tracks);
+			stream.read((char*)&track_flags_.front(), sizeof(UInt32)*num_tracks);
+		}
+
+		if (num_tracks > 0 && frame_count_ > 0)
+		{
+			frames_.resize(frame_count_*num_tracks);
+			stream.read((char*)&frames_.front(), sizeof(TrackPose)*frames_.size());
+		}
+
+		return !stream.fail();
+	}
+
+	bool BakedAnimation::Write(std::ostream& stream) const
+	{
+		const Int32 num_tracks = track_count();
+		stream.write((char*)&num_tracks, sizeof(Int32));
+		stream.write((char*)&frame_count_, sizeof(Int32));
+		stream.write((char*)&frame_rate_, sizeof(float));
+		stream.write((char*)&start_time_, sizeof(float));
+
+		if (num_tracks > 0)
+		{
+			stream.write((char*)&track_name_ids_.front(), sizeof(StringId)*num_tracks);
+			stream.write((char*)&track_flags_.front(), sizeof(UInt32)*num_tracks);
+		}
+		if (!frames_.empty())
+			stream.write((char*)&frames_.front(), sizeof(TrackPose)*frames_.size());
+
+		return true;
+	}
+
+	size_t BakedAnimation::GetMemorySize() const
+	{
+		return sizeof(BakedAnimation)
+			+ track_name_ids_.size()*sizeof(StringId)
+			+ track_flags_.size()*sizeof(UInt32)
+			+ frames_.size()*sizeof(TrackPose);
+	}
+}
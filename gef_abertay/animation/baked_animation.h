@@ -0,0 +1,99 @@
+#ifndef _GEF_BAKED_ANIMATION_H
+#define _GEF_BAKED_ANIMATION_H
+
+#include <gef.h>
+#include <maths/vector4.h>
+#include <maths/quaternion.h>
+#include <system/string_id.h>
+#include <vector>
+#include <istream>
+
+namespace gef
+{
+	class Animation;
+
+	/// @brief The transform nodes of a clip resampled at a fixed frame rate.
+	/// @note Each frame is one contiguous block holding the rotation and translation of every track, in node order.
+	/// Sampling finds the two frames either side of a time with index arithmetic and blends them,
+	/// so it costs the same at any time, with no key search and no cursor.
+	/// Scale is not baked, the skeleton poses always sample a scale of one.
+	/// Channel nodes are not baked.
+	class BakedAnimation
+	{
+	public:
+		/// @brief The rotation and translation of a track on one frame.
+		struct TrackPose
+		{
+			Quaternion rotation;
+			Vector4 translation;
+		};
+
+		/// @brief Which of a track's channels are animated. The others are left to the bind pose.
+		enum TrackFlags
+		{
+			kRotation = 1 << 0,
+			kTranslation = 1 << 1
+		};
+
+		/// @brief The two frames either side of a sample time and the blend between them.
+		struct FrameBlend
+		{
+			Int32 frame;
+			float blend;
+		};
+
+		BakedAnimation();
+
+		/// @brief Resamples the transform nodes of a clip, replacing anything baked before.
+		/// @param[in] animation	The clip to bake.
+		/// @param[in] frame_rate	The frames per second to sample at. It is rounded up so frames fall exactly on the start and end of the clip.
+		/// @return true if the clip was baked, false if the frame rate is not positive
+		bool Bake(const Animation& animation, const float frame_rate);
+		void Clear();
+
+		/// @return the index of the track with a name, or -1 if the clip doesn't have one
+		Int32 FindTrackIndex(const StringId name_id) const;
+
+		/// @brief Finds the frames to blend for a time. Times outside the clip use its first or last frame.
+		/// @param[in] time		The time to sample the clip at, in the same time as the clip's keys.
+		const FrameBlend GetFrameBlend(const float time) const;
+
+		/// @brief Samples a track's rotation and translation, with the blend found by GetFrameBlend.
+		/// @note Channels the track doesn't animate are not written, check track_flags.
+		void SampleTrack(const Int32 track_index, const FrameBlend& frame_blend, Quaternion& rotation, Vector4& translation) const;
+
+		/// @brief Samples a track like TransformAnimNode::GetRotation.
+		const Quaternion GetRotation(const Int32 track_index, const float time) const;
+
+		/// @brief Samples a track like TransformAnimNode::GetTranslation.
+		const Vector4 GetTranslation(const Int32 track_index, const float time) const;
+
+		bool Read(std::istream& stream);
+		bool Write(std::ostream& stream) const;
+
+		/// @return the number of bytes the baked frames and tracks use
+		size_t GetMemorySize() const;
+
+		inline bool empty() const { return frame_count_ == 0; }
+		inline Int32 track_count() const { return (Int32)track_name_ids_.size(); }
+		inline StringId track_name_id(const Int32 track_index) const { return track_name_ids_[track_index]; }
+		inline UInt32 track_flags(const Int32 track_index) const { return track_flags_[track_index]; }
+		inline Int32 frame_count() const { return frame_count_; }
+		inline float frame_rate() const { return frame_rate_; }
+		inline float start_time() const { return start_time_; }
+
+		/// @return the poses of every track on a frame
+		inline const TrackPose* frame(const Int32 frame_index) const { return &frames_[frame_index*track_name_ids_.size()]; }
+
+	private:
+		std::vector<StringId> track_name_ids_;	// sorted, the order of the clip's node map
+		std::vector<UInt32> track_flags_;
+		std::vector<TrackPose> frames_;			// frame_count_ blocks of track_count poses
+
+		Int32 frame_count_;
+		float frame_rate_;		// frames per second, exactly frame_count_ - 1 frames over the clip
+		float start_time_;		// the time of frame 0
+	};
+}
+
+#endif // _GEF_BAKED_ANIMATION_H
@@ -0,0 +1,328 @@
+#include <animation/blend_tree.h>
+#include <animation/animation.h>
+#include <animation/skeleton.h>
+
+namespace gef
+{
+	PosePool::PosePool() :
+		used_count_(0)
+	{
+	}
+
+	void PosePool::Create(const SkeletonPoseSoA& bind_pose, const Int32 pose_count)
+	{
+		poses_.assign(pose_count, bind_pose);
+		used_count_ = 0;
+	}
+
+	void PosePool::CleanUp()
+	{
+		poses_.clear();
+		used_count_ = 0;
+	}
+
+	SkeletonPoseSoA* PosePool::Push()
+	{
+		if (used_count_ == pose_count())
+			return NULL;
+
+		return &poses_[used_count_++];
+	}
+
+	void PosePool::Pop()
+	{
+		if (used_count_ > 0)
+			--used_count_;
+	}
+
+
+	BlendTree::BlendTree() :
+		root_(-1)
+	{
+	}
+
+	void BlendTree::Clear()
+	{
+		nodes_.clear();
+		inputs_.clear();
+		input_weights_.clear();
+		clips_.clear();
+		masks_.clear();
+		scaled_mask_.clear();
+		root_ = -1;
+	}
+
+	Int32 BlendTree::AddNode(const NodeType type, const float weight, const Int32 data)
+	{
+		Node node;
+		node.type = type;
+		node.weight = weight;
+		node.first_input = (Int32)inputs_.size();
+		node.input_count = 0;
+		node.data = data;
+		nodes_.push_back(node);
+
+		root_ = node_count() - 1;
+		return root_;
+	}
+
+	Int32 BlendTree::AddClipNode(const Animation* clip, const bool looping)
+	{
+		Clip clip_node;
+		clip_node.playback.clip = clip;
+		clip_node.playback.looping = looping;
+		clips_.push_back(clip_node);
+
+		return AddNode(kClip, 1.0f, (Int32)clips_.size() - 1);
+	}
+
+	Int32 BlendTree::AddBlendNode()
+	{
+		return AddNode(kBlend, 1.0f, -1);
+	}
+
+	Int32 BlendTree::AddBlendInput(const Int32 blend_node, const Int32 input_node, const float weight)
+	{
+		// keep each node's inputs together, moving on the inputs of any nodes added since
+		Node& node = nodes_[blend_node];
+		const Int32 insert_at = node.first_input + node.input_count;
+		inputs_.insert(inputs_.begin() + insert_at, input_node);
+		input_weights_.insert(input_weights_.begin() + insert_at, weight);
+		for (std::vector<Node>::iterator other_node = nodes_.begin(); other_node != nodes_.end(); ++other_node)
+		{
+			if (other_node->first_input >= insert_at && &*other_node != &node)
+				++other_node->first_input;
+		}
+
+		return node.input_count++;
+	}
+
+	Int32 BlendTree::AddAdditiveNode(const Int32 base_node, const Int32 additive_node, const Int32 reference_node, const float weight)
+	{
+		const Int32 node_index = AddNode(kAdditive, weight, -1);
+		const Int32 node_inputs[3] = { base_node, additive_node, reference_node };
+		for (Int32 input = 0; input < 3; ++input)
+		{
+			inputs_.push_back(node_inputs[input]);
+			input_weights_.push_back(1.0f);
+		}
+		nodes_[node_index].input_count = 3;
+
+		return node_index;
+	}
+
+	Int32 BlendTree::AddMaskNode(const Int32 base_node, const Int32 layer_node, const std::vector<float>& joint_weights, const float weight)
+	{
+		masks_.push_back(joint_weights);
+
+		const Int32 node_index = AddNode(kMask, weight, (Int32)masks_.size() - 1);
+		const Int32 node_inputs[2] = { base_node, layer_node };
+		for (Int32 input = 0; input < 2; ++input)
+		{
+			inputs_.push_back(node_inputs[input]);
+			input_weights_.push_back(1.0f);
+		}
+		nodes_[node_index].input_count = 2;
+
+		return node_index;
+	}
+
+	void BlendTree::Update(const float delta_time)
+	{
+		for (std::vector<Clip>::iterator clip = clips_.begin(); clip != clips_.end(); ++clip)
+			clip->playback.Advance(delta_time);
+	}
+
+	bool BlendTree::Evaluate(const SkeletonPoseSoA& bind_pose, PosePool& pool, SkeletonPoseSoA& result)
+	{
+		if (root_ < 0 || root_ >= node_count())
+			return false;
+
+		return EvaluateNode(root_, bind_pose, pool, result);
+	}
+
+	bool BlendTree::EvaluateNode(const Int32 node_index, const SkeletonPoseSoA& bind_pose, PosePool& pool, SkeletonPoseSoA& result)
+	{
+		const Node& node = nodes_[node_index];
+		const Int32* node_inputs = node.input_count > 0 ? &inputs_[node.first_input] : NULL;
+		bool success = true;
+
+		switch (node.type)
+		{
+		case kClip:
+			{
+				Clip& clip = clips_[node.data];
+				if (clip.playback.clip)
+					result.SetPoseFromAnim(*clip.playback.clip, bind_pose, clip.playback.SampleTime(), clip.binding, false);
+				else
+				{
+					result.rotations() = bind_pose.rotations();
+					result.translations() = bind_pose.translations();
+					result.scales() = bind_pose.scales();
+				}
+			}
+			break;
+
+		case kBlend:
+			{
+				const float* weights = node.input_count > 0 ? &input_weights_[node.first_input] : NULL;
+				float total_weight = 0.0f;
+				Int32 num_weighted = 0, last_weighted = 0;
+				for (Int32 input = 0; input < node.input_count; ++input)
+				{
+					if (weights[input] > 0.0f)
+					{
+						total_weight += weights[input];
+						++num_weighted;
+						last_weighted = input;
+					}
+				}
+
+				// a single input needs no blending, it is evaluated straight into the result
+				if (num_weighted <= 1)
+				{
+					if (node.input_count > 0)
+						success = EvaluateNode(node_inputs[last_weighted], bind_pose, pool, result);
+					break;
+				}
+
+				SkeletonPoseSoA* input_pose = pool.Push();
+				if (!input_pose)
+					return false;
+
+				result.ClearLocalPose();
+				for (Int32 input = 0; input < node.input_count && success; ++input)
+				{
+					if (weights[input] > 0.0f)
+					{
+						success = EvaluateNode(node_inputs[input], bind_pose, pool, *input_pose);
+						result.AddWeightedPose(*input_pose, weights[input] / total_weight);
+					}
+				}
+				result.NormaliseRotations();
+				pool.Pop();
+			}
+			break;
+
+		case kAdditive:
+			{
+				success = EvaluateNode(node_inputs[0], bind_pose, pool, result);
+				if (!success || node.weight <= 0.0f)
+					break;
+
+				SkeletonPoseSoA* additive_pose = pool.Push();
+				if (!additive_pose)
+					return false;
+
+				success = EvaluateNode(node_inputs[1], bind_pose, pool, *additive_pose);
+				SkeletonPoseSoA* reference_pose = success ? pool.Push() : NULL;
+				if (reference_pose)
+				{
+					success = EvaluateNode(node_inputs[2], bind_pose, pool, *reference_pose);
+					if (success)
+						result.AddAdditivePose(*additive_pose, *reference_pose, node.weight, false);
+					pool.Pop();
+				}
+				else
+					success = false;
+				pool.Pop();
+			}
+			break;
+
+		case kMask:
+			{
+				success = EvaluateNode(node_inputs[0], bind_pose, pool, result);
+				if (!success || node.weight <= 0.0f)
+					break;
+
+				SkeletonPoseSoA* layer_pose = pool.Push();
+				if (!layer_pose)
+					return false;
+
+				success = EvaluateNode(node_inputs[1], bind_pose, pool, *layer_pose);
+				if (success)
+				{
+					// scaled after the layer is evaluated, as the layer may contain mask nodes too
+					// joints past the end of a short mask keep the base, weights past the joint count are ignored
+					const std::vector<float>& mask = masks_[node.data];
+					const Int32 joint_count = result.joint_count();
+					if ((Int32)scaled_mask_.size() < joint_count)
+						scaled_mask_.resize(joint_count);
+					for (Int32 joint_num = 0; joint_num < joint_count; ++joint_num)
+						scaled_mask_[joint_num] = joint_num < (Int32)mask.size() ? mask[joint_num] * node.weight : 0.0f;
+					if (joint_count > 0)
+						result.MaskedPoseBlend(*layer_pose, &scaled_mask_[0], false);
+				}
+				pool.Pop();
+			}
+			break;
+		}
+
+		return success;
+	}
+
+	Int32 BlendTree::GetPoolSizeNeeded() const
+	{
+		if (root_ < 0 || root_ >= node_count())
+			return 0;
+
+		return GetPoolSizeNeeded(root_);
+	}
+
+	Int32 BlendTree::GetPoolSizeNeeded(const Int32 node_index) const
+	{
+		const Node& node = nodes_[node_index];
+		Int32 pool_size = 0;
+
+		switch (node.type)
+		{
+		case kClip:
+			break;
+
+		case kBlend:
+			// each input is evaluated into the same pool pose
+			for (Int32 input = 0; input < node.input_count; ++input)
+			{
+				const Int32 input_size = (node.input_count > 1 ? 1 : 0) + GetPoolSizeNeeded(inputs_[node.first_input + input]);
+				pool_size = input_size > pool_size ? input_size : pool_size;
+			}
+			break;
+
+		case kAdditive:
+		case kMask:
+			// the base is evaluated into the result, then each of the other inputs into one more pool pose
+			for (Int32 input = 0; input < node.input_count; ++input)
+			{
+				const Int32 input_size = input + GetPoolSizeNeeded(inputs_[node.first_input + input]);
+				pool_size = input_size > pool_size ? input_size : pool_size;
+			}
+			break;
+		}
+
+		return pool_size;
+	}
+
+	bool BlendTree::CreateJointMask(const Skeleton& skeleton, const StringId root_joint_name, std::vector<float>& joint_weights)
+	{
+		const Int32 root_joint = skeleton.FindJointIndex(root_joint_name);
+		joint_weights.assign(skeleton.joint_count(), 0.0f);
+		if (root_joint == -1)
+			return false;
+
+		for (Int32 joint_num = 0; joint_num < skeleton.joint_count(); ++joint_num)
+		{
+			// the skeleton's joints may not be in parent order, so walk up from each joint
+			Int32 depth = 0;
+			for (Int32 joint = joint_num; joint != -1 && depth <= skeleton.joint_count(); joint = skeleton.joint(joint).parent, ++depth)
+			{
+				if (joint == root_joint)
+				{
+					joint_weights[joint_num] = 1.0f;
+					break;
+				}
+			}
+		}
+
+		return true;
+	}
+}
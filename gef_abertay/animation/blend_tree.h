@@ -0,0 +1,163 @@
+#ifndef _GEF_BLEND_TREE_H
+#define _GEF_BLEND_TREE_H
+
+#include <gef.h>
+#include <animation/skeleton_pose_soa.h>
+#include <animation/anim_binding.h>
+#include <animation/animation_system.h>
+#include <system/string_id.h>
+#include <vector>
+
+namespace gef
+{
+	class Animation;
+	class Skeleton;
+
+	/// @brief A fixed number of poses for one skeleton, lent out in stack order while a BlendTree is evaluated.
+	/// @note Every pose is allocated by Create, so evaluating a tree never allocates.
+	/// A pool can be shared by every tree for the same skeleton that is evaluated on the same thread.
+	class PosePool
+	{
+	public:
+		PosePool();
+
+		/// @brief Allocates the poses.
+		/// @param[in] bind_pose	A pose for the skeleton, e.g. its bind pose.
+		/// @param[in] pose_count	The number of poses, see BlendTree::GetPoolSizeNeeded.
+		void Create(const SkeletonPoseSoA& bind_pose, const Int32 pose_count);
+		void CleanUp();
+
+		/// @brief Borrows the next free pose. Its local pose is whatever it was last used for.
+		/// @return the pose, or NULL if every pose is in use
+		SkeletonPoseSoA* Push();
+
+		/// @brief Gives back the pose borrowed last.
+		void Pop();
+
+		inline Int32 pose_count() const { return (Int32)poses_.size(); }
+		inline Int32 used_count() const { return used_count_; }
+
+	private:
+		std::vector<SkeletonPoseSoA> poses_;
+		Int32 used_count_;
+	};
+
+	/// @brief A tree of nodes that sample clips and blend the results, evaluated into a local pose.
+	/// @note Leaves sample a clip, each with its own playback and binding. Blend nodes sum any number of
+	/// inputs with their own weights, additive nodes apply the difference between two inputs to a third,
+	/// and mask nodes blend a layer over a base with a weight per joint, e.g. only the upper body.
+	/// Each node works on whole poses with the batched SkeletonPoseSoA operations. The poses in between
+	/// nodes come from a PosePool, so once the tree is built evaluating it never allocates.
+	/// Inputs with a weight of zero are skipped without being evaluated.
+	class BlendTree
+	{
+	public:
+		enum NodeType
+		{
+			kClip = 0,
+			kBlend,
+			kAdditive,
+			kMask
+		};
+
+		BlendTree();
+
+		/// @brief Removes every node.
+		void Clear();
+
+		/// @brief Adds a leaf that samples a clip.
+		/// @param[in] clip		The clip. It must outlive the tree.
+		/// @param[in] looping	Whether the clip loops.
+		/// @return the index of the node
+		Int32 AddClipNode(const Animation* clip, const bool looping = true);
+
+		/// @brief Adds a node that blends any number of inputs, added with AddBlendInput.
+		/// @note The weights are normalised when the tree is evaluated, so they don't have to add up to one.
+		/// @return the index of the node
+		Int32 AddBlendNode();
+
+		/// @brief Adds an input to a blend node.
+		/// @return the index of the input within the node, for set_input_weight
+		Int32 AddBlendInput(const Int32 blend_node, const Int32 input_node, const float weight);
+
+		/// @brief Adds a node that applies the difference between additive and reference to base.
+		/// @note The reference is often a clip node with a playback speed of zero, e.g. the first frame of the additive clip.
+		/// @return the index of the node
+		Int32 AddAdditiveNode(const Int32 base_node, const Int32 additive_node, const Int32 reference_node, const float weight = 1.0f);
+
+		/// @brief Adds a node that blends a layer over a base by a different amount for each joint.
+		/// @param[in] joint_weights	The blend amount of each joint, see CreateJointMask. Each is scaled by the node's weight.
+		/// A mask with fewer weights than the skeleton has joints is padded with zero weights, so the rest of the joints keep the base.
+		/// @return the index of the node
+		Int32 AddMaskNode(const Int32 base_node, const Int32 layer_node, const std::vector<float>& joint_weights, const float weight = 1.0f);
+
+		/// @brief Advances the playback of every clip node.
+		void Update(const float delta_time);
+
+		/// @brief Evaluates the tree from its root into a local pose.
+		/// @param[in] bind_pose	The bind pose of the skeleton, used for joints the clips don't animate.
+		/// @param[in,out] pool		The poses to evaluate the nodes in between into. Every pose is given back before returning.
+		/// @param[out] result		Receives the local pose. Its global pose is not updated.
+		/// @return false if the pool ran out of poses, or the tree has no root
+		bool Evaluate(const SkeletonPoseSoA& bind_pose, PosePool& pool, SkeletonPoseSoA& result);
+
+		/// @return the number of pool poses Evaluate needs for the tree
+		Int32 GetPoolSizeNeeded() const;
+
+		/// @brief Sets the blend amount of each joint to 1 for a joint and every joint below it, and 0 for the others.
+		/// @param[in] skeleton			The skeleton the mask is for.
+		/// @param[in] root_joint_name	The name of the joint at the top of the masked joints, e.g. the spine.
+		/// @param[out] joint_weights	Receives the joint_count blend amounts.
+		/// @return false if the skeleton has no joint with the name, when every amount is 0
+		static bool CreateJointMask(const Skeleton& skeleton, const StringId root_joint_name, std::vector<float>& joint_weights);
+
+		inline Int32 node_count() const { return (Int32)nodes_.size(); }
+		inline NodeType node_type(const Int32 node) const { return nodes_[node].type; }
+
+		/// @brief The root node, the last node added by default.
+		inline Int32 root() const { return root_; }
+		inline void set_root(const Int32 node) { root_ = node; }
+
+		/// @brief The weight of an additive or mask node.
+		inline float weight(const Int32 node) const { return nodes_[node].weight; }
+		inline void set_weight(const Int32 node, const float weight) { nodes_[node].weight = weight; }
+
+		/// @brief The weight of an input of a blend node.
+		inline float input_weight(const Int32 blend_node, const Int32 input) const { return input_weights_[nodes_[blend_node].first_input + input]; }
+		inline void set_input_weight(const Int32 blend_node, const Int32 input, const float weight) { input_weights_[nodes_[blend_node].first_input + input] = weight; }
+
+		/// @brief The playback of a clip node.
+		inline const AnimClipPlayback& playback(const Int32 clip_node) const { return clips_[nodes_[clip_node].data].playback; }
+		inline AnimClipPlayback& playback(const Int32 clip_node) { return clips_[nodes_[clip_node].data].playback; }
+
+	private:
+		struct Node
+		{
+			NodeType type;
+			float weight;			// additive and mask nodes
+			Int32 first_input;		// into inputs_ and input_weights_
+			Int32 input_count;
+			Int32 data;				// the node's clip or mask
+		};
+
+		struct Clip
+		{
+			AnimClipPlayback playback;
+			AnimBinding binding;
+		};
+
+		Int32 AddNode(const NodeType type, const float weight, const Int32 data);
+		bool EvaluateNode(const Int32 node_index, const SkeletonPoseSoA& bind_pose, PosePool& pool, SkeletonPoseSoA& result);
+		Int32 GetPoolSizeNeeded(const Int32 node_index) const;
+
+		std::vector<Node> nodes_;
+		std::vector<Int32> inputs_;				// the inputs of every node, each node's together
+		std::vector<float> input_weights_;		// the weights of the inputs of blend nodes
+		std::vector<Clip> clips_;
+		std::vector<std::vector<float> > masks_;
+		std::vector<float> scaled_mask_;		// a mask node's joint weights times its weight, sized for the joint count of the poses evaluated
+		Int32 root_;
+	};
+}
+
+#endif // _GEF_BLEND_TREE_H
@@ -0,0 +1,512 @@
+#include <animation/compressed_animation.h>
+#include <algorithm>
+#include <math.h>
+
+namespace gef
+{
+	static const float kMaxQuantisedValue = 65535.0f;
+
+	// the smallest three components of a unit quaternion are within +/- 1/sqrt(2), stored in 15 bits each
+	static const float kSmallestThreeRange = 0.707106781f;
+	static const float kMaxQuantisedComponent = 32767.0f;
+
+	// how far from a frame a key time can be, in frames, for a clip to count as sampled at a fixed frame rate
+	static const float kMaxFrameError = 0.001f;
+
+	// forward playback usually moves on by no more than a key or two each frame
+	static const UInt32 kMaxCursorSteps = 4;
+
+	AnimCompressionSettings::AnimCompressionSettings() :
+		rotation_error(0.0005f),
+		translation_error(0.01f),
+		scale_error(0.001f)
+	{
+	}
+
+	static UInt16 Quantise(const float value, const float min, const float step)
+	{
+		if (step <= 0.0f)
+			return 0;
+		const float quantised = floorf((value - min) / step + 0.5f);
+		return static_cast<UInt16>(quantised < 0.0f ? 0.0f : (quantised > kMaxQuantisedValue ? kMaxQuantisedValue : quantised));
+	}
+
+	static float Dequantise(const UInt16 value, const float min, const float step)
+	{
+		return min + value*step;
+	}
+
+	static UInt16 QuantiseComponent(const float value)
+	{
+		const float quantised = floorf((value + kSmallestThreeRange) * (kMaxQuantisedComponent / (2.0f*kSmallestThreeRange)) + 0.5f);
+		return static_cast<UInt16>(quantised < 0.0f ? 0.0f : (quantised > kMaxQuantisedComponent ? kMaxQuantisedComponent : quantised));
+	}
+
+	static float DequantiseComponent(const UInt16 value)
+	{
+		return (value & 0x7fff) * (2.0f*kSmallestThreeRange / kMaxQuantisedComponent) - kSmallestThreeRange;
+	}
+
+	// the largest component is dropped and rebuilt from the others, its sign is made positive since q and -q are the same rotation
+	static void QuantiseRotation(const Quaternion& rotation, UInt16& x, UInt16& y, UInt16& z)
+	{
+		Quaternion unit = rotation;
+		unit.Normalise();
+		const float values[4] = { unit.x, unit.y, unit.z, unit.w };
+
+		UInt32 largest = 0;
+		for (UInt32 component = 1; component < 4; ++component)
+		{
+			if (fabsf(values[component]) > fabsf(values[largest]))
+				largest = component;
+		}
+		const float sign = values[largest] < 0.0f ? -1.0f : 1.0f;
+
+		UInt16 smallest[3];
+		for (UInt32 component = 0, smallest_num = 0; component < 4; ++component)
+		{
+			if (component != largest)
+				smallest[smallest_num++] = QuantiseComponent(values[component]*sign);
+		}
+
+		x = static_cast<UInt16>(smallest[0] | ((largest & 1) << 15));
+		y = static_cast<UInt16>(smallest[1] | ((largest >> 1) << 15));
+		z = smallest[2];
+	}
+
+	// the components stored for each largest component
+	static const UInt32 kSmallestComponents[4][3] = { { 1, 2, 3 }, { 0, 2, 3 }, { 0, 1, 3 }, { 0, 1, 2 } };
+
+	static const Quaternion DequantiseRotation(const UInt16 x, const UInt16 y, const UInt16 z)
+	{
+		const UInt32 largest = (x >> 15) | ((y >> 15) << 1);
+		const UInt32* smallest_components = kSmallestComponents[largest];
+
+		float values[4];
+		values[smallest_components[0]] = DequantiseComponent(x);
+		values[smallest_components[1]] = DequantiseComponent(y);
+		values[smallest_components[2]] = DequantiseComponent(z);
+		const float largest_squared = 1.0f - values[smallest_components[0]]*values[smallest_components[0]] -
+			values[smallest_components[1]]*values[smallest_components[1]] - values[smallest_components[2]]*values[smallest_components[2]];
+		values[largest] = sqrtf(largest_squared > 0.0f ? largest_squared : 0.0f);
+
+		return Quaternion(values[0], values[1], values[2], values[3]);
+	}
+
+	// the angle between two rotations in radians, from the distance between the quaternions since acos is inaccurate for small angles
+	static double RotationError(const Quaternion& a, const Quaternion& b)
+	{
+		const double same = (double)(a.x - b.x)*(a.x - b.x) + (double)(a.y - b.y)*(a.y - b.y) + (double)(a.z - b.z)*(a.z - b.z) + (double)(a.w - b.w)*(a.w - b.w);
+		const double opposite = (double)(a.x + b.x)*(a.x + b.x) + (double)(a.y + b.y)*(a.y + b.y) + (double)(a.z + b.z)*(a.z + b.z) + (double)(a.w + b.w)*(a.w + b.w);
+		const double chord = sqrt(same < opposite ? same : opposite);
+		return 4.0*asin(chord < 2.0 ? chord*0.5 : 1.0);
+	}
+
+	static double VectorError(const Vector4& a, const Vector4& b)
+	{
+		const double x = a.x() - b.x(), y = a.y() - b.y(), z = a.z() - b.z();
+		return sqrt(x*x + y*y + z*z);
+	}
+
+	// the same search as the TransformAnimNode samplers, over key times in key time units
+	static UInt32 FindNextKey(const UInt16* times, const UInt32 first_key, const UInt32 last_key, const float time)
+	{
+		UInt32 low = first_key, high = last_key;
+		while (low < high)
+		{
+			const UInt32 middle = low + (high - low) / 2;
+			if (times[middle] > time)
+				high = middle;
+			else
+				low = middle + 1;
+		}
+		return low;
+	}
+
+	static UInt32 FindNextKey(const UInt16* times, const UInt32 num_keys, const float time, UInt32& cursor)
+	{
+		UInt32 key_index = cursor < num_keys ? cursor : num_keys;
+
+		if (key_index > 0 && times[key_index - 1] > time)
+		{
+			key_index = FindNextKey(times, 0, key_index, time);
+		}
+		else
+		{
+			for (UInt32 step = 0; step < kMaxCursorSteps && key_index < num_keys && times[key_index] <= time; ++step)
+				++key_index;
+
+			if (key_index < num_keys && times[key_index] <= time)
+				key_index = FindNextKey(times, key_index, num_keys, time);
+		}
+
+		cursor = key_index;
+		return key_index;
+	}
+
+	// the interpolation amount between two keys, zero if the keys share a time
+	static float GetBlendTime(const float time, const float prev_time, const float next_time)
+	{
+		return next_time > prev_time ? (time - prev_time) / (next_time - prev_time) : 0.0f;
+	}
+
+	template<typename Key>
+	static bool KeysInOrder(const std::vector<Key>& keys)
+	{
+		for (size_t key_num = 1; key_num < keys.size(); ++key_num)
+		{
+			if (keys[key_num].time < keys[key_num - 1].time)
+				return false;
+		}
+		return true;
+	}
+
+	template<typename Key>
+	static void AddKeyTimes(const std::vector<Key>& keys, std::vector<float>& key_times)
+	{
+		for (size_t key_num = 0; key_num < keys.size(); ++key_num)
+			key_times.push_back(keys[key_num].time);
+	}
+
+	// greedily removes keys that can be interpolated from the keys either side of them
+	// Fits(first, last) checks whether the keys between first and last are within the error of the line from first to last
+	template<typename Fits>
+	static void ReduceKeys(const UInt32 num_keys, Fits fits, std::vector<UInt32>& kept_keys)
+	{
+		kept_keys.clear();
+		kept_keys.push_back(0);
+		if (num_keys < 2)
+			return;
+
+		UInt32 anchor_key = 0;
+		for (UInt32 end_key = 2; end_key < num_keys; ++end_key)
+		{
+			if (!fits(anchor_key, end_key))
+			{
+				anchor_key = end_key - 1;
+				kept_keys.push_back(anchor_key);
+			}
+		}
+		kept_keys.push_back(num_keys - 1);
+	}
+
+	CompressedAnimation::CompressedAnimation() :
+		time_min_(0.0f),
+		time_scale_(0.0f),
+		duration_(0.0f),
+		start_time_(0.0f),
+		end_time_(0.0f),
+		name_id_(0)
+	{
+	}
+
+	void CompressedAnimation::Clear()
+	{
+		nodes_.clear();
+		vector_times_.clear();
+		vectors_.clear();
+		rotation_times_.clear();
+		rotations_.clear();
+		time_min_ = 0.0f;
+		time_scale_ = 0.0f;
+		duration_ = 0.0f;
+		start_time_ = 0.0f;
+		end_time_ = 0.0f;
+		name_id_ = 0;
+	}
+
+	// clips exported at a fixed frame rate have every key on a frame, so key times are stored as frame numbers
+	// and interpolate exactly like the original keys
+	// otherwise key times are spread over the 16 bit range, which moves keys by up to half a step
+	void CompressedAnimation::SetKeyTimeScale(const std::vector<float>& key_times)
+	{
+		time_min_ = key_times.empty() ? 0.0f : key_times.front();
+		time_scale_ = 0.0f;
+		if (key_times.size() < 2)
+			return;
+
+		const float time_range = key_times.back() - key_times.front();
+		float min_interval = time_range;
+		for (size_t time_num = 1; time_num < key_times.size(); ++time_num)
+			min_interval = key_times[time_num] - key_times[time_num - 1] < min_interval ? key_times[time_num] - key_times[time_num - 1] : min_interval;
+
+		const float num_frames = floorf(time_range / min_interval + 0.5f);
+		if (num_frames <= kMaxQuantisedValue)
+		{
+			const float frame_scale = num_frames / time_range;
+			bool on_frames = true;
+			for (size_t time_num = 0; time_num < key_times.size() && on_frames; ++time_num)
+			{
+				const float frame = (key_times[time_num] - time_min_)*frame_scale;
+				on_frames = fabsf(frame - floorf(frame + 0.5f)) < kMaxFrameError;
+			}
+
+			if (on_frames)
+			{
+				time_scale_ = frame_scale;
+				return;
+			}
+		}
+
+		time_scale_ = kMaxQuantisedValue / time_range;
+	}
+
+	float CompressedAnimation::GetKeyTime(const float time) const
+	{
+		return (time - time_min_)*time_scale_;
+	}
+
+	bool CompressedAnimation::Compress(const Animation& animation, const AnimCompressionSettings& settings)
+	{
+		Clear();
+
+		duration_ = animation.duration();
+		start_time_ = animation.start_time();
+		end_time_ = animation.end_time();
+		name_id_ = animation.name_id();
+
+		// every key time of the clip, to choose how key times are quantised
+		std::vector<float> key_times;
+		for (std::map<StringId, AnimNode*>::const_iterator node_iter = animation.anim_nodes().begin(); node_iter != animation.anim_nodes().end(); ++node_iter)
+		{
+			if (node_iter->second->type() != AnimNode::kTransform)
+				continue;
+
+			const TransformAnimNode* transform_node = static_cast<const TransformAnimNode*>(node_iter->second);
+			if (!KeysInOrder(transform_node->scale_keys()) || !KeysInOrder(transform_node->rotation_keys()) || !KeysInOrder(transform_node->translation_keys()))
+			{
+				Clear();
+				return false;
+			}
+
+			AddKeyTimes(transform_node->scale_keys(), key_times);
+			AddKeyTimes(transform_node->rotation_keys(), key_times);
+			AddKeyTimes(transform_node->translation_keys(), key_times);
+		}
+		std::sort(key_times.begin(), key_times.end());
+		key_times.erase(std::unique(key_times.begin(), key_times.end()), key_times.end());
+		SetKeyTimeScale(key_times);
+
+		for (std::map<StringId, AnimNode*>::const_iterator node_iter = animation.anim_nodes().begin(); node_iter != animation.anim_nodes().end(); ++node_iter)
+		{
+			if (node_iter->second->type() != AnimNode::kTransform)
+				continue;
+
+			const TransformAnimNode* transform_node = static_cast<const TransformAnimNode*>(node_iter->second);
+			Node node;
+			node.name_id = node_iter->first;
+			CompressVectorTrack(transform_node->scale_keys(), settings.scale_error, node.scale, node.scale_min, node.scale_step);
+			CompressRotationTrack(transform_node->rotation_keys(), settings.rotation_error, node.rotation);
+			CompressVectorTrack(transform_node->translation_keys(), settings.translation_error, node.translation, node.translation_min, node.translation_step);
+			nodes_.push_back(node);
+		}
+
+		return true;
+	}
+
+	void CompressedAnimation::CompressVectorTrack(const std::vector<Vector3Key>& keys, const float max_error, Track& track, Vector4& min, Vector4& step)
+	{
+		const UInt32 num_keys = static_cast<UInt32>(keys.size());
+		track.first_key = static_cast<UInt32>(vectors_.size());
+		track.num_keys = 0;
+		min = Vector4(0.0f, 0.0f, 0.0f, 0.0f);
+		step = Vector4(0.0f, 0.0f, 0.0f, 0.0f);
+		if (num_keys == 0)
+			return;
+
+		// the range of each component, w isn't animated so the first key's is kept
+		float min_values[3] = { keys[0].value.x(), keys[0].value.y(), keys[0].value.z() };
+		float max_values[3] = { min_values[0], min_values[1], min_values[2] };
+		for (UInt32 key_num = 1; key_num < num_keys; ++key_num)
+		{
+			for (Int32 component = 0; component < 3; ++component)
+			{
+				const float value = keys[key_num].value[component];
+				min_values[component] = value < min_values[component] ? value : min_values[component];
+				max_values[component] = value > max_values[component] ? value : max_values[component];
+			}
+		}
+		min = Vector4(min_values[0], min_values[1], min_values[2], keys[0].value.w());
+		step = Vector4((max_values[0] - min_values[0]) / kMaxQuantisedValue, (max_values[1] - min_values[1]) / kMaxQuantisedValue, (max_values[2] - min_values[2]) / kMaxQuantisedValue, 0.0f);
+
+		std::vector<QuantisedVector> values(num_keys);
+		std::vector<Vector4> decoded(num_keys);
+		std::vector<UInt16> times(num_keys);
+		for (UInt32 key_num = 0; key_num < num_keys; ++key_num)
+		{
+			const Vector4& value = keys[key_num].value;
+			values[key_num].x = Quantise(value.x(), min.x(), step.x());
+			values[key_num].y = Quantise(value.y(), min.y(), step.y());
+			values[key_num].z = Quantise(value.z(), min.z(), step.z());
+			decoded[key_num] = Vector4(Dequantise(values[key_num].x, min.x(), step.x()), Dequantise(values[key_num].y, min.y(), step.y()), Dequantise(values[key_num].z, min.z(), step.z()), min.w());
+			times[key_num] = Quantise(GetKeyTime(keys[key_num].time), 0.0f, 1.0f);
+		}
+
+		std::vector<UInt32> kept_keys;
+
+		// a track that doesn't move only needs one key
+		bool constant = true;
+		for (UInt32 key_num = 0; key_num < num_keys && constant; ++key_num)
+			constant = VectorError(decoded[0], keys[key_num].value) <= max_error;
+
+		if (constant)
+			kept_keys.push_back(0);
+		else
+		{
+			ReduceKeys(num_keys, [&](const UInt32 first_key, const UInt32 last_key)
+			{
+				for (UInt32 key_num = first_key + 1; key_num < last_key; ++key_num)
+				{
+					Vector4 value;
+					value.Lerp(decoded[first_key], decoded[last_key], GetBlendTime(GetKeyTime(keys[key_num].time), times[first_key], times[last_key]));
+					if (VectorError(value, keys[key_num].value) > max_error)
+						return false;
+				}
+				return true;
+			}, kept_keys);
+		}
+
+		for (size_t kept_num = 0; kept_num < kept_keys.size(); ++kept_num)
+		{
+			vectors_.push_back(values[kept_keys[kept_num]]);
+			vector_times_.push_back(times[kept_keys[kept_num]]);
+		}
+		track.num_keys = static_cast<UInt32>(kept_keys.size());
+	}
+
+	void CompressedAnimation::CompressRotationTrack(const std::vector<QuaternionKey>& keys, const float max_error, Track& track)
+	{
+		const UInt32 num_keys = static_cast<UInt32>(keys.size());
+		track.first_key = static_cast<UInt32>(rotations_.size());
+		track.num_keys = 0;
+		if (num_keys == 0)
+			return;
+
+		std::vector<QuantisedQuaternion> values(num_keys);
+		std::vector<Quaternion> decoded(num_keys);
+		std::vector<UInt16> times(num_keys);
+		for (UInt32 key_num = 0; key_num < num_keys; ++key_num)
+		{
+			QuantiseRotation(keys[key_num].value, values[key_num].x, values[key_num].y, values[key_num].z);
+			decoded[key_num] = DequantiseRotation(values[key_num].x, values[key_num].y, values[key_num].z);
+			times[key_num] = Quantise(GetKeyTime(keys[key_num].time), 0.0f, 1.0f);
+		}
+
+		std::vector<UInt32> kept_keys;
+
+		bool constant = true;
+		for (UInt32 key_num = 0; key_num < num_keys && constant; ++key_num)
+			constant = RotationError(decoded[0], keys[key_num].value) <= max_error;
+
+		if (constant)
+			kept_keys.push_back(0);
+		else
+		{
+			ReduceKeys(num_keys, [&](const UInt32 first_key, const UInt32 last_key)
+			{
+				for (UInt32 key_num = first_key + 1; key_num < last_key; ++key_num)
+				{
+					Quaternion value;
+					value.FastSlerp(decoded[first_key], decoded[last_key], GetBlendTime(GetKeyTime(keys[key_num].time), times[first_key], times[last_key]));
+					if (RotationError(value, keys[key_num].value) > max_error)
+						return false;
+				}
+				return true;
+			}, kept_keys);
+		}
+
+		for (size_t kept_num = 0; kept_num < kept_keys.size(); ++kept_num)
+		{
+			rotations_.push_back(values[kept_keys[kept_num]]);
+			rotation_times_.push_back(times[kept_keys[kept_num]]);
+		}
+		track.num_keys = static_cast<UInt32>(kept_keys.size());
+	}
+
+	Int32 CompressedAnimation::FindNodeIndex(const StringId name_id) const
+	{
+		Int32 low = 0, high = (Int32)nodes_.size();
+		while (low < high)
+		{
+			const Int32 middle = low + (high - low) / 2;
+			if (nodes_[middle].name_id < name_id)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+		return low < (Int32)nodes_.size() && nodes_[low].name_id == name_id ? low : -1;
+	}
+
+	// before the first key the first key is used, after the last key the last key is used
+	const Vector4 CompressedAnimation::GetVector(const Track& track, const Vector4& min, const Vector4& step, const float time, UInt32& cursor) const
+	{
+		if (track.num_keys == 0)
+			return min;
+
+		const UInt16* times = &vector_times_[track.first_key];
+		const QuantisedVector* values = &vectors_[track.first_key];
+		const float key_time = GetKeyTime(time);
+		const UInt32 next_key = track.num_keys > 1 ? FindNextKey(times, track.num_keys, key_time, cursor) : track.num_keys;
+
+		const QuantisedVector& next_value = values[next_key == track.num_keys ? next_key - 1 : next_key];
+		const Vector4 next(Dequantise(next_value.x, min.x(), step.x()), Dequantise(next_value.y, min.y(), step.y()), Dequantise(next_value.z, min.z(), step.z()), min.w());
+		if (next_key == track.num_keys || next_key == 0)
+			return next;
+
+		const QuantisedVector& prev_value = values[next_key - 1];
+		const Vector4 prev(Dequantise(prev_value.x, min.x(), step.x()), Dequantise(prev_value.y, min.y(), step.y()), Dequantise(prev_value.z, min.z(), step.z()), min.w());
+
+		Vector4 result;
+		result.Lerp(prev, next, GetBlendTime(key_time, times[next_key - 1], times[next_key]));
+		return result;
+	}
+
+	const Vector4 CompressedAnimation::GetTranslation(const Int32 node_index, const float time, TransformAnimCursor& cursor) const
+	{
+		const Node& node = nodes_[node_index];
+		return GetVector(node.translation, node.translation_min, node.translation_step, time, cursor.translation_key);
+	}
+
+	const Vector4 CompressedAnimation::GetScale(const Int32 node_index, const float time, TransformAnimCursor& cursor) const
+	{
+		const Node& node = nodes_[node_index];
+		return GetVector(node.scale, node.scale_min, node.scale_step, time, cursor.scale_key);
+	}
+
+	const Quaternion CompressedAnimation::GetRotation(const Int32 node_index, const float time, TransformAnimCursor& cursor) const
+	{
+		const Track& track = nodes_[node_index].rotation;
+		if (track.num_keys == 0)
+			return Quaternion(0.0f, 0.0f, 0.0f, 1.0f);
+
+		const UInt16* times = &rotation_times_[track.first_key];
+		const QuantisedQuaternion* values = &rotations_[track.first_key];
+		const float key_time = GetKeyTime(time);
+		const UInt32 next_key = track.num_keys > 1 ? FindNextKey(times, track.num_keys, key_time, cursor.rotation_key) : track.num_keys;
+
+		const QuantisedQuaternion& next_value = values[next_key == track.num_keys ? next_key - 1 : next_key];
+		const Quaternion next = DequantiseRotation(next_value.x, next_value.y, next_value.z);
+		if (next_key == track.num_keys || next_key == 0)
+			return next;
+
+		const QuantisedQuaternion& prev_value = values[next_key - 1];
+		Quaternion result;
+		result.FastSlerp(DequantiseRotation(prev_value.x, prev_value.y, prev_value.z), next, GetBlendTime(key_time, times[next_key - 1], times[next_key]));
+		return result;
+	}
+
+	Int32 CompressedAnimation::GetKeyCount() const
+	{
+		return (Int32)(vectors_.size() + rotations_.size());
+	}
+
+	size_t CompressedAnimation::GetMemorySize() const
+	{
+		return sizeof(CompressedAnimation) +
+			nodes_.size()*sizeof(Node) +
+			vector_times_.size()*sizeof(UInt16) +
+			vectors_.size()*sizeof(QuantisedVector) +
+			rotation_times_.size()*sizeof(UInt16) +
+			rotations_.size()*sizeof(QuantisedQuaternion);
+	}
+}
@@ -0,0 +1,121 @@
+#ifndef _GEF_COMPRESSED_ANIMATION_H
+#define _GEF_COMPRESSED_ANIMATION_H
+
+#include <gef.h>
+#include <animation/animation.h>
+#include <maths/vector4.h>
+#include <maths/quaternion.h>
+#include <vector>
+
+namespace gef
+{
+	/// @brief The largest errors CompressedAnimation::Compress may add to each track, measured at the original key times.
+	/// @note The errors are per joint, they add up down a joint hierarchy.
+	struct AnimCompressionSettings
+	{
+		AnimCompressionSettings();
+
+		float rotation_error;		// radians
+		float translation_error;	// scene units
+		float scale_error;
+	};
+
+	/// @brief A read only copy of an Animation's transform nodes with far fewer, smaller keys.
+	/// @note Rotations are stored as the smallest three components of the quaternion in 16 bits each.
+	/// Translations and scales are stored in 16 bits per component across the range of each track.
+	/// Key times are stored in 16 bits, as frame numbers if the clip has a fixed frame rate.
+	/// Keys that can be interpolated from their neighbours to within the settings' errors are removed.
+	/// Channel nodes are not compressed.
+	class CompressedAnimation
+	{
+	public:
+		CompressedAnimation();
+
+		/// @brief Compresses the transform nodes of a clip, replacing anything compressed before.
+		/// @param[in] animation	The clip to compress.
+		/// @param[in] settings		The largest errors compression may add.
+		/// @return true if the clip was compressed, false if its key times are out of order
+		bool Compress(const Animation& animation, const AnimCompressionSettings& settings = AnimCompressionSettings());
+		void Clear();
+
+		/// @return the index of the node with a name, or -1 if the clip doesn't have one
+		Int32 FindNodeIndex(const StringId name_id) const;
+
+		/// @brief Samples a node's translation, like TransformAnimNode::GetTranslation.
+		/// @param[in] node_index	The node to sample.
+		/// @param[in] time			The time to sample the node at.
+		/// @param[in,out] cursor	The key cursor for this node.
+		const Vector4 GetTranslation(const Int32 node_index, const float time, TransformAnimCursor& cursor) const;
+		const Vector4 GetScale(const Int32 node_index, const float time, TransformAnimCursor& cursor) const;
+		const Quaternion GetRotation(const Int32 node_index, const float time, TransformAnimCursor& cursor) const;
+
+		inline Int32 node_count() const { return (Int32)nodes_.size(); }
+		inline StringId node_name_id(const Int32 node_index) const { return nodes_[node_index].name_id; }
+		inline Int32 scale_key_count(const Int32 node_index) const { return (Int32)nodes_[node_index].scale.num_keys; }
+		inline Int32 rotation_key_count(const Int32 node_index) const { return (Int32)nodes_[node_index].rotation.num_keys; }
+		inline Int32 translation_key_count(const Int32 node_index) const { return (Int32)nodes_[node_index].translation.num_keys; }
+
+		/// @return the total number of keys kept in every track
+		Int32 GetKeyCount() const;
+
+		/// @return the number of bytes the compressed clip uses
+		size_t GetMemorySize() const;
+
+		inline float duration() const { return duration_; }
+		inline float start_time() const { return start_time_; }
+		inline float end_time() const { return end_time_; }
+		inline StringId name_id() const { return name_id_; }
+
+	private:
+		struct QuantisedVector
+		{
+			UInt16 x, y, z;
+		};
+
+		// the three smallest components of a unit quaternion, the top bits of x and y hold the index of the largest
+		struct QuantisedQuaternion
+		{
+			UInt16 x, y, z;
+		};
+
+		// a range of keys, indexing both the times and the values of the track's type
+		struct Track
+		{
+			UInt32 first_key;
+			UInt32 num_keys;
+		};
+
+		struct Node
+		{
+			Vector4 scale_min;
+			Vector4 scale_step;
+			Vector4 translation_min;
+			Vector4 translation_step;
+			Track scale;
+			Track rotation;
+			Track translation;
+			StringId name_id;
+		};
+
+		void CompressVectorTrack(const std::vector<Vector3Key>& keys, const float max_error, Track& track, Vector4& min, Vector4& step);
+		void CompressRotationTrack(const std::vector<QuaternionKey>& keys, const float max_error, Track& track);
+		const Vector4 GetVector(const Track& track, const Vector4& min, const Vector4& step, const float time, UInt32& cursor) const;
+		void SetKeyTimeScale(const std::vector<float>& key_times);
+		float GetKeyTime(const float time) const;
+
+		std::vector<Node> nodes_;			// sorted by name id
+		std::vector<UInt16> vector_times_;
+		std::vector<QuantisedVector> vectors_;
+		std::vector<UInt16> rotation_times_;
+		std::vector<QuantisedQuaternion> rotations_;
+
+		float time_min_;		// the time of key time 0
+		float time_scale_;		// key time units per second
+		float duration_;
+		float start_time_;
+		float end_time_;
+		StringId name_id_;
+	};
+}
+
+#endif // _GEF_COMPRESSED_ANIMATION_H
@@ -1,5 +1,7 @@
 #include <animation/skeleton.h>
 #include <animation/animation.h>
+#include <animation/anim_binding.h>
+#include <animation/baked_animation.h>
 
 namespace gef
 {
@@ -45,6 +47,8 @@ namespace gef
 		if(skeleton_)
 		{
 			const std::vector<Joint>& joints = skeleton_->joints();
+			if(global_pose_.size() != joints.size())
+				global_pose_.resize(joints.size());
 			for(UInt32 jointNum=0; jointNum<joints.size(); jointNum++)
 			{
 				const Joint& joint = joints[jointNum];
@@ -59,11 +63,7 @@ namespace gef
 				else
 					global_pose_matrix = local_pose_matrix * global_pose()[joint.parent];
 
-
-				if(global_pose_.size() > jointNum )
-					global_pose_[jointNum] = global_pose_matrix;
-				else
-					global_pose_.push_back(global_pose_matrix);
+				global_pose_[jointNum] = global_pose_matrix;
 			}
 		}
 	}
@@ -73,6 +73,8 @@ namespace gef
 		if(skeleton_)
 		{
 			const std::vector<Joint>& joints = skeleton_->joints();
+			if(global_pose_.size() != joints.size())
+				global_pose_.resize(joints.size());
 			for(UInt32 jointNum=0; jointNum<joints.size(); jointNum++)
 			{
 				const Joint& joint = joints[jointNum];
@@ -185,6 +187,69 @@ namespace gef
 			CalculateGlobalPose();
 	}
 
+	void SkeletonPose::SetPoseFromAnim(const Animation& anim, const SkeletonPose& bind_pose, const float time, AnimBinding& binding, const bool updateGlobalPose)
+	{
+		binding.Update(*skeleton_, anim);
+
+		std::vector<AnimBinding::JointTrack>& joint_tracks = binding.joint_tracks();
+		const std::vector<JointPose>& bind_local_pose = bind_pose.local_pose();
+
+		// baked clips find their frames once for every joint
+		const BakedAnimation* baked = anim.baked();
+		BakedAnimation::FrameBlend frame_blend = { 0, 0.0f };
+		if (baked)
+			frame_blend = baked->GetFrameBlend(time);
+
+		for (Int32 joint_index = 0; joint_index < binding.joint_count(); ++joint_index)
+		{
+			AnimBinding::JointTrack& joint_track = joint_tracks[joint_index];
+			const TransformAnimNode* transform_node = joint_track.node;
+			JointPose& joint_pose = local_pose_[joint_index];
+
+			if(baked && joint_track.baked_track >= 0)
+			{
+				Quaternion rotation = bind_local_pose[joint_index].rotation();
+				Vector4 translation = bind_local_pose[joint_index].translation();
+				baked->SampleTrack(joint_track.baked_track, frame_blend, rotation, translation);
+
+				joint_pose.set_scale(gef::Vector4(1.f, 1.f, 1.f));
+				joint_pose.set_rotation(rotation);
+				joint_pose.set_translation(translation);
+			}
+			else if(transform_node)
+			{
+				// scale is always set to one, as in SetPoseFromAnim without a binding, so the scale keys aren't sampled
+				joint_pose.set_scale(gef::Vector4(1.f, 1.f, 1.f));
+
+				// rotation
+				if(!transform_node->rotation_keys().empty())
+					joint_pose.set_rotation(transform_node->GetRotation(time, joint_track.cursor));
+				else
+					joint_pose.set_rotation(bind_local_pose[joint_index].rotation());
+
+				// translation
+				if(!transform_node->translation_keys().empty())
+					joint_pose.set_translation(transform_node->GetTranslation(time, joint_track.cursor));
+				else
+					joint_pose.set_translation(bind_local_pose[joint_index].translation());
+			}
+			else
+			{
+				joint_pose = bind_local_pose[joint_index];
+			}
+
+#ifdef REMOVE_BIND_POSE
+			gef::Matrix44 inv_local_joint_orient;
+			inv_local_joint_orient.AffineInverse(bind_local_pose[joint_index].GetMatrix());
+			inv_local_joint_orient.SetTranslation(gef::Vector4(0.f, 0.f, 0.f));
+			joint_pose.Set(inv_local_joint_orient * joint_pose.GetMatrix());
+#endif
+		}
+
+		if(updateGlobalPose)
+			CalculateGlobalPose();
+	}
+
 	void SkeletonPose::Linear2PoseBlend(const SkeletonPose& start_pose, const SkeletonPose& end_pose, const float time)
 	{
 		// assume _startPose _endPose and "this" pose all have the same number of joints
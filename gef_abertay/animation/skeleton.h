@@ -47,6 +47,15 @@ namespace gef
 		void CalculateGlobalPose(const gef::Matrix44 * const pose_transform = NULL);
 		void CalculateLocalPose(const std::vector<Matrix44>& global_pose);
 		void SetPoseFromAnim(const class Animation& _anim, const SkeletonPose& _bindPose, const float _time, const bool _updateGlobalPose = true);
+
+		/// @brief Samples a clip through a binding instead of looking up each joint's node in the clip.
+		/// @note If the clip is baked, the joints bound to baked tracks are sampled from the baked frames.
+		/// @param[in] anim				The clip to sample.
+		/// @param[in] bind_pose		The bind pose, used for joints and tracks the clip doesn't animate.
+		/// @param[in] time				The time to sample the clip at.
+		/// @param[in,out] binding		The binding for this pose's skeleton and the clip. It is rebound if it's for a different pair.
+		/// @param[in] updateGlobalPose	Whether to calculate the global pose from the sampled local pose.
+		void SetPoseFromAnim(const class Animation& anim, const SkeletonPose& bind_pose, const float time, class AnimBinding& binding, const bool updateGlobalPose = true);
 	//	void SetLocalJointPoseFromAnim(JointPose& _jointPose, const UInt32 _jointNum, const JointPose& _jointBindPose, const class Anim& _anim, const float _time);
 		void Linear2PoseBlend(const SkeletonPose& _startPose, const SkeletonPose& _endPose, const float _time);
 
@@ -0,0 +1,289 @@
+#include <animation/skeleton_pose_soa.h>
+#include <animation/skeleton.h>
+#include <animation/animation.h>
+#include <animation/anim_binding.h>
+#include <maths/transform_batch.h>
+
+namespace gef
+{
+	SkeletonPoseSoA::SkeletonPoseSoA() :
+		in_order_(true),
+		skeleton_(NULL)
+	{
+	}
+
+	void SkeletonPoseSoA::Create(const SkeletonPose& pose)
+	{
+		CleanUp();
+
+		skeleton_ = pose.skeleton();
+		const Int32 joint_count = skeleton_ ? skeleton_->joint_count() : 0;
+		rotations_.resize(joint_count);
+		translations_.resize(joint_count);
+		scales_.resize(joint_count);
+		global_pose_.resize(joint_count);
+		parents_.resize(joint_count);
+		inv_bind_poses_.resize(joint_count);
+		for (Int32 joint_num = 0; joint_num < joint_count; ++joint_num)
+		{
+			parents_[joint_num] = skeleton_->joint(joint_num).parent;
+			inv_bind_poses_[joint_num] = skeleton_->joint(joint_num).inv_bind_pose;
+			in_order_ = in_order_ && parents_[joint_num] < joint_num;
+		}
+
+		// the depth of every joint, updating the joints in order of depth puts every parent before its children
+		if (!in_order_)
+		{
+			std::vector<Int32> depths(joint_count, -1);
+			Int32 max_depth = 0;
+			for (Int32 joint_num = 0; joint_num < joint_count; ++joint_num)
+			{
+				Int32 depth = 0;
+				for (Int32 parent = parents_[joint_num]; parent != -1 && depth <= joint_count; parent = parents_[parent])
+					++depth;
+				depths[joint_num] = depth;
+				max_depth = depth > max_depth ? depth : max_depth;
+			}
+
+			update_order_.reserve(joint_count);
+			for (Int32 depth = 0; depth <= max_depth; ++depth)
+			{
+				for (Int32 joint_num = 0; joint_num < joint_count; ++joint_num)
+				{
+					if (depths[joint_num] == depth)
+						update_order_.push_back(joint_num);
+				}
+			}
+		}
+
+		SetLocalPose(pose);
+		CalculateGlobalPose();
+	}
+
+	void SkeletonPoseSoA::CleanUp()
+	{
+		rotations_.clear();
+		translations_.clear();
+		scales_.clear();
+		global_pose_.clear();
+		update_order_.clear();
+		parents_.clear();
+		inv_bind_poses_.clear();
+		in_order_ = true;
+		skeleton_ = NULL;
+	}
+
+	void SkeletonPoseSoA::SetLocalPose(const SkeletonPose& pose)
+	{
+		for (Int32 joint_num = 0; joint_num < joint_count(); ++joint_num)
+		{
+			const JointPose& joint_pose = pose.local_pose()[joint_num];
+			rotations_[joint_num] = joint_pose.rotation();
+			translations_[joint_num] = joint_pose.translation();
+			scales_[joint_num] = joint_pose.scale();
+		}
+	}
+
+	void SkeletonPoseSoA::SetPoseFromAnim(const Animation& anim, const SkeletonPoseSoA& bind_pose, const float time, AnimBinding& binding, const bool update_global_pose)
+	{
+		binding.Update(*skeleton_, anim);
+
+		std::vector<AnimBinding::JointTrack>& joint_tracks = binding.joint_tracks();
+		const BakedAnimation* baked = anim.baked();
+		BakedAnimation::FrameBlend frame_blend = { 0, 0.0f };
+		if (baked)
+			frame_blend = baked->GetFrameBlend(time);
+
+		for (Int32 joint_num = 0; joint_num < binding.joint_count(); ++joint_num)
+			SampleJoint(joint_num, joint_tracks[joint_num], bind_pose, time, baked, frame_blend);
+
+		if (update_global_pose)
+			CalculateGlobalPose();
+	}
+
+	void SkeletonPoseSoA::SetPoseFromAnim(const Animation& anim, const SkeletonPoseSoA& bind_pose, const float time, AnimBinding& binding, const std::vector<Int32>& joints, const bool update_global_pose)
+	{
+		binding.Update(*skeleton_, anim);
+
+		std::vector<AnimBinding::JointTrack>& joint_tracks = binding.joint_tracks();
+		const BakedAnimation* baked = anim.baked();
+		BakedAnimation::FrameBlend frame_blend = { 0, 0.0f };
+		if (baked)
+			frame_blend = baked->GetFrameBlend(time);
+
+		for (size_t index = 0; index < joints.size(); ++index)
+			SampleJoint(joints[index], joint_tracks[joints[index]], bind_pose, time, baked, frame_blend);
+
+		if (update_global_pose)
+			CalculateGlobalPose();
+	}
+
+	void SkeletonPoseSoA::SampleJoint(const Int32 joint_num, AnimBinding::JointTrack& joint_track, const SkeletonPoseSoA& bind_pose, const float time, const BakedAnimation* baked, const BakedAnimation::FrameBlend& frame_blend)
+	{
+		const TransformAnimNode* transform_node = joint_track.node;
+
+		if (baked && joint_track.baked_track >= 0)
+		{
+			scales_[joint_num] = Vector4(1.f, 1.f, 1.f);
+
+			const UInt32 flags = baked->track_flags(joint_track.baked_track);
+			if (!(flags & BakedAnimation::kRotation))
+				rotations_[joint_num] = bind_pose.rotations_[joint_num];
+			if (!(flags & BakedAnimation::kTranslation))
+				translations_[joint_num] = bind_pose.translations_[joint_num];
+
+			baked->SampleTrack(joint_track.baked_track, frame_blend, rotations_[joint_num], translations_[joint_num]);
+		}
+		else if (transform_node)
+		{
+			// scale is always one, as in SkeletonPose::SetPoseFromAnim
+			scales_[joint_num] = Vector4(1.f, 1.f, 1.f);
+
+			if (!transform_node->rotation_keys().empty())
+				rotations_[joint_num] = transform_node->GetRotation(time, joint_track.cursor);
+			else
+				rotations_[joint_num] = bind_pose.rotations_[joint_num];
+
+			if (!transform_node->translation_keys().empty())
+				translations_[joint_num] = transform_node->GetTranslation(time, joint_track.cursor);
+			else
+				translations_[joint_num] = bind_pose.translations_[joint_num];
+		}
+		else
+		{
+			rotations_[joint_num] = bind_pose.rotations_[joint_num];
+			translations_[joint_num] = bind_pose.translations_[joint_num];
+			scales_[joint_num] = bind_pose.scales_[joint_num];
+		}
+	}
+
+	void SkeletonPoseSoA::Linear2PoseBlend(const SkeletonPoseSoA& start_pose, const SkeletonPoseSoA& end_pose, const float time, const bool update_global_pose, const QuaternionBlend blend)
+	{
+		const Int32 num_joints = joint_count();
+		if (num_joints == 0)
+			return;
+
+		// the same blends as Transform::Linear2TransformBlend, the rotations in one batch
+		BlendQuaternionsBatch(&start_pose.rotations_[0], &end_pose.rotations_[0], time, &rotations_[0], num_joints, blend);
+		for (Int32 joint_num = 0; joint_num < num_joints; ++joint_num)
+		{
+			translations_[joint_num].Lerp(start_pose.translations_[joint_num], end_pose.translations_[joint_num], time);
+			scales_[joint_num].Lerp(start_pose.scales_[joint_num], end_pose.scales_[joint_num], time);
+		}
+
+		if (update_global_pose)
+			CalculateGlobalPose();
+	}
+
+	void SkeletonPoseSoA::Linear2PoseBlend(const SkeletonPoseSoA& start_pose, const SkeletonPoseSoA& end_pose, const float time, const std::vector<Int32>& joints, const bool update_global_pose, const QuaternionBlend blend)
+	{
+		// one joint at a time, BlendQuaternion gives the same results as the batch
+		for (size_t index = 0; index < joints.size(); ++index)
+		{
+			const Int32 joint_num = joints[index];
+			BlendQuaternion(start_pose.rotations_[joint_num], end_pose.rotations_[joint_num], time, rotations_[joint_num], blend);
+			translations_[joint_num].Lerp(start_pose.translations_[joint_num], end_pose.translations_[joint_num], time);
+			scales_[joint_num].Lerp(start_pose.scales_[joint_num], end_pose.scales_[joint_num], time);
+		}
+
+		if (update_global_pose)
+			CalculateGlobalPose();
+	}
+
+	void SkeletonPoseSoA::ClearLocalPose()
+	{
+		const Vector4 zero(0.f, 0.f, 0.f, 0.f);
+		for (Int32 joint_num = 0; joint_num < joint_count(); ++joint_num)
+		{
+			rotations_[joint_num] = Quaternion(0.f, 0.f, 0.f, 0.f);
+			translations_[joint_num] = zero;
+			scales_[joint_num] = zero;
+		}
+	}
+
+	void SkeletonPoseSoA::AddWeightedPose(const SkeletonPoseSoA& pose, const float weight)
+	{
+		const Int32 num_joints = joint_count();
+		if (num_joints == 0)
+			return;
+
+		AddWeightedQuaternionsBatch(&pose.rotations_[0], weight, &rotations_[0], num_joints);
+		for (Int32 joint_num = 0; joint_num < num_joints; ++joint_num)
+		{
+			translations_[joint_num] += pose.translations_[joint_num] * weight;
+			scales_[joint_num] += pose.scales_[joint_num] * weight;
+		}
+	}
+
+	void SkeletonPoseSoA::NormaliseRotations()
+	{
+		if (joint_count() > 0)
+			NormaliseQuaternionsBatch(&rotations_[0], joint_count());
+	}
+
+	void SkeletonPoseSoA::AddAdditivePose(const SkeletonPoseSoA& additive, const SkeletonPoseSoA& reference, const float weight, const bool update_global_pose)
+	{
+		const Int32 num_joints = joint_count();
+		if (num_joints == 0)
+			return;
+
+		AddAdditiveQuaternionsBatch(&rotations_[0], &additive.rotations_[0], &reference.rotations_[0], weight, &rotations_[0], num_joints);
+		for (Int32 joint_num = 0; joint_num < num_joints; ++joint_num)
+		{
+			translations_[joint_num] += (additive.translations_[joint_num] - reference.translations_[joint_num]) * weight;
+			scales_[joint_num] += (additive.scales_[joint_num] - reference.scales_[joint_num]) * weight;
+		}
+
+		if (update_global_pose)
+			CalculateGlobalPose();
+	}
+
+	void SkeletonPoseSoA::MaskedPoseBlend(const SkeletonPoseSoA& layer, const float* joint_weights, const bool update_global_pose, const QuaternionBlend blend)
+	{
+		const Int32 num_joints = joint_count();
+		if (num_joints == 0)
+			return;
+
+		BlendQuaternionsBatch(&rotations_[0], &layer.rotations_[0], joint_weights, &rotations_[0], num_joints, blend);
+		for (Int32 joint_num = 0; joint_num < num_joints; ++joint_num)
+		{
+			translations_[joint_num].Lerp(translations_[joint_num], layer.translations_[joint_num], joint_weights[joint_num]);
+			scales_[joint_num].Lerp(scales_[joint_num], layer.scales_[joint_num], joint_weights[joint_num]);
+		}
+
+		if (update_global_pose)
+			CalculateGlobalPose();
+	}
+
+	void SkeletonPoseSoA::CalculateGlobalPose(const Matrix44* const pose_transform)
+	{
+		const Int32 num_joints = joint_count();
+		if (num_joints == 0)
+			return;
+
+		// the local matrices are built in place, then each is multiplied by its parent's global matrix
+		TransformMatricesBatch(&rotations_[0], &translations_[0], &scales_[0], &global_pose_[0], num_joints);
+
+		for (Int32 order_num = 0; order_num < num_joints; ++order_num)
+		{
+			const Int32 joint_num = in_order_ ? order_num : update_order_[order_num];
+			const Int32 parent = parents_[joint_num];
+			if (parent != -1)
+				global_pose_[joint_num] = global_pose_[joint_num] * global_pose_[parent];
+			else if (pose_transform)
+				global_pose_[joint_num] = global_pose_[joint_num] * (*pose_transform);
+		}
+	}
+
+	void SkeletonPoseSoA::CalculateSkinningMatrices(Matrix44* matrices) const
+	{
+		if (joint_count() > 0)
+			MultiplyMatricesBatch(&inv_bind_poses_[0], &global_pose_[0], matrices, joint_count());
+	}
+
+	void SkeletonPoseSoA::CalculateSkinningPalette(Matrix44* palette) const
+	{
+		if (joint_count() > 0)
+			MultiplyTransposeMatricesBatch(&inv_bind_poses_[0], &global_pose_[0], palette, joint_count());
+	}
+}
@@ -0,0 +1,131 @@
+#ifndef _GEF_SKELETON_POSE_SOA_H
+#define _GEF_SKELETON_POSE_SOA_H
+
+#include <gef.h>
+#include <maths/matrix44.h>
+#include <maths/quaternion.h>
+#include <maths/vector4.h>
+#include <animation/anim_binding.h>
+#include <animation/baked_animation.h>
+#include <vector>
+
+namespace gef
+{
+	class Skeleton;
+	class SkeletonPose;
+	class Animation;
+
+	/// @brief A skeleton pose with the rotations, translations and scales of the joints in separate arrays.
+	/// @note Every array, including the global pose, is allocated by Create, so updating the pose never allocates.
+	/// The global pose is calculated by building every local matrix in one batch, then multiplying each
+	/// joint by its parent with parents always before their children. The global pose has the same
+	/// values as SkeletonPose::CalculateGlobalPose.
+	class SkeletonPoseSoA
+	{
+	public:
+		SkeletonPoseSoA();
+
+		/// @brief Allocates the pose for a skeleton and copies its local pose.
+		/// @param[in] pose		The pose to copy, e.g. the skeleton's bind pose.
+		void Create(const SkeletonPose& pose);
+		void CleanUp();
+
+		/// @brief Copies the local pose of a pose for the same skeleton.
+		void SetLocalPose(const SkeletonPose& pose);
+
+		/// @brief Samples a clip through a binding, like SkeletonPose::SetPoseFromAnim.
+		/// @note If the clip is baked, the joints bound to baked tracks are sampled from the baked frames.
+		/// @param[in] anim				The clip to sample.
+		/// @param[in] bind_pose		The bind pose, used for joints and tracks the clip doesn't animate.
+		/// @param[in] time				The time to sample the clip at.
+		/// @param[in,out] binding		The binding for the skeleton and the clip. It is rebound if it's for a different pair.
+		/// @param[in] update_global_pose	Whether to calculate the global pose from the sampled local pose.
+		void SetPoseFromAnim(const Animation& anim, const SkeletonPoseSoA& bind_pose, const float time, AnimBinding& binding, const bool update_global_pose = true);
+
+		/// @brief Samples a clip for some of the joints only, e.g. to skip the finger joints of a distant character.
+		/// @param[in] joints	The joints to sample. The other joints keep their local pose.
+		/// @note The other parameters are the same as the version that samples every joint.
+		void SetPoseFromAnim(const Animation& anim, const SkeletonPoseSoA& bind_pose, const float time, AnimBinding& binding, const std::vector<Int32>& joints, const bool update_global_pose = true);
+
+		/// @brief Blends the local poses of two poses for the same skeleton, like SkeletonPose::Linear2PoseBlend.
+		/// @param[in] start_pose	The pose at time 0. This can be this pose.
+		/// @param[in] end_pose		The pose at time 1. This can be this pose.
+		/// @param[in] time			The blend amount.
+		/// @param[in] update_global_pose	Whether to calculate the global pose from the blended local pose.
+		/// @param[in] blend		How accurately to blend the rotations, see QuaternionBlend.
+		void Linear2PoseBlend(const SkeletonPoseSoA& start_pose, const SkeletonPoseSoA& end_pose, const float time, const bool update_global_pose = true, const QuaternionBlend blend = QB_SLERP);
+
+		/// @brief Blends some of the joints only, e.g. the joints sampled with the masked SetPoseFromAnim.
+		/// @param[in] joints	The joints to blend. The other joints keep their local pose.
+		/// @note The other parameters are the same as the version that blends every joint, and so are the results of the blended joints.
+		void Linear2PoseBlend(const SkeletonPoseSoA& start_pose, const SkeletonPoseSoA& end_pose, const float time, const std::vector<Int32>& joints, const bool update_global_pose = true, const QuaternionBlend blend = QB_SLERP);
+
+		/// @brief Zeroes the local pose, ready to sum weighted poses with AddWeightedPose.
+		void ClearLocalPose();
+
+		/// @brief Adds the local pose of a pose for the same skeleton, scaled by a weight, to this pose's local pose.
+		/// @note Each rotation is negated if it is more than 90 degrees from its sum, so the poses blend along the shortest path.
+		/// Once every pose is added call NormaliseRotations. For a blend, the weights should add up to one.
+		void AddWeightedPose(const SkeletonPoseSoA& pose, const float weight);
+
+		/// @brief Normalises the rotations of the local pose, e.g. after summing weighted poses.
+		void NormaliseRotations();
+
+		/// @brief Applies the difference between two poses for the same skeleton to the local pose, e.g. an additive layer.
+		/// @param[in] additive		The pose the difference is measured to.
+		/// @param[in] reference	The pose the difference is measured from, e.g. the first frame of the additive clip.
+		/// @param[in] weight		How much of the difference to apply, from 0 to 1.
+		/// @param[in] update_global_pose	Whether to calculate the global pose from the new local pose.
+		/// @note Rotations are applied with AddAdditiveQuaternionsBatch, translations and scales add the weighted difference.
+		void AddAdditivePose(const SkeletonPoseSoA& additive, const SkeletonPoseSoA& reference, const float weight, const bool update_global_pose = true);
+
+		/// @brief Blends the local pose towards a pose for the same skeleton by a different amount for each joint, e.g. an upper body layer.
+		/// @param[in] layer			The pose at a joint weight of 1. This can't be this pose.
+		/// @param[in] joint_weights	Array of joint_count blend amounts.
+		/// @param[in] update_global_pose	Whether to calculate the global pose from the blended local pose.
+		/// @param[in] blend			How accurately to blend the rotations, see QuaternionBlend.
+		void MaskedPoseBlend(const SkeletonPoseSoA& layer, const float* joint_weights, const bool update_global_pose = true, const QuaternionBlend blend = QB_SLERP);
+
+		/// @brief Calculates the global pose from the local pose.
+		/// @param[in] pose_transform	An optional transform applied to the root joints.
+		void CalculateGlobalPose(const Matrix44* const pose_transform = NULL);
+
+		/// @brief Calculates the matrices that skin a mesh to the global pose, each joint's inverse bind pose times its global pose.
+		/// @param[out] matrices	Array of joint_count matrices that receives the skinning matrices.
+		void CalculateSkinningMatrices(Matrix44* matrices) const;
+
+		/// @brief Calculates the skinning matrices already transposed for the skinning shader, in one pass.
+		/// @param[out] palette		Array of joint_count matrices that receives the transposed skinning matrices.
+		/// @note Draw with the palette overload of Renderer3D::DrawSkinnedMesh, which uploads it without another copy.
+		void CalculateSkinningPalette(Matrix44* palette) const;
+
+		inline Int32 joint_count() const { return (Int32)rotations_.size(); }
+		inline const Skeleton* skeleton() const { return skeleton_; }
+
+		inline const std::vector<Quaternion>& rotations() const { return rotations_; }
+		inline std::vector<Quaternion>& rotations() { return rotations_; }
+		inline const std::vector<Vector4>& translations() const { return translations_; }
+		inline std::vector<Vector4>& translations() { return translations_; }
+		inline const std::vector<Vector4>& scales() const { return scales_; }
+		inline std::vector<Vector4>& scales() { return scales_; }
+		inline const std::vector<Matrix44>& global_pose() const { return global_pose_; }
+
+		/// @return the joints in the order the global pose is calculated, every parent before its children
+		inline const std::vector<Int32>& update_order() const { return update_order_; }
+
+	private:
+		void SampleJoint(const Int32 joint_num, AnimBinding::JointTrack& joint_track, const SkeletonPoseSoA& bind_pose, const float time, const BakedAnimation* baked, const BakedAnimation::FrameBlend& frame_blend);
+
+		std::vector<Quaternion> rotations_;
+		std::vector<Vector4> translations_;
+		std::vector<Vector4> scales_;
+		std::vector<Matrix44> global_pose_;
+		std::vector<Int32> update_order_;
+		std::vector<Int32> parents_;		// the parent of each joint, copied from the skeleton so the update only reads flat arrays
+		std::vector<Matrix44> inv_bind_poses_;	// the inverse bind pose of each joint, copied from the skeleton for the same reason
+		bool in_order_;						// every joint's parent comes before it in the skeleton, so update_order_ isn't needed
+		const Skeleton* skeleton_;
+	};
+}
+
+#endif // _GEF_SKELETON_POSE_SOA_H
@@ -0,0 +1,201 @@
+#include <assets/asset_loader.h>
+#include <assets/png_loader.h>
+#include <assets/obj_loader.h>
+#include <graphics/scene.h>
+#include <graphics/texture.h>
+#include <graphics/font.h>
+#include <graphics/image_data.h>
+#include <graphics/model.h>
+#include <graphics/mesh_optimiser.h>
+#include <system/platform.h>
+#include <map>
+#include <string>
+
+namespace gef
+{
+	// everything one load reads on the loading thread, and the asset it is read into
+	struct AssetLoad
+	{
+		enum Type
+		{
+			kScene = 0,
+			kTexture,
+			kFont,
+			kModel
+		};
+
+		AssetLoad(Platform& load_platform, const Type load_type, const char* load_filename) :
+			platform(load_platform),
+			type(load_type),
+			filename(load_filename),
+			callback(NULL),
+			user_data(NULL),
+			scene(NULL),
+			create_materials(false),
+			texture(NULL),
+			font(NULL),
+			model(NULL),
+			optimise_model(false)
+		{
+		}
+
+		Platform& platform;
+		Type type;
+		std::string filename;
+		AssetLoadCallback callback;
+		void* user_data;
+
+		Scene* scene;
+		bool create_materials;
+		std::map<gef::StringId, ImageData> scene_images;	// the materials' textures
+
+		Texture** texture;
+		ImageData image;	// the texture's or the font's image
+
+		Font* font;
+
+		Model* model;
+		bool optimise_model;
+		MeshOptimiserSettings optimiser_settings;	// copied, as the caller's may be gone by the time the model is read
+		OBJModelData model_data;
+	};
+
+	// run on the loading thread, everything here has to leave the platform alone
+	static bool ReadAsset(LoadQueue& queue, const Int32 request, void* data)
+	{
+		AssetLoad* load = static_cast<AssetLoad*>(data);
+		bool success = false;
+
+		switch (load->type)
+		{
+		case AssetLoad::kScene:
+			success = load->scene->ReadSceneFromFile(load->platform, load->filename.c_str());
+			if (success && load->create_materials)
+			{
+				// the textures usually take longer than the scene itself
+				queue.SetProgress(request, 0.25f);
+				if (queue.IsCancelled(request))
+					return false;
+
+				load->scene->ReadMaterialImages(load->platform, load->scene_images);
+			}
+			break;
+
+		case AssetLoad::kTexture:
+			{
+				PNGLoader png_loader;
+				png_loader.Load(load->filename.c_str(), load->platform, load->image);
+				success = load->image.image() != NULL;
+			}
+			break;
+
+		case AssetLoad::kFont:
+			success = load->font->ReadFont(load->filename.c_str(), load->image);
+			break;
+
+		case AssetLoad::kModel:
+			{
+				OBJLoader obj_loader;
+				success = obj_loader.ReadModel(load->filename.c_str(), load->platform, load->model_data, load->optimise_model ? &load->optimiser_settings : NULL);
+			}
+			break;
+		}
+
+		return success;
+	}
+
+	// run by Update on the main thread, creates the asset's resources on the platform
+	static void FinishAsset(const Int32 request, const LoadQueue::Status status, void* data)
+	{
+		AssetLoad* load = static_cast<AssetLoad*>(data);
+		LoadQueue::Status finished_status = status;
+
+		if (status == LoadQueue::kRead)
+		{
+			switch (load->type)
+			{
+			case AssetLoad::kScene:
+				if (load->create_materials)
+					load->scene->CreateMaterials(load->platform, load->scene_images);
+				break;
+
+			case AssetLoad::kTexture:
+				*load->texture = Texture::Create(load->platform, load->image);
+				if (*load->texture == NULL)
+					finished_status = LoadQueue::kFailed;
+				break;
+
+			case AssetLoad::kFont:
+				load->font->CreateTexture(load->image);
+				break;
+
+			case AssetLoad::kModel:
+				{
+					OBJLoader obj_loader;
+					if (!obj_loader.CreateModel(load->platform, load->model_data, *load->model))
+						finished_status = LoadQueue::kFailed;
+				}
+				break;
+			}
+		}
+
+		if (load->callback)
+			load->callback(request, finished_status, load->user_data);
+
+		delete load;
+	}
+
+	AssetLoader::AssetLoader(Platform& platform, const Int32 num_worker_threads) :
+		platform_(platform),
+		queue_(num_worker_threads)
+	{
+	}
+
+	AssetLoader::~AssetLoader()
+	{
+		// the queue finishes every load it has left as cancelled, which frees them
+		queue_.CancelAll();
+	}
+
+	Int32 AssetLoader::LoadScene(const char* filename, Scene& scene, const bool create_materials, AssetLoadCallback callback, void* user_data)
+	{
+		AssetLoad* load = new AssetLoad(platform_, AssetLoad::kScene, filename);
+		load->scene = &scene;
+		load->create_materials = create_materials;
+		return Add(load, callback, user_data);
+	}
+
+	Int32 AssetLoader::LoadTexture(const char* filename, Texture*& texture, AssetLoadCallback callback, void* user_data)
+	{
+		AssetLoad* load = new AssetLoad(platform_, AssetLoad::kTexture, filename);
+		load->texture = &texture;
+		texture = NULL;
+		return Add(load, callback, user_data);
+	}
+
+	Int32 AssetLoader::LoadFont(const char* font_name, Font& font, AssetLoadCallback callback, void* user_data)
+	{
+		AssetLoad* load = new AssetLoad(platform_, AssetLoad::kFont, font_name);
+		load->font = &font;
+		return Add(load, callback, user_data);
+	}
+
+	Int32 AssetLoader::LoadModel(const char* filename, Model& model, AssetLoadCallback callback, void* user_data, const MeshOptimiserSettings* optimiser_settings)
+	{
+		AssetLoad* load = new AssetLoad(platform_, AssetLoad::kModel, filename);
+		load->model = &model;
+		if (optimiser_settings)
+		{
+			load->optimise_model = true;
+			load->optimiser_settings = *optimiser_settings;
+		}
+		return Add(load, callback, user_data);
+	}
+
+	Int32 AssetLoader::Add(AssetLoad* load, AssetLoadCallback callback, void* user_data)
+	{
+		load->callback = callback;
+		load->user_data = user_data;
+		return queue_.Add(ReadAsset, FinishAsset, load);
+	}
+}
@@ -0,0 +1,87 @@
+#ifndef _GEF_ASSET_LOADER_H
+#define _GEF_ASSET_LOADER_H
+
+#include <gef.h>
+#include <system/load_queue.h>
+#include <cstddef>
+
+namespace gef
+{
+	class Platform;
+	class Scene;
+	class Texture;
+	class Font;
+	class Model;
+	struct MeshOptimiserSettings;
+	struct AssetLoad;
+
+	/// @brief Function called when a load has finished.
+	/// @param[in] request		The id returned when the load was started.
+	/// @param[in] status		kRead if the asset was loaded and its resources created, otherwise kFailed or kCancelled.
+	/// @param[in] user_data	The user data passed when the load was started.
+	typedef void (*AssetLoadCallback)(const Int32 request, const LoadQueue::Status status, void* user_data);
+
+	/**
+	Loads scenes, textures, fonts and OBJ models without blocking the main thread.
+	The files are read and decoded on a loading thread, see LoadQueue. Update, called on the main thread,
+	then creates the textures, meshes and materials on the platform and calls each load's callback.
+	The asset being loaded into must not be used until its callback has been called.
+	If a load fails or is cancelled the asset may have been partly read into.
+	*/
+	class AssetLoader
+	{
+	public:
+		/// @param[in] platform				The platform to create resources on.
+		/// @param[in] num_worker_threads	The number of loading threads.
+		AssetLoader(Platform& platform, const Int32 num_worker_threads = 1);
+
+		/// @brief Cancels every load. The callbacks of loads not yet finished are called with kCancelled.
+		~AssetLoader();
+
+		/// @brief Loads a scene like Scene::ReadSceneFromFile, then Scene::CreateMaterials.
+		/// @param[in] create_materials		Whether to decode the materials' textures and create them too.
+		/// @note The meshes are left for the callback to create with Scene::CreateMesh, which does no file reading.
+		/// @return the id of the load
+		Int32 LoadScene(const char* filename, Scene& scene, const bool create_materials = true, AssetLoadCallback callback = NULL, void* user_data = NULL);
+
+		/// @brief Loads a PNG texture like PNGLoader::Load, then Texture::Create.
+		/// @param[out] texture		Receives the texture, which the caller owns.
+		Int32 LoadTexture(const char* filename, Texture*& texture, AssetLoadCallback callback = NULL, void* user_data = NULL);
+
+		/// @brief Loads a font like Font::Load.
+		Int32 LoadFont(const char* font_name, Font& font, AssetLoadCallback callback = NULL, void* user_data = NULL);
+
+		/// @brief Loads an OBJ model like OBJLoader::Load.
+		/// @param[in] optimiser_settings	Optional, see OBJLoader::ReadModel. They're copied, so needn't outlive the call.
+		Int32 LoadModel(const char* filename, Model& model, AssetLoadCallback callback = NULL, void* user_data = NULL, const MeshOptimiserSettings* optimiser_settings = NULL);
+
+		/// @brief Creates the resources of loads that have been read and calls their callbacks, see LoadQueue::Update.
+		/// @param[in] max_finished		The most loads to finish, to spread creating resources over several frames.
+		/// @return the number of loads finished
+		inline Int32 Update(const Int32 max_finished = -1) { return queue_.Update(max_finished); }
+
+		/// @brief Waits for every load and finishes them all.
+		inline void Flush() { queue_.Flush(); }
+
+		/// @brief Cancels a load, see LoadQueue::Cancel.
+		inline bool Cancel(const Int32 request) { return queue_.Cancel(request); }
+		inline void CancelAll() { queue_.CancelAll(); }
+
+		/// @return how much of a load has been read, from 0 to 1
+		inline float GetProgress(const Int32 request) const { return queue_.GetProgress(request); }
+
+		/// @return how much of every load started since the loader was last idle has been read, from 0 to 1
+		inline float GetProgress() const { return queue_.GetProgress(); }
+
+		/// @return the number of loads that have not been finished
+		inline Int32 pending_count() const { return queue_.pending_count(); }
+
+	private:
+		Int32 Add(AssetLoad* load, AssetLoadCallback callback, void* user_data);
+
+		Platform& platform_;
+		LoadQueue queue_;
+	};
+}
+
+#endif // _GEF_ASSET_LOADER_H
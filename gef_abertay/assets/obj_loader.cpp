@@ -12,6 +12,7 @@
 #include <system/file.h>
 #include <system/memory_stream_buffer.h>
 #include <graphics/material.h>
+#include <graphics/mesh_optimiser.h>
 
 #include <cstdio>
 #include <cstring>
@@ -21,17 +22,23 @@ namespace gef
 {
 
 
-bool OBJLoader::Load(const char* filename, Platform& platform, Model& model)
+bool OBJLoader::Load(const char* filename, Platform& platform, Model& model, const MeshOptimiserSettings* optimiser_settings)
+{
+	OBJModelData model_data;
+	bool success = ReadModel(filename, platform, model_data, optimiser_settings);
+	if(success)
+		success = CreateModel(platform, model_data, model);
+	return success;
+}
+
+bool OBJLoader::ReadModel(const char* filename, const Platform& platform, OBJModelData& model_data, const MeshOptimiserSettings* optimiser_settings)
 {
 	bool success = true;
 
-	std::vector<Texture*> textures;
 	std::vector<gef::Vector4> positions;
 	std::vector<gef::Vector4> normals;
 	std::vector<gef::Vector2> uvs;
 	std::vector<Int32> face_indices;
-	std::vector<Int32> primitive_indices;
-	std::vector<Int32> texture_indices;
 
 	std::map<std::string, Int32> materials;
 
@@ -56,15 +63,16 @@ bool OBJLoader::Load(const char* filename, Platform& platform, Model& model)
 					success = bytes_read == file_size;
 			}
 		}
+		file->Close();
 	}
 
+	delete file;
+	file = NULL;
+
 	if(!success)
 	{
 		free(obj_file_data);
 		obj_file_data = NULL;
-
-		delete file;
-		file = NULL;
 		return false;
 	}
 	gef::MemoryStreamBuffer buffer((char*)obj_file_data, file_size);
@@ -80,7 +88,7 @@ bool OBJLoader::Load(const char* filename, Platform& platform, Model& model)
 				char material_filename[256];
 				stream >> material_filename;
 
-				LoadMaterials(platform, material_filename, materials, textures);
+				LoadMaterials(platform, material_filename, materials, model_data.texture_images);
 			}
 
 			// vertices
@@ -120,9 +128,9 @@ bool OBJLoader::Load(const char* filename, Platform& platform, Model& model)
 
 				// any time the material is changed
 				// a new primitive is created
-				primitive_indices.push_back((Int32)face_indices.size());
+				model_data.primitive_starts.push_back((Int32)face_indices.size() / 3);
 
-				texture_indices.push_back(materials[material_name]);
+				model_data.primitive_textures.push_back(materials[material_name]);
 			}
 			else if ( strcmp( line, "f" ) == 0 )
 			{
@@ -160,20 +168,15 @@ bool OBJLoader::Load(const char* filename, Platform& platform, Model& model)
 		obj_file_data = NULL;
 
 		// finished reading the file
-//		fclose(file);
-		// start building the mesh
+		// build the vertices, one for each corner of each face
 		Int32 num_faces = (Int32)face_indices.size() / 9;
 		Int32 num_vertices = num_faces*3;
 
-		// create vertex buffer
-		gef::Mesh::Vertex* vertices = new gef::Mesh::Vertex[num_vertices];
-
-		// need to record min and max position values for mesh bounds
-		gef::Vector4 pos_min(FLT_MAX, FLT_MAX, FLT_MAX), pos_max(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+		model_data.vertices.resize(num_vertices);
 
 		for(Int32 vertex_num = 0; vertex_num < num_vertices; ++vertex_num)
 		{
-			gef::Mesh::Vertex* vertex = &vertices[vertex_num];
+			gef::Mesh::Vertex* vertex = &model_data.vertices[vertex_num];
 			gef::Vector4 position = positions[face_indices[vertex_num*3]-1];
 			gef::Vector2 uv = uvs[face_indices[vertex_num*3+1]-1];
 			gef::Vector4 normal = normals[face_indices[vertex_num*3+2]-1];
@@ -186,90 +189,107 @@ bool OBJLoader::Load(const char* filename, Platform& platform, Model& model)
 			vertex->nz = normal.z();
 			vertex->u = uv.x;
 			vertex->v = -uv.y;
-
-			// update min and max positions for bounds
-			if (position.x() < pos_min.x())
-				pos_min.set_x(position.x());
-			if (position.y() < pos_min.y())
-				pos_min.set_y(position.y());
-			if (position.z() < pos_min.z())
-				pos_min.set_z(position.z());
-			if (position.x() > pos_max.x())
-				pos_max.set_x(position.x());
-			if (position.y() > pos_max.y())
-				pos_max.set_y(position.y());
-			if (position.z() > pos_max.z())
-				pos_max.set_z(position.z());
 		}
 
+		// without optimiser settings each corner is drawn as it was read, otherwise corners that faces share
+		// become one vertex, then each primitive is ordered for the vertex cache
+		std::vector<UInt32> corner_indices;
+		if(optimiser_settings && num_vertices > 0)
+		{
+			num_vertices = WeldVertices(&model_data.vertices[0], num_vertices, sizeof(gef::Mesh::Vertex), corner_indices);
+			model_data.vertices.resize(num_vertices);
+		}
+		else
+		{
+			corner_indices.resize(num_vertices);
+			for(Int32 vertex_num = 0; vertex_num < num_vertices; ++vertex_num)
+				corner_indices[vertex_num] = vertex_num;
+		}
 
-		Mesh* mesh = new Mesh(platform);
-		model.set_mesh(mesh);
-		model.set_textures(textures);
-
-		// set bounds
-		gef::Aabb aabb(pos_min, pos_max);
-		gef::Sphere sphere(aabb);
-		mesh->set_aabb(aabb);
-		mesh->set_bounding_sphere(sphere);
-
-
-		// create materials for each texture
-		for(std::vector<Texture*>::iterator texture=textures.begin(); texture != textures.end(); ++texture)
+		const size_t num_primitives = model_data.primitive_starts.size();
+		model_data.primitive_indices.resize(num_primitives);
+		for(size_t primitive_num=0;primitive_num<num_primitives;++primitive_num)
 		{
-			Material* material = new Material();
-			material->set_texture(*texture);
-			model.AddMaterial(material);
+			const Int32 start = model_data.primitive_starts[primitive_num];
+			const Int32 end = primitive_num+1 < num_primitives ? model_data.primitive_starts[primitive_num+1] : (Int32)corner_indices.size();
+			std::vector<UInt32>& indices = model_data.primitive_indices[primitive_num];
+			indices.assign(corner_indices.begin()+start, corner_indices.begin()+end);
+			if(optimiser_settings && !indices.empty())
+			{
+				if(optimiser_settings->optimise_vertex_cache)
+					OptimiseVertexCache(&indices[0], (Int32)indices.size(), num_vertices);
+				if(optimiser_settings->optimise_overdraw)
+					OptimiseOverdraw(&indices[0], (Int32)indices.size(), &model_data.vertices[0], num_vertices, sizeof(gef::Mesh::Vertex), optimiser_settings->overdraw_threshold);
+			}
 		}
 
-		mesh->InitVertexBuffer(platform, vertices, num_vertices, sizeof(gef::Mesh::Vertex));
+		if(optimiser_settings && optimiser_settings->optimise_vertex_fetch && num_vertices > 0)
+			model_data.vertices.resize(OptimiseVertexFetch(&model_data.vertices[0], num_vertices, sizeof(gef::Mesh::Vertex), model_data.primitive_indices));
+	}
+	return success;
+}
 
-		// create primitives
-		mesh->AllocatePrimitives((UInt32)primitive_indices.size());
+bool OBJLoader::CreateModel(Platform& platform, const OBJModelData& model_data, Model& model)
+{
+	const Int32 num_vertices = (Int32)model_data.vertices.size();
+	const gef::Mesh::Vertex* vertices = num_vertices > 0 ? &model_data.vertices[0] : NULL;
 
-		std::vector<UInt32*> indices;
-		indices.resize(primitive_indices.size());
-		for(UInt32 primitive_num=0;primitive_num<primitive_indices.size();++primitive_num)
-		{
-			Int32 index_count = 0;
+	// create textures
+	std::vector<Texture*> textures;
+	for(std::list<ImageData>::const_iterator image_data = model_data.texture_images.begin(); image_data != model_data.texture_images.end(); ++image_data)
+		textures.push_back(gef::Texture::Create(platform, *image_data));
 
-			if(primitive_num == primitive_indices.size()-1)
-				index_count = (Int32)face_indices.size() - primitive_indices[primitive_num];
-			else
-				index_count = primitive_indices[primitive_num+1] - primitive_indices[primitive_num];
+	Mesh* mesh = new Mesh(platform);
+	model.set_mesh(mesh);
+	model.set_textures(textures);
 
-			// 9 indices per triangle, index count is the number of vertices in this primitive
-			index_count /= 3;
+	// set bounds
+	mesh->CalculateBounds(vertices, num_vertices, sizeof(gef::Mesh::Vertex));
 
-			indices[primitive_num] = new UInt32[index_count];
 
-			for(Int32 index=0;index<index_count;++index)
-				indices[primitive_num][index] = primitive_indices[primitive_num]+index;
+	// create materials for each texture
+	for(std::vector<Texture*>::iterator texture=textures.begin(); texture != textures.end(); ++texture)
+	{
+		Material* material = new Material();
+		material->set_texture(*texture);
+		model.AddMaterial(material);
+	}
 
-			mesh->GetPrimitive(primitive_num)->set_type(gef::TRIANGLE_LIST);
-			mesh->GetPrimitive(primitive_num)->InitIndexBuffer(platform, indices[primitive_num], index_count, sizeof(UInt32));
-//			mesh->GetPrimitive(primitive_num)->InitIndexBuffer(platform, indices[primitive_num], 3, sizeof(UInt32));
+	mesh->InitVertexBuffer(platform, vertices, num_vertices, sizeof(gef::Mesh::Vertex));
 
+	// create primitives, with 16 bit indices when there are few enough vertices
+	const std::vector<std::vector<UInt32> >& primitive_indices = model_data.primitive_indices;
+	mesh->AllocatePrimitives((UInt32)primitive_indices.size());
 
-			Int32 texture_index = texture_indices[primitive_num];
-			if(texture_index == -1)
-				mesh->GetPrimitive(primitive_num)->set_material(NULL);
-			else
-				mesh->GetPrimitive(primitive_num)->set_material(model.material(texture_index));
-			//mesh->GetPrimitive(primitive_num)->set_texture(textures_[0]);
+	const bool use_16_bit_indices = num_vertices <= 65536;
+	std::vector<UInt16> indices_16;
+	for(UInt32 primitive_num=0;primitive_num<primitive_indices.size();++primitive_num)
+	{
+		const std::vector<UInt32>& indices = primitive_indices[primitive_num];
+		const Int32 index_count = (Int32)indices.size();
+
+		mesh->GetPrimitive(primitive_num)->set_type(gef::TRIANGLE_LIST);
+		if(use_16_bit_indices)
+		{
+			indices_16.assign(indices.begin(), indices.end());
+			mesh->GetPrimitive(primitive_num)->InitIndexBuffer(platform, index_count > 0 ? &indices_16[0] : NULL, index_count, sizeof(UInt16));
 		}
+		else
+			mesh->GetPrimitive(primitive_num)->InitIndexBuffer(platform, index_count > 0 ? &indices[0] : NULL, index_count, sizeof(UInt32));
 
-		// mesh construction complete
-		// clean up
-		DeleteArrayNull(vertices);
-		for(UInt32 primitive_num=0;primitive_num<indices.size();++primitive_num)
-			DeleteArrayNull(indices[primitive_num]);
 
+		Int32 texture_index = model_data.primitive_textures[primitive_num];
+		if(texture_index == -1)
+			mesh->GetPrimitive(primitive_num)->set_material(NULL);
+		else
+			mesh->GetPrimitive(primitive_num)->set_material(model.material(texture_index));
 	}
-	return success;
+
+	// mesh construction complete
+	return true;
 }
 
-bool OBJLoader::LoadMaterials(Platform& platform, const char* filename, std::map<std::string, Int32>& materials, std::vector<Texture*>& textures)
+bool OBJLoader::LoadMaterials(const Platform& platform, const char* filename, std::map<std::string, Int32>& materials, std::list<ImageData>& texture_images)
 {
 	PNGLoader png_loader;
 
@@ -339,11 +359,10 @@ bool OBJLoader::LoadMaterials(Platform& platform, const char* filename, std::map
 		{
 			if(iter->second.compare("") != 0)
 			{
-				gef::ImageData image_data;
-				png_loader.Load(iter->second.c_str(), platform, image_data);
-				Texture* texture = gef::Texture::Create(platform, image_data);
-				textures.push_back(texture);
-				materials[iter->first] = (Int32)textures.size()-1;
+				// decoded in place, image data can't be copied once it has an image
+				texture_images.push_back(gef::ImageData());
+				png_loader.Load(iter->second.c_str(), platform, texture_images.back());
+				materials[iter->first] = (Int32)texture_images.size()-1;
 			}
 			else
 			{
@@ -2,6 +2,9 @@
 #define _GEF_OBJ_LOADER_H
 
 #include <gef.h>
+#include <graphics/mesh.h>
+#include <graphics/image_data.h>
+#include <list>
 #include <map>
 #include <string>
 #include <vector>
@@ -11,13 +14,35 @@ namespace gef
 	class Platform;
 	class Model;
 	class Texture;
+	struct MeshOptimiserSettings;
+
+	/// @brief A model read from an OBJ file, before any of its platform resources are created.
+	struct OBJModelData
+	{
+		std::vector<Mesh::Vertex> vertices;		// the unique corners of the faces, in the order they're drawn
+		std::vector<Int32> primitive_starts;	// the first corner of each primitive, as the faces were read
+		std::vector<std::vector<UInt32> > primitive_indices;	// the triangles of each primitive
+		std::vector<Int32> primitive_textures;	// the texture of each primitive, or -1
+		std::list<ImageData> texture_images;	// a list, as image data can't be copied once it has an image
+	};
 
 	class OBJLoader
 	{
 	public:
-		bool Load(const char* filename, Platform& platform, Model& model);
+		/// @param[in] optimiser_settings	Optional, see ReadModel.
+		bool Load(const char* filename, Platform& platform, Model& model, const MeshOptimiserSettings* optimiser_settings = NULL);
+
+		/// @brief Reads the file and decodes its textures, the part of Load that doesn't need the platform.
+		/// @note Nothing is created on the platform, so it can be called on a loading thread, see AssetLoader.
+		/// @param[in] optimiser_settings	Optional. Without them there's a vertex for every corner of every face, drawn in the
+		/// order they were read. With them the shared corners are welded and the passes they set run, as in OptimiseMesh.
+		/// compact_indices isn't used, CreateModel always uses 16 bit indices when there are few enough vertices.
+		bool ReadModel(const char* filename, const Platform& platform, OBJModelData& model_data, const MeshOptimiserSettings* optimiser_settings = NULL);
+
+		/// @brief Creates the mesh, textures and materials of a model read by ReadModel.
+		bool CreateModel(Platform& platform, const OBJModelData& model_data, Model& model);
 	private:
-		bool LoadMaterials(Platform& platform, const char* filename, std::map<std::string, Int32>& materials, std::vector<Texture*>& textures);
+		bool LoadMaterials(const Platform& platform, const char* filename, std::map<std::string, Int32>& materials, std::list<ImageData>& texture_images);
 	};
 }
 
@@ -0,0 +1,78 @@
+#include <graphics/cached_sprite_layer.h>
+#include <graphics/render_target.h>
+#include <graphics/sprite_renderer.h>
+#include <graphics/sprite.h>
+#include <system/platform.h>
+#include <cstddef>
+
+namespace gef
+{
+	CachedSpriteLayer::CachedSpriteLayer(Platform& platform, const Int32 width, const Int32 height, const Colour& clear_colour) :
+		platform_(platform),
+		render_target_(NULL),
+		clear_colour_(clear_colour),
+		previous_render_target_(NULL),
+		previous_blend_mode_(kSpriteBlendAlpha),
+		state_key_(0),
+		valid_(false)
+	{
+		render_target_ = RenderTarget::Create(platform_, width, height, kRenderTargetRGBA8);
+	}
+
+	CachedSpriteLayer::~CachedSpriteLayer()
+	{
+		DeleteNull(render_target_);
+	}
+
+	bool CachedSpriteLayer::BeginRedraw(SpriteRenderer* sprite_renderer, const UInt32 state_key)
+	{
+		if (!render_target_ || (valid_ && state_key == state_key_))
+			return false;
+
+		state_key_ = state_key;
+		valid_ = true;
+
+		previous_render_target_ = platform_.render_target();
+		previous_clear_colour_ = platform_.render_target_clear_colour();
+
+		platform_.set_render_target(render_target_);
+		platform_.set_render_target_clear_colour(clear_colour_);
+		previous_blend_mode_ = sprite_renderer->blend_mode();
+		sprite_renderer->set_blend_mode(kSpriteBlendLayer);
+		sprite_renderer->Begin(true);
+
+		return true;
+	}
+
+	void CachedSpriteLayer::EndRedraw(SpriteRenderer* sprite_renderer)
+	{
+		sprite_renderer->End();
+		sprite_renderer->set_blend_mode(previous_blend_mode_);
+
+		platform_.set_render_target(previous_render_target_);
+		platform_.set_render_target_clear_colour(previous_clear_colour_);
+		previous_render_target_ = NULL;
+	}
+
+	void CachedSpriteLayer::Draw(SpriteRenderer* sprite_renderer, const float depth) const
+	{
+		if (!render_target_)
+			return;
+
+		// sprite positions are the centre of the sprite
+		const float width = static_cast<float>(render_target_->width());
+		const float height = static_cast<float>(render_target_->height());
+
+		Sprite layer_sprite;
+		layer_sprite.set_texture(render_target_->texture());
+		layer_sprite.set_position(width*0.5f, height*0.5f, depth);
+		layer_sprite.set_width(width);
+		layer_sprite.set_height(height);
+
+		// the layer's colours were premultiplied by its alpha as it was drawn
+		const SpriteBlendMode blend_mode = sprite_renderer->blend_mode();
+		sprite_renderer->set_blend_mode(kSpriteBlendPremultiplied);
+		sprite_renderer->DrawSprite(layer_sprite);
+		sprite_renderer->set_blend_mode(blend_mode);
+	}
+}
@@ -0,0 +1,75 @@
+#ifndef _GEF_CACHED_SPRITE_LAYER_H
+#define _GEF_CACHED_SPRITE_LAYER_H
+
+#include <gef.h>
+#include <graphics/colour.h>
+#include <graphics/sprite_renderer.h>
+
+namespace gef
+{
+	class Platform;
+	class RenderTarget;
+
+	/// @brief A retained layer of sprites that is rendered to an off-screen render target.
+	///
+	/// Static or slowly changing 2D elements such as text and icons are drawn into the layer
+	/// only when their contents change. Every frame the cached texture is drawn as a single sprite.
+	/// The layer is drawn into with kSpriteBlendLayer, so it holds colours premultiplied by alpha,
+	/// and composited with kSpriteBlendPremultiplied.
+	///
+	/// Usage:
+	///		if (layer->BeginRedraw(sprite_renderer, state_key))
+	///		{
+	///			// draw sprites and text as normal
+	///			layer->EndRedraw(sprite_renderer);
+	///		}
+	///		sprite_renderer->Begin();
+	///		layer->Draw(sprite_renderer);
+	///		sprite_renderer->End();
+	class CachedSpriteLayer
+	{
+	public:
+		/// @brief Constructor
+		/// @param[in] platform		The platform used to create the render target.
+		/// @param[in] width		The width of the layer in pixels.
+		/// @param[in] height		The height of the layer in pixels.
+		/// @param[in] clear_colour	The colour the layer is cleared to before it is redrawn.
+		/// Use a transparent colour for layers drawn over the top of a 3D scene.
+		/// A partly transparent colour must be premultiplied by its alpha.
+		CachedSpriteLayer(Platform& platform, const Int32 width, const Int32 height, const Colour& clear_colour);
+		~CachedSpriteLayer();
+
+		/// @brief Starts redrawing the layer if it is out of date.
+		/// @param[in] sprite_renderer	The renderer used to draw the contents of the layer.
+		/// @param[in] state_key		A value that identifies what the layer shows.
+		/// The layer is redrawn when the key is different from the one it was last drawn with.
+		/// @return true if the layer needs redrawing, in which case sprites drawn until EndRedraw
+		/// is called go into the layer
+		bool BeginRedraw(SpriteRenderer* sprite_renderer, const UInt32 state_key);
+
+		/// @brief Finishes redrawing the layer and restores the previous render target.
+		/// @param[in] sprite_renderer	The renderer passed to BeginRedraw.
+		void EndRedraw(SpriteRenderer* sprite_renderer);
+
+		/// @brief Draws the cached layer as a single sprite covering the whole layer.
+		/// @param[in] sprite_renderer	The renderer to draw with. Must be between Begin and End.
+		/// @param[in] depth			The depth of the sprite.
+		void Draw(SpriteRenderer* sprite_renderer, const float depth = 0.0f) const;
+
+		/// @brief Forces the layer to be redrawn the next time BeginRedraw is called.
+		inline void Invalidate() { valid_ = false; }
+
+		inline const RenderTarget* render_target() const { return render_target_; }
+	private:
+		Platform& platform_;
+		RenderTarget* render_target_;
+		Colour clear_colour_;
+		Colour previous_clear_colour_;
+		RenderTarget* previous_render_target_;
+		SpriteBlendMode previous_blend_mode_;
+		UInt32 state_key_;
+		bool valid_;
+	};
+}
+
+#endif // _GEF_CACHED_SPRITE_LAYER_H
@@ -0,0 +1,97 @@
+#include <graphics/cpu_skinning.h>
+#include <graphics/vertex_buffer.h>
+#include <maths/matrix44.h>
+#include <maths/simd.h>
+#include <system/job_system.h>
+
+namespace gef
+{
+	// enough vertices per job to cover the cost of handing out the range
+	static const Int32 kMinVerticesPerJob = 256;
+
+	static void SkinVertexRange(const Mesh::SkinnedVertex* vertices, const Matrix44* bone_matrices, Mesh::Vertex* results, const Int32 begin, const Int32 end)
+	{
+		for (Int32 vertex_num = begin; vertex_num < end; ++vertex_num)
+		{
+			const Mesh::SkinnedVertex& vertex = vertices[vertex_num];
+			Mesh::Vertex& result = results[vertex_num];
+
+			// blend the bone matrices by the weights, bones with no weight are skipped after the first
+			const Matrix44& first_bone = bone_matrices[vertex.bone_indices[0]];
+			const SimdVector first_weight = SimdSplat(vertex.bone_weights[0]);
+			SimdVector row0 = SimdMul(first_weight, first_bone.GetRow(0).simd_values());
+			SimdVector row1 = SimdMul(first_weight, first_bone.GetRow(1).simd_values());
+			SimdVector row2 = SimdMul(first_weight, first_bone.GetRow(2).simd_values());
+			SimdVector row3 = SimdMul(first_weight, first_bone.GetRow(3).simd_values());
+			for (Int32 influence = 1; influence < 4; ++influence)
+			{
+				if (vertex.bone_weights[influence] == 0.0f)
+					continue;
+
+				const Matrix44& bone = bone_matrices[vertex.bone_indices[influence]];
+				const SimdVector weight = SimdSplat(vertex.bone_weights[influence]);
+				row0 = SimdAdd(row0, SimdMul(weight, bone.GetRow(0).simd_values()));
+				row1 = SimdAdd(row1, SimdMul(weight, bone.GetRow(1).simd_values()));
+				row2 = SimdAdd(row2, SimdMul(weight, bone.GetRow(2).simd_values()));
+				row3 = SimdAdd(row3, SimdMul(weight, bone.GetRow(3).simd_values()));
+			}
+
+			SimdVector position = SimdMul(SimdSplat(vertex.px), row0);
+			position = SimdAdd(position, SimdMul(SimdSplat(vertex.py), row1));
+			position = SimdAdd(position, SimdMul(SimdSplat(vertex.pz), row2));
+			position = SimdAdd(position, row3);
+
+			SimdVector normal = SimdMul(SimdSplat(vertex.nx), row0);
+			normal = SimdAdd(normal, SimdMul(SimdSplat(vertex.ny), row1));
+			normal = SimdAdd(normal, SimdMul(SimdSplat(vertex.nz), row2));
+
+			// each store writes one float past the values, which the next store or the uvs overwrite
+			SimdStore(&result.px, position);
+			SimdStore(&result.nx, normal);
+			result.u = vertex.u;
+			result.v = vertex.v;
+		}
+	}
+
+	struct SkinJobData
+	{
+		const Mesh::SkinnedVertex* vertices;
+		const Matrix44* bone_matrices;
+		Mesh::Vertex* results;
+
+		static void Run(void* data, const Int32 begin, const Int32 end)
+		{
+			const SkinJobData* job = static_cast<const SkinJobData*>(data);
+			SkinVertexRange(job->vertices, job->bone_matrices, job->results, begin, end);
+		}
+	};
+
+	void SkinVerticesBatch(const Mesh::SkinnedVertex* vertices, const Matrix44* bone_matrices, Mesh::Vertex* results, const Int32 num_vertices)
+	{
+		SkinVertexRange(vertices, bone_matrices, results, 0, num_vertices);
+	}
+
+	void SkinVerticesBatch(const Mesh::SkinnedVertex* vertices, const Matrix44* bone_matrices, Mesh::Vertex* results, const Int32 num_vertices, JobSystem& job_system)
+	{
+		SkinJobData job;
+		job.vertices = vertices;
+		job.bone_matrices = bone_matrices;
+		job.results = results;
+		job_system.ParallelFor(num_vertices, kMinVerticesPerJob, &SkinJobData::Run, &job);
+	}
+
+	bool SkinVertexBuffer(const Platform& platform, const Mesh::SkinnedVertex* vertices, const std::vector<Matrix44>& bone_matrices, VertexBuffer& vertex_buffer, JobSystem* job_system)
+	{
+		Mesh::Vertex* results = static_cast<Mesh::Vertex*>(vertex_buffer.vertex_data());
+		if (!results || vertex_buffer.vertex_byte_size() != sizeof(Mesh::Vertex) || bone_matrices.empty())
+			return false;
+
+		const Int32 num_vertices = (Int32)vertex_buffer.num_vertices();
+		if (job_system)
+			SkinVerticesBatch(vertices, &bone_matrices[0], results, num_vertices, *job_system);
+		else
+			SkinVerticesBatch(vertices, &bone_matrices[0], results, num_vertices);
+
+		return vertex_buffer.Update(platform);
+	}
+}
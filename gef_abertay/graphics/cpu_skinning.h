@@ -0,0 +1,38 @@
+#ifndef _GEF_CPU_SKINNING_H
+#define _GEF_CPU_SKINNING_H
+
+#include <gef.h>
+#include <graphics/mesh.h>
+#include <vector>
+
+namespace gef
+{
+	class Matrix44;
+	class Platform;
+	class VertexBuffer;
+	class JobSystem;
+
+	/// @brief Skins vertices on the CPU, the same way Default3DSkinningShader does on the GPU.
+	/// @param[in] vertices			The skinned vertices of a mesh.
+	/// @param[in] bone_matrices	The bone matrices for the pose, as passed to Renderer3D::DrawSkinnedMesh.
+	/// @param[out] results			Array of num_vertices vertices that receives the deformed positions and normals, and the uvs.
+	/// @param[in] num_vertices		The number of vertices to skin.
+	/// @note Each vertex is transformed by the weighted sum of its bone matrices. The normals aren't renormalised,
+	/// as in the skinning shader the shaders that draw them normalise them.
+	void SkinVerticesBatch(const Mesh::SkinnedVertex* vertices, const Matrix44* bone_matrices, Mesh::Vertex* results, const Int32 num_vertices);
+
+	/// @brief Skins vertices on the CPU, with ranges of vertices spread across the job system's threads.
+	/// @note The parameters and results are the same as the single threaded version.
+	void SkinVerticesBatch(const Mesh::SkinnedVertex* vertices, const Matrix44* bone_matrices, Mesh::Vertex* results, const Int32 num_vertices, JobSystem& job_system);
+
+	/// @brief Skins vertices into a dynamic vertex buffer and uploads it, so a skinned mesh can be drawn without a skinning shader.
+	/// @param[in] platform			The platform the vertex buffer was created for.
+	/// @param[in] vertices			The skinned vertices of a mesh.
+	/// @param[in] bone_matrices	The bone matrices for the pose.
+	/// @param[in,out] vertex_buffer	A buffer of as many Mesh::Vertex vertices, created with read_only set to false.
+	/// @param[in] job_system		Optional job system to spread the skinning across.
+	/// @return true if the vertex buffer was updated, false if it isn't a dynamic buffer of Mesh::Vertex or the update failed
+	bool SkinVertexBuffer(const Platform& platform, const Mesh::SkinnedVertex* vertices, const std::vector<Matrix44>& bone_matrices, VertexBuffer& vertex_buffer, JobSystem* job_system = NULL);
+}
+
+#endif // _GEF_CPU_SKINNING_H
@@ -52,7 +52,7 @@ namespace gef
 		world_matrix_variable_index_ = device_interface_->AddVertexShaderVariable("world", ShaderInterface::kMatrix44);
 		invworld_matrix_variable_index_ = device_interface_->AddVertexShaderVariable("invworld", ShaderInterface::kMatrix44);
 		light_position_variable_index_ = device_interface_->AddVertexShaderVariable("light_position", ShaderInterface::kVector4, 4);
-		bone_matrices_variable_index_ = device_interface_->AddVertexShaderVariable("bone_matrices", ShaderInterface::kMatrix44, 128);
+		bone_matrices_variable_index_ = device_interface_->AddVertexShaderVariable("bone_matrices", ShaderInterface::kMatrix44, MAX_NUM_BONE_MATRICES);
 
 		// pixel shader variables
 		// TODO - probable need to keep these separate for D3D11
@@ -82,6 +82,7 @@ namespace gef
 		, ambient_light_colour_variable_index_(-1)
 		, light_colour_variable_index_(-1)
 		, texture_sampler_index_(-1)
+		, bone_matrices_variable_index_(-1)
 	{
 	}
 
@@ -92,6 +93,14 @@ namespace gef
 
 
 	void Default3DSkinningShader::SetSceneData(const SkinnedMeshShaderData& shader_data, const Matrix44& view_matrix, const Matrix44& projection_matrix)
+	{
+		SetSceneData(static_cast<const Default3DShaderData&>(shader_data), view_matrix, projection_matrix);
+
+		if (shader_data.bone_matrices() && !shader_data.bone_matrices()->empty())
+			SetBoneMatrices(&shader_data.bone_matrices()->front(), (Int32)shader_data.bone_matrices()->size());
+	}
+
+	void Default3DSkinningShader::SetSceneData(const Default3DShaderData& shader_data, const Matrix44& view_matrix, const Matrix44& projection_matrix)
 	{
 		//gef::Matrix44 wvp = world_matrix * view_matrix * projection_matrix;
 		gef::Vector4 light_positions[MAX_NUM_POINT_LIGHTS];
@@ -124,18 +133,32 @@ namespace gef
 
 		device_interface_->SetVertexShaderVariable(light_position_variable_index_, (float*)light_positions);
 
+		device_interface_->SetPixelShaderVariable(ambient_light_colour_variable_index_, (float*)&ambient_light_colour);
+		device_interface_->SetPixelShaderVariable(light_colour_variable_index_, (float*)light_colours);
+	}
+
+	void Default3DSkinningShader::SetBoneMatrices(const Matrix44* bone_matrices, const Int32 bone_count)
+	{
 		// need to transpose the bone matrices for the shader
-		if (bone_matrices_variable_index_ != -1)
-		{
-			UInt32 matrix_index = 0;
-			for (std::vector<gef::Matrix44>::const_iterator matrix_iter = shader_data.bone_matrices()->begin(); matrix_iter != shader_data.bone_matrices()->end(); ++matrix_iter, ++matrix_index)
-				mesh_data_.bones_matrices[matrix_index].Transpose((*matrix_iter));
+		const Int32 palette_count = bone_count < MAX_NUM_BONE_MATRICES ? bone_count : MAX_NUM_BONE_MATRICES;
+		if (bone_matrices_variable_index_ == -1 || palette_count <= 0)
+			return;
 
-			device_interface_->SetVertexShaderVariable(bone_matrices_variable_index_, (float*)&mesh_data_.bones_matrices[0], (Int32)shader_data.bone_matrices()->size());
-		}
+		if ((Int32)bone_palette_.size() < palette_count)
+			bone_palette_.resize(palette_count);
+		for (Int32 matrix_index = 0; matrix_index < palette_count; ++matrix_index)
+			bone_palette_[matrix_index].Transpose(bone_matrices[matrix_index]);
 
-		device_interface_->SetPixelShaderVariable(ambient_light_colour_variable_index_, (float*)&ambient_light_colour);
-		device_interface_->SetPixelShaderVariable(light_colour_variable_index_, (float*)light_colours);
+		device_interface_->SetVertexShaderVariable(bone_matrices_variable_index_, (float*)&bone_palette_[0], palette_count);
+	}
+
+	void Default3DSkinningShader::SetBonePalette(const Matrix44* bone_palette, const Int32 bone_count)
+	{
+		const Int32 palette_count = bone_count < MAX_NUM_BONE_MATRICES ? bone_count : MAX_NUM_BONE_MATRICES;
+		if (bone_matrices_variable_index_ == -1 || palette_count <= 0)
+			return;
+
+		device_interface_->SetVertexShaderVariable(bone_matrices_variable_index_, (float*)bone_palette, palette_count);
 	}
 
 	void Default3DSkinningShader::SetMeshData(const gef::MeshInstance& mesh_instance)
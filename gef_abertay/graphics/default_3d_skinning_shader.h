@@ -12,6 +12,7 @@
 #include <gef.h>
 #include <maths/vector4.h>
 #include <maths/matrix44.h>
+#include <vector>
 
 #define MAX_NUM_POINT_LIGHTS 4
 #define MAX_NUM_BONE_MATRICES 128
@@ -24,6 +25,7 @@ namespace gef
 	class Texture;
 	class Material;
 	class SkinnedMeshShaderData;
+	class Default3DShaderData;
 
 	class Default3DSkinningShader: public Shader
 	{
@@ -36,7 +38,6 @@ namespace gef
 			Vector4 ambient_light_colour;
 			Vector4 light_position[MAX_NUM_POINT_LIGHTS];
 			Vector4 light_colour[MAX_NUM_POINT_LIGHTS];
-			Matrix44 bones_matrices[MAX_NUM_BONE_MATRICES];
 		};
 
 		struct PrimitiveData
@@ -50,6 +51,18 @@ namespace gef
 		//void SetSceneData(const Matrix44& wvp_matrix);
 		//void SetSpriteData(const Sprite& sprite, const Texture* texture);
 		void SetSceneData(const SkinnedMeshShaderData& shader_data, const Matrix44& view_matrix, const Matrix44& projection_matrix);
+
+		/// @brief Sets the lights and camera without the bone matrices, so the lights can be shared with Default3DShader.
+		void SetSceneData(const Default3DShaderData& shader_data, const Matrix44& view_matrix, const Matrix44& projection_matrix);
+
+		/// @brief Sets the bone matrices, transposing each for the shader.
+		/// @note Only bone_count matrices are uploaded, up to MAX_NUM_BONE_MATRICES.
+		void SetBoneMatrices(const Matrix44* bone_matrices, const Int32 bone_count);
+
+		/// @brief Sets bone matrices that are already transposed, e.g. by SkeletonPoseSoA::CalculateSkinningPalette.
+		/// @note The palette is uploaded as it is, only bone_count matrices up to MAX_NUM_BONE_MATRICES.
+		void SetBonePalette(const Matrix44* bone_palette, const Int32 bone_count);
+
 		void SetMeshData(const gef::MeshInstance& mesh_instance);
 		void SetMaterialData(const gef::Material* material);
 
@@ -71,6 +84,7 @@ namespace gef
 
 		MeshData mesh_data_;
 		PrimitiveData primitive_data_;
+		std::vector<Matrix44> bone_palette_;	// transposed bone matrices, only as many as the largest skeleton drawn
 
 		gef::Matrix44 view_projection_matrix_;
 
@@ -38,6 +38,15 @@ Font::~Font()
 }
 
 bool Font::Load(const char* font_name)
+{
+	gef::ImageData image_data;
+	bool config_initialised = ReadFont(font_name, image_data);
+	CreateTexture(image_data);
+
+	return config_initialised;
+}
+
+bool Font::ReadFont(const char* font_name, ImageData& texture_image)
 {
 	std::string font_config_filename(font_name);
 	font_config_filename += ".fnt";
@@ -85,15 +94,21 @@ bool Font::Load(const char* font_name)
 		std::string font_texture_filename(font_name);
 		font_texture_filename += "_0.png";
 		PNGLoader png_loader;
-		gef::ImageData image_data;
-		png_loader.Load(font_texture_filename.c_str(), platform_, image_data);
-		font_texture_ = gef::Texture::Create(platform_, image_data);
-		platform_.AddTexture(font_texture_);
+		png_loader.Load(font_texture_filename.c_str(), platform_, texture_image);
 	}
 
 	return config_initialised;
 }
 
+void Font::CreateTexture(const ImageData& texture_image)
+{
+	if(texture_image.image() == NULL)
+		return;
+
+	font_texture_ = gef::Texture::Create(platform_, texture_image);
+	platform_.AddTexture(font_texture_);
+}
+
 
 bool Font::ParseFont( std::istream& Stream, Font::Charset& CharsetDesc )
 {
@@ -11,6 +11,7 @@ namespace gef
 	class Texture;
 	class Platform;
 	class Vector4;
+	class ImageData;
 
 	enum TextJustification
 	{
@@ -25,6 +26,15 @@ namespace gef
 		Font(Platform& platform);
 		~Font();
 		bool Load(const char* font_name);
+
+		/// @brief Reads the character set and decodes the texture image, the part of Load that doesn't need the platform.
+		/// @note Nothing is created on the platform, so it can be called on a loading thread, see AssetLoader.
+		/// @param[out] texture_image	Receives the font's texture, for CreateTexture.
+		/// @return true if the character set was read
+		bool ReadFont(const char* font_name, ImageData& texture_image);
+
+		/// @brief Creates the font's texture from the image decoded by ReadFont.
+		void CreateTexture(const ImageData& texture_image);
 		void RenderText(SpriteRenderer* renderer, const Vector4& pos, const float scale, const UInt32 colour, const TextJustification justification, const char * text, ...) const;
 		float GetStringLength(const char * text) const;
 
@@ -2,6 +2,7 @@
 #include <graphics/primitive.h>
 #include <graphics/vertex_buffer.h>
 #include <system/platform.h>
+#include <maths/transform_batch.h>
 
 namespace gef
 {
@@ -32,6 +33,12 @@ namespace gef
 		return success;
 	}
 
+	void Mesh::CalculateBounds(const void* vertices, const UInt32 num_vertices, const UInt32 vertex_byte_size)
+	{
+		aabb_ = CalculateBoundsBatch(static_cast<const float*>(vertices), vertex_byte_size, static_cast<Int32>(num_vertices));
+		bounding_sphere_ = Sphere(aabb_);
+	}
+
 	void Mesh::AllocatePrimitives(const UInt32 num_primitives)
 	{
 		if(primitives_)
@@ -62,6 +62,12 @@ namespace gef
 		inline void set_aabb(const gef::Aabb& aabb) { aabb_ = aabb; }
 		inline void set_bounding_sphere(const gef::Sphere& sphere) { bounding_sphere_ = sphere; }
 
+		/// @brief Sets the bounding box and bounding sphere from the vertex positions.
+		/// @param[in] vertices				The vertices, each must start with its x, y and z position.
+		/// @param[in] num_vertices			The number of vertices.
+		/// @param[in] vertex_byte_size		The size of each vertex in bytes.
+		void CalculateBounds(const void* vertices, const UInt32 num_vertices, const UInt32 vertex_byte_size);
+
 		inline const Aabb& aabb() const { return aabb_; }
 		inline const Sphere& bounding_sphere() const { return bounding_sphere_; }
 
@@ -71,7 +77,6 @@ namespace gef
 	protected:
 		virtual class Primitive* AllocatePrimitive(); // move to platform class?
 		void ReleasePrimitives();
-		void CalculateBounds(const Vector4* vertex_positions, const UInt32 num_vertices, const UInt32 vertex_byte_size);
 
 		UInt32 num_primitives_;
 		class Primitive ** primitives_;
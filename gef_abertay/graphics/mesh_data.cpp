@@ -64,13 +64,15 @@ namespace gef
 
 
 	VertexData::VertexData() :
-		vertices(NULL)
+		vertices(NULL),
+		owns_vertices(true)
 	{
 	}
 
 	VertexData::~VertexData()
 	{
-		free(vertices);
+		if(owns_vertices)
+			free(vertices);
 		vertices = NULL;
 	}
 
@@ -104,13 +106,15 @@ namespace gef
 
 	PrimitiveData::PrimitiveData() :
 		indices(NULL),
-		material_name_id(0)
+		material_name_id(0),
+		owns_indices(true)
 	{
 	}
 
 	PrimitiveData::~PrimitiveData()
 	{
-		free(indices);
+		if(owns_indices)
+			free(indices);
 		indices = NULL;
 	}
 
@@ -36,6 +36,7 @@ namespace gef
 		Int32 num_indices;
 		Int32 index_byte_size;
 		PrimitiveType type;
+		bool owns_indices;		// false when indices point into a mapped scene file, see PackedSceneReader
 	};
 
 	struct VertexData
@@ -49,6 +50,7 @@ namespace gef
 		void* vertices;
 		Int32 num_vertices;
 		Int32 vertex_byte_size;
+		bool owns_vertices;		// false when vertices point into a mapped scene file, see PackedSceneReader
 	};
 
 
@@ -0,0 +1,541 @@
+#include <graphics/mesh_optimiser.h>
+#include <graphics/mesh_data.h>
+#include <graphics/primitive.h>
+#include <system/crc.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace gef
+{
+	// the scoring from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+	static const Int32 kForsythCacheSize = 32;
+	static const Int32 kForsythMaxValence = 32;
+	static const float kForsythCacheDecayPower = 1.5f;
+	static const float kForsythLastTriangleScore = 0.75f;
+	static const float kForsythValenceBoostScale = 2.0f;
+	static const float kForsythValenceBoostPower = 0.5f;
+
+	static const UInt32 kUnusedVertex = 0xffffffff;
+
+	struct ForsythScores
+	{
+		ForsythScores()
+		{
+			// the vertices of the last triangle get a fixed score, so triangles sharing an edge with it aren't always preferred
+			for (Int32 position = 0; position < kForsythCacheSize; ++position)
+			{
+				if (position < 3)
+					cache[position] = kForsythLastTriangleScore;
+				else
+					cache[position] = powf(1.0f - (float)(position - 3) / (float)(kForsythCacheSize - 3), kForsythCacheDecayPower);
+			}
+
+			// vertices with few triangles left are boosted, so they're finished off rather than left as lone triangles
+			valence[0] = 0.0f;
+			for (Int32 remaining = 1; remaining < kForsythMaxValence; ++remaining)
+				valence[remaining] = kForsythValenceBoostScale * powf((float)remaining, -kForsythValenceBoostPower);
+		}
+
+		float VertexScore(const Int32 cache_position, const Int32 remaining) const
+		{
+			if (remaining == 0)
+				return -1.0f;
+
+			const float cache_score = cache_position >= 0 ? cache[cache_position] : 0.0f;
+			return cache_score + valence[remaining < kForsythMaxValence ? remaining : kForsythMaxValence - 1];
+		}
+
+		float cache[kForsythCacheSize];
+		float valence[kForsythMaxValence];
+	};
+
+	static bool IndicesInRange(const UInt32* indices, const Int32 num_indices, const Int32 num_vertices)
+	{
+		for (Int32 index = 0; index < num_indices; ++index)
+		{
+			if (indices[index] >= (UInt32)num_vertices)
+				return false;
+		}
+		return true;
+	}
+
+	// counts the vertices transformed with a FIFO cache, a vertex stays cached until cache_size more have been transformed
+	static Int32 CountCacheMisses(const UInt32* indices, const Int32 num_indices, std::vector<UInt32>& vertex_times, UInt32& time, const Int32 cache_size)
+	{
+		Int32 num_misses = 0;
+		for (Int32 index = 0; index < num_indices; ++index)
+		{
+			UInt32& vertex_time = vertex_times[indices[index]];
+			if (time - vertex_time > (UInt32)cache_size)
+			{
+				vertex_time = time++;
+				++num_misses;
+			}
+		}
+		return num_misses;
+	}
+
+	float CalculateACMR(const UInt32* indices, const Int32 num_indices, const Int32 num_vertices, const Int32 cache_size)
+	{
+		const Int32 num_triangles = num_indices / 3;
+		if (num_triangles == 0 || !IndicesInRange(indices, num_triangles*3, num_vertices))
+			return 0.0f;
+
+		std::vector<UInt32> vertex_times(num_vertices, 0);
+		UInt32 time = cache_size + 1;
+		return (float)CountCacheMisses(indices, num_triangles*3, vertex_times, time, cache_size) / (float)num_triangles;
+	}
+
+	// the indices of a primitive widened to 32 bits
+	static bool ReadIndices(const PrimitiveData& primitive, std::vector<UInt32>& indices)
+	{
+		indices.resize(primitive.num_indices > 0 ? primitive.num_indices : 0);
+		if (primitive.index_byte_size == 2)
+		{
+			const UInt16* primitive_indices = static_cast<const UInt16*>(primitive.indices);
+			for (size_t index = 0; index < indices.size(); ++index)
+				indices[index] = primitive_indices[index];
+		}
+		else if (primitive.index_byte_size == 4)
+		{
+			if (!indices.empty())
+				memcpy(&indices[0], primitive.indices, indices.size()*sizeof(UInt32));
+		}
+		else
+			return false;
+
+		return true;
+	}
+
+	// the ACMR of the triangle lists of a mesh, each primitive is a draw of its own so starts with an empty cache
+	static float CalculateACMR(const MeshData& mesh, const std::vector<std::vector<UInt32> >& index_lists, const Int32 num_vertices, const Int32 cache_size)
+	{
+		std::vector<UInt32> vertex_times(num_vertices, 0);
+		UInt32 time = cache_size + 1;
+		Int32 num_misses = 0, num_triangles = 0;
+		for (size_t primitive_num = 0; primitive_num < index_lists.size(); ++primitive_num)
+		{
+			const std::vector<UInt32>& indices = index_lists[primitive_num];
+			const Int32 num_primitive_triangles = (Int32)indices.size() / 3;
+			if (mesh.primitives[primitive_num]->type != TRIANGLE_LIST || num_primitive_triangles == 0
+				|| !IndicesInRange(&indices[0], num_primitive_triangles*3, num_vertices))
+				continue;
+
+			num_misses += CountCacheMisses(&indices[0], num_primitive_triangles*3, vertex_times, time, cache_size);
+			num_triangles += num_primitive_triangles;
+			time += cache_size + 1;
+		}
+
+		return num_triangles > 0 ? (float)num_misses / (float)num_triangles : 0.0f;
+	}
+
+	float CalculateACMR(const MeshData& mesh, const Int32 cache_size)
+	{
+		std::vector<std::vector<UInt32> > index_lists(mesh.primitives.size());
+		for (size_t primitive_num = 0; primitive_num < mesh.primitives.size(); ++primitive_num)
+			ReadIndices(*mesh.primitives[primitive_num], index_lists[primitive_num]);
+
+		return CalculateACMR(mesh, index_lists, mesh.vertex_data.num_vertices, cache_size);
+	}
+
+	void OptimiseVertexCache(UInt32* indices, const Int32 num_indices, const Int32 num_vertices)
+	{
+		const Int32 num_triangles = num_indices / 3;
+		if (num_triangles < 2 || !IndicesInRange(indices, num_triangles*3, num_vertices))
+			return;
+
+		static const ForsythScores scores;
+
+		// the triangles using each vertex, triangles are removed as they're drawn
+		std::vector<Int32> remaining(num_vertices, 0);
+		for (Int32 index = 0; index < num_triangles*3; ++index)
+			++remaining[indices[index]];
+
+		std::vector<Int32> adjacency_starts(num_vertices + 1, 0);
+		for (Int32 vertex_num = 0; vertex_num < num_vertices; ++vertex_num)
+			adjacency_starts[vertex_num + 1] = adjacency_starts[vertex_num] + remaining[vertex_num];
+
+		std::vector<Int32> adjacency(num_triangles*3);
+		std::vector<Int32> adjacency_ends(adjacency_starts.begin(), adjacency_starts.end() - 1);
+		for (Int32 index = 0; index < num_triangles*3; ++index)
+			adjacency[adjacency_ends[indices[index]]++] = index / 3;
+
+		std::vector<Int32> cache_positions(num_vertices, -1);
+		std::vector<float> vertex_scores(num_vertices);
+		for (Int32 vertex_num = 0; vertex_num < num_vertices; ++vertex_num)
+			vertex_scores[vertex_num] = scores.VertexScore(-1, remaining[vertex_num]);
+
+		std::vector<char> drawn(num_triangles, 0);
+		std::vector<UInt32> ordered_indices;
+		ordered_indices.reserve(num_triangles*3);
+
+		UInt32 cache[kForsythCacheSize + 3];
+		Int32 cache_count = 0;
+		Int32 best_triangle = 0;
+		Int32 next_undrawn = 0;
+		for (Int32 drawn_count = 0; drawn_count < num_triangles; ++drawn_count)
+		{
+			// when nothing in the cache has triangles left, carry on from the first triangle not drawn
+			if (best_triangle < 0)
+			{
+				while (drawn[next_undrawn])
+					++next_undrawn;
+				best_triangle = next_undrawn;
+			}
+
+			const UInt32* triangle = &indices[best_triangle*3];
+			drawn[best_triangle] = 1;
+			ordered_indices.insert(ordered_indices.end(), triangle, triangle + 3);
+
+			// the triangle's vertices go to the front of the cache, then the rest of it in order
+			UInt32 new_cache[kForsythCacheSize + 3];
+			Int32 new_cache_count = 0;
+			for (Int32 corner = 0; corner < 3; ++corner)
+			{
+				const UInt32 vertex = triangle[corner];
+				Int32* vertex_triangles = &adjacency[adjacency_starts[vertex]];
+				for (Int32 triangle_num = 0; triangle_num < remaining[vertex]; ++triangle_num)
+				{
+					if (vertex_triangles[triangle_num] == best_triangle)
+					{
+						vertex_triangles[triangle_num] = vertex_triangles[remaining[vertex] - 1];
+						break;
+					}
+				}
+				--remaining[vertex];
+
+				if (std::find(new_cache, new_cache + new_cache_count, vertex) == new_cache + new_cache_count)
+					new_cache[new_cache_count++] = vertex;
+			}
+
+			for (Int32 cache_num = 0; cache_num < cache_count; ++cache_num)
+			{
+				const UInt32 vertex = cache[cache_num];
+				if (vertex != triangle[0] && vertex != triangle[1] && vertex != triangle[2])
+					new_cache[new_cache_count++] = vertex;
+			}
+
+			for (Int32 cache_num = 0; cache_num < new_cache_count; ++cache_num)
+			{
+				const UInt32 vertex = new_cache[cache_num];
+				cache_positions[vertex] = cache_num < kForsythCacheSize ? cache_num : -1;
+				vertex_scores[vertex] = scores.VertexScore(cache_positions[vertex], remaining[vertex]);
+			}
+
+			cache_count = new_cache_count < kForsythCacheSize ? new_cache_count : kForsythCacheSize;
+			memcpy(cache, new_cache, cache_count*sizeof(UInt32));
+
+			// the next triangle is the best one using a vertex in the cache
+			best_triangle = -1;
+			float best_score = -1.0f;
+			for (Int32 cache_num = 0; cache_num < cache_count; ++cache_num)
+			{
+				const UInt32 vertex = cache[cache_num];
+				const Int32* vertex_triangles = &adjacency[adjacency_starts[vertex]];
+				for (Int32 triangle_num = 0; triangle_num < remaining[vertex]; ++triangle_num)
+				{
+					const UInt32* candidate = &indices[vertex_triangles[triangle_num]*3];
+					const float score = vertex_scores[candidate[0]] + vertex_scores[candidate[1]] + vertex_scores[candidate[2]];
+					if (score > best_score)
+					{
+						best_score = score;
+						best_triangle = vertex_triangles[triangle_num];
+					}
+				}
+			}
+		}
+
+		memcpy(indices, &ordered_indices[0], ordered_indices.size()*sizeof(UInt32));
+	}
+
+	struct TriangleCluster
+	{
+		Int32 start;
+		Int32 end;
+		float sort_key;
+	};
+
+	// clusters facing out of the mesh are drawn first, as they're the most likely to hide what's behind them
+	static bool DrawClusterFirst(const TriangleCluster& lhs, const TriangleCluster& rhs)
+	{
+		return lhs.sort_key > rhs.sort_key;
+	}
+
+	void OptimiseOverdraw(UInt32* indices, const Int32 num_indices, const void* vertices, const Int32 num_vertices, const Int32 vertex_byte_size, const float threshold)
+	{
+		const Int32 num_triangles = num_indices / 3;
+		if (num_triangles < 2 || !vertices || vertex_byte_size < (Int32)(3*sizeof(float)) || !IndicesInRange(indices, num_triangles*3, num_vertices))
+			return;
+
+		// the list is split where a triangle misses the cache with every vertex, so the clusters can be drawn in any order
+		// without losing any cache reuse, then further where a cluster's ACMR so far is within threshold of the whole cluster's
+		std::vector<UInt32> vertex_times(num_vertices, 0);
+		UInt32 time = kMeshOptimiserCacheSize + 1;
+		std::vector<Int32> triangle_misses(num_triangles);
+		std::vector<Int32> hard_starts;
+		for (Int32 triangle_num = 0; triangle_num < num_triangles; ++triangle_num)
+		{
+			triangle_misses[triangle_num] = CountCacheMisses(&indices[triangle_num*3], 3, vertex_times, time, kMeshOptimiserCacheSize);
+			if (triangle_num == 0 || triangle_misses[triangle_num] == 3)
+				hard_starts.push_back(triangle_num);
+		}
+		hard_starts.push_back(num_triangles);
+
+		std::vector<TriangleCluster> clusters;
+		for (size_t hard_num = 0; hard_num + 1 < hard_starts.size(); ++hard_num)
+		{
+			const Int32 hard_start = hard_starts[hard_num], hard_end = hard_starts[hard_num + 1];
+			Int32 hard_misses = 0;
+			for (Int32 triangle_num = hard_start; triangle_num < hard_end; ++triangle_num)
+				hard_misses += triangle_misses[triangle_num];
+			const float max_acmr = threshold * (float)hard_misses / (float)(hard_end - hard_start);
+
+			// each soft cluster starts with an empty cache, as it may be drawn after any other
+			TriangleCluster cluster = { hard_start, hard_end, 0.0f };
+			Int32 cluster_misses = 0;
+			time += kMeshOptimiserCacheSize + 1;
+			for (Int32 triangle_num = hard_start; triangle_num < hard_end; ++triangle_num)
+			{
+				cluster_misses += CountCacheMisses(&indices[triangle_num*3], 3, vertex_times, time, kMeshOptimiserCacheSize);
+				if (triangle_num + 1 < hard_end && (float)cluster_misses <= max_acmr * (float)(triangle_num + 1 - cluster.start))
+				{
+					cluster.end = triangle_num + 1;
+					clusters.push_back(cluster);
+					cluster.start = triangle_num + 1;
+					cluster_misses = 0;
+					time += kMeshOptimiserCacheSize + 1;
+				}
+			}
+			cluster.end = hard_end;
+			clusters.push_back(cluster);
+		}
+
+		// area weighted centres and normals, the cross product of two edges is the normal scaled by twice the area
+		const UInt8* vertex_bytes = static_cast<const UInt8*>(vertices);
+		std::vector<float> cluster_centres(clusters.size()*3, 0.0f);
+		std::vector<float> cluster_normals(clusters.size()*3, 0.0f);
+		std::vector<float> cluster_areas(clusters.size(), 0.0f);
+		float mesh_centre[3] = { 0.0f, 0.0f, 0.0f };
+		float mesh_area = 0.0f;
+		for (size_t cluster_num = 0; cluster_num < clusters.size(); ++cluster_num)
+		{
+			float* centre = &cluster_centres[cluster_num*3];
+			float* normal = &cluster_normals[cluster_num*3];
+			for (Int32 triangle_num = clusters[cluster_num].start; triangle_num < clusters[cluster_num].end; ++triangle_num)
+			{
+				const float* p0 = reinterpret_cast<const float*>(vertex_bytes + indices[triangle_num*3]*vertex_byte_size);
+				const float* p1 = reinterpret_cast<const float*>(vertex_bytes + indices[triangle_num*3+1]*vertex_byte_size);
+				const float* p2 = reinterpret_cast<const float*>(vertex_bytes + indices[triangle_num*3+2]*vertex_byte_size);
+				const float edge0[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+				const float edge1[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+				const float cross[3] = { edge0[1]*edge1[2] - edge0[2]*edge1[1], edge0[2]*edge1[0] - edge0[0]*edge1[2], edge0[0]*edge1[1] - edge0[1]*edge1[0] };
+				const float area = sqrtf(cross[0]*cross[0] + cross[1]*cross[1] + cross[2]*cross[2]);
+
+				for (Int32 axis = 0; axis < 3; ++axis)
+				{
+					centre[axis] += area * (p0[axis] + p1[axis] + p2[axis]) / 3.0f;
+					normal[axis] += cross[axis];
+				}
+				cluster_areas[cluster_num] += area;
+			}
+
+			for (Int32 axis = 0; axis < 3; ++axis)
+				mesh_centre[axis] += centre[axis];
+			mesh_area += cluster_areas[cluster_num];
+		}
+
+		if (mesh_area <= 0.0f)
+			return;
+
+		for (Int32 axis = 0; axis < 3; ++axis)
+			mesh_centre[axis] /= mesh_area;
+
+		for (size_t cluster_num = 0; cluster_num < clusters.size(); ++cluster_num)
+		{
+			const float* centre = &cluster_centres[cluster_num*3];
+			const float* normal = &cluster_normals[cluster_num*3];
+			const float area = cluster_areas[cluster_num];
+			const float normal_length = sqrtf(normal[0]*normal[0] + normal[1]*normal[1] + normal[2]*normal[2]);
+			if (area <= 0.0f || normal_length <= 0.0f)
+				continue;
+
+			float sort_key = 0.0f;
+			for (Int32 axis = 0; axis < 3; ++axis)
+				sort_key += (centre[axis] / area - mesh_centre[axis]) * normal[axis];
+			clusters[cluster_num].sort_key = sort_key / normal_length;
+		}
+
+		std::stable_sort(clusters.begin(), clusters.end(), DrawClusterFirst);
+
+		std::vector<UInt32> ordered_indices;
+		ordered_indices.reserve(num_triangles*3);
+		for (size_t cluster_num = 0; cluster_num < clusters.size(); ++cluster_num)
+			ordered_indices.insert(ordered_indices.end(), indices + clusters[cluster_num].start*3, indices + clusters[cluster_num].end*3);
+
+		memcpy(indices, &ordered_indices[0], ordered_indices.size()*sizeof(UInt32));
+	}
+
+	Int32 OptimiseVertexFetch(void* vertices, const Int32 num_vertices, const Int32 vertex_byte_size, std::vector<std::vector<UInt32> >& index_lists)
+	{
+		for (size_t list_num = 0; list_num < index_lists.size(); ++list_num)
+		{
+			if (!index_lists[list_num].empty() && !IndicesInRange(&index_lists[list_num][0], (Int32)index_lists[list_num].size(), num_vertices))
+				return num_vertices;
+		}
+
+		// each vertex's new position is the order it's first used in
+		std::vector<UInt32> remap(num_vertices, kUnusedVertex);
+		UInt32 next_vertex = 0;
+		for (size_t list_num = 0; list_num < index_lists.size(); ++list_num)
+		{
+			std::vector<UInt32>& indices = index_lists[list_num];
+			for (size_t index = 0; index < indices.size(); ++index)
+			{
+				UInt32& new_vertex = remap[indices[index]];
+				if (new_vertex == kUnusedVertex)
+					new_vertex = next_vertex++;
+				indices[index] = new_vertex;
+			}
+		}
+
+		UInt8* vertex_bytes = static_cast<UInt8*>(vertices);
+		const std::vector<UInt8> old_vertex_bytes(vertex_bytes, vertex_bytes + (size_t)num_vertices*vertex_byte_size);
+		for (Int32 vertex_num = 0; vertex_num < num_vertices; ++vertex_num)
+		{
+			if (remap[vertex_num] != kUnusedVertex)
+				memcpy(vertex_bytes + (size_t)remap[vertex_num]*vertex_byte_size, &old_vertex_bytes[(size_t)vertex_num*vertex_byte_size], vertex_byte_size);
+		}
+
+		return (Int32)next_vertex;
+	}
+
+	Int32 WeldVertices(void* vertices, const Int32 num_vertices, const Int32 vertex_byte_size, std::vector<UInt32>& indices)
+	{
+		indices.resize(num_vertices);
+
+		// an open addressing hash table of the unique vertices, at most half full
+		size_t table_size = 16;
+		while (table_size < (size_t)num_vertices*2)
+			table_size *= 2;
+		std::vector<Int32> table(table_size, -1);
+
+		UInt8* vertex_bytes = static_cast<UInt8*>(vertices);
+		Int32 num_unique = 0;
+		for (Int32 vertex_num = 0; vertex_num < num_vertices; ++vertex_num)
+		{
+			const UInt8* vertex = vertex_bytes + (size_t)vertex_num*vertex_byte_size;
+			size_t slot = CRC::GetCRC(vertex, vertex_byte_size) & (table_size - 1);
+			for (;;)
+			{
+				const Int32 unique_vertex = table[slot];
+				if (unique_vertex < 0)
+				{
+					// unique vertices are moved down to follow the ones before, none still to be read are overwritten
+					table[slot] = num_unique;
+					if (num_unique != vertex_num)
+						memmove(vertex_bytes + (size_t)num_unique*vertex_byte_size, vertex, vertex_byte_size);
+					indices[vertex_num] = num_unique++;
+					break;
+				}
+
+				if (memcmp(vertex_bytes + (size_t)unique_vertex*vertex_byte_size, vertex, vertex_byte_size) == 0)
+				{
+					indices[vertex_num] = unique_vertex;
+					break;
+				}
+
+				slot = (slot + 1) & (table_size - 1);
+			}
+		}
+
+		return num_unique;
+	}
+
+	static size_t MeshBytes(const MeshData& mesh)
+	{
+		size_t bytes = (size_t)mesh.vertex_data.num_vertices*mesh.vertex_data.vertex_byte_size;
+		for (size_t primitive_num = 0; primitive_num < mesh.primitives.size(); ++primitive_num)
+			bytes += (size_t)mesh.primitives[primitive_num]->num_indices*mesh.primitives[primitive_num]->index_byte_size;
+		return bytes;
+	}
+
+	bool OptimiseMesh(MeshData& mesh, const MeshOptimiserSettings& settings, MeshOptimiserStats* stats)
+	{
+		VertexData& vertex_data = mesh.vertex_data;
+
+		std::vector<std::vector<UInt32> > index_lists(mesh.primitives.size());
+		for (size_t primitive_num = 0; primitive_num < mesh.primitives.size(); ++primitive_num)
+		{
+			if (!ReadIndices(*mesh.primitives[primitive_num], index_lists[primitive_num]))
+				return false;
+		}
+
+		if (stats)
+		{
+			stats->acmr_before = CalculateACMR(mesh, index_lists, vertex_data.num_vertices, kMeshOptimiserCacheSize);
+			stats->bytes_before = MeshBytes(mesh);
+		}
+
+		for (size_t primitive_num = 0; primitive_num < mesh.primitives.size(); ++primitive_num)
+		{
+			std::vector<UInt32>& indices = index_lists[primitive_num];
+			if (mesh.primitives[primitive_num]->type != TRIANGLE_LIST || indices.empty())
+				continue;
+
+			if (settings.optimise_vertex_cache)
+				OptimiseVertexCache(&indices[0], (Int32)indices.size(), vertex_data.num_vertices);
+			if (settings.optimise_overdraw)
+				OptimiseOverdraw(&indices[0], (Int32)indices.size(), vertex_data.vertices, vertex_data.num_vertices, vertex_data.vertex_byte_size, settings.overdraw_threshold);
+		}
+
+		if (settings.optimise_vertex_fetch && vertex_data.vertices)
+		{
+			// vertices read in place from a packed scene are copied out of the file before they're reordered
+			if (!vertex_data.owns_vertices)
+			{
+				const size_t vertex_bytes = (size_t)vertex_data.num_vertices*vertex_data.vertex_byte_size;
+				void* vertices = malloc(vertex_bytes);
+				memcpy(vertices, vertex_data.vertices, vertex_bytes);
+				vertex_data.vertices = vertices;
+				vertex_data.owns_vertices = true;
+			}
+
+			vertex_data.num_vertices = OptimiseVertexFetch(vertex_data.vertices, vertex_data.num_vertices, vertex_data.vertex_byte_size, index_lists);
+		}
+
+		// the indices are written back to buffers of their own
+		const bool use_16_bit_indices = settings.compact_indices && vertex_data.num_vertices <= 65536;
+		for (size_t primitive_num = 0; primitive_num < mesh.primitives.size(); ++primitive_num)
+		{
+			PrimitiveData& primitive = *mesh.primitives[primitive_num];
+			const std::vector<UInt32>& indices = index_lists[primitive_num];
+			const Int32 index_byte_size = use_16_bit_indices ? 2 : primitive.index_byte_size;
+
+			void* primitive_indices = malloc(indices.size()*index_byte_size);
+			if (index_byte_size == 2)
+			{
+				UInt16* indices_16 = static_cast<UInt16*>(primitive_indices);
+				for (size_t index = 0; index < indices.size(); ++index)
+					indices_16[index] = (UInt16)indices[index];
+			}
+			else if (!indices.empty())
+				memcpy(primitive_indices, &indices[0], indices.size()*sizeof(UInt32));
+
+			if (primitive.owns_indices)
+				free(primitive.indices);
+			primitive.indices = primitive_indices;
+			primitive.index_byte_size = index_byte_size;
+			primitive.owns_indices = true;
+		}
+
+		if (stats)
+		{
+			stats->acmr_after = CalculateACMR(mesh, index_lists, vertex_data.num_vertices, kMeshOptimiserCacheSize);
+			stats->bytes_after = MeshBytes(mesh);
+		}
+
+		return true;
+	}
+}
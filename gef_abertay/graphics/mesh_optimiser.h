@@ -0,0 +1,89 @@
+#ifndef _GEF_MESH_OPTIMISER_H
+#define _GEF_MESH_OPTIMISER_H
+
+#include <gef.h>
+#include <vector>
+#include <cstddef>
+
+namespace gef
+{
+	struct MeshData;
+
+	/// @brief The size of the post-transform vertex cache the optimiser orders triangles for, and ACMR is measured with.
+	static const Int32 kMeshOptimiserCacheSize = 16;
+
+	/// @brief Which passes OptimiseMesh runs.
+	struct MeshOptimiserSettings
+	{
+		MeshOptimiserSettings() :
+			optimise_vertex_cache(true),
+			optimise_overdraw(true),
+			optimise_vertex_fetch(true),
+			compact_indices(true),
+			overdraw_threshold(1.05f)
+		{
+		}
+
+		bool optimise_vertex_cache;		// reorder triangles so their vertices are reused from the post-transform cache
+		bool optimise_overdraw;			// then reorder clusters of triangles so those facing out of the mesh are drawn first
+		bool optimise_vertex_fetch;		// reorder vertices into the order they're first used, dropping any that aren't
+		bool compact_indices;			// use 16 bit indices when every vertex can be indexed with them
+		float overdraw_threshold;		// how much worse the ACMR of a cluster may get to let clusters be smaller and sorted more finely
+	};
+
+	/// @brief How a mesh changed in OptimiseMesh.
+	struct MeshOptimiserStats
+	{
+		MeshOptimiserStats() :
+			acmr_before(0.0f),
+			acmr_after(0.0f),
+			bytes_before(0),
+			bytes_after(0)
+		{
+		}
+
+		float acmr_before;		// the average number of vertices transformed per triangle, 0.5 to 3, lower is better
+		float acmr_after;
+		size_t bytes_before;	// the size of the vertices and indices
+		size_t bytes_after;
+	};
+
+	/// @brief Measures the average cache miss ratio of a triangle list, with a FIFO cache of cache_size vertices.
+	/// @return the number of vertices transformed per triangle
+	float CalculateACMR(const UInt32* indices, const Int32 num_indices, const Int32 num_vertices, const Int32 cache_size = kMeshOptimiserCacheSize);
+
+	/// @brief Measures the average cache miss ratio of the triangle list primitives of a mesh.
+	float CalculateACMR(const MeshData& mesh, const Int32 cache_size = kMeshOptimiserCacheSize);
+
+	/// @brief Reorders the triangles of a triangle list for post-transform vertex cache reuse, using Forsyth's linear-speed algorithm.
+	/// @param[in,out] indices	The triangle list, num_indices long.
+	void OptimiseVertexCache(UInt32* indices, const Int32 num_indices, const Int32 num_vertices);
+
+	/// @brief Reorders a cache optimised triangle list to reduce overdraw, keeping most of its cache reuse.
+	/// @note The triangles are split into clusters where the cache reuse allows, and the clusters sorted
+	/// so those facing out from the centre of the mesh are drawn first.
+	/// @param[in] vertices		The mesh's vertices, each starting with its x, y and z position as floats, as Mesh::Vertex and Mesh::SkinnedVertex do.
+	/// @param[in] threshold	How much worse than the whole list's ACMR a cluster's may be, e.g. 1.05.
+	void OptimiseOverdraw(UInt32* indices, const Int32 num_indices, const void* vertices, const Int32 num_vertices, const Int32 vertex_byte_size, const float threshold);
+
+	/// @brief Reorders vertices into the order the indices first use them, so they're fetched from memory in order.
+	/// @param[in,out] vertices		Receives the vertices in their new order. Vertices no index uses are dropped.
+	/// @param[in,out] index_lists	The indices of every primitive that uses the vertices, in the order they're drawn. They're remapped to the new order.
+	/// @return the number of vertices left
+	Int32 OptimiseVertexFetch(void* vertices, const Int32 num_vertices, const Int32 vertex_byte_size, std::vector<std::vector<UInt32> >& index_lists);
+
+	/// @brief Merges vertices that are identical byte for byte, e.g. the corners faces share in an unindexed mesh.
+	/// @param[in,out] vertices		Receives the unique vertices, in the order each was first seen.
+	/// @param[out] indices			Receives an index for each vertex that was passed in, into the unique vertices.
+	/// @return the number of unique vertices
+	Int32 WeldVertices(void* vertices, const Int32 num_vertices, const Int32 vertex_byte_size, std::vector<UInt32>& indices);
+
+	/// @brief Optimises a mesh for drawing. The passes run are set in settings.
+	/// @note Only triangle list primitives are reordered, every primitive is remapped to the new vertex order.
+	/// Meshes read in place from a packed scene are copied, the mesh owns its vertices and indices afterwards.
+	/// @param[out] stats		Optional, receives the mesh's ACMR and size before and after.
+	/// @return false if the mesh has indices that aren't 16 or 32 bit, which are left alone
+	bool OptimiseMesh(MeshData& mesh, const MeshOptimiserSettings& settings = MeshOptimiserSettings(), MeshOptimiserStats* stats = NULL);
+}
+
+#endif // _GEF_MESH_OPTIMISER_H
@@ -0,0 +1,561 @@
+#include <graphics/packed_scene.h>
+#include <graphics/mesh_data.h>
+#include <animation/skeleton.h>
+#include <animation/animation.h>
+#include <system/memory_stream_buffer.h>
+#include <sstream>
+#include <cstring>
+
+namespace gef
+{
+	// chunks, and the vertex and index blobs in them, start on this boundary, so they can be loaded with aligned SIMD reads or DMA'd straight to the GPU
+	static const UInt32 kPackedBlobAlignment = 16;
+
+	// appends to the file or chunk being built, returning the offset the bytes were written at
+	static UInt32 Append(std::vector<char>& file, const void* data, const size_t size)
+	{
+		const UInt32 offset = (UInt32)file.size();
+		if (size > 0)
+			file.insert(file.end(), static_cast<const char*>(data), static_cast<const char*>(data) + size);
+		return offset;
+	}
+
+	static UInt32 Reserve(std::vector<char>& file, const size_t size)
+	{
+		const UInt32 offset = (UInt32)file.size();
+		file.resize(file.size() + size, 0);
+		return offset;
+	}
+
+	static void Align(std::vector<char>& file)
+	{
+		file.resize((file.size() + kPackedBlobAlignment - 1) & ~(size_t)(kPackedBlobAlignment - 1), 0);
+	}
+
+	// tables are reserved before the elements they point to are appended, so they're written back once filled in
+	template<class T> static void Patch(std::vector<char>& file, const UInt32 offset, const T& value)
+	{
+		memcpy(&file[offset], &value, sizeof(T));
+	}
+
+	static void WriteMaterialChunk(const MaterialData& material, std::vector<char>& chunk)
+	{
+		PackedMaterialData packed_material;
+		packed_material.name_id = material.name_id;
+		packed_material.diffuse_texture_offset = sizeof(PackedMaterialData);
+		Append(chunk, &packed_material, sizeof(PackedMaterialData));
+		Append(chunk, material.diffuse_texture.c_str(), material.diffuse_texture.length() + 1);
+	}
+
+	// the mesh, then its primitives, its vertices and the indices of each primitive
+	static void WriteMeshChunk(const MeshData& mesh, std::vector<char>& chunk)
+	{
+		PackedMeshData packed_mesh;
+		packed_mesh.name_id = mesh.name_id;
+		packed_mesh.primitive_count = (Int32)mesh.primitives.size();
+		packed_mesh.num_vertices = mesh.vertex_data.num_vertices;
+		packed_mesh.vertex_byte_size = mesh.vertex_data.vertex_byte_size;
+		for (Int32 axis = 0; axis < 3; ++axis)
+		{
+			packed_mesh.aabb_min[axis] = mesh.aabb.min_vtx()[axis];
+			packed_mesh.aabb_max[axis] = mesh.aabb.max_vtx()[axis];
+		}
+		Reserve(chunk, sizeof(PackedMeshData));
+
+		Align(chunk);
+		packed_mesh.primitives_offset = Reserve(chunk, mesh.primitives.size()*sizeof(PackedPrimitiveData));
+
+		Align(chunk);
+		packed_mesh.vertices_offset = Append(chunk, mesh.vertex_data.vertices, (size_t)mesh.vertex_data.num_vertices*mesh.vertex_data.vertex_byte_size);
+
+		for (size_t primitive_num = 0; primitive_num < mesh.primitives.size(); ++primitive_num)
+		{
+			const PrimitiveData& primitive = *mesh.primitives[primitive_num];
+			PackedPrimitiveData packed_primitive;
+			packed_primitive.material_name_id = primitive.material_name_id;
+			packed_primitive.type = (Int32)primitive.type;
+			packed_primitive.num_indices = primitive.num_indices;
+			packed_primitive.index_byte_size = primitive.index_byte_size;
+
+			Align(chunk);
+			packed_primitive.indices_offset = Append(chunk, primitive.indices, (size_t)primitive.num_indices*primitive.index_byte_size);
+			Patch(chunk, packed_mesh.primitives_offset + (UInt32)(primitive_num*sizeof(PackedPrimitiveData)), packed_primitive);
+		}
+
+		Patch(chunk, 0, packed_mesh);
+	}
+
+	template<class T> static void WriteStreamChunk(const T& element, std::vector<char>& chunk)
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		element.Write(stream);
+		const std::string bytes = stream.str();
+		Append(chunk, bytes.data(), bytes.size());
+	}
+
+	// appends a chunk to the file and fills in its table of contents entry
+	static void AppendChunk(std::vector<char>& file, const UInt32 chunks_offset, const Int32 chunk_index, const PackedChunkType type, const StringId name_id, const std::vector<char>& chunk)
+	{
+		Align(file);
+		PackedSceneChunk packed_chunk;
+		packed_chunk.type = type;
+		packed_chunk.name_id = name_id;
+		packed_chunk.offset = Append(file, chunk.empty() ? NULL : &chunk[0], chunk.size());
+		packed_chunk.size = (UInt32)chunk.size();
+		Patch(file, chunks_offset + (UInt32)(chunk_index*sizeof(PackedSceneChunk)), packed_chunk);
+	}
+
+	// the checks on a chunk's contents, offsets are from the start of the chunk
+	static bool InChunk(const UInt32 chunk_size, const UInt32 offset, const UInt32 size)
+	{
+		return offset <= chunk_size && size <= chunk_size - offset;
+	}
+
+	static bool InChunk(const UInt32 chunk_size, const UInt32 offset, const Int32 count, const UInt32 element_size)
+	{
+		return count >= 0 && (UInt64)count*element_size <= chunk_size && InChunk(chunk_size, offset, (UInt32)count*element_size);
+	}
+
+	// reads a material whose offsets are from base, the start of its chunk or, in a version 2 file, of the file
+	static bool ReadMaterialAt(const UInt8* base, const UInt32 base_size, const UInt32 material_offset, MaterialData& material)
+	{
+		if (!InChunk(base_size, material_offset, sizeof(PackedMaterialData)))
+			return false;
+
+		const PackedMaterialData& packed_material = *reinterpret_cast<const PackedMaterialData*>(base + material_offset);
+		if (!InChunk(base_size, packed_material.diffuse_texture_offset, 1))
+			return false;
+
+		const char* diffuse_texture = reinterpret_cast<const char*>(base + packed_material.diffuse_texture_offset);
+		material.name_id = packed_material.name_id;
+		material.diffuse_texture.assign(diffuse_texture, strnlen(diffuse_texture, base_size - packed_material.diffuse_texture_offset));
+		return true;
+	}
+
+	// reads a mesh in place, its offsets are from base as in ReadMaterialAt
+	static bool ReadMeshAt(const UInt8* base, const UInt32 base_size, const UInt32 mesh_offset, MeshData& mesh)
+	{
+		if (!InChunk(base_size, mesh_offset, sizeof(PackedMeshData)))
+			return false;
+
+		const PackedMeshData& packed_mesh = *reinterpret_cast<const PackedMeshData*>(base + mesh_offset);
+		if (!InChunk(base_size, packed_mesh.primitives_offset, packed_mesh.primitive_count, sizeof(PackedPrimitiveData))
+			|| packed_mesh.vertex_byte_size < 0
+			|| !InChunk(base_size, packed_mesh.vertices_offset, packed_mesh.num_vertices, (UInt32)packed_mesh.vertex_byte_size))
+			return false;
+
+		mesh.name_id = packed_mesh.name_id;
+		mesh.aabb.Update(Vector4(packed_mesh.aabb_min[0], packed_mesh.aabb_min[1], packed_mesh.aabb_min[2]));
+		mesh.aabb.Update(Vector4(packed_mesh.aabb_max[0], packed_mesh.aabb_max[1], packed_mesh.aabb_max[2]));
+
+		mesh.vertex_data.vertices = const_cast<UInt8*>(base + packed_mesh.vertices_offset);
+		mesh.vertex_data.num_vertices = packed_mesh.num_vertices;
+		mesh.vertex_data.vertex_byte_size = packed_mesh.vertex_byte_size;
+		mesh.vertex_data.owns_vertices = false;
+
+		const PackedPrimitiveData* packed_primitives = reinterpret_cast<const PackedPrimitiveData*>(base + packed_mesh.primitives_offset);
+		mesh.primitives.reserve(packed_mesh.primitive_count);
+		for (Int32 primitive_num = 0; primitive_num < packed_mesh.primitive_count; ++primitive_num)
+		{
+			const PackedPrimitiveData& packed_primitive = packed_primitives[primitive_num];
+			if (packed_primitive.index_byte_size < 0
+				|| !InChunk(base_size, packed_primitive.indices_offset, packed_primitive.num_indices, (UInt32)packed_primitive.index_byte_size))
+				return false;
+
+			PrimitiveData* primitive = new PrimitiveData();
+			primitive->material_name_id = packed_primitive.material_name_id;
+			primitive->type = (PrimitiveType)packed_primitive.type;
+			primitive->num_indices = packed_primitive.num_indices;
+			primitive->index_byte_size = packed_primitive.index_byte_size;
+			primitive->indices = const_cast<UInt8*>(base + packed_primitive.indices_offset);
+			primitive->owns_indices = false;
+			mesh.primitives.push_back(primitive);
+		}
+
+		return true;
+	}
+
+	PackedSceneWriter::PackedSceneWriter() :
+		string_id_table_(NULL)
+	{
+	}
+
+	void PackedSceneWriter::AddMaterial(const MaterialData& material)
+	{
+		materials_.push_back(&material);
+	}
+
+	void PackedSceneWriter::AddMesh(const MeshData& mesh)
+	{
+		meshes_.push_back(&mesh);
+	}
+
+	void PackedSceneWriter::AddSkeleton(const Skeleton& skeleton)
+	{
+		skeletons_.push_back(&skeleton);
+	}
+
+	void PackedSceneWriter::AddAnimation(const Animation& animation)
+	{
+		animations_.push_back(&animation);
+	}
+
+	bool PackedSceneWriter::Write(std::ostream& stream) const
+	{
+		std::vector<char> file;
+		PackedSceneHeader header;
+		memset(&header, 0, sizeof(header));
+		header.magic = kPackedSceneMagic;
+		header.version = kPackedSceneVersion;
+		header.material_count = (Int32)materials_.size();
+		header.mesh_count = (Int32)meshes_.size();
+		header.skeleton_count = (Int32)skeletons_.size();
+		header.animation_count = (Int32)animations_.size();
+		Reserve(file, sizeof(header));
+
+		// the table of contents, filled in as the chunks are appended
+		const Int32 chunk_count = header.material_count + header.mesh_count + header.skeleton_count + header.animation_count;
+		header.chunks_offset = Reserve(file, chunk_count*sizeof(PackedSceneChunk));
+
+		// strings
+		if (string_id_table_ && string_id_table_->num_strings() > 0)
+		{
+			header.string_count = string_id_table_->num_strings();
+			header.strings_size = (UInt32)string_id_table_->strings_size();
+			header.strings_offset = Append(file, string_id_table_->strings(), header.strings_size);
+		}
+
+		// a chunk for each element
+		Int32 chunk_index = 0;
+		std::vector<char> chunk;
+		for (size_t material_num = 0; material_num < materials_.size(); ++material_num, ++chunk_index)
+		{
+			chunk.clear();
+			WriteMaterialChunk(*materials_[material_num], chunk);
+			AppendChunk(file, header.chunks_offset, chunk_index, kPackedMaterialChunk, materials_[material_num]->name_id, chunk);
+		}
+
+		for (size_t mesh_num = 0; mesh_num < meshes_.size(); ++mesh_num, ++chunk_index)
+		{
+			chunk.clear();
+			WriteMeshChunk(*meshes_[mesh_num], chunk);
+			AppendChunk(file, header.chunks_offset, chunk_index, kPackedMeshChunk, meshes_[mesh_num]->name_id, chunk);
+		}
+
+		for (size_t skeleton_num = 0; skeleton_num < skeletons_.size(); ++skeleton_num, ++chunk_index)
+		{
+			chunk.clear();
+			WriteStreamChunk(*skeletons_[skeleton_num], chunk);
+			AppendChunk(file, header.chunks_offset, chunk_index, kPackedSkeletonChunk, 0, chunk);
+		}
+
+		for (size_t animation_num = 0; animation_num < animations_.size(); ++animation_num, ++chunk_index)
+		{
+			chunk.clear();
+			WriteStreamChunk(*animations_[animation_num], chunk);
+			AppendChunk(file, header.chunks_offset, chunk_index, kPackedAnimationChunk, animations_[animation_num]->name_id(), chunk);
+		}
+
+		header.file_size = (UInt32)file.size();
+		Patch(file, 0, header);
+
+		stream.write(&file[0], file.size());
+		return !stream.fail();
+	}
+
+
+	PackedSceneReader::PackedSceneReader() :
+		data_(NULL),
+		header_(NULL),
+		chunks_(NULL)
+	{
+		memset(&converted_header_, 0, sizeof(converted_header_));
+		for (Int32 type = 0; type < kNumPackedChunkTypes; ++type)
+		{
+			first_chunks_[type] = 0;
+			chunk_counts_[type] = 0;
+		}
+	}
+
+	bool PackedSceneReader::IsPackedScene(const void* data, const Int32 size)
+	{
+		UInt32 magic = 0;
+		if (data && size >= (Int32)sizeof(PackedSceneHeader))
+			memcpy(&magic, data, sizeof(UInt32));
+		return magic == kPackedSceneMagic;
+	}
+
+	bool PackedSceneReader::Open(const void* data, const Int32 size)
+	{
+		data_ = NULL;
+		header_ = NULL;
+		chunks_ = NULL;
+		converted_chunks_.clear();
+		if (!IsPackedScene(data, size))
+			return false;
+
+		const PackedSceneHeader* header = static_cast<const PackedSceneHeader*>(data);
+		if (header->version == kPackedSceneVersion2)
+			return OpenVersion2(data, size);
+
+		if (header->version != kPackedSceneVersion || header->file_size > (UInt32)size
+			|| header->string_count < 0 || header->material_count < 0 || header->mesh_count < 0
+			|| header->skeleton_count < 0 || header->animation_count < 0)
+			return false;
+
+		data_ = static_cast<const UInt8*>(data);
+		header_ = header;
+		chunks_ = reinterpret_cast<const PackedSceneChunk*>(data_ + header->chunks_offset);
+		chunk_counts_[kPackedMaterialChunk] = header->material_count;
+		chunk_counts_[kPackedMeshChunk] = header->mesh_count;
+		chunk_counts_[kPackedSkeletonChunk] = header->skeleton_count;
+		chunk_counts_[kPackedAnimationChunk] = header->animation_count;
+
+		// every chunk has to be in the file and in type order, what's in them is checked as they're read
+		const UInt64 chunk_count = (UInt64)header->material_count + header->mesh_count + header->skeleton_count + header->animation_count;
+		bool valid = InFile(header->strings_offset, header->strings_size)
+			&& chunk_count*sizeof(PackedSceneChunk) <= header->file_size
+			&& InFile(header->chunks_offset, (UInt32)chunk_count*sizeof(PackedSceneChunk));
+
+		Int32 chunk_index = 0;
+		for (Int32 type = 0; type < kNumPackedChunkTypes && valid; ++type)
+		{
+			first_chunks_[type] = chunk_index;
+			for (Int32 element_num = 0; element_num < chunk_counts_[type] && valid; ++element_num, ++chunk_index)
+			{
+				const PackedSceneChunk& chunk = chunks_[chunk_index];
+				valid = chunk.type == (UInt32)type && InFile(chunk.offset, chunk.size);
+			}
+		}
+
+		if (!valid)
+		{
+			data_ = NULL;
+			header_ = NULL;
+			chunks_ = NULL;
+			return false;
+		}
+
+		return true;
+	}
+
+	bool PackedSceneReader::OpenVersion2(const void* data, const Int32 size)
+	{
+		if (size < (Int32)sizeof(PackedSceneHeaderV2))
+			return false;
+
+		const PackedSceneHeaderV2& header = *static_cast<const PackedSceneHeaderV2*>(data);
+		if (header.file_size > (UInt32)size
+			|| !InChunk(header.file_size, header.strings_offset, header.strings_size)
+			|| header.string_count < 0
+			|| !InChunk(header.file_size, header.materials_offset, header.material_count, sizeof(PackedMaterialData))
+			|| !InChunk(header.file_size, header.meshes_offset, header.mesh_count, sizeof(PackedMeshData))
+			|| !InChunk(header.file_size, header.skeletons_offset, header.skeleton_count, sizeof(PackedBlob))
+			|| !InChunk(header.file_size, header.animations_offset, header.animation_count, sizeof(PackedBlob)))
+			return false;
+
+		const UInt8* file = static_cast<const UInt8*>(data);
+		const PackedMaterialData* materials = reinterpret_cast<const PackedMaterialData*>(file + header.materials_offset);
+		const PackedMeshData* meshes = reinterpret_cast<const PackedMeshData*>(file + header.meshes_offset);
+		const PackedBlob* skeletons = reinterpret_cast<const PackedBlob*>(file + header.skeletons_offset);
+		const PackedBlob* animations = reinterpret_cast<const PackedBlob*>(file + header.animations_offset);
+
+		// the table of contents, a material or mesh entry covers its table entry, a skeleton or animation entry its blob
+		converted_chunks_.reserve((size_t)header.material_count + header.mesh_count + header.skeleton_count + header.animation_count);
+		for (Int32 material_num = 0; material_num < header.material_count; ++material_num)
+		{
+			PackedSceneChunk chunk;
+			chunk.type = kPackedMaterialChunk;
+			chunk.name_id = materials[material_num].name_id;
+			chunk.offset = header.materials_offset + (UInt32)(material_num*sizeof(PackedMaterialData));
+			chunk.size = sizeof(PackedMaterialData);
+			converted_chunks_.push_back(chunk);
+		}
+
+		for (Int32 mesh_num = 0; mesh_num < header.mesh_count; ++mesh_num)
+		{
+			PackedSceneChunk chunk;
+			chunk.type = kPackedMeshChunk;
+			chunk.name_id = meshes[mesh_num].name_id;
+			chunk.offset = header.meshes_offset + (UInt32)(mesh_num*sizeof(PackedMeshData));
+			chunk.size = sizeof(PackedMeshData);
+			converted_chunks_.push_back(chunk);
+		}
+
+		bool valid = true;
+		for (Int32 skeleton_num = 0; skeleton_num < header.skeleton_count && valid; ++skeleton_num)
+		{
+			PackedSceneChunk chunk;
+			chunk.type = kPackedSkeletonChunk;
+			chunk.name_id = 0;
+			chunk.offset = skeletons[skeleton_num].offset;
+			chunk.size = skeletons[skeleton_num].size;
+			valid = InChunk(header.file_size, chunk.offset, chunk.size);
+			converted_chunks_.push_back(chunk);
+		}
+
+		for (Int32 animation_num = 0; animation_num < header.animation_count && valid; ++animation_num)
+		{
+			PackedSceneChunk chunk;
+			chunk.type = kPackedAnimationChunk;
+			chunk.offset = animations[animation_num].offset;
+			chunk.size = animations[animation_num].size;
+			valid = InChunk(header.file_size, chunk.offset, chunk.size) && chunk.size >= sizeof(StringId);
+
+			// Animation::Write starts with the animation's name
+			chunk.name_id = 0;
+			if (valid)
+				memcpy(&chunk.name_id, file + chunk.offset, sizeof(StringId));
+			converted_chunks_.push_back(chunk);
+		}
+
+		if (!valid)
+		{
+			converted_chunks_.clear();
+			return false;
+		}
+
+		memset(&converted_header_, 0, sizeof(converted_header_));
+		converted_header_.magic = header.magic;
+		converted_header_.version = header.version;
+		converted_header_.file_size = header.file_size;
+		converted_header_.string_count = header.string_count;
+		converted_header_.strings_offset = header.strings_offset;
+		converted_header_.strings_size = header.strings_size;
+		converted_header_.material_count = header.material_count;
+		converted_header_.mesh_count = header.mesh_count;
+		converted_header_.skeleton_count = header.skeleton_count;
+		converted_header_.animation_count = header.animation_count;
+
+		data_ = file;
+		header_ = &converted_header_;
+		chunks_ = converted_chunks_.empty() ? NULL : &converted_chunks_[0];
+		chunk_counts_[kPackedMaterialChunk] = header.material_count;
+		chunk_counts_[kPackedMeshChunk] = header.mesh_count;
+		chunk_counts_[kPackedSkeletonChunk] = header.skeleton_count;
+		chunk_counts_[kPackedAnimationChunk] = header.animation_count;
+
+		Int32 chunk_index = 0;
+		for (Int32 type = 0; type < kNumPackedChunkTypes; ++type)
+		{
+			first_chunks_[type] = chunk_index;
+			chunk_index += chunk_counts_[type];
+		}
+
+		return true;
+	}
+
+	bool PackedSceneReader::InFile(const UInt32 offset, const UInt32 size) const
+	{
+		return InChunk(header_->file_size, offset, size);
+	}
+
+	void PackedSceneReader::ReadStrings(StringIdTable& string_id_table) const
+	{
+		if (!header_ || header_->strings_size == 0)
+			return;
+
+		const char* strings = reinterpret_cast<const char*>(data_ + header_->strings_offset);
+		const char* strings_end = strings + header_->strings_size;
+		for (Int32 string_num = 0; string_num < header_->string_count && strings < strings_end; ++string_num)
+		{
+			const size_t length = strnlen(strings, strings_end - strings);
+			string_id_table.Add(std::string(strings, length));
+			strings += length + 1;
+		}
+	}
+
+	Int32 PackedSceneReader::Find(const PackedChunkType type, const StringId name_id) const
+	{
+		if (!header_ || type < 0 || type >= kNumPackedChunkTypes)
+			return -1;
+
+		const PackedSceneChunk* chunks = chunks_ + first_chunks_[type];
+		for (Int32 element_num = 0; element_num < chunk_counts_[type]; ++element_num)
+		{
+			if (chunks[element_num].name_id == name_id)
+				return element_num;
+		}
+		return -1;
+	}
+
+	const PackedSceneChunk* PackedSceneReader::GetChunk(const PackedChunkType type, const Int32 index) const
+	{
+		if (!header_ || type < 0 || type >= kNumPackedChunkTypes || index < 0 || index >= chunk_counts_[type])
+			return NULL;
+
+		return &chunks_[first_chunks_[type] + index];
+	}
+
+	const UInt8* PackedSceneReader::ChunkData(const PackedChunkType type, const Int32 index, UInt32& chunk_size) const
+	{
+		const PackedSceneChunk* chunk = GetChunk(type, index);
+		if (!chunk)
+			return NULL;
+
+		chunk_size = chunk->size;
+		return data_ + chunk->offset;
+	}
+
+	bool PackedSceneReader::ReadMaterial(const Int32 material_index, MaterialData& material) const
+	{
+		const PackedSceneChunk* chunk = GetChunk(kPackedMaterialChunk, material_index);
+		if (!chunk)
+			return false;
+
+		// the offsets in a version 2 material are from the start of the file
+		if (header_->version == kPackedSceneVersion2)
+			return ReadMaterialAt(data_, header_->file_size, chunk->offset, material);
+		return ReadMaterialAt(data_ + chunk->offset, chunk->size, 0, material);
+	}
+
+	bool PackedSceneReader::ReadMesh(const Int32 mesh_index, MeshData& mesh) const
+	{
+		const PackedSceneChunk* chunk = GetChunk(kPackedMeshChunk, mesh_index);
+		if (!chunk)
+			return false;
+
+		if (header_->version == kPackedSceneVersion2)
+			return ReadMeshAt(data_, header_->file_size, chunk->offset, mesh);
+		return ReadMeshAt(data_ + chunk->offset, chunk->size, 0, mesh);
+	}
+
+	bool PackedSceneReader::ReadSkeleton(const Int32 skeleton_index, Skeleton& skeleton) const
+	{
+		UInt32 chunk_size = 0;
+		const UInt8* chunk_data = ChunkData(kPackedSkeletonChunk, skeleton_index, chunk_size);
+		return chunk_data && ReadSkeletonChunk(chunk_data, chunk_size, skeleton);
+	}
+
+	bool PackedSceneReader::ReadAnimation(const Int32 animation_index, Animation& animation) const
+	{
+		UInt32 chunk_size = 0;
+		const UInt8* chunk_data = ChunkData(kPackedAnimationChunk, animation_index, chunk_size);
+		return chunk_data && ReadAnimationChunk(chunk_data, chunk_size, animation);
+	}
+
+	bool PackedSceneReader::ReadMaterialChunk(const void* chunk_data, const UInt32 chunk_size, MaterialData& material)
+	{
+		return ReadMaterialAt(static_cast<const UInt8*>(chunk_data), chunk_size, 0, material);
+	}
+
+	bool PackedSceneReader::ReadMeshChunk(const void* chunk_data, const UInt32 chunk_size, MeshData& mesh)
+	{
+		return ReadMeshAt(static_cast<const UInt8*>(chunk_data), chunk_size, 0, mesh);
+	}
+
+	bool PackedSceneReader::ReadSkeletonChunk(const void* chunk_data, const UInt32 chunk_size, Skeleton& skeleton)
+	{
+		// the stream only reads from the chunk
+		MemoryStreamBuffer stream_buffer((char*)chunk_data, chunk_size);
+		std::istream stream(&stream_buffer);
+		return skeleton.Read(stream) && !stream.fail();
+	}
+
+	bool PackedSceneReader::ReadAnimationChunk(const void* chunk_data, const UInt32 chunk_size, Animation& animation)
+	{
+		MemoryStreamBuffer stream_buffer((char*)chunk_data, chunk_size);
+		std::istream stream(&stream_buffer);
+		return animation.Read(stream) && !stream.fail();
+	}
+}
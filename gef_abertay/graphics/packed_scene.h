@@ -0,0 +1,230 @@
+#ifndef _GEF_PACKED_SCENE_H
+#define _GEF_PACKED_SCENE_H
+
+#include <gef.h>
+#include <system/string_id.h>
+#include <ostream>
+#include <vector>
+
+namespace gef
+{
+	struct MaterialData;
+	struct MeshData;
+	class Skeleton;
+	class Animation;
+
+	/// @brief The header at the start of a packed .scn file.
+	/// @note A packed scene is laid out so it can be mapped into memory and used in place. Every material,
+	/// mesh, skeleton and animation is a chunk of its own, listed in a table of contents after the header,
+	/// so one element can be read without reading or parsing anything else in the file.
+	/// Chunks start on a 16 byte boundary and everything inside a chunk is found by byte offsets from the
+	/// start of the chunk, so a chunk can be used in place in a mapped file, or read on its own with a seek
+	/// into any 16 byte aligned buffer. Every vertex and index blob is 16 byte aligned too, so meshes can be
+	/// created straight from the chunk.
+	/// Skeletons and animations are kept in the stream format of Skeleton::Write and Animation::Write,
+	/// as they are rebuilt into their own objects when read.
+	/// Files written by Scene::WriteScene have no header, they start with the mesh count.
+	struct PackedSceneHeader
+	{
+		UInt32 magic;				// kPackedSceneMagic
+		UInt32 version;				// kPackedSceneVersion
+		UInt32 file_size;
+		Int32 string_count;
+		UInt32 strings_offset;		// every string null terminated, one after another, as StringIdTable::strings
+		UInt32 strings_size;
+		Int32 material_count;
+		Int32 mesh_count;
+		Int32 skeleton_count;
+		Int32 animation_count;
+		UInt32 chunks_offset;		// the table of contents, a PackedSceneChunk for each element, in PackedChunkType order
+	};
+
+	/// @brief "GSCN" as read from the start of a file.
+	static const UInt32 kPackedSceneMagic = 0x4e435347;
+
+	/// @brief Files written by Scene::WriteScene are version 1.
+	static const UInt32 kPackedSceneVersion = 3;
+
+	/// @brief Version 2 had a table for each type of element instead of a table of contents, see PackedSceneHeaderV2.
+	/// It's still read, but can't be written.
+	static const UInt32 kPackedSceneVersion2 = 2;
+
+	enum PackedChunkType
+	{
+		kPackedMaterialChunk = 0,	// a PackedMaterialData, then its texture filename
+		kPackedMeshChunk,			// a PackedMeshData, then its primitives, vertices and indices
+		kPackedSkeletonChunk,		// the stream format of Skeleton::Write
+		kPackedAnimationChunk,		// the stream format of Animation::Write
+		kNumPackedChunkTypes
+	};
+
+	/// @brief An entry in the table of contents of a packed scene.
+	struct PackedSceneChunk
+	{
+		UInt32 type;				// PackedChunkType
+		StringId name_id;			// the name of the material, mesh or animation, skeletons have no name
+		UInt32 offset;				// from the start of the file, a multiple of 16
+		UInt32 size;
+	};
+
+	/// @brief The header of a version 2 packed scene, as written by fbx2scn -packed before the table of contents.
+	/// @note The materials and meshes are tables of PackedMaterialData and PackedMeshData, skeletons and animations
+	/// tables of PackedBlob. Every offset, including those in the tables, is from the start of the file.
+	struct PackedSceneHeaderV2
+	{
+		UInt32 magic;				// kPackedSceneMagic
+		UInt32 version;				// kPackedSceneVersion2
+		UInt32 file_size;
+		Int32 string_count;
+		UInt32 strings_offset;
+		UInt32 strings_size;
+		Int32 material_count;
+		UInt32 materials_offset;	// material_count PackedMaterialData
+		Int32 mesh_count;
+		UInt32 meshes_offset;		// mesh_count PackedMeshData
+		Int32 skeleton_count;
+		UInt32 skeletons_offset;	// skeleton_count PackedBlob
+		Int32 animation_count;
+		UInt32 animations_offset;	// animation_count PackedBlob
+	};
+
+	/// @brief A range of bytes in a version 2 packed scene.
+	struct PackedBlob
+	{
+		UInt32 offset;
+		UInt32 size;
+	};
+
+	// offsets in the chunk structures are from the start of their chunk
+
+	struct PackedMaterialData
+	{
+		StringId name_id;
+		UInt32 diffuse_texture_offset;		// a null terminated string
+	};
+
+	struct PackedPrimitiveData
+	{
+		StringId material_name_id;
+		Int32 type;							// PrimitiveType
+		Int32 num_indices;
+		Int32 index_byte_size;
+		UInt32 indices_offset;
+	};
+
+	struct PackedMeshData
+	{
+		StringId name_id;
+		Int32 primitive_count;
+		UInt32 primitives_offset;			// primitive_count PackedPrimitiveData
+		Int32 num_vertices;
+		Int32 vertex_byte_size;
+		UInt32 vertices_offset;
+		float aabb_min[3];
+		float aabb_max[3];
+	};
+
+	/// @brief Lays out the elements of a scene as a packed .scn file, see PackedSceneHeader.
+	/// @note The writer only keeps pointers to the elements, they must stay valid until the scene is written.
+	class PackedSceneWriter
+	{
+	public:
+		PackedSceneWriter();
+
+		inline void set_string_id_table(const StringIdTable* string_id_table) { string_id_table_ = string_id_table; }
+		void AddMaterial(const MaterialData& material);
+		void AddMesh(const MeshData& mesh);
+		void AddSkeleton(const Skeleton& skeleton);
+		void AddAnimation(const Animation& animation);
+
+		/// @brief Writes the packed scene.
+		/// @return true if the scene was written
+		bool Write(std::ostream& stream) const;
+
+	private:
+		const StringIdTable* string_id_table_;
+		std::vector<const MaterialData*> materials_;
+		std::vector<const MeshData*> meshes_;
+		std::vector<const Skeleton*> skeletons_;
+		std::vector<const Animation*> animations_;
+	};
+
+	/// @brief Reads the elements of a packed .scn file that is already in memory, e.g. mapped with MappedFile.
+	/// @note Meshes are read in place, their vertices and indices point into the file data and are not owned
+	/// by the MeshData, so the file data must stay valid for as long as the meshes are used.
+	/// Reading one element only touches the header, the table of contents and the element's chunk,
+	/// so only those pages of a mapped file are read from disk.
+	class PackedSceneReader
+	{
+	public:
+		PackedSceneReader();
+
+		/// @return true if the data starts with the header of a packed scene
+		static bool IsPackedScene(const void* data, const Int32 size);
+
+		/// @brief Checks the header and the table of contents of a packed scene.
+		/// @param[in] data		The contents of the file.
+		/// @param[in] size		The size of the file in bytes.
+		/// @note A version 2 file is read through a table of contents built from its tables.
+		/// @return false if the data isn't a packed scene of a version this reader understands, or it is truncated
+		bool Open(const void* data, const Int32 size);
+
+		/// @brief Adds the strings of the scene to a table.
+		void ReadStrings(StringIdTable& string_id_table) const;
+
+		/// @brief Finds an element by name in the table of contents.
+		/// @return the index of the first element of the type with the name, among those of its type, or -1 if there isn't one
+		Int32 Find(const PackedChunkType type, const StringId name_id) const;
+
+		/// @return the table of contents entry of an element, or NULL if the index is out of range
+		/// @note In a version 2 file the entry of a material or mesh only covers its PackedMaterialData or PackedMeshData,
+		/// whose offsets are from the start of the file, so only skeletons and animations can be read from a chunk on their own.
+		const PackedSceneChunk* GetChunk(const PackedChunkType type, const Int32 index) const;
+
+		/// @brief Reads a material. The texture filename is copied.
+		bool ReadMaterial(const Int32 material_index, MaterialData& material) const;
+
+		/// @brief Reads a mesh in place. The mesh must be empty.
+		/// @return false if the mesh's data lies outside its chunk
+		bool ReadMesh(const Int32 mesh_index, MeshData& mesh) const;
+
+		/// @brief Reads a skeleton from its chunk.
+		bool ReadSkeleton(const Int32 skeleton_index, Skeleton& skeleton) const;
+
+		/// @brief Reads an animation from its chunk.
+		bool ReadAnimation(const Int32 animation_index, Animation& animation) const;
+
+		/// @brief Read an element from a chunk on its own, e.g. read from the file with a seek to its table of contents entry.
+		/// @param[in] chunk_data	The chunk, 16 byte aligned for the vertices and indices of a mesh to be aligned.
+		/// @param[in] chunk_size	The size of the chunk from its table of contents entry.
+		static bool ReadMaterialChunk(const void* chunk_data, const UInt32 chunk_size, MaterialData& material);
+		static bool ReadMeshChunk(const void* chunk_data, const UInt32 chunk_size, MeshData& mesh);
+		static bool ReadSkeletonChunk(const void* chunk_data, const UInt32 chunk_size, Skeleton& skeleton);
+		static bool ReadAnimationChunk(const void* chunk_data, const UInt32 chunk_size, Animation& animation);
+
+		inline Int32 material_count() const { return header_ ? header_->material_count : 0; }
+		inline Int32 mesh_count() const { return header_ ? header_->mesh_count : 0; }
+		inline Int32 skeleton_count() const { return header_ ? header_->skeleton_count : 0; }
+		inline Int32 animation_count() const { return header_ ? header_->animation_count : 0; }
+		inline Int32 chunk_count() const { return material_count() + mesh_count() + skeleton_count() + animation_count(); }
+
+	private:
+		PackedSceneReader(const PackedSceneReader&);
+		PackedSceneReader& operator=(const PackedSceneReader&);
+
+		bool OpenVersion2(const void* data, const Int32 size);
+		bool InFile(const UInt32 offset, const UInt32 size) const;
+		const UInt8* ChunkData(const PackedChunkType type, const Int32 index, UInt32& chunk_size) const;
+
+		const UInt8* data_;
+		const PackedSceneHeader* header_;
+		const PackedSceneChunk* chunks_;
+		Int32 first_chunks_[kNumPackedChunkTypes];	// the table of contents index of the first element of each type
+		Int32 chunk_counts_[kNumPackedChunkTypes];
+
+		PackedSceneHeader converted_header_;				// the header of a version 2 file in the current layout
+		std::vector<PackedSceneChunk> converted_chunks_;	// the table of contents of a version 2 file, built from its tables
+	};
+}
+
+#endif // _GEF_PACKED_SCENE_H
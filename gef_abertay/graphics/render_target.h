@@ -8,6 +8,13 @@ namespace gef
 	class Texture;
 	class Platform;
 
+	/// @brief The format of the pixels of a render target.
+	enum RenderTargetFormat
+	{
+		kRenderTargetFloat,		// 32 bit float per channel, for render targets holding data such as shadow map depths
+		kRenderTargetRGBA8		// 8 bit per channel, for render targets holding colours
+	};
+
 	class RenderTarget
 	{
 	public:
@@ -20,7 +27,8 @@ namespace gef
 		inline Int32 height() const { return height_; }
 		inline const Texture* texture() const { return texture_; }
 
-		static RenderTarget* Create(const Platform& platform, const Int32 width, const Int32 height);
+		/// @note format is only used on platforms with a choice, the Vita's render targets are always RGBA8
+		static RenderTarget* Create(const Platform& platform, const Int32 width, const Int32 height, const RenderTargetFormat format = kRenderTargetFloat);
 	protected:
 		RenderTarget(const Platform& platform, const Int32 width, const Int32 height);
 		Int32 width_;
@@ -34,22 +34,29 @@ namespace gef
 		Shader* previous_shader = shader_;
 		if(use_default_shader)
 		{
-			// copy lighting from default shader data
-			// GRC FIXME need to separate light data out
-			// so we don't need to do this
-			default_skinned_mesh_shader_data_.CleanUp();
+			// the lights are read straight from the default shader data
+			SetShader(&default_skinned_mesh_shader_);
 
-			for(Int32 light_num=0;light_num<default_shader_data_.GetNumPointLights();++light_num)
-			{
-				default_skinned_mesh_shader_data_.AddPointLight(default_shader_data_.GetPointLight(light_num));
-			}
-			default_skinned_mesh_shader_data_.set_ambient_light_colour(default_shader_data_.ambient_light_colour());
+			default_skinned_mesh_shader_.SetSceneData(default_shader_data_, view_matrix_, projection_matrix_);
+			if(!bone_matrices.empty())
+				default_skinned_mesh_shader_.SetBoneMatrices(&bone_matrices[0], (Int32)bone_matrices.size());
+		}
 
-			default_skinned_mesh_shader_data_.set_bone_matrices(&bone_matrices);
+		DrawMesh(mesh_instance);
 
+		if(use_default_shader)
+			SetShader(previous_shader);
+	}
+
+	void Renderer3D::DrawSkinnedMesh(const MeshInstance& mesh_instance, const Matrix44* bone_palette, const Int32 bone_count, bool use_default_shader)
+	{
+		Shader* previous_shader = shader_;
+		if(use_default_shader)
+		{
 			SetShader(&default_skinned_mesh_shader_);
 
-			default_skinned_mesh_shader_.SetSceneData(default_skinned_mesh_shader_data_, view_matrix_, projection_matrix_);
+			default_skinned_mesh_shader_.SetSceneData(default_shader_data_, view_matrix_, projection_matrix_);
+			default_skinned_mesh_shader_.SetBonePalette(bone_palette, bone_count);
 		}
 
 		DrawMesh(mesh_instance);
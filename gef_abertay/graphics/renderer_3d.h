@@ -45,6 +45,11 @@ namespace gef
 		virtual void SetFillMode(FillMode fill_mode) = 0;
 		virtual void SetDepthTest(DepthTest depth_test) = 0;
 		void DrawSkinnedMesh(const  MeshInstance& mesh_instance, const std::vector<Matrix44>& bone_matrices, bool use_default_shader = true);
+
+		/// @brief Draws a skinned mesh with bone matrices that are already transposed for the skinning shader.
+		/// @param[in] bone_palette		Array of bone_count matrices, e.g. from SkeletonPoseSoA::CalculateSkinningPalette.
+		/// @note The palette is uploaded without being copied or transposed again.
+		void DrawSkinnedMesh(const  MeshInstance& mesh_instance, const Matrix44* bone_palette, const Int32 bone_count, bool use_default_shader = true);
 		void SetShader( Shader* shader);
 
 
@@ -77,7 +82,6 @@ namespace gef
 		Default3DShader default_shader_;
 		Default3DSkinningShader default_skinned_mesh_shader_;
 		Default3DShaderData default_shader_data_;
-		SkinnedMeshShaderData default_skinned_mesh_shader_data_;
 		const Material* override_material_;
 
 		Platform& platform_;
@@ -8,11 +8,13 @@
 #include <graphics/image_data.h>
 #include <assets/png_loader.h>
 #include <graphics/material.h>
+#include <graphics/packed_scene.h>
 
-#include <system/file.h>
 #include <system/memory_stream_buffer.h>
 #include <fstream>
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
 
 namespace gef
 {
@@ -77,6 +79,30 @@ namespace gef
 	}
 
 	void Scene::CreateMaterials(const Platform& platform)
+	{
+		std::map<gef::StringId, ImageData> images;
+		ReadMaterialImages(platform, images);
+		CreateMaterials(platform, images);
+	}
+
+	void Scene::ReadMaterialImages(const Platform& platform, std::map<gef::StringId, ImageData>& images) const
+	{
+		PNGLoader png_loader;
+		for(std::list<MaterialData>::const_iterator materialIter = material_data.begin();materialIter!=material_data.end();++materialIter)
+		{
+			if(materialIter->diffuse_texture != "")
+			{
+				gef::StringId texture_name_id = gef::GetStringId(materialIter->diffuse_texture);
+				if(images.find(texture_name_id) == images.end())
+				{
+					// the image is decoded in place, image data can't be copied
+					png_loader.Load(materialIter->diffuse_texture.c_str(), platform, images[texture_name_id]);
+				}
+			}
+		}
+	}
+
+	void Scene::CreateMaterials(const Platform& platform, const std::map<gef::StringId, ImageData>& images)
 	{
 
 		// go through all the materials and create new textures for them
@@ -93,12 +119,10 @@ namespace gef
 				{
 					string_id_table.Add(materialIter->diffuse_texture);
 
-					ImageData image_data;
-					PNGLoader png_loader;
-					png_loader.Load(materialIter->diffuse_texture.c_str(), platform, image_data);
-					if(image_data.image() != NULL)
+					std::map<gef::StringId, ImageData>::const_iterator image = images.find(texture_name_id);
+					if(image != images.end() && image->second.image() != NULL)
 					{
-						Texture* texture = Texture::Create(platform, image_data);
+						Texture* texture = Texture::Create(platform, image->second);
 						textures.push_back(texture);
 						textures_map[texture_name_id] = texture;
 						material->set_texture(texture);
@@ -130,44 +154,163 @@ namespace gef
 
 	bool Scene::ReadSceneFromFile(const Platform& platform, const char* filename)
 	{
-		bool success = true;
-		void* file_data = NULL;
-		File* file = gef::File::Create();
-		Int32 file_size;
+		// opening another file unmaps the last one, so meshes read in place from it need copies of their own
+		if(mapped_file_.data() && !CopyMappedMeshes())
+			return false;
 
-		success = file->Open(filename);
+		bool success = mapped_file_.Open(filename);
 		if(success)
 		{
-			success = file->GetSize(file_size);
-			if(success)
+			if(PackedSceneReader::IsPackedScene(mapped_file_.data(), mapped_file_.size()))
 			{
-				file_data = malloc(file_size);
-				success = file_data != NULL;
+				// the meshes are used in place, so the file stays mapped
+				PackedSceneReader reader;
+				success = reader.Open(mapped_file_.data(), mapped_file_.size());
 				if(success)
+					success = ReadPackedScene(reader);
+			}
+			else
+			{
+				// the stream only reads from the mapped file
+				gef::MemoryStreamBuffer stream_buffer((char*)mapped_file_.data(), mapped_file_.size());
+
+				std::istream input_stream(&stream_buffer);
+				success = ReadScene(input_stream);
+
+				// everything has been copied out of the file
+				mapped_file_.Close();
+			}
+		}
+		return success;
+	}
+
+	bool Scene::ReadAnimationFromFile(const Platform& platform, const char* filename, const gef::StringId anim_name_id)
+	{
+		MappedFile mapped_file;
+		if(!mapped_file.Open(filename))
+			return false;
+
+		Animation* animation = NULL;
+		if(PackedSceneReader::IsPackedScene(mapped_file.data(), mapped_file.size()))
+		{
+			PackedSceneReader reader;
+			if(reader.Open(mapped_file.data(), mapped_file.size()))
+			{
+				Int32 animation_index = anim_name_id != 0 ? reader.Find(kPackedAnimationChunk, anim_name_id) : 0;
+
+				// the first of the animations map, as a scene written by WriteSceneToFile gives, is the lowest name id
+				for(Int32 chunk_num = 1; anim_name_id == 0 && chunk_num < reader.animation_count(); ++chunk_num)
 				{
-					Int32 bytes_read;
-					success = file->Read(file_data, file_size, bytes_read);
-					if(success)
-						success = bytes_read == file_size;
+					if(reader.GetChunk(kPackedAnimationChunk, chunk_num)->name_id < reader.GetChunk(kPackedAnimationChunk, animation_index)->name_id)
+						animation_index = chunk_num;
 				}
 
-				if(success)
+				if(animation_index >= 0 && animation_index < reader.animation_count())
 				{
-					gef::MemoryStreamBuffer stream_buffer((char*)file_data, file_size);
+					animation = new Animation();
+					if(!reader.ReadAnimation(animation_index, *animation))
+						DeleteNull(animation);
+				}
+			}
+		}
+		else
+		{
+			// the whole scene has to be parsed to get to the animations at the end of it
+			gef::MemoryStreamBuffer stream_buffer((char*)mapped_file.data(), mapped_file.size());
+			std::istream input_stream(&stream_buffer);
+
+			Scene file_scene;
+			if(file_scene.ReadScene(input_stream))
+			{
+				std::map<gef::StringId, Animation*>::iterator animation_iter = anim_name_id != 0 ? file_scene.animations.find(anim_name_id) : file_scene.animations.begin();
+				if(animation_iter != file_scene.animations.end())
+				{
+					animation = animation_iter->second;
+					file_scene.animations.erase(animation_iter);
+				}
+			}
+		}
+
+		if(!animation)
+			return false;
+
+		// an animation that's already been read may be in use, so it's kept rather than replaced
+		if(animations.find(animation->name_id()) != animations.end())
+		{
+			delete animation;
+			return true;
+		}
 
-					std::istream input_stream(&stream_buffer);
-					success = ReadScene(input_stream);
+		// the animation is copied out of the file, so it doesn't need to stay mapped
+		animations[animation->name_id()] = animation;
+		return true;
+	}
 
-					// don't need the font file data any more
-					free(file_data);
-					file_data = NULL;
+	bool Scene::CopyMappedMeshes()
+	{
+		for(std::list<MeshData>::iterator mesh_iter = meshes.begin(); mesh_iter != meshes.end(); ++mesh_iter)
+		{
+			VertexData& vertex_data = mesh_iter->vertex_data;
+			if(!vertex_data.owns_vertices && vertex_data.vertices)
+			{
+				const size_t vertex_bytes = (size_t)vertex_data.num_vertices*vertex_data.vertex_byte_size;
+				void* vertices = malloc(vertex_bytes);
+				if(!vertices)
+					return false;
+				memcpy(vertices, vertex_data.vertices, vertex_bytes);
+				vertex_data.vertices = vertices;
+				vertex_data.owns_vertices = true;
+			}
+
+			for(size_t primitive_num = 0; primitive_num < mesh_iter->primitives.size(); ++primitive_num)
+			{
+				PrimitiveData& primitive = *mesh_iter->primitives[primitive_num];
+				if(!primitive.owns_indices && primitive.indices)
+				{
+					const size_t index_bytes = (size_t)primitive.num_indices*primitive.index_byte_size;
+					void* indices = malloc(index_bytes);
+					if(!indices)
+						return false;
+					memcpy(indices, primitive.indices, index_bytes);
+					primitive.indices = indices;
+					primitive.owns_indices = true;
 				}
+			}
+		}
+		return true;
+	}
 
+	void Scene::OptimiseMeshes(const MeshOptimiserSettings& settings, MeshOptimiserStats* stats)
+	{
+		// the ACMR of the whole scene is weighted by the triangles in each mesh
+		float scene_triangles = 0.0f;
+		MeshOptimiserStats scene_stats;
+		for(std::list<MeshData>::iterator mesh_iter = meshes.begin(); mesh_iter != meshes.end(); ++mesh_iter)
+		{
+			MeshOptimiserStats mesh_stats;
+			if(!OptimiseMesh(*mesh_iter, settings, &mesh_stats))
+				continue;
+
+			float num_triangles = 0.0f;
+			for(std::vector<PrimitiveData*>::const_iterator prim_iter = mesh_iter->primitives.begin(); prim_iter != mesh_iter->primitives.end(); ++prim_iter)
+			{
+				if((*prim_iter)->type == TRIANGLE_LIST)
+					num_triangles += (float)((*prim_iter)->num_indices / 3);
 			}
 
-			file->Close();
+			scene_stats.acmr_before += mesh_stats.acmr_before*num_triangles;
+			scene_stats.acmr_after += mesh_stats.acmr_after*num_triangles;
+			scene_stats.bytes_before += mesh_stats.bytes_before;
+			scene_stats.bytes_after += mesh_stats.bytes_after;
+			scene_triangles += num_triangles;
+		}
+
+		if(stats)
+		{
+			*stats = scene_stats;
+			stats->acmr_before = scene_triangles > 0.0f ? scene_stats.acmr_before / scene_triangles : 0.0f;
+			stats->acmr_after = scene_triangles > 0.0f ? scene_stats.acmr_after / scene_triangles : 0.0f;
 		}
-		return success;
 	}
 
 	bool Scene::ReadScene(std::istream& stream)
@@ -255,6 +398,86 @@ namespace gef
 		return success;
 	}
 
+	bool Scene::WritePackedSceneToFile(const char* filename) const
+	{
+		bool success = true;
+
+		std::ofstream file_stream(filename, std::ios::out | std::ios::binary);
+		if(file_stream.is_open())
+		{
+			success = WritePackedScene(file_stream);
+		}
+		else
+		{
+			success = false;
+		}
+
+		file_stream.close();
+
+		return success;
+	}
+
+	bool Scene::WritePackedScene(std::ostream& stream) const
+	{
+		PackedSceneWriter writer;
+		writer.set_string_id_table(&string_id_table);
+
+		for(std::list<MaterialData>::const_iterator material_iter = material_data.begin(); material_iter != material_data.end(); ++material_iter)
+			writer.AddMaterial(*material_iter);
+		for(std::list<MeshData>::const_iterator mesh_iter = meshes.begin(); mesh_iter != meshes.end(); ++mesh_iter)
+			writer.AddMesh(*mesh_iter);
+		for(std::list<Skeleton*>::const_iterator skeleton_iter = skeletons.begin();skeleton_iter != skeletons.end(); ++skeleton_iter)
+			writer.AddSkeleton(**skeleton_iter);
+		for(std::map<gef::StringId, Animation*>::const_iterator animation_iter = animations.begin(); animation_iter != animations.end(); ++animation_iter)
+			writer.AddAnimation(*animation_iter->second);
+
+		return writer.Write(stream);
+	}
+
+	bool Scene::ReadPackedScene(const PackedSceneReader& reader)
+	{
+		bool success = true;
+
+		reader.ReadStrings(string_id_table);
+
+		// materials
+		for(Int32 material_num=0;material_num<reader.material_count() && success;++material_num)
+		{
+			material_data.push_back(MaterialData());
+			MaterialData& material = material_data.back();
+			success = reader.ReadMaterial(material_num, material);
+			material_data_map[material.name_id] = &material;
+		}
+
+		// meshes
+		for(Int32 mesh_num=0;mesh_num<reader.mesh_count() && success;++mesh_num)
+		{
+			meshes.push_back(MeshData());
+			success = reader.ReadMesh(mesh_num, meshes.back());
+		}
+
+		// skeletons
+		for(Int32 skeleton_num=0;skeleton_num<reader.skeleton_count() && success;++skeleton_num)
+		{
+			Skeleton* skeleton = new Skeleton();
+			success = reader.ReadSkeleton(skeleton_num, *skeleton);
+			skeletons.push_back(skeleton);
+		}
+
+		// animations
+		for(Int32 animation_num=0;animation_num<reader.animation_count() && success;++animation_num)
+		{
+			Animation* animation = new Animation();
+			success = reader.ReadAnimation(animation_num, *animation);
+			if(success)
+				animations[animation->name_id()] = animation;
+			else
+				delete animation;
+		}
+
+		return success;
+	}
+
 	bool Scene::WriteScene(std::ostream& stream) const
 	{
 		bool success = true;
@@ -263,7 +486,7 @@ namespace gef
 		Int32 material_count = (Int32)material_data.size();
 		Int32 skeleton_count = (Int32)skeletons.size();
 		Int32 animation_count = (Int32)animations.size();
-		Int32 string_count = (Int32)string_id_table.table().size();
+		Int32 string_count = string_id_table.num_strings();
 
 		stream.write((char*)&mesh_count, sizeof(Int32));
 		stream.write((char*)&material_count, sizeof(Int32));
@@ -272,11 +495,9 @@ namespace gef
 		stream.write((char*)&string_count, sizeof(Int32));
 
 		// string table
-		for(std::map<gef::StringId, std::string>::const_iterator string_iter = string_id_table.table().begin(); string_iter != string_id_table.table().end(); ++string_iter)
-		{
-			//Int32 string_length = string_iter->second.length();
-			stream.write(string_iter->second.c_str(), string_iter->second.length()+1);
-		}
+		// the table already holds the strings null terminated, one after another
+		if(string_id_table.strings_size() > 0)
+			stream.write(string_id_table.strings(), string_id_table.strings_size());
 
 		// materials
 		for(std::list<MaterialData>::const_iterator material_iter = material_data.begin(); material_iter != material_data.end(); ++material_iter)
@@ -4,6 +4,8 @@
 #include <list>
 #include <system/string_id.h>
 #include <graphics/mesh_data.h>
+#include <system/mapped_file.h>
+#include <graphics/mesh_optimiser.h>
 #include <ostream>
 #include <istream>
 #include <map>
@@ -15,6 +17,8 @@ namespace gef
 	class Animation;
 	class Platform;
 	class Material;
+	class ImageData;
+	class PackedSceneReader;
 
 	class Scene
 	{
@@ -24,14 +28,49 @@ namespace gef
 		Mesh* CreateMesh(Platform& platform, const MeshData& mesh_data, const bool read_only = true);
 		void CreateMaterials(const Platform& platform);
 
+		/// @brief Decodes the diffuse texture of every material, the part of CreateMaterials that doesn't need the platform.
+		/// @note Nothing is created on the platform, so it can be called on a loading thread, see AssetLoader.
+		/// @param[out] images	Receives each texture's image, by the name id of its filename.
+		void ReadMaterialImages(const Platform& platform, std::map<gef::StringId, ImageData>& images) const;
+
+		/// @brief Creates the materials and textures like CreateMaterials, from images decoded by ReadMaterialImages.
+		void CreateMaterials(const Platform& platform, const std::map<gef::StringId, ImageData>& images);
+
 		bool WriteSceneToFile(const Platform& platform, const char* filename) const;
+
+		/// @brief Reads a scene written by WriteSceneToFile or WritePackedSceneToFile.
+		/// @note The file is mapped into memory rather than copied. The meshes of a packed scene are used in place,
+		/// so the file stays mapped until the scene is destroyed, the meshes must not be modified. Reading another
+		/// file into the same scene copies the meshes of the last packed scene out of it before it's unmapped,
+		/// and fails without reading anything if there isn't the memory for the copies.
 		bool ReadSceneFromFile(const Platform& platform, const char* filename);
 
+		/// @brief Reads one animation from a scene file and adds it to animations, leaving everything else in the file.
+		/// @note In a packed scene only the table of contents and the animation's chunk are read. A scene written
+		/// by WriteSceneToFile has no table of contents, so the whole file has to be parsed to find it.
+		/// If animations already has one with the same name it's left as it is, so pointers to it stay valid.
+		/// @param[in] anim_name_id		The name of the animation, or 0 for the one with the lowest name id, the first in animations.
+		/// @return false if the file couldn't be read or has no such animation
+		bool ReadAnimationFromFile(const Platform& platform, const char* filename, const gef::StringId anim_name_id = 0);
+
 		bool ReadScene(std::istream& Stream);
 		bool WriteScene(std::ostream& Stream) const;
+
+		/// @brief Writes the scene in the packed layout, see PackedSceneHeader.
+		bool WritePackedSceneToFile(const char* filename) const;
+		bool WritePackedScene(std::ostream& stream) const;
+
+		/// @brief Reads every element of a packed scene. Meshes point into the reader's data, which must outlive them.
+		bool ReadPackedScene(const PackedSceneReader& reader);
 //		void WriteStringTable(std::istream& Stream) const;
 //		void ReadStringTable(std::istream& Stream);
 
+		/// @brief Optimises every mesh for drawing, see OptimiseMesh. Call before the meshes are created with CreateMesh.
+		/// @note Scenes exported with fbx2scn -optimise-meshes don't need this. The meshes of a packed scene are
+		/// copied out of the mapped file to be reordered.
+		/// @param[out] stats	Optional, receives the ACMR and size of all the meshes together before and after.
+		void OptimiseMeshes(const MeshOptimiserSettings& settings = MeshOptimiserSettings(), MeshOptimiserStats* stats = NULL);
+
 		class Skeleton* FindSkeleton(const MeshData& mesh_data);
 		void FixUpSkinWeights();
 
@@ -50,6 +89,13 @@ namespace gef
 		std::map<gef::StringId, Texture*> textures_map;
 
 		std::vector<gef::StringId> skin_cluster_name_ids;
+
+	private:
+		/// @brief Copies the vertices and indices of meshes read in place into buffers the meshes own, so the file can be unmapped.
+		/// @return false if a buffer couldn't be allocated, the meshes not yet copied still point into the file
+		bool CopyMappedMeshes();
+
+		MappedFile mapped_file_;	// the file the meshes of a packed scene point into
 	};
 }
 
@@ -62,6 +62,7 @@ namespace gef
 		shader_variable.type = variable_type;
 		shader_variable.byte_offset = 0;
 		shader_variable.count = variable_count;
+		shader_variable.upload_count = variable_count;
 		variables.push_back(shader_variable);
 		return (Int32)variables.size()-1;
 	}
@@ -71,6 +72,7 @@ namespace gef
 		ShaderVariable& shader_variable = variables[variable_index];
 		if (variable_count == -1)
 			variable_count = shader_variable.count;
+		shader_variable.upload_count = variable_count;
 
 		void* variable_data = &static_cast<UInt8*>(variables_data)[shader_variable.byte_offset];
 		Int32 data_size = GetTypeSize(shader_variable.type)*variable_count;
@@ -149,6 +151,18 @@ namespace gef
 		return static_cast<UInt8*>(malloc(variable_data_size));
 	}
 
+	Int32 ShaderInterface::GetVariableDataUploadSize(const std::vector<ShaderVariable>& variables)
+	{
+		Int32 upload_size = 0;
+		for (std::vector<ShaderVariable>::const_iterator shader_variable = variables.begin(); shader_variable != variables.end(); ++shader_variable)
+		{
+			const Int32 variable_end = shader_variable->byte_offset + GetTypeSize(shader_variable->type)*shader_variable->upload_count;
+			upload_size = variable_end > upload_size ? variable_end : upload_size;
+		}
+
+		return upload_size;
+	}
+
 	void ShaderInterface::SetVertexShaderSource(const char* vs_shader_source, Int32 vs_shader_source_size)
 	{
 		vs_shader_source_size_ = vs_shader_source_size;
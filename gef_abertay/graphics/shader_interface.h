@@ -37,6 +37,7 @@ namespace gef
 			VariableType type;
 			Int32 byte_offset;
 			Int32 count;
+			Int32 upload_count;		// the number of elements set last, only these are uploaded
 		};
 
 		struct ShaderParameter
@@ -95,6 +96,10 @@ namespace gef
 		void AllocateVariableData();
 		UInt8* AllocateVariableData(std::vector<ShaderVariable>& variables, Int32& variable_data_size);
 
+		/// @return the number of bytes of variable data up to the end of the elements last set, e.g. only
+		/// the bone matrices a mesh uses rather than every one the shader has room for
+		static Int32 GetVariableDataUploadSize(const std::vector<ShaderVariable>& variables);
+
 		char* vs_shader_source_;
 		Int32 vs_shader_source_size_;
 		char* ps_shader_source_;
@@ -0,0 +1,100 @@
+#include <graphics/sprite_batch.h>
+#include <maths/vector2.h>
+#include <maths/vector4.h>
+#include <maths/matrix44.h>
+#include <maths/simd.h>
+
+namespace gef
+{
+	SpriteBatchData::SpriteBatchData() :
+		positions(NULL),
+		sizes(NULL),
+		rotations(NULL),
+		uv_rects(NULL),
+		colours(NULL)
+	{
+	}
+
+	static void BuildSpriteShaderDataBlock(
+		const Vector4* positions,
+		const Vector2* sizes,
+		const float* rotations,
+		const Vector4* uv_rects,
+		const UInt32* colours,
+		const Int32 num_sprites,
+		Matrix44* sprite_data)
+	{
+		// sizes are stored as (width, height) pairs, split them into a vector of widths and a vector of heights
+		const float* size_values = &sizes[0].x;
+		const SimdVector sizes_01 = SimdLoad(size_values);
+		const SimdVector sizes_23 = SimdLoad(size_values + 4);
+		const SimdVector widths = SimdEvenLanes(sizes_01, sizes_23);
+		const SimdVector heights = SimdOddLanes(sizes_01, sizes_23);
+
+		SimdVector s, c;
+		SimdSinCos(SimdLoad(rotations), s, c);
+
+		// scale*rotation for four sprites, transposed so each row holds the 2x2 block for one sprite
+		SimdVector rotation_0 = SimdMul(c, widths);
+		SimdVector rotation_1 = SimdMul(s, widths);
+		SimdVector rotation_2 = SimdSub(SimdZero(), SimdMul(s, heights));
+		SimdVector rotation_3 = SimdMul(c, heights);
+		SimdTranspose4x4(rotation_0, rotation_1, rotation_2, rotation_3);
+		const SimdVector rotations_transposed[4] = { rotation_0, rotation_1, rotation_2, rotation_3 };
+
+		const SimdVector colour_scale = SimdSplat(1.f / 255.f);
+
+		for (Int32 sprite_num = 0; sprite_num < num_sprites; ++sprite_num)
+		{
+			float* data = reinterpret_cast<float*>(&sprite_data[sprite_num]);
+			const SimdVector uv_rect = SimdLoad(reinterpret_cast<const float*>(&uv_rects[sprite_num]));
+			const Vector4& position = positions[sprite_num];
+
+			SimdStore(data, SimdCombineLow(rotations_transposed[sprite_num], uv_rect));
+			SimdStore(data + 4, SimdCombineHigh(rotations_transposed[sprite_num], uv_rect));
+			SimdStore(data + 8, SimdSet(position.x(), position.y(), position.z(), 0.0f));
+			SimdStore(data + 12, SimdMul(SimdUnpackUByte4(colours[sprite_num]), colour_scale));
+		}
+	}
+
+	void BuildSpriteShaderDataBatch(const SpriteBatchData& sprites, const Int32 num_sprites, Matrix44* sprite_data)
+	{
+		Int32 sprite_num = 0;
+		for (; sprite_num + 4 <= num_sprites; sprite_num += 4)
+		{
+			BuildSpriteShaderDataBlock(
+				&sprites.positions[sprite_num],
+				&sprites.sizes[sprite_num],
+				&sprites.rotations[sprite_num],
+				&sprites.uv_rects[sprite_num],
+				&sprites.colours[sprite_num],
+				4,
+				&sprite_data[sprite_num]);
+		}
+
+		// pad the last few sprites out to a full block
+		const Int32 remaining = num_sprites - sprite_num;
+		if (remaining > 0)
+		{
+			Vector4 positions[4];
+			Vector2 sizes[4];
+			float rotations[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			Vector4 uv_rects[4];
+			UInt32 colours[4] = { 0, 0, 0, 0 };
+
+			for (Int32 i = 0; i < 4; ++i)
+				sizes[i] = Vector2(0.0f, 0.0f);
+
+			for (Int32 i = 0; i < remaining; ++i)
+			{
+				positions[i] = sprites.positions[sprite_num + i];
+				sizes[i] = sprites.sizes[sprite_num + i];
+				rotations[i] = sprites.rotations[sprite_num + i];
+				uv_rects[i] = sprites.uv_rects[sprite_num + i];
+				colours[i] = sprites.colours[sprite_num + i];
+			}
+
+			BuildSpriteShaderDataBlock(positions, sizes, rotations, uv_rects, colours, remaining, &sprite_data[sprite_num]);
+		}
+	}
+}
@@ -0,0 +1,38 @@
+#ifndef _GEF_SPRITE_BATCH_H
+#define _GEF_SPRITE_BATCH_H
+
+#include <gef.h>
+
+namespace gef
+{
+	class Vector2;
+	class Vector4;
+	class Matrix44;
+
+	/// @brief Structure-of-arrays description of a batch of sprites.
+	///
+	/// Each array must contain at least as many elements as the number of sprites
+	/// passed to BuildSpriteShaderDataBatch.
+	struct SpriteBatchData
+	{
+		SpriteBatchData();
+
+		const Vector4* positions;		// position on screen (z value used for depth sorting sprites)
+		const Vector2* sizes;			// width and height of each sprite
+		const float* rotations;			// rotation angle of each sprite (in radians)
+		const Vector4* uv_rects;		// source rectangle in texture space (u, v, width, height)
+		const UInt32* colours;			// colour of each sprite (ABGR)
+	};
+
+	/// @brief Builds the per sprite shader data for a batch of sprites.
+	/// @param[in] sprites		The sprites to build the data for.
+	/// @param[in] num_sprites	The number of sprites in the batch.
+	/// @param[out] sprite_data	Array of num_sprites matrices that receives the shader data.
+	/// Each matrix has the same layout as the one built by SpriteRenderer::BuildSpriteShaderData.
+	/// @note Four sprites are processed at a time using SIMD instructions where available.
+	/// Rotations use a polynomial sine/cosine approximation so results can differ from
+	/// sinf/cosf in the last bit.
+	void BuildSpriteShaderDataBatch(const SpriteBatchData& sprites, const Int32 num_sprites, Matrix44* sprite_data);
+}
+
+#endif // _GEF_SPRITE_BATCH_H
@@ -14,7 +14,8 @@ namespace gef
 SpriteRenderer::SpriteRenderer(Platform& platform) :
 platform_(platform),
 	shader_(NULL),
-	default_shader_(platform_)
+	default_shader_(platform_),
+	blend_mode_(kSpriteBlendAlpha)
 {
 	//SCE_DBG_ASSERT(platform_ != NULL);
 }
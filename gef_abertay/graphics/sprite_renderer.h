@@ -12,6 +12,15 @@ namespace gef
 	class Platform;
 	class Shader;
 
+	/// @brief How sprites are blended with what they're drawn over.
+	enum SpriteBlendMode
+	{
+		kSpriteBlendAlpha,			// colour is blended by the sprite's alpha, alpha replaces what's there
+		kSpriteBlendLayer,			// as kSpriteBlendAlpha, but alpha is accumulated so the target ends up premultiplied, for drawing into a CachedSpriteLayer
+		kSpriteBlendPremultiplied,	// the sprite's colour is already multiplied by its alpha, for compositing a CachedSpriteLayer
+		kNumSpriteBlendModes
+	};
+
 	class SpriteRenderer
 	{
 	public:
@@ -25,6 +34,11 @@ namespace gef
 		inline const Matrix44& projection_matrix() const { return projection_matrix_; }
 		inline void set_projection_matrix(const  Matrix44& matrix) {projection_matrix_ = matrix;}
 
+		/// @brief Sets how the sprites drawn from now on are blended. Can be changed between Begin and End.
+		/// @note On the Vita the blend is part of the fragment program, so only sprites drawn with the default shader use it.
+		inline void set_blend_mode(const SpriteBlendMode blend_mode) { blend_mode_ = blend_mode; }
+		inline SpriteBlendMode blend_mode() const { return blend_mode_; }
+
 		static SpriteRenderer* Create(Platform& platform);
 	protected:
 		SpriteRenderer(Platform& platform);
@@ -37,6 +51,7 @@ namespace gef
 
 		Shader* shader_;
 		DefaultSpriteShader default_shader_;
+		SpriteBlendMode blend_mode_;
 	};
 }
 #endif // _GEF_SPRITE_RENDERER_H
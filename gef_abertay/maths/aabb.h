@@ -29,6 +29,7 @@ namespace gef
 		/// @brief Transforms the bounds of the AABB by a transformation matrix.
 		/// @param[in] transform_matrix		The matrix to transform this AABB.
 		/// @return The transformed AABB.
+		/// @note See TransformAabbsBatch for transforming many boxes at once.
 		const Aabb Transform(const Matrix44& transform_matrix) const;
 
 		/// @brief Sets the minimum bounds of the AABB.
@@ -2,10 +2,30 @@
 #include <maths/matrix44.h>
 #include <maths/sphere.h>
 #include <maths/aabb.h>
+#include <maths/simd.h>
+#include <system/job_system.h>
 #include <math.h>
 
 namespace gef
 {
+	SphereBoundsSoA::SphereBoundsSoA() :
+		centre_x(NULL),
+		centre_y(NULL),
+		centre_z(NULL),
+		radii(NULL)
+	{
+	}
+
+	AabbBoundsSoA::AabbBoundsSoA() :
+		centre_x(NULL),
+		centre_y(NULL),
+		centre_z(NULL),
+		extent_x(NULL),
+		extent_y(NULL),
+		extent_z(NULL)
+	{
+	}
+
 	//
 	// http://www.flipcode.com/archives/Frustum_Culling.shtml
 	//
@@ -91,35 +111,35 @@ namespace gef
 	void Frustum::ExtractPlanesD3D(const Matrix44& viewproj, bool normalise)
 	{
 		// Left clipping plane
-		planes_[0].set_a(viewproj.m(0,3) + viewproj.m(0,0));
-		planes_[0].set_b(viewproj.m(1,3) + viewproj.m(1,0));
-		planes_[0].set_c(viewproj.m(2,3) + viewproj.m(2,0));
-		planes_[0].set_d(viewproj.m(3,3) + viewproj.m(3,0));
+		planes_[FP_LEFT].set_a(viewproj.m(0,3) + viewproj.m(0,0));
+		planes_[FP_LEFT].set_b(viewproj.m(1,3) + viewproj.m(1,0));
+		planes_[FP_LEFT].set_c(viewproj.m(2,3) + viewproj.m(2,0));
+		planes_[FP_LEFT].set_d(viewproj.m(3,3) + viewproj.m(3,0));
 		// Right clipping plane
-		planes_[0].set_a(viewproj.m(0,3) - viewproj.m(0,0));
-		planes_[0].set_b(viewproj.m(1,3) - viewproj.m(1,0));
-		planes_[0].set_c(viewproj.m(2,3) - viewproj.m(2,0));
-		planes_[0].set_d(viewproj.m(3,3) - viewproj.m(3,0));
+		planes_[FP_RIGHT].set_a(viewproj.m(0,3) - viewproj.m(0,0));
+		planes_[FP_RIGHT].set_b(viewproj.m(1,3) - viewproj.m(1,0));
+		planes_[FP_RIGHT].set_c(viewproj.m(2,3) - viewproj.m(2,0));
+		planes_[FP_RIGHT].set_d(viewproj.m(3,3) - viewproj.m(3,0));
 		// Top clipping plane
-		planes_[1].set_a(viewproj.m(0,3) - viewproj.m(0,1));
-		planes_[1].set_b(viewproj.m(1,3) - viewproj.m(1,1));
-		planes_[1].set_c(viewproj.m(2,3) - viewproj.m(2,1));
-		planes_[1].set_d(viewproj.m(3,3) - viewproj.m(3,1));
+		planes_[FP_TOP].set_a(viewproj.m(0,3) - viewproj.m(0,1));
+		planes_[FP_TOP].set_b(viewproj.m(1,3) - viewproj.m(1,1));
+		planes_[FP_TOP].set_c(viewproj.m(2,3) - viewproj.m(2,1));
+		planes_[FP_TOP].set_d(viewproj.m(3,3) - viewproj.m(3,1));
 		// Bottom clipping plane
-		planes_[2].set_a(viewproj.m(0,3) + viewproj.m(0,1));
-		planes_[2].set_b(viewproj.m(1,3) + viewproj.m(1,1));
-		planes_[2].set_c(viewproj.m(2,3) + viewproj.m(2,1));
-		planes_[2].set_d(viewproj.m(3,3) + viewproj.m(3,1));
+		planes_[FP_BOTTOM].set_a(viewproj.m(0,3) + viewproj.m(0,1));
+		planes_[FP_BOTTOM].set_b(viewproj.m(1,3) + viewproj.m(1,1));
+		planes_[FP_BOTTOM].set_c(viewproj.m(2,3) + viewproj.m(2,1));
+		planes_[FP_BOTTOM].set_d(viewproj.m(3,3) + viewproj.m(3,1));
 		// Near clipping plane
-		planes_[3].set_a(viewproj.m(0,2));
-		planes_[3].set_b(viewproj.m(1,2));
-		planes_[3].set_c(viewproj.m(2,2));
-		planes_[3].set_d(viewproj.m(3,2));
+		planes_[FP_NEAR].set_a(viewproj.m(0,2));
+		planes_[FP_NEAR].set_b(viewproj.m(1,2));
+		planes_[FP_NEAR].set_c(viewproj.m(2,2));
+		planes_[FP_NEAR].set_d(viewproj.m(3,2));
 		// Far clipping plane
-		planes_[5].set_a(viewproj.m(0,3) - viewproj.m(0,2));
-		planes_[5].set_b(viewproj.m(1,3) - viewproj.m(1,2));
-		planes_[5].set_c(viewproj.m(2,3) - viewproj.m(2,2));
-		planes_[5].set_d(viewproj.m(3,3) - viewproj.m(3,2));
+		planes_[FP_FAR].set_a(viewproj.m(0,3) - viewproj.m(0,2));
+		planes_[FP_FAR].set_b(viewproj.m(1,3) - viewproj.m(1,2));
+		planes_[FP_FAR].set_c(viewproj.m(2,3) - viewproj.m(2,2));
+		planes_[FP_FAR].set_d(viewproj.m(3,3) - viewproj.m(3,2));
 		// Normalize the plane equations, if requested
 		if (normalise == true)
 		{
@@ -136,35 +156,35 @@ namespace gef
 	void Frustum::ExtractPlanesGL(const Matrix44& viewproj, bool normalise)
 	{
 		// Left clipping plane
-		planes_[0].set_a(viewproj.m(3,0) + viewproj.m(0,0));
-		planes_[0].set_b(viewproj.m(3,1) + viewproj.m(0,1));
-		planes_[0].set_c(viewproj.m(3,2) + viewproj.m(0,2));
-		planes_[0].set_d(viewproj.m(3,3) + viewproj.m(0,3));
+		planes_[FP_LEFT].set_a(viewproj.m(3,0) + viewproj.m(0,0));
+		planes_[FP_LEFT].set_b(viewproj.m(3,1) + viewproj.m(0,1));
+		planes_[FP_LEFT].set_c(viewproj.m(3,2) + viewproj.m(0,2));
+		planes_[FP_LEFT].set_d(viewproj.m(3,3) + viewproj.m(0,3));
 		// Right clipping plane
-		planes_[0].set_a(viewproj.m(3,0) - viewproj.m(0,0));
-		planes_[0].set_b(viewproj.m(3,1) - viewproj.m(0,1));
-		planes_[0].set_c(viewproj.m(3,2) - viewproj.m(0,2));
-		planes_[0].set_d(viewproj.m(3,3) - viewproj.m(0,3));
+		planes_[FP_RIGHT].set_a(viewproj.m(3,0) - viewproj.m(0,0));
+		planes_[FP_RIGHT].set_b(viewproj.m(3,1) - viewproj.m(0,1));
+		planes_[FP_RIGHT].set_c(viewproj.m(3,2) - viewproj.m(0,2));
+		planes_[FP_RIGHT].set_d(viewproj.m(3,3) - viewproj.m(0,3));
 		// Top clipping plane
-		planes_[1].set_a(viewproj.m(3,0) - viewproj.m(1,0));
-		planes_[1].set_b(viewproj.m(3,1) - viewproj.m(1,1));
-		planes_[1].set_c(viewproj.m(3,2) - viewproj.m(1,2));
-		planes_[1].set_d(viewproj.m(3,3) - viewproj.m(1,3));
+		planes_[FP_TOP].set_a(viewproj.m(3,0) - viewproj.m(1,0));
+		planes_[FP_TOP].set_b(viewproj.m(3,1) - viewproj.m(1,1));
+		planes_[FP_TOP].set_c(viewproj.m(3,2) - viewproj.m(1,2));
+		planes_[FP_TOP].set_d(viewproj.m(3,3) - viewproj.m(1,3));
 		// Bottom clipping plane
-		planes_[2].set_a(viewproj.m(3,0) + viewproj.m(1,0));
-		planes_[2].set_b(viewproj.m(3,1) + viewproj.m(1,1));
-		planes_[2].set_c(viewproj.m(3,2) + viewproj.m(1,2));
-		planes_[2].set_d(viewproj.m(3,3) + viewproj.m(1,3));
+		planes_[FP_BOTTOM].set_a(viewproj.m(3,0) + viewproj.m(1,0));
+		planes_[FP_BOTTOM].set_b(viewproj.m(3,1) + viewproj.m(1,1));
+		planes_[FP_BOTTOM].set_c(viewproj.m(3,2) + viewproj.m(1,2));
+		planes_[FP_BOTTOM].set_d(viewproj.m(3,3) + viewproj.m(1,3));
 		// Near clipping plane
-		planes_[3].set_a(viewproj.m(3,0) + viewproj.m(2,0));
-		planes_[3].set_b(viewproj.m(3,1) + viewproj.m(2,1));
-		planes_[3].set_c(viewproj.m(3,2) + viewproj.m(2,2));
-		planes_[3].set_d(viewproj.m(3,3) + viewproj.m(2,3));
+		planes_[FP_NEAR].set_a(viewproj.m(3,0) + viewproj.m(2,0));
+		planes_[FP_NEAR].set_b(viewproj.m(3,1) + viewproj.m(2,1));
+		planes_[FP_NEAR].set_c(viewproj.m(3,2) + viewproj.m(2,2));
+		planes_[FP_NEAR].set_d(viewproj.m(3,3) + viewproj.m(2,3));
 		// Far clipping plane
-		planes_[5].set_a(viewproj.m(3,0) - viewproj.m(2,0));
-		planes_[5].set_b(viewproj.m(3,1) - viewproj.m(2,1));
-		planes_[5].set_c(viewproj.m(3,2) - viewproj.m(2,2));
-		planes_[5].set_d(viewproj.m(3,3) - viewproj.m(2,3));
+		planes_[FP_FAR].set_a(viewproj.m(3,0) - viewproj.m(2,0));
+		planes_[FP_FAR].set_b(viewproj.m(3,1) - viewproj.m(2,1));
+		planes_[FP_FAR].set_c(viewproj.m(3,2) - viewproj.m(2,2));
+		planes_[FP_FAR].set_d(viewproj.m(3,3) - viewproj.m(2,3));
 		// Normalize the plane equations, if requested
 		if (normalise == true)
 		{
@@ -176,4 +196,186 @@ namespace gef
 			planes_[5].Normalise();
 		}
 	}
-}
\ No newline at end of file
+
+	// plane coefficients splatted across all four lanes, so four objects are tested against a plane at once
+	struct FrustumPlanesSimd
+	{
+		SimdVector a[NUM_FRUSTUM_PLANES];
+		SimdVector b[NUM_FRUSTUM_PLANES];
+		SimdVector c[NUM_FRUSTUM_PLANES];
+		SimdVector d[NUM_FRUSTUM_PLANES];
+		SimdVector abs_a[NUM_FRUSTUM_PLANES];
+		SimdVector abs_b[NUM_FRUSTUM_PLANES];
+		SimdVector abs_c[NUM_FRUSTUM_PLANES];
+	};
+
+	static void SplatPlanes(const Plane* planes, FrustumPlanesSimd& splat)
+	{
+		for (Int32 plane_num = 0; plane_num < NUM_FRUSTUM_PLANES; ++plane_num)
+		{
+			const Plane& plane = planes[plane_num];
+			splat.a[plane_num] = SimdSplat(plane.a());
+			splat.b[plane_num] = SimdSplat(plane.b());
+			splat.c[plane_num] = SimdSplat(plane.c());
+			splat.d[plane_num] = SimdSplat(plane.d());
+			splat.abs_a[plane_num] = SimdSplat(fabsf(plane.a()));
+			splat.abs_b[plane_num] = SimdSplat(fabsf(plane.b()));
+			splat.abs_c[plane_num] = SimdSplat(fabsf(plane.c()));
+		}
+	}
+
+	// a sphere is outside if its centre is further than its radius behind any plane
+	struct SphereCull
+	{
+		enum { kNumStreams = 4 };
+
+		static void GetStreams(const SphereBoundsSoA& spheres, const float* streams[kNumStreams])
+		{
+			streams[0] = spheres.centre_x;
+			streams[1] = spheres.centre_y;
+			streams[2] = spheres.centre_z;
+			streams[3] = spheres.radii;
+		}
+
+		static Int32 Outside(const FrustumPlanesSimd& planes, const SimdVector values[kNumStreams])
+		{
+			SimdVector nearest = SimdSplat(1.0f);
+			for (Int32 plane_num = 0; plane_num < NUM_FRUSTUM_PLANES; ++plane_num)
+			{
+				SimdVector distance = SimdMul(values[0], planes.a[plane_num]);
+				distance = SimdAdd(distance, SimdMul(values[1], planes.b[plane_num]));
+				distance = SimdAdd(distance, SimdMul(values[2], planes.c[plane_num]));
+				distance = SimdAdd(distance, planes.d[plane_num]);
+				nearest = SimdMin(nearest, SimdAdd(distance, values[3]));
+			}
+			return SimdLessThanMask(nearest, SimdZero());
+		}
+	};
+
+	// a box is outside if the corner furthest along a plane normal is behind that plane
+	struct AabbCull
+	{
+		enum { kNumStreams = 6 };
+
+		static void GetStreams(const AabbBoundsSoA& boxes, const float* streams[kNumStreams])
+		{
+			streams[0] = boxes.centre_x;
+			streams[1] = boxes.centre_y;
+			streams[2] = boxes.centre_z;
+			streams[3] = boxes.extent_x;
+			streams[4] = boxes.extent_y;
+			streams[5] = boxes.extent_z;
+		}
+
+		static Int32 Outside(const FrustumPlanesSimd& planes, const SimdVector values[kNumStreams])
+		{
+			SimdVector nearest = SimdSplat(1.0f);
+			for (Int32 plane_num = 0; plane_num < NUM_FRUSTUM_PLANES; ++plane_num)
+			{
+				SimdVector distance = SimdMul(values[0], planes.a[plane_num]);
+				distance = SimdAdd(distance, SimdMul(values[1], planes.b[plane_num]));
+				distance = SimdAdd(distance, SimdMul(values[2], planes.c[plane_num]));
+				distance = SimdAdd(distance, planes.d[plane_num]);
+
+				SimdVector reach = SimdMul(values[3], planes.abs_a[plane_num]);
+				reach = SimdAdd(reach, SimdMul(values[4], planes.abs_b[plane_num]));
+				reach = SimdAdd(reach, SimdMul(values[5], planes.abs_c[plane_num]));
+				nearest = SimdMin(nearest, SimdAdd(distance, reach));
+			}
+			return SimdLessThanMask(nearest, SimdZero());
+		}
+	};
+
+	// tests the objects covered by visibility words begin_word to end_word-1
+	template<class Cull>
+	static void CullRange(const FrustumPlanesSimd& planes, const float* const* streams, const Int32 num_objects, const Int32 begin_word, const Int32 end_word, UInt32* visibility)
+	{
+		SimdVector values[Cull::kNumStreams];
+
+		for (Int32 word_num = begin_word; word_num < end_word; ++word_num)
+		{
+			const Int32 word_start = word_num*32;
+			const Int32 word_end = word_start + 32 < num_objects ? word_start + 32 : num_objects;
+			UInt32 word = 0;
+
+			Int32 index = word_start;
+			for (; index + 4 <= word_end; index += 4)
+			{
+				for (Int32 stream_num = 0; stream_num < Cull::kNumStreams; ++stream_num)
+					values[stream_num] = SimdLoad(streams[stream_num] + index);
+				word |= static_cast<UInt32>(~Cull::Outside(planes, values) & 0xf) << (index - word_start);
+			}
+
+			// the last few objects are copied into a full block, the padding lanes are masked out
+			if (index < word_end)
+			{
+				const Int32 num_remaining = word_end - index;
+				for (Int32 stream_num = 0; stream_num < Cull::kNumStreams; ++stream_num)
+				{
+					float tail[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+					for (Int32 lane = 0; lane < num_remaining; ++lane)
+						tail[lane] = streams[stream_num][index + lane];
+					values[stream_num] = SimdLoad(tail);
+				}
+				const Int32 lane_mask = (1 << num_remaining) - 1;
+				word |= static_cast<UInt32>(~Cull::Outside(planes, values) & lane_mask) << (index - word_start);
+			}
+
+			visibility[word_num] = word;
+		}
+	}
+
+	// visibility words per job, large enough that the split costs less than the work
+	static const Int32 kMinCullWordsPerJob = 64;
+
+	template<class Cull>
+	struct CullJobData
+	{
+		FrustumPlanesSimd planes;
+		const float* streams[Cull::kNumStreams];
+		Int32 num_objects;
+		UInt32* visibility;
+
+		static void Run(void* data, const Int32 begin_word, const Int32 end_word)
+		{
+			const CullJobData* job = static_cast<const CullJobData*>(data);
+			CullRange<Cull>(job->planes, job->streams, job->num_objects, begin_word, end_word, job->visibility);
+		}
+	};
+
+	void Frustum::CullSpheres(const SphereBoundsSoA& spheres, const Int32 num_spheres, UInt32* visibility) const
+	{
+		CullJobData<SphereCull> job;
+		SplatPlanes(planes_, job.planes);
+		SphereCull::GetStreams(spheres, job.streams);
+		CullRange<SphereCull>(job.planes, job.streams, num_spheres, 0, VisibilityMaskSize(num_spheres), visibility);
+	}
+
+	void Frustum::CullSpheres(const SphereBoundsSoA& spheres, const Int32 num_spheres, UInt32* visibility, JobSystem& job_system) const
+	{
+		CullJobData<SphereCull> job;
+		SplatPlanes(planes_, job.planes);
+		SphereCull::GetStreams(spheres, job.streams);
+		job.num_objects = num_spheres;
+		job.visibility = visibility;
+		job_system.ParallelFor(VisibilityMaskSize(num_spheres), kMinCullWordsPerJob, &CullJobData<SphereCull>::Run, &job);
+	}
+
+	void Frustum::CullAabbs(const AabbBoundsSoA& boxes, const Int32 num_boxes, UInt32* visibility) const
+	{
+		CullJobData<AabbCull> job;
+		SplatPlanes(planes_, job.planes);
+		AabbCull::GetStreams(boxes, job.streams);
+		CullRange<AabbCull>(job.planes, job.streams, num_boxes, 0, VisibilityMaskSize(num_boxes), visibility);
+	}
+
+	void Frustum::CullAabbs(const AabbBoundsSoA& boxes, const Int32 num_boxes, UInt32* visibility, JobSystem& job_system) const
+	{
+		CullJobData<AabbCull> job;
+		SplatPlanes(planes_, job.planes);
+		AabbCull::GetStreams(boxes, job.streams);
+		job.num_objects = num_boxes;
+		job.visibility = visibility;
+		job_system.ParallelFor(VisibilityMaskSize(num_boxes), kMinCullWordsPerJob, &CullJobData<AabbCull>::Run, &job);
+	}
+}
@@ -8,6 +8,7 @@ namespace gef
 	class Matrix44;
 	class Sphere;
 	class Aabb;
+	class JobSystem;
 
 	enum FrustumPlane
 	{
@@ -26,13 +27,65 @@ namespace gef
 		FI_IN,
 		FI_INTERSECTS
 	};
+
+	/// @brief Structure-of-arrays description of a set of bounding spheres.
+	struct SphereBoundsSoA
+	{
+		SphereBoundsSoA();
+
+		const float* centre_x;
+		const float* centre_y;
+		const float* centre_z;
+		const float* radii;
+	};
+
+	/// @brief Structure-of-arrays description of a set of axis aligned bounding boxes.
+	struct AabbBoundsSoA
+	{
+		AabbBoundsSoA();
+
+		const float* centre_x;
+		const float* centre_y;
+		const float* centre_z;
+		const float* extent_x;		// half the size of the box along each axis
+		const float* extent_y;
+		const float* extent_z;
+	};
+
+	/// @return The number of 32 bit words needed to hold the visibility bits of a number of objects.
+	inline Int32 VisibilityMaskSize(const Int32 num_objects) { return (num_objects + 31) / 32; }
+
 	class Frustum
 	{
 	public:
 		FrustumIntersect Intersects(const Sphere& sphere) const;
 		FrustumIntersect Intersects(const Aabb& aabb) const;
+
+		/// @brief Tests a set of bounding spheres against all six planes, four at a time.
+		/// @param[in] spheres		The spheres to test.
+		/// @param[in] num_spheres	The number of spheres.
+		/// @param[out] visibility	Receives VisibilityMaskSize(num_spheres) words. Bit (i % 32) of word (i / 32)
+		/// is set if sphere i is at least partly inside the frustum. Unused bits in the last word are cleared.
+		void CullSpheres(const SphereBoundsSoA& spheres, const Int32 num_spheres, UInt32* visibility) const;
+
+		/// @brief Tests a set of bounding spheres against the frustum, splitting the work between threads.
+		/// @note The other parameters are the same as the single threaded version.
+		void CullSpheres(const SphereBoundsSoA& spheres, const Int32 num_spheres, UInt32* visibility, JobSystem& job_system) const;
+
+		/// @brief Tests a set of axis aligned bounding boxes against all six planes, four at a time.
+		/// @param[in] boxes		The boxes to test.
+		/// @param[in] num_boxes	The number of boxes.
+		/// @param[out] visibility	Receives VisibilityMaskSize(num_boxes) words, laid out the same as CullSpheres.
+		void CullAabbs(const AabbBoundsSoA& boxes, const Int32 num_boxes, UInt32* visibility) const;
+
+		/// @brief Tests a set of axis aligned bounding boxes against the frustum, splitting the work between threads.
+		/// @note The other parameters are the same as the single threaded version.
+		void CullAabbs(const AabbBoundsSoA& boxes, const Int32 num_boxes, UInt32* visibility, JobSystem& job_system) const;
+
 		void ExtractPlanesD3D(const Matrix44& viewproj, bool normalise);
 		void ExtractPlanesGL(const Matrix44& viewproj, bool normalise);
+
+		inline const Plane& plane(const FrustumPlane plane_num) const { return planes_[plane_num]; }
 	protected:
 		Plane planes_[NUM_FRUSTUM_PLANES];
 	};
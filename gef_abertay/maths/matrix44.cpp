@@ -27,12 +27,20 @@ namespace gef
 	{
 		Matrix44 result;
 
+		const SimdVector row0 = matrix.values_[0].simd_values();
+		const SimdVector row1 = matrix.values_[1].simd_values();
+		const SimdVector row2 = matrix.values_[2].simd_values();
+		const SimdVector row3 = matrix.values_[3].simd_values();
+
+		// each result row is x*row0 + y*row1 + z*row2 + w*row3, summed in the same order as the scalar version
 		for (int i = 0; i < 4; i++)
 		{
-			result.values_[i].set_x(values_[i].x() * matrix.values_[0].x() + values_[i].y() * matrix.values_[1].x() + values_[i].z() * matrix.values_[2].x() + values_[i].w() * matrix.values_[3].x());
-			result.values_[i].set_y(values_[i].x() * matrix.values_[0].y() + values_[i].y() * matrix.values_[1].y() + values_[i].z() * matrix.values_[2].y() + values_[i].w() * matrix.values_[3].y());
-			result.values_[i].set_z(values_[i].x() * matrix.values_[0].z() + values_[i].y() * matrix.values_[1].z() + values_[i].z() * matrix.values_[2].z() + values_[i].w() * matrix.values_[3].z());
-			result.values_[i].set_w(values_[i].x() * matrix.values_[0].w() + values_[i].y() * matrix.values_[1].w() + values_[i].z() * matrix.values_[2].w() + values_[i].w() * matrix.values_[3].w());
+			const SimdVector values = values_[i].simd_values();
+			SimdVector product = SimdMul(SimdSplatX(values), row0);
+			product = SimdAdd(product, SimdMul(SimdSplatY(values), row1));
+			product = SimdAdd(product, SimdMul(SimdSplatZ(values), row2));
+			product = SimdAdd(product, SimdMul(SimdSplatW(values), row3));
+			result.values_[i].set_simd_values(product);
 		}
 
 		return result; 
@@ -40,7 +48,6 @@ namespace gef
 
 	void Matrix44::LookAt(const Vector4& eye, const Vector4& lookat, const Vector4& up)
 	{
-		SetIdentity();
 		Vector4 forward = eye - lookat;
 		forward.Normalise();
 
@@ -51,18 +58,24 @@ namespace gef
 		Vector4 calculated_up;
 		calculated_up = forward.CrossProduct(side);
 
-		values_[0].set_x(side.x());
-		values_[1].set_x(side.y());
-		values_[2].set_x(side.z());
-		values_[0].set_y(calculated_up.x());
-		values_[1].set_y(calculated_up.y());
-		values_[2].set_y(calculated_up.z());
-		values_[0].set_z(forward.x());
-		values_[1].set_z(forward.y());
-		values_[2].set_z(forward.z());
-		values_[3].set_x(-side.DotProduct(eye));
-		values_[3].set_y(-calculated_up.DotProduct(eye));
-		values_[3].set_z(-forward.DotProduct(eye));
+		// the axes are the columns of the rotation, all of them have w = 0
+		SimdVector row0 = side.simd_values();
+		SimdVector row1 = calculated_up.simd_values();
+		SimdVector row2 = forward.simd_values();
+		SimdVector row3 = SimdSet(0.0f, 0.0f, 0.0f, 1.0f);
+		SimdTranspose4x4(row0, row1, row2, row3);
+
+		// translation is (-side.eye, -up.eye, -forward.eye)
+		const SimdVector eye_values = eye.simd_values();
+		SimdVector translation = SimdMul(SimdSplatX(eye_values), row0);
+		translation = SimdAdd(translation, SimdMul(SimdSplatY(eye_values), row1));
+		translation = SimdAdd(translation, SimdMul(SimdSplatZ(eye_values), row2));
+		translation = SimdMul(translation, SimdSplat(-1.0f));
+
+		values_[0].set_simd_values(row0);
+		values_[1].set_simd_values(row1);
+		values_[2].set_simd_values(row2);
+		values_[3].set_simd_values(SimdSelectXYZ(translation, row3));
 	}
 
 	void Matrix44::PerspectiveFrustumGL(const float left, const float right, const float top, const float bottom, const float near_distance, const float far_distance)
@@ -287,28 +300,46 @@ namespace gef
 
 	void Matrix44::Transpose(const Matrix44& matrix)
 	{
-		for (Int32 rowNum = 0; rowNum < 4; ++rowNum)
-			values_[rowNum] = matrix.GetColumn(rowNum);
+		SimdVector row0 = matrix.values_[0].simd_values();
+		SimdVector row1 = matrix.values_[1].simd_values();
+		SimdVector row2 = matrix.values_[2].simd_values();
+		SimdVector row3 = matrix.values_[3].simd_values();
+		SimdTranspose4x4(row0, row1, row2, row3);
+
+		values_[0].set_simd_values(row0);
+		values_[1].set_simd_values(row1);
+		values_[2].set_simd_values(row2);
+		values_[3].set_simd_values(row3);
 	}
 
 	void Matrix44::AffineInverse(const Matrix44& matrix)
 	{
-		Transpose(matrix);
-		values_[3].set_x(0.0f);
-		values_[3].set_y(0.0f);
-		values_[3].set_z(0.0f);
-		values_[0].set_w(0.0f);
-		values_[1].set_w(0.0f);
-		values_[2].set_w(0.0f);
-
-		Vector4 pos, invTrans;
-
-		pos = matrix.GetTranslation();
-		pos = pos * -1.0f;
-
-		invTrans = pos.Transform(*this);
-
-		SetTranslation(invTrans);
+		const SimdVector translation = matrix.values_[3].simd_values();
+
+		// transpose the rotation, the w column is cleared and the bottom row keeps m(3, 3)
+		SimdVector row0 = matrix.values_[0].simd_values();
+		SimdVector row1 = matrix.values_[1].simd_values();
+		SimdVector row2 = matrix.values_[2].simd_values();
+		SimdVector row3 = translation;
+		SimdTranspose4x4(row0, row1, row2, row3);
+
+		const SimdVector zero = SimdZero();
+		row0 = SimdSelectXYZ(row0, zero);
+		row1 = SimdSelectXYZ(row1, zero);
+		row2 = SimdSelectXYZ(row2, zero);
+		row3 = SimdSelectXYZ(zero, row3);
+
+		// inverse translation is -translation transformed by the transposed rotation
+		const SimdVector position = SimdMul(translation, SimdSplat(-1.0f));
+		SimdVector inverse_translation = SimdMul(SimdSplatX(position), row0);
+		inverse_translation = SimdAdd(inverse_translation, SimdMul(SimdSplatY(position), row1));
+		inverse_translation = SimdAdd(inverse_translation, SimdMul(SimdSplatZ(position), row2));
+		inverse_translation = SimdAdd(inverse_translation, row3);
+
+		values_[0].set_simd_values(row0);
+		values_[1].set_simd_values(row1);
+		values_[2].set_simd_values(row2);
+		values_[3].set_simd_values(SimdSelectXYZ(inverse_translation, row3));
 	}
 
 	void Matrix44::NormaliseRotation()
@@ -341,38 +372,83 @@ namespace gef
 		return values_[0].x() * v[0] + values_[0].y() * v[1] + values_[0].z() * v[2] + values_[0].w() * v[3];
 	}
 
-	void Matrix44::Inverse(const Matrix44 matrix, float* determinant)
+	// products of 2x2 matrices stored row major in a single vector as (m00, m01, m10, m11)
+	// a*b
+	static inline SimdVector Matrix22Mul(SimdVector a, SimdVector b)
 	{
-		int a, i, j;
-		Vector4 v, vec[3];
-		float det;
-
-		det = matrix.CalculateDeterminant();
-		if ( det!= 0.0f )
-		{
-			for (i=0; i<4; i++)
-			{
-				for (j=0; j<4; j++)
-				{
-					if (j != i )
-					{
-						a = j;
-						if ( j > i )
-							a = a-1;
-
-						vec[a] = matrix.GetRow(j);
-					}
-				}
+		return SimdAdd(SimdMul(a, SimdSwizzle<0, 3, 0, 3>(b)), SimdMul(SimdSwizzle<1, 0, 3, 2>(a), SimdSwizzle<2, 1, 2, 1>(b)));
+	}
 
-				v = vec[0].CrossProduct3(vec[1], vec[2]);
+	// adjugate(a)*b
+	static inline SimdVector Matrix22AdjMul(SimdVector a, SimdVector b)
+	{
+		return SimdSub(SimdMul(SimdSwizzle<3, 3, 0, 0>(a), b), SimdMul(SimdSwizzle<1, 1, 2, 2>(a), SimdSwizzle<2, 3, 0, 1>(b)));
+	}
 
+	// a*adjugate(b)
+	static inline SimdVector Matrix22MulAdj(SimdVector a, SimdVector b)
+	{
+		return SimdSub(SimdMul(a, SimdSwizzle<3, 0, 3, 0>(b)), SimdMul(SimdSwizzle<1, 0, 3, 2>(a), SimdSwizzle<2, 1, 2, 1>(b)));
+	}
 
-				float temp = powf(-1.0f, (float)i) / det;
-				SetColumn(i, Vector4(temp*v.x(), temp*v.y(), temp*v.z(), temp*v.w()));
-			}
-	   }
+	void Matrix44::Inverse(const Matrix44 matrix, float* determinant)
+	{
+		// block wise inverse of | A B |
+		//                       | C D |
+		// using the adjugates of the 2x2 sub matrices, see Eric Zhang's "Fast 4x4 Matrix Inverse with SSE SIMD"
+		const SimdVector row0 = matrix.values_[0].simd_values();
+		const SimdVector row1 = matrix.values_[1].simd_values();
+		const SimdVector row2 = matrix.values_[2].simd_values();
+		const SimdVector row3 = matrix.values_[3].simd_values();
+
+		const SimdVector a = SimdCombineLow(row0, row1);
+		const SimdVector b = SimdCombineHigh(row0, row1);
+		const SimdVector c = SimdCombineLow(row2, row3);
+		const SimdVector d = SimdCombineHigh(row2, row3);
+
+		// (|A|, |B|, |C|, |D|)
+		const SimdVector sub_determinants = SimdSub(
+			SimdMul(SimdEvenLanes(row0, row2), SimdOddLanes(row1, row3)),
+			SimdMul(SimdOddLanes(row0, row2), SimdEvenLanes(row1, row3)));
+		const SimdVector det_a = SimdSplatX(sub_determinants);
+		const SimdVector det_b = SimdSplatY(sub_determinants);
+		const SimdVector det_c = SimdSplatZ(sub_determinants);
+		const SimdVector det_d = SimdSplatW(sub_determinants);
+
+		const SimdVector adj_d_c = Matrix22AdjMul(d, c);
+		const SimdVector adj_a_b = Matrix22AdjMul(a, b);
+
+		// inverse is | X Y | / |M|, these are the adjugates of X, Y, Z and W
+		//            | Z W |
+		SimdVector x = SimdSub(SimdMul(det_d, a), Matrix22Mul(b, adj_d_c));
+		SimdVector w = SimdSub(SimdMul(det_a, d), Matrix22Mul(c, adj_a_b));
+		SimdVector y = SimdSub(SimdMul(det_b, c), Matrix22MulAdj(d, adj_a_b));
+		SimdVector z = SimdSub(SimdMul(det_c, b), Matrix22MulAdj(a, adj_d_c));
+
+		// |M| = |A||D| + |B||C| - trace((A#B)(D#C))
+		SimdVector trace = SimdMul(adj_a_b, SimdSwizzle<0, 2, 1, 3>(adj_d_c));
+		trace = SimdAdd(trace, SimdSwizzle<1, 0, 3, 2>(trace));
+		trace = SimdAdd(trace, SimdSwizzle<2, 3, 0, 1>(trace));
+		const SimdVector det = SimdSub(SimdAdd(SimdMul(det_a, det_d), SimdMul(det_b, det_c)), trace);
+
+		float det_values[4];
+		SimdStore(det_values, det);
+		if (det_values[0] != 0.0f)
+		{
+			const SimdVector reciprocal_det = SimdDiv(SimdSet(1.0f, -1.0f, -1.0f, 1.0f), det);
+			x = SimdMul(x, reciprocal_det);
+			y = SimdMul(y, reciprocal_det);
+			z = SimdMul(z, reciprocal_det);
+			w = SimdMul(w, reciprocal_det);
+
+			// undo the adjugate shuffle and put the blocks back in rows
+			values_[0].set_simd_values(SimdShuffle<3, 1, 3, 1>(x, y));
+			values_[1].set_simd_values(SimdShuffle<2, 0, 2, 0>(x, y));
+			values_[2].set_simd_values(SimdShuffle<3, 1, 3, 1>(z, w));
+			values_[3].set_simd_values(SimdShuffle<2, 0, 2, 0>(z, w));
+		}
 
 		if(determinant)
-			*determinant = det;
+			*determinant = det_values[0];
 	}
 }
\ No newline at end of file
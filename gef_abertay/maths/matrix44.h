@@ -208,6 +208,51 @@ namespace gef
 		/// The matrix is stored as 4 rows of Vectors
 		Vector4 values_[4];
 	};
+
+	// the Vector4 transforms are defined here, rather than in vector4.inl, as they need the definition of Matrix44
+	// vector4.h includes this file so they're available, and can be inlined, wherever Vector4 is used
+
+	inline const Vector4 Vector4::Transform(const class Matrix44& _mat) const
+	{
+		Vector4 result;
+
+		// x*row0 + y*row1 + z*row2 + row3, summed in the same order as the scalar version
+		const SimdVector values = simd_values();
+		SimdVector transformed = SimdMul(SimdSplatX(values), _mat.GetRow(0).simd_values());
+		transformed = SimdAdd(transformed, SimdMul(SimdSplatY(values), _mat.GetRow(1).simd_values()));
+		transformed = SimdAdd(transformed, SimdMul(SimdSplatZ(values), _mat.GetRow(2).simd_values()));
+		transformed = SimdAdd(transformed, _mat.GetRow(3).simd_values());
+		result.set_simd_values(SimdSelectXYZ(transformed, SimdZero()));
+
+		return result;
+	}
+
+	inline const Vector4 Vector4::TransformNoTranslation(const class Matrix44& _mat) const
+	{
+		Vector4 result;
+
+		const SimdVector values = simd_values();
+		SimdVector transformed = SimdMul(SimdSplatX(values), _mat.GetRow(0).simd_values());
+		transformed = SimdAdd(transformed, SimdMul(SimdSplatY(values), _mat.GetRow(1).simd_values()));
+		transformed = SimdAdd(transformed, SimdMul(SimdSplatZ(values), _mat.GetRow(2).simd_values()));
+		result.set_simd_values(SimdSelectXYZ(transformed, SimdZero()));
+
+		return result;
+	}
+
+	inline const Vector4 Vector4::TransformW(const class Matrix44& _mat) const
+	{
+		Vector4 result;
+
+		const SimdVector values = simd_values();
+		SimdVector transformed = SimdMul(SimdSplatX(values), _mat.GetRow(0).simd_values());
+		transformed = SimdAdd(transformed, SimdMul(SimdSplatY(values), _mat.GetRow(1).simd_values()));
+		transformed = SimdAdd(transformed, SimdMul(SimdSplatZ(values), _mat.GetRow(2).simd_values()));
+		transformed = SimdAdd(transformed, SimdMul(SimdSplatW(values), _mat.GetRow(3).simd_values()));
+		result.set_simd_values(transformed);
+
+		return result;
+	}
 }
 
 #endif // _GEF_MATRIX_44_H
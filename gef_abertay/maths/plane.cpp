@@ -3,6 +3,11 @@
 
 namespace gef
 {
+	Plane::Plane() :
+		Vector4(0.0f, 0.0f, 0.0f, 0.0f)
+	{
+	}
+
 	Plane::Plane(float a, float b, float c, float d) :
 		Vector4(a, b, c, d)
 	{
@@ -1,5 +1,6 @@
 #include <maths/quaternion.h>
 #include <maths/matrix44.h>
+#include <maths/simd.h>
 
 namespace gef
 {
@@ -102,6 +103,44 @@ void Quaternion::Slerp(const Quaternion& startQ, const Quaternion& endQ, float t
 
 }
 
+// The time adjustment for FastSlerp, a cubic in time whose coefficients depend on the angle between the quaternions.
+// Fitted to slerp by Arseny Kapoulkine, http://zeux.io/2015/07/23/approximating-slerp/
+static inline float FastSlerpTime(const float time, const float abs_dot)
+{
+	const float centred_time = time - 0.5f;
+	const float a = 1.0904f + abs_dot*(-3.2452f + abs_dot*(3.55645f - abs_dot*1.43519f));
+	const float b = 0.848013f + abs_dot*(-1.06021f + abs_dot*0.215638f);
+	const float k = a*centred_time*centred_time + b;
+	return time + time*centred_time*(time - 1.0f)*k;
+}
+
+// normalised lerp, with the end negated when the quaternions are more than 90 degrees apart
+static inline Quaternion NormalisedBlend(const Quaternion& startQ, const Quaternion& endQ, const float dot, const float time)
+{
+	const float start_weight = 1.0f - time;
+	const float end_weight = dot < 0.0f ? time*-1.0f : time;
+
+	Quaternion result(
+		startQ.x*start_weight + endQ.x*end_weight,
+		startQ.y*start_weight + endQ.y*end_weight,
+		startQ.z*start_weight + endQ.z*end_weight,
+		startQ.w*start_weight + endQ.w*end_weight);
+	result.Normalise();
+	return result;
+}
+
+void Quaternion::FastSlerp(const Quaternion& startQ, const Quaternion& endQ, float time)
+{
+	const float dot = startQ.x*endQ.x + startQ.y*endQ.y + startQ.z*endQ.z + startQ.w*endQ.w;
+	*this = NormalisedBlend(startQ, endQ, dot, FastSlerpTime(time, fabsf(dot)));
+}
+
+void Quaternion::Nlerp(const Quaternion& startQ, const Quaternion& endQ, float time)
+{
+	const float dot = startQ.x*endQ.x + startQ.y*endQ.y + startQ.z*endQ.z + startQ.w*endQ.w;
+	*this = NormalisedBlend(startQ, endQ, dot, time);
+}
+
 // result = this * quaternion;
 // when used to represent rotations
 // the result quaternion represents an initial rotation specified by quaternion rotated by "this"
@@ -136,4 +175,244 @@ void Quaternion::Conjugate(const Quaternion& quaternion)
 }
 
 
+// Four quaternions are transposed so each vector holds one component of all four,
+// then blended with the same operations as FastSlerp and Nlerp.
+static inline void BlendQuaternionBlock(const Quaternion* start, const Quaternion* end, SimdVector time, Quaternion* results, const bool fast_slerp)
+{
+	SimdVector start_x = SimdLoad(&start[0].x), start_y = SimdLoad(&start[1].x), start_z = SimdLoad(&start[2].x), start_w = SimdLoad(&start[3].x);
+	SimdVector end_x = SimdLoad(&end[0].x), end_y = SimdLoad(&end[1].x), end_z = SimdLoad(&end[2].x), end_w = SimdLoad(&end[3].x);
+	SimdTranspose4x4(start_x, start_y, start_z, start_w);
+	SimdTranspose4x4(end_x, end_y, end_z, end_w);
+
+	SimdVector dot = SimdMul(start_x, end_x);
+	dot = SimdAdd(dot, SimdMul(start_y, end_y));
+	dot = SimdAdd(dot, SimdMul(start_z, end_z));
+	dot = SimdAdd(dot, SimdMul(start_w, end_w));
+
+	if (fast_slerp)
+	{
+		const SimdVector abs_dot = SimdAbs(dot);
+		const SimdVector centred_time = SimdSub(time, SimdSplat(0.5f));
+
+		SimdVector a = SimdSub(SimdSplat(3.55645f), SimdMul(abs_dot, SimdSplat(1.43519f)));
+		a = SimdAdd(SimdSplat(-3.2452f), SimdMul(abs_dot, a));
+		a = SimdAdd(SimdSplat(1.0904f), SimdMul(abs_dot, a));
+		SimdVector b = SimdAdd(SimdSplat(-1.06021f), SimdMul(abs_dot, SimdSplat(0.215638f)));
+		b = SimdAdd(SimdSplat(0.848013f), SimdMul(abs_dot, b));
+		const SimdVector k = SimdAdd(SimdMul(SimdMul(a, centred_time), centred_time), b);
+
+		const SimdVector adjustment = SimdMul(SimdMul(SimdMul(time, centred_time), SimdSub(time, SimdSplat(1.0f))), k);
+		time = SimdAdd(time, adjustment);
+	}
+
+	const SimdVector start_weight = SimdSub(SimdSplat(1.0f), time);
+	const SimdVector end_weight = SimdSelectLess(dot, SimdZero(), SimdMul(time, SimdSplat(-1.0f)), time);
+
+	SimdVector x = SimdAdd(SimdMul(start_x, start_weight), SimdMul(end_x, end_weight));
+	SimdVector y = SimdAdd(SimdMul(start_y, start_weight), SimdMul(end_y, end_weight));
+	SimdVector z = SimdAdd(SimdMul(start_z, start_weight), SimdMul(end_z, end_weight));
+	SimdVector w = SimdAdd(SimdMul(start_w, start_weight), SimdMul(end_w, end_weight));
+
+	SimdVector length_squared = SimdMul(x, x);
+	length_squared = SimdAdd(length_squared, SimdMul(y, y));
+	length_squared = SimdAdd(length_squared, SimdMul(z, z));
+	length_squared = SimdAdd(length_squared, SimdMul(w, w));
+	const SimdVector length = SimdSqrt(length_squared);
+	x = SimdDiv(x, length);
+	y = SimdDiv(y, length);
+	z = SimdDiv(z, length);
+	w = SimdDiv(w, length);
+
+	SimdTranspose4x4(x, y, z, w);
+	SimdStore(&results[0].x, x);
+	SimdStore(&results[1].x, y);
+	SimdStore(&results[2].x, z);
+	SimdStore(&results[3].x, w);
+}
+
+void BlendQuaternion(const Quaternion& startQ, const Quaternion& endQ, const float time, Quaternion& result, const QuaternionBlend blend)
+{
+	switch (blend)
+	{
+	case QB_SLERP:
+		result.Slerp(startQ, endQ, time);
+		break;
+	case QB_FAST_SLERP:
+		result.FastSlerp(startQ, endQ, time);
+		break;
+	case QB_NLERP:
+		result.Nlerp(startQ, endQ, time);
+		break;
+	}
+}
+
+void BlendQuaternionsBatch(const Quaternion* start, const Quaternion* end, const float time, Quaternion* results, const Int32 num, const QuaternionBlend blend)
+{
+	Int32 index = 0;
+	if (blend != QB_SLERP)
+	{
+		const SimdVector times = SimdSplat(time);
+		for (; index + 4 <= num; index += 4)
+			BlendQuaternionBlock(start + index, end + index, times, results + index, blend == QB_FAST_SLERP);
+	}
+
+	for (; index < num; ++index)
+		BlendQuaternion(start[index], end[index], time, results[index], blend);
+}
+
+void BlendQuaternionsBatch(const Quaternion* start, const Quaternion* end, const float* times, Quaternion* results, const Int32 num, const QuaternionBlend blend)
+{
+	Int32 index = 0;
+	if (blend != QB_SLERP)
+	{
+		for (; index + 4 <= num; index += 4)
+			BlendQuaternionBlock(start + index, end + index, SimdLoad(times + index), results + index, blend == QB_FAST_SLERP);
+	}
+
+	for (; index < num; ++index)
+		BlendQuaternion(start[index], end[index], times[index], results[index], blend);
+}
+
+// Each block of four quaternions is transposed so each vector holds one component of all four, as in BlendQuaternionBlock.
+static inline void LoadQuaternionBlock(const Quaternion* quaternions, SimdVector& x, SimdVector& y, SimdVector& z, SimdVector& w)
+{
+	x = SimdLoad(&quaternions[0].x);
+	y = SimdLoad(&quaternions[1].x);
+	z = SimdLoad(&quaternions[2].x);
+	w = SimdLoad(&quaternions[3].x);
+	SimdTranspose4x4(x, y, z, w);
+}
+
+static inline void StoreQuaternionBlock(SimdVector x, SimdVector y, SimdVector z, SimdVector w, Quaternion* quaternions)
+{
+	SimdTranspose4x4(x, y, z, w);
+	SimdStore(&quaternions[0].x, x);
+	SimdStore(&quaternions[1].x, y);
+	SimdStore(&quaternions[2].x, z);
+	SimdStore(&quaternions[3].x, w);
+}
+
+static inline void NormaliseQuaternionBlock(SimdVector& x, SimdVector& y, SimdVector& z, SimdVector& w)
+{
+	SimdVector length_squared = SimdMul(x, x);
+	length_squared = SimdAdd(length_squared, SimdMul(y, y));
+	length_squared = SimdAdd(length_squared, SimdMul(z, z));
+	length_squared = SimdAdd(length_squared, SimdMul(w, w));
+	const SimdVector length = SimdSqrt(length_squared);
+	x = SimdDiv(x, length);
+	y = SimdDiv(y, length);
+	z = SimdDiv(z, length);
+	w = SimdDiv(w, length);
+}
+
+// a * b, the same terms as Quaternion::operator *
+static inline void MultiplyQuaternionBlock(const SimdVector ax, const SimdVector ay, const SimdVector az, const SimdVector aw,
+	const SimdVector bx, const SimdVector by, const SimdVector bz, const SimdVector bw,
+	SimdVector& x, SimdVector& y, SimdVector& z, SimdVector& w)
+{
+	x = SimdSub(SimdAdd(SimdAdd(SimdMul(bw, ax), SimdMul(bx, aw)), SimdMul(by, az)), SimdMul(bz, ay));
+	y = SimdAdd(SimdAdd(SimdSub(SimdMul(bw, ay), SimdMul(bx, az)), SimdMul(by, aw)), SimdMul(bz, ax));
+	z = SimdAdd(SimdSub(SimdAdd(SimdMul(bw, az), SimdMul(bx, ay)), SimdMul(by, ax)), SimdMul(bz, aw));
+	w = SimdSub(SimdSub(SimdSub(SimdMul(bw, aw), SimdMul(bx, ax)), SimdMul(by, ay)), SimdMul(bz, az));
+}
+
+void AddWeightedQuaternionsBatch(const Quaternion* quaternions, const float weight, Quaternion* results, const Int32 num)
+{
+	const SimdVector weights = SimdSplat(weight);
+	const SimdVector negated_weights = SimdSplat(-weight);
+
+	Int32 index = 0;
+	for (; index + 4 <= num; index += 4)
+	{
+		SimdVector x, y, z, w, sum_x, sum_y, sum_z, sum_w;
+		LoadQuaternionBlock(quaternions + index, x, y, z, w);
+		LoadQuaternionBlock(results + index, sum_x, sum_y, sum_z, sum_w);
+
+		SimdVector dot = SimdMul(sum_x, x);
+		dot = SimdAdd(dot, SimdMul(sum_y, y));
+		dot = SimdAdd(dot, SimdMul(sum_z, z));
+		dot = SimdAdd(dot, SimdMul(sum_w, w));
+		const SimdVector signed_weights = SimdSelectLess(dot, SimdZero(), negated_weights, weights);
+
+		sum_x = SimdAdd(sum_x, SimdMul(x, signed_weights));
+		sum_y = SimdAdd(sum_y, SimdMul(y, signed_weights));
+		sum_z = SimdAdd(sum_z, SimdMul(z, signed_weights));
+		sum_w = SimdAdd(sum_w, SimdMul(w, signed_weights));
+		StoreQuaternionBlock(sum_x, sum_y, sum_z, sum_w, results + index);
+	}
+
+	for (; index < num; ++index)
+	{
+		const Quaternion& quaternion = quaternions[index];
+		Quaternion& sum = results[index];
+		const float dot = sum.x*quaternion.x + sum.y*quaternion.y + sum.z*quaternion.z + sum.w*quaternion.w;
+		const float signed_weight = dot < 0.0f ? -weight : weight;
+		sum = Quaternion(sum.x + quaternion.x*signed_weight, sum.y + quaternion.y*signed_weight, sum.z + quaternion.z*signed_weight, sum.w + quaternion.w*signed_weight);
+	}
+}
+
+void NormaliseQuaternionsBatch(Quaternion* quaternions, const Int32 num)
+{
+	Int32 index = 0;
+	for (; index + 4 <= num; index += 4)
+	{
+		SimdVector x, y, z, w;
+		LoadQuaternionBlock(quaternions + index, x, y, z, w);
+		NormaliseQuaternionBlock(x, y, z, w);
+		StoreQuaternionBlock(x, y, z, w, quaternions + index);
+	}
+
+	for (; index < num; ++index)
+		quaternions[index].Normalise();
+}
+
+// the difference additive * conjugate(reference), along the shortest path and scaled by weight, then applied to base
+static inline Quaternion AddAdditiveQuaternion(const Quaternion& base, const Quaternion& additive, const Quaternion& reference, const float weight)
+{
+	Quaternion inverse_reference;
+	inverse_reference.Conjugate(reference);
+	Quaternion difference = additive * inverse_reference;
+	if (difference.w < 0.0f)
+		difference = -difference;
+
+	Quaternion weighted_difference(difference.x*weight, difference.y*weight, difference.z*weight, (1.0f - weight) + difference.w*weight);
+	weighted_difference.Normalise();
+	return weighted_difference * base;
+}
+
+void AddAdditiveQuaternionsBatch(const Quaternion* base, const Quaternion* additive, const Quaternion* reference, const float weight, Quaternion* results, const Int32 num)
+{
+	const SimdVector weights = SimdSplat(weight);
+	const SimdVector identity_weights = SimdSplat(1.0f - weight);
+
+	Int32 index = 0;
+	for (; index + 4 <= num; index += 4)
+	{
+		SimdVector base_x, base_y, base_z, base_w, additive_x, additive_y, additive_z, additive_w, reference_x, reference_y, reference_z, reference_w;
+		LoadQuaternionBlock(base + index, base_x, base_y, base_z, base_w);
+		LoadQuaternionBlock(additive + index, additive_x, additive_y, additive_z, additive_w);
+		LoadQuaternionBlock(reference + index, reference_x, reference_y, reference_z, reference_w);
+
+		const SimdVector zero = SimdZero();
+		SimdVector x, y, z, w;
+		MultiplyQuaternionBlock(additive_x, additive_y, additive_z, additive_w,
+			SimdSub(zero, reference_x), SimdSub(zero, reference_y), SimdSub(zero, reference_z), reference_w, x, y, z, w);
+
+		// negate differences of more than 180 degrees, then scale the rotation
+		const SimdVector signed_weights = SimdSelectLess(w, zero, SimdSub(zero, weights), weights);
+		x = SimdMul(x, signed_weights);
+		y = SimdMul(y, signed_weights);
+		z = SimdMul(z, signed_weights);
+		w = SimdAdd(identity_weights, SimdMul(w, signed_weights));
+		NormaliseQuaternionBlock(x, y, z, w);
+
+		SimdVector result_x, result_y, result_z, result_w;
+		MultiplyQuaternionBlock(x, y, z, w, base_x, base_y, base_z, base_w, result_x, result_y, result_z, result_w);
+		StoreQuaternionBlock(result_x, result_y, result_z, result_w, results + index);
+	}
+
+	for (; index < num; ++index)
+		results[index] = AddAdditiveQuaternion(base[index], additive[index], reference[index], weight);
+}
+
 }
@@ -0,0 +1,127 @@
+#ifndef _GEF_SIMD_H
+#define _GEF_SIMD_H
+
+#include <gef.h>
+
+// Thin wrapper around the 4-wide float SIMD instruction set of the target
+// platform. SSE2 is used on x86/x64, NEON on ARM (PS Vita) and a plain
+// scalar implementation is used everywhere else.
+// Define GEF_NO_SIMD to force the scalar implementation.
+//
+// All loads and stores are unaligned. The gef maths classes are tightly
+// packed and serialised as raw memory so they can't rely on 16 byte alignment.
+
+#if !defined(GEF_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define GEF_SIMD_SSE
+#include <emmintrin.h>
+#elif !defined(GEF_NO_SIMD) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#define GEF_SIMD_NEON
+#include <arm_neon.h>
+#else
+#define GEF_SIMD_SCALAR
+#endif
+
+namespace gef
+{
+#if defined(GEF_SIMD_SSE)
+	typedef __m128 SimdVector;
+#elif defined(GEF_SIMD_NEON)
+	typedef float32x4_t SimdVector;
+#else
+	struct SimdVector
+	{
+		float v[4];
+	};
+#endif
+
+	/// @brief Loads four floats from memory. The address does not need to be aligned.
+	SimdVector SimdLoad(const float* values);
+
+	/// @brief Stores four floats to memory. The address does not need to be aligned.
+	void SimdStore(float* values, SimdVector v);
+
+	/// @return a vector with the lanes (x, y, z, w)
+	SimdVector SimdSet(float x, float y, float z, float w);
+
+	/// @return a vector with value in every lane
+	SimdVector SimdSplat(float value);
+
+	/// @return a vector with every lane set to zero
+	SimdVector SimdZero();
+
+	/// @return a vector with the x, y, z or w lane of v in every lane
+	SimdVector SimdSplatX(SimdVector v);
+	SimdVector SimdSplatY(SimdVector v);
+	SimdVector SimdSplatZ(SimdVector v);
+	SimdVector SimdSplatW(SimdVector v);
+
+	SimdVector SimdAdd(SimdVector a, SimdVector b);
+	SimdVector SimdSub(SimdVector a, SimdVector b);
+	SimdVector SimdMul(SimdVector a, SimdVector b);
+	SimdVector SimdDiv(SimdVector a, SimdVector b);
+
+	/// @return the lane wise square root of v
+	SimdVector SimdSqrt(SimdVector v);
+
+	/// @return the lane wise minimum of a and b
+	SimdVector SimdMin(SimdVector a, SimdVector b);
+
+	/// @return the lane wise maximum of a and b
+	SimdVector SimdMax(SimdVector a, SimdVector b);
+
+	/// @return the lane wise absolute value of v
+	SimdVector SimdAbs(SimdVector v);
+
+	/// @return a four bit mask with bit i set if a[i] < b[i]
+	Int32 SimdLessThanMask(SimdVector a, SimdVector b);
+
+	/// @return lane i is if_less[i] where a[i] < b[i], otherwise otherwise[i]
+	SimdVector SimdSelectLess(SimdVector a, SimdVector b, SimdVector if_less, SimdVector otherwise);
+
+	/// @return (a.x, a.y, a.z, b.w)
+	SimdVector SimdSelectXYZ(SimdVector a, SimdVector b);
+
+	/// @return (v[X], v[Y], v[Z], v[W])
+	template<int X, int Y, int Z, int W> SimdVector SimdSwizzle(SimdVector v);
+
+	/// @return (a[X], a[Y], b[Z], b[W])
+	template<int X, int Y, int Z, int W> SimdVector SimdShuffle(SimdVector a, SimdVector b);
+
+	/// @return (v.y, v.z, v.x, v.w)
+	SimdVector SimdSwizzleYZXW(SimdVector v);
+
+	/// @return (v.z, v.x, v.y, v.w)
+	SimdVector SimdSwizzleZXYW(SimdVector v);
+
+	/// @return (a.x, a.y, b.x, b.y)
+	SimdVector SimdCombineLow(SimdVector a, SimdVector b);
+
+	/// @return (a.z, a.w, b.z, b.w)
+	SimdVector SimdCombineHigh(SimdVector a, SimdVector b);
+
+	/// @return (a.x, a.z, b.x, b.z)
+	SimdVector SimdEvenLanes(SimdVector a, SimdVector b);
+
+	/// @return (a.y, a.w, b.y, b.w)
+	SimdVector SimdOddLanes(SimdVector a, SimdVector b);
+
+	/// @brief Transposes the 4x4 matrix held in the rows r0 to r3 in place.
+	void SimdTranspose4x4(SimdVector& r0, SimdVector& r1, SimdVector& r2, SimdVector& r3);
+
+	/// @brief Converts the four bytes of a packed 32 bit value to floats.
+	/// @param[in] packed	The packed value. The least significant byte ends up in the x lane.
+	/// @return the bytes as floats in the range [0, 255]
+	SimdVector SimdUnpackUByte4(UInt32 packed);
+
+	/// @brief Calculates the sine and cosine of four angles at once.
+	/// @param[in] angles	The angles in radians.
+	/// @param[out] s		The sine of each angle.
+	/// @param[out] c		The cosine of each angle.
+	/// @note The SIMD versions use a polynomial approximation with a maximum error around 1e-7
+	/// for angles in the range [-8192, 8192].
+	void SimdSinCos(SimdVector angles, SimdVector& s, SimdVector& c);
+}
+
+#include "simd.inl"
+
+#endif // _GEF_SIMD_H
@@ -0,0 +1,664 @@
+#include <math.h>
+
+namespace gef
+{
+#if defined(GEF_SIMD_SSE)
+
+	inline SimdVector SimdLoad(const float* values)
+	{
+		return _mm_loadu_ps(values);
+	}
+
+	inline void SimdStore(float* values, SimdVector v)
+	{
+		_mm_storeu_ps(values, v);
+	}
+
+	inline SimdVector SimdSet(float x, float y, float z, float w)
+	{
+		return _mm_setr_ps(x, y, z, w);
+	}
+
+	inline SimdVector SimdSplat(float value)
+	{
+		return _mm_set1_ps(value);
+	}
+
+	inline SimdVector SimdZero()
+	{
+		return _mm_setzero_ps();
+	}
+
+	inline SimdVector SimdSplatX(SimdVector v)
+	{
+		return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0));
+	}
+
+	inline SimdVector SimdSplatY(SimdVector v)
+	{
+		return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1));
+	}
+
+	inline SimdVector SimdSplatZ(SimdVector v)
+	{
+		return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2));
+	}
+
+	inline SimdVector SimdSplatW(SimdVector v)
+	{
+		return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3));
+	}
+
+	inline SimdVector SimdAdd(SimdVector a, SimdVector b)
+	{
+		return _mm_add_ps(a, b);
+	}
+
+	inline SimdVector SimdSub(SimdVector a, SimdVector b)
+	{
+		return _mm_sub_ps(a, b);
+	}
+
+	inline SimdVector SimdMul(SimdVector a, SimdVector b)
+	{
+		return _mm_mul_ps(a, b);
+	}
+
+	inline SimdVector SimdDiv(SimdVector a, SimdVector b)
+	{
+		return _mm_div_ps(a, b);
+	}
+
+	inline SimdVector SimdMin(SimdVector a, SimdVector b)
+	{
+		return _mm_min_ps(a, b);
+	}
+
+	inline SimdVector SimdMax(SimdVector a, SimdVector b)
+	{
+		return _mm_max_ps(a, b);
+	}
+
+	inline SimdVector SimdAbs(SimdVector v)
+	{
+		return _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff)));
+	}
+
+	inline Int32 SimdLessThanMask(SimdVector a, SimdVector b)
+	{
+		return _mm_movemask_ps(_mm_cmplt_ps(a, b));
+	}
+
+	inline SimdVector SimdSqrt(SimdVector v)
+	{
+		return _mm_sqrt_ps(v);
+	}
+
+	inline SimdVector SimdSelectLess(SimdVector a, SimdVector b, SimdVector if_less, SimdVector otherwise)
+	{
+		const __m128 mask = _mm_cmplt_ps(a, b);
+		return _mm_or_ps(_mm_and_ps(mask, if_less), _mm_andnot_ps(mask, otherwise));
+	}
+
+	inline SimdVector SimdSelectXYZ(SimdVector a, SimdVector b)
+	{
+		const __m128 mask = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+
+	template<int X, int Y, int Z, int W>
+	inline SimdVector SimdSwizzle(SimdVector v)
+	{
+		return _mm_shuffle_ps(v, v, _MM_SHUFFLE(W, Z, Y, X));
+	}
+
+	template<int X, int Y, int Z, int W>
+	inline SimdVector SimdShuffle(SimdVector a, SimdVector b)
+	{
+		return _mm_shuffle_ps(a, b, _MM_SHUFFLE(W, Z, Y, X));
+	}
+
+	inline SimdVector SimdSwizzleYZXW(SimdVector v)
+	{
+		return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 2, 1));
+	}
+
+	inline SimdVector SimdSwizzleZXYW(SimdVector v)
+	{
+		return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 1, 0, 2));
+	}
+
+	inline SimdVector SimdCombineLow(SimdVector a, SimdVector b)
+	{
+		return _mm_movelh_ps(a, b);
+	}
+
+	inline SimdVector SimdCombineHigh(SimdVector a, SimdVector b)
+	{
+		return _mm_movehl_ps(b, a);
+	}
+
+	inline SimdVector SimdEvenLanes(SimdVector a, SimdVector b)
+	{
+		return _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+	}
+
+	inline SimdVector SimdOddLanes(SimdVector a, SimdVector b)
+	{
+		return _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+	}
+
+	inline void SimdTranspose4x4(SimdVector& r0, SimdVector& r1, SimdVector& r2, SimdVector& r3)
+	{
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+	}
+
+	inline SimdVector SimdUnpackUByte4(UInt32 packed)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		__m128i bytes = _mm_cvtsi32_si128(static_cast<int>(packed));
+		bytes = _mm_unpacklo_epi8(bytes, zero);
+		bytes = _mm_unpacklo_epi16(bytes, zero);
+		return _mm_cvtepi32_ps(bytes);
+	}
+
+	inline void SimdSinCos(SimdVector angles, SimdVector& s, SimdVector& c)
+	{
+		// Cephes single precision sincos, four lanes at a time
+		const __m128 sign_mask = _mm_castsi128_ps(_mm_set1_epi32(0x80000000));
+		const __m128i one_i = _mm_set1_epi32(1);
+		const __m128i two_i = _mm_set1_epi32(2);
+		const __m128i four_i = _mm_set1_epi32(4);
+
+		__m128 sign_sin = _mm_and_ps(angles, sign_mask);
+		__m128 x = _mm_andnot_ps(sign_mask, angles);
+
+		// octant of the angle, rounded up to an even number
+		__m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, _mm_set1_ps(1.27323954473516f)));
+		j = _mm_andnot_si128(one_i, _mm_add_epi32(j, one_i));
+		__m128 y = _mm_cvtepi32_ps(j);
+
+		sign_sin = _mm_xor_ps(sign_sin, _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, four_i), 29)));
+		const __m128 sign_cos = _mm_castsi128_ps(_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, two_i), four_i), 29));
+		const __m128 poly_mask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, two_i), _mm_setzero_si128()));
+
+		// extended precision modular arithmetic
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(0.78515625f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(2.4187564849853515625e-4f)));
+		x = _mm_sub_ps(x, _mm_mul_ps(y, _mm_set1_ps(3.77489497744594108e-8f)));
+
+		const __m128 z = _mm_mul_ps(x, x);
+
+		__m128 poly_cos = _mm_set1_ps(2.443315711809948e-5f);
+		poly_cos = _mm_add_ps(_mm_mul_ps(poly_cos, z), _mm_set1_ps(-1.388731625493765e-3f));
+		poly_cos = _mm_add_ps(_mm_mul_ps(poly_cos, z), _mm_set1_ps(4.166664568298827e-2f));
+		poly_cos = _mm_mul_ps(_mm_mul_ps(poly_cos, z), z);
+		poly_cos = _mm_sub_ps(poly_cos, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+		poly_cos = _mm_add_ps(poly_cos, _mm_set1_ps(1.0f));
+
+		__m128 poly_sin = _mm_set1_ps(-1.9515295891e-4f);
+		poly_sin = _mm_add_ps(_mm_mul_ps(poly_sin, z), _mm_set1_ps(8.3321608736e-3f));
+		poly_sin = _mm_add_ps(_mm_mul_ps(poly_sin, z), _mm_set1_ps(-1.6666654611e-1f));
+		poly_sin = _mm_mul_ps(_mm_mul_ps(poly_sin, z), x);
+		poly_sin = _mm_add_ps(poly_sin, x);
+
+		// pick the right polynomial for each octant
+		const __m128 sin_result = _mm_or_ps(_mm_and_ps(poly_mask, poly_sin), _mm_andnot_ps(poly_mask, poly_cos));
+		const __m128 cos_result = _mm_or_ps(_mm_and_ps(poly_mask, poly_cos), _mm_andnot_ps(poly_mask, poly_sin));
+
+		s = _mm_xor_ps(sin_result, sign_sin);
+		c = _mm_xor_ps(cos_result, sign_cos);
+	}
+
+#elif defined(GEF_SIMD_NEON)
+
+	inline SimdVector SimdLoad(const float* values)
+	{
+		return vld1q_f32(values);
+	}
+
+	inline void SimdStore(float* values, SimdVector v)
+	{
+		vst1q_f32(values, v);
+	}
+
+	inline SimdVector SimdSet(float x, float y, float z, float w)
+	{
+		const float values[4] = { x, y, z, w };
+		return vld1q_f32(values);
+	}
+
+	inline SimdVector SimdSplat(float value)
+	{
+		return vdupq_n_f32(value);
+	}
+
+	inline SimdVector SimdZero()
+	{
+		return vdupq_n_f32(0.0f);
+	}
+
+	inline SimdVector SimdSplatX(SimdVector v)
+	{
+		return vdupq_lane_f32(vget_low_f32(v), 0);
+	}
+
+	inline SimdVector SimdSplatY(SimdVector v)
+	{
+		return vdupq_lane_f32(vget_low_f32(v), 1);
+	}
+
+	inline SimdVector SimdSplatZ(SimdVector v)
+	{
+		return vdupq_lane_f32(vget_high_f32(v), 0);
+	}
+
+	inline SimdVector SimdSplatW(SimdVector v)
+	{
+		return vdupq_lane_f32(vget_high_f32(v), 1);
+	}
+
+	inline SimdVector SimdAdd(SimdVector a, SimdVector b)
+	{
+		return vaddq_f32(a, b);
+	}
+
+	inline SimdVector SimdSub(SimdVector a, SimdVector b)
+	{
+		return vsubq_f32(a, b);
+	}
+
+	inline SimdVector SimdMul(SimdVector a, SimdVector b)
+	{
+		return vmulq_f32(a, b);
+	}
+
+	inline SimdVector SimdDiv(SimdVector a, SimdVector b)
+	{
+		// NEON has no divide instruction and the reciprocal estimate isn't exact,
+		// divide each lane so results match the scalar code
+		float values_a[4], values_b[4];
+		vst1q_f32(values_a, a);
+		vst1q_f32(values_b, b);
+		values_a[0] /= values_b[0];
+		values_a[1] /= values_b[1];
+		values_a[2] /= values_b[2];
+		values_a[3] /= values_b[3];
+		return vld1q_f32(values_a);
+	}
+
+	inline SimdVector SimdMin(SimdVector a, SimdVector b)
+	{
+		return vminq_f32(a, b);
+	}
+
+	inline SimdVector SimdMax(SimdVector a, SimdVector b)
+	{
+		return vmaxq_f32(a, b);
+	}
+
+	inline SimdVector SimdAbs(SimdVector v)
+	{
+		return vabsq_f32(v);
+	}
+
+	inline Int32 SimdLessThanMask(SimdVector a, SimdVector b)
+	{
+		// keep one bit per lane then add the lanes together
+		static const uint32_t lane_bits[4] = { 1, 2, 4, 8 };
+		const uint32x4_t bits = vandq_u32(vcltq_f32(a, b), vld1q_u32(lane_bits));
+		const uint32x2_t sum = vadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+		return static_cast<Int32>(vget_lane_u32(vpadd_u32(sum, sum), 0));
+	}
+
+	inline SimdVector SimdSqrt(SimdVector v)
+	{
+		// ARMv7 NEON only has a square root estimate, so each lane is done like SimdDiv
+		float values[4];
+		vst1q_f32(values, v);
+		values[0] = sqrtf(values[0]);
+		values[1] = sqrtf(values[1]);
+		values[2] = sqrtf(values[2]);
+		values[3] = sqrtf(values[3]);
+		return vld1q_f32(values);
+	}
+
+	inline SimdVector SimdSelectLess(SimdVector a, SimdVector b, SimdVector if_less, SimdVector otherwise)
+	{
+		return vbslq_f32(vcltq_f32(a, b), if_less, otherwise);
+	}
+
+	inline SimdVector SimdSelectXYZ(SimdVector a, SimdVector b)
+	{
+		return vsetq_lane_f32(vgetq_lane_f32(b, 3), a, 3);
+	}
+
+	template<int X, int Y, int Z, int W>
+	inline SimdVector SimdSwizzle(SimdVector v)
+	{
+		// no general permute on ARMv7, move the lanes one at a time
+		float32x4_t result = vdupq_n_f32(vgetq_lane_f32(v, X));
+		result = vsetq_lane_f32(vgetq_lane_f32(v, Y), result, 1);
+		result = vsetq_lane_f32(vgetq_lane_f32(v, Z), result, 2);
+		return vsetq_lane_f32(vgetq_lane_f32(v, W), result, 3);
+	}
+
+	template<int X, int Y, int Z, int W>
+	inline SimdVector SimdShuffle(SimdVector a, SimdVector b)
+	{
+		float32x4_t result = vdupq_n_f32(vgetq_lane_f32(a, X));
+		result = vsetq_lane_f32(vgetq_lane_f32(a, Y), result, 1);
+		result = vsetq_lane_f32(vgetq_lane_f32(b, Z), result, 2);
+		return vsetq_lane_f32(vgetq_lane_f32(b, W), result, 3);
+	}
+
+	inline SimdVector SimdSwizzleYZXW(SimdVector v)
+	{
+		// (y, z, w, x) then swap the top two lanes
+		const float32x4_t yzwx = vextq_f32(v, v, 1);
+		return vcombine_f32(vget_low_f32(yzwx), vrev64_f32(vget_high_f32(yzwx)));
+	}
+
+	inline SimdVector SimdSwizzleZXYW(SimdVector v)
+	{
+		return SimdSwizzleYZXW(SimdSwizzleYZXW(v));
+	}
+
+	inline SimdVector SimdCombineLow(SimdVector a, SimdVector b)
+	{
+		return vcombine_f32(vget_low_f32(a), vget_low_f32(b));
+	}
+
+	inline SimdVector SimdCombineHigh(SimdVector a, SimdVector b)
+	{
+		return vcombine_f32(vget_high_f32(a), vget_high_f32(b));
+	}
+
+	inline SimdVector SimdEvenLanes(SimdVector a, SimdVector b)
+	{
+		return vuzpq_f32(a, b).val[0];
+	}
+
+	inline SimdVector SimdOddLanes(SimdVector a, SimdVector b)
+	{
+		return vuzpq_f32(a, b).val[1];
+	}
+
+	inline void SimdTranspose4x4(SimdVector& r0, SimdVector& r1, SimdVector& r2, SimdVector& r3)
+	{
+		const float32x4x2_t t01 = vtrnq_f32(r0, r1);
+		const float32x4x2_t t23 = vtrnq_f32(r2, r3);
+		r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+		r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+		r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+		r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+	}
+
+	inline SimdVector SimdUnpackUByte4(UInt32 packed)
+	{
+		const uint8x8_t bytes = vreinterpret_u8_u32(vdup_n_u32(packed));
+		const uint16x4_t shorts = vget_low_u16(vmovl_u8(bytes));
+		return vcvtq_f32_u32(vmovl_u16(shorts));
+	}
+
+	inline void SimdSinCos(SimdVector angles, SimdVector& s, SimdVector& c)
+	{
+		// Cephes single precision sincos, four lanes at a time
+		const uint32x4_t sign_mask = vdupq_n_u32(0x80000000);
+		const uint32x4_t one_u = vdupq_n_u32(1);
+		const uint32x4_t two_u = vdupq_n_u32(2);
+		const uint32x4_t four_u = vdupq_n_u32(4);
+
+		uint32x4_t sign_sin = vandq_u32(vreinterpretq_u32_f32(angles), sign_mask);
+		float32x4_t x = vabsq_f32(angles);
+
+		// octant of the angle, rounded up to an even number
+		uint32x4_t j = vcvtq_u32_f32(vmulq_f32(x, vdupq_n_f32(1.27323954473516f)));
+		j = vbicq_u32(vaddq_u32(j, one_u), one_u);
+		const float32x4_t y = vcvtq_f32_u32(j);
+
+		sign_sin = veorq_u32(sign_sin, vshlq_n_u32(vandq_u32(j, four_u), 29));
+		const uint32x4_t sign_cos = vshlq_n_u32(vbicq_u32(four_u, vsubq_u32(j, two_u)), 29);
+		const uint32x4_t poly_mask = vceqq_u32(vandq_u32(j, two_u), vdupq_n_u32(0));
+
+		// extended precision modular arithmetic
+		x = vsubq_f32(x, vmulq_f32(y, vdupq_n_f32(0.78515625f)));
+		x = vsubq_f32(x, vmulq_f32(y, vdupq_n_f32(2.4187564849853515625e-4f)));
+		x = vsubq_f32(x, vmulq_f32(y, vdupq_n_f32(3.77489497744594108e-8f)));
+
+		const float32x4_t z = vmulq_f32(x, x);
+
+		float32x4_t poly_cos = vdupq_n_f32(2.443315711809948e-5f);
+		poly_cos = vaddq_f32(vmulq_f32(poly_cos, z), vdupq_n_f32(-1.388731625493765e-3f));
+		poly_cos = vaddq_f32(vmulq_f32(poly_cos, z), vdupq_n_f32(4.166664568298827e-2f));
+		poly_cos = vmulq_f32(vmulq_f32(poly_cos, z), z);
+		poly_cos = vsubq_f32(poly_cos, vmulq_f32(z, vdupq_n_f32(0.5f)));
+		poly_cos = vaddq_f32(poly_cos, vdupq_n_f32(1.0f));
+
+		float32x4_t poly_sin = vdupq_n_f32(-1.9515295891e-4f);
+		poly_sin = vaddq_f32(vmulq_f32(poly_sin, z), vdupq_n_f32(8.3321608736e-3f));
+		poly_sin = vaddq_f32(vmulq_f32(poly_sin, z), vdupq_n_f32(-1.6666654611e-1f));
+		poly_sin = vmulq_f32(vmulq_f32(poly_sin, z), x);
+		poly_sin = vaddq_f32(poly_sin, x);
+
+		// pick the right polynomial for each octant
+		const float32x4_t sin_result = vbslq_f32(poly_mask, poly_sin, poly_cos);
+		const float32x4_t cos_result = vbslq_f32(poly_mask, poly_cos, poly_sin);
+
+		s = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(sin_result), sign_sin));
+		c = vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(cos_result), sign_cos));
+	}
+
+#else
+
+	inline SimdVector SimdLoad(const float* values)
+	{
+		SimdVector result = { { values[0], values[1], values[2], values[3] } };
+		return result;
+	}
+
+	inline void SimdStore(float* values, SimdVector v)
+	{
+		values[0] = v.v[0];
+		values[1] = v.v[1];
+		values[2] = v.v[2];
+		values[3] = v.v[3];
+	}
+
+	inline SimdVector SimdSet(float x, float y, float z, float w)
+	{
+		SimdVector result = { { x, y, z, w } };
+		return result;
+	}
+
+	inline SimdVector SimdSplat(float value)
+	{
+		SimdVector result = { { value, value, value, value } };
+		return result;
+	}
+
+	inline SimdVector SimdZero()
+	{
+		return SimdSplat(0.0f);
+	}
+
+	inline SimdVector SimdSplatX(SimdVector v)
+	{
+		return SimdSplat(v.v[0]);
+	}
+
+	inline SimdVector SimdSplatY(SimdVector v)
+	{
+		return SimdSplat(v.v[1]);
+	}
+
+	inline SimdVector SimdSplatZ(SimdVector v)
+	{
+		return SimdSplat(v.v[2]);
+	}
+
+	inline SimdVector SimdSplatW(SimdVector v)
+	{
+		return SimdSplat(v.v[3]);
+	}
+
+	inline SimdVector SimdAdd(SimdVector a, SimdVector b)
+	{
+		SimdVector result = { { a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3] } };
+		return result;
+	}
+
+	inline SimdVector SimdSub(SimdVector a, SimdVector b)
+	{
+		SimdVector result = { { a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3] } };
+		return result;
+	}
+
+	inline SimdVector SimdMul(SimdVector a, SimdVector b)
+	{
+		SimdVector result = { { a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3] } };
+		return result;
+	}
+
+	inline SimdVector SimdDiv(SimdVector a, SimdVector b)
+	{
+		SimdVector result = { { a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3] } };
+		return result;
+	}
+
+	inline SimdVector SimdMin(SimdVector a, SimdVector b)
+	{
+		SimdVector result = { {
+			a.v[0] < b.v[0] ? a.v[0] : b.v[0],
+			a.v[1] < b.v[1] ? a.v[1] : b.v[1],
+			a.v[2] < b.v[2] ? a.v[2] : b.v[2],
+			a.v[3] < b.v[3] ? a.v[3] : b.v[3] } };
+		return result;
+	}
+
+	inline SimdVector SimdMax(SimdVector a, SimdVector b)
+	{
+		SimdVector result = { {
+			a.v[0] > b.v[0] ? a.v[0] : b.v[0],
+			a.v[1] > b.v[1] ? a.v[1] : b.v[1],
+			a.v[2] > b.v[2] ? a.v[2] : b.v[2],
+			a.v[3] > b.v[3] ? a.v[3] : b.v[3] } };
+		return result;
+	}
+
+	inline SimdVector SimdAbs(SimdVector v)
+	{
+		SimdVector result = { { fabsf(v.v[0]), fabsf(v.v[1]), fabsf(v.v[2]), fabsf(v.v[3]) } };
+		return result;
+	}
+
+	inline Int32 SimdLessThanMask(SimdVector a, SimdVector b)
+	{
+		return (a.v[0] < b.v[0] ? 1 : 0) | (a.v[1] < b.v[1] ? 2 : 0) | (a.v[2] < b.v[2] ? 4 : 0) | (a.v[3] < b.v[3] ? 8 : 0);
+	}
+
+	inline SimdVector SimdSqrt(SimdVector v)
+	{
+		SimdVector result = { { sqrtf(v.v[0]), sqrtf(v.v[1]), sqrtf(v.v[2]), sqrtf(v.v[3]) } };
+		return result;
+	}
+
+	inline SimdVector SimdSelectLess(SimdVector a, SimdVector b, SimdVector if_less, SimdVector otherwise)
+	{
+		SimdVector result = { {
+			a.v[0] < b.v[0] ? if_less.v[0] : otherwise.v[0],
+			a.v[1] < b.v[1] ? if_less.v[1] : otherwise.v[1],
+			a.v[2] < b.v[2] ? if_less.v[2] : otherwise.v[2],
+			a.v[3] < b.v[3] ? if_less.v[3] : otherwise.v[3] } };
+		return result;
+	}
+
+	inline SimdVector SimdSelectXYZ(SimdVector a, SimdVector b)
+	{
+		SimdVector result = { { a.v[0], a.v[1], a.v[2], b.v[3] } };
+		return result;
+	}
+
+	template<int X, int Y, int Z, int W>
+	inline SimdVector SimdSwizzle(SimdVector v)
+	{
+		SimdVector result = { { v.v[X], v.v[Y], v.v[Z], v.v[W] } };
+		return result;
+	}
+
+	template<int X, int Y, int Z, int W>
+	inline SimdVector SimdShuffle(SimdVector a, SimdVector b)
+	{
+		SimdVector result = { { a.v[X], a.v[Y], b.v[Z], b.v[W] } };
+		return result;
+	}
+
+	inline SimdVector SimdSwizzleYZXW(SimdVector v)
+	{
+		SimdVector result = { { v.v[1], v.v[2], v.v[0], v.v[3] } };
+		return result;
+	}
+
+	inline SimdVector SimdSwizzleZXYW(SimdVector v)
+	{
+		SimdVector result = { { v.v[2], v.v[0], v.v[1], v.v[3] } };
+		return result;
+	}
+
+	inline SimdVector SimdCombineLow(SimdVector a, SimdVector b)
+	{
+		SimdVector result = { { a.v[0], a.v[1], b.v[0], b.v[1] } };
+		return result;
+	}
+
+	inline SimdVector SimdCombineHigh(SimdVector a, SimdVector b)
+	{
+		SimdVector result = { { a.v[2], a.v[3], b.v[2], b.v[3] } };
+		return result;
+	}
+
+	inline SimdVector SimdEvenLanes(SimdVector a, SimdVector b)
+	{
+		SimdVector result = { { a.v[0], a.v[2], b.v[0], b.v[2] } };
+		return result;
+	}
+
+	inline SimdVector SimdOddLanes(SimdVector a, SimdVector b)
+	{
+		SimdVector result = { { a.v[1], a.v[3], b.v[1], b.v[3] } };
+		return result;
+	}
+
+	inline void SimdTranspose4x4(SimdVector& r0, SimdVector& r1, SimdVector& r2, SimdVector& r3)
+	{
+		const SimdVector c0 = { { r0.v[0], r1.v[0], r2.v[0], r3.v[0] } };
+		const SimdVector c1 = { { r0.v[1], r1.v[1], r2.v[1], r3.v[1] } };
+		const SimdVector c2 = { { r0.v[2], r1.v[2], r2.v[2], r3.v[2] } };
+		const SimdVector c3 = { { r0.v[3], r1.v[3], r2.v[3], r3.v[3] } };
+		r0 = c0;
+		r1 = c1;
+		r2 = c2;
+		r3 = c3;
+	}
+
+	inline SimdVector SimdUnpackUByte4(UInt32 packed)
+	{
+		SimdVector result = { {
+			static_cast<float>(packed & 0x000000ff),
+			static_cast<float>((packed >> 8) & 0x000000ff),
+			static_cast<float>((packed >> 16) & 0x000000ff),
+			static_cast<float>((packed >> 24) & 0x000000ff) } };
+		return result;
+	}
+
+	inline void SimdSinCos(SimdVector angles, SimdVector& s, SimdVector& c)
+	{
+		for (Int32 lane = 0; lane < 4; ++lane)
+		{
+			s.v[lane] = sinf(angles.v[lane]);
+			c.v[lane] = cosf(angles.v[lane]);
+		}
+	}
+
+#endif
+}
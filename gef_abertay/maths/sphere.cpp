@@ -1,5 +1,6 @@
 #include <maths/sphere.h>
 #include <maths/aabb.h>
+#include <maths/transform_batch.h>
 
 namespace gef
 {
@@ -23,16 +24,7 @@ namespace gef
 	const Sphere Sphere::Transform(const Matrix44& transform_matrix) const
 	{
 		Sphere result;
-
-		Vector4 point_on_sphere(1.0f, 1.0f, 1.0f);
-		point_on_sphere.Normalise();
-
-		point_on_sphere *= radius_;
-
-		point_on_sphere = point_on_sphere.TransformNoTranslation(transform_matrix);
-		result.set_radius(point_on_sphere.Length());
-		result.set_position(position_.Transform(transform_matrix));
-
+		TransformSpheresBatch(transform_matrix, this, &result, 1);
 		return result;
 	}
 }
\ No newline at end of file
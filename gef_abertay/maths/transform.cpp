@@ -32,13 +32,13 @@ namespace gef
 		scale_ = matrix.GetScale();
 	}
 
-	void Transform::Linear2TransformBlend(const gef::Transform& start, const gef::Transform& end, const float time)
+	void Transform::Linear2TransformBlend(const gef::Transform& start, const gef::Transform& end, const float time, const QuaternionBlend blend)
 	{
 		Vector4 scale(1.0f, 1.0f, 1.0f), translation;
 		Quaternion rotation;
 		scale.Lerp(start.scale(), end.scale(), time);
 		translation.Lerp(start.translation(), end.translation(), time);
-		rotation.Slerp(start.rotation(), end.rotation(), time);
+		BlendQuaternion(start.rotation(), end.rotation(), time, rotation, blend);
 		set_scale(scale);
 		set_rotation(rotation);
 		set_translation(translation);
@@ -14,7 +14,10 @@ namespace gef
 		Transform(const Matrix44& matrix);
 		const Matrix44 GetMatrix() const;
 		void Set(const Matrix44& matrix);
-		void Linear2TransformBlend(const gef::Transform& start, const gef::Transform& end, const float time);
+		
+		/// @brief Blends two transforms. Scale and translation are lerped, rotation blended with blend.
+		/// @param[in] blend	How accurately to blend the rotation. Exact Slerp unless a faster blend is asked for.
+		void Linear2TransformBlend(const gef::Transform& start, const gef::Transform& end, const float time, const QuaternionBlend blend = QB_SLERP);
 
 		inline void set_rotation(const Quaternion& rot) { rotation_ = rot; }
 		inline const Quaternion& rotation() const { return rotation_; }
@@ -0,0 +1,461 @@
+#include <maths/transform_batch.h>
+#include <maths/matrix44.h>
+#include <maths/aabb.h>
+#include <maths/sphere.h>
+#include <maths/quaternion.h>
+#include <math.h>
+#include <maths/simd.h>
+
+namespace gef
+{
+	// matrix elements splatted across all four lanes, so four positions held as
+	// separate x, y and z vectors can be transformed together
+	struct SplatMatrix
+	{
+		SimdVector rows[4][3];
+	};
+
+	static void SplatMatrixElements(const Matrix44& matrix, SplatMatrix& splat)
+	{
+		for (Int32 row = 0; row < 4; ++row)
+		{
+			for (Int32 column = 0; column < 3; ++column)
+				splat.rows[row][column] = SimdSplat(matrix.m(row, column));
+		}
+	}
+
+	// x*row0 + y*row1 + z*row2 (+ row3), summed in the same order as Vector4::Transform
+	static inline void TransformBlock(const SplatMatrix& matrix, const bool translate,
+		const SimdVector x, const SimdVector y, const SimdVector z,
+		SimdVector& result_x, SimdVector& result_y, SimdVector& result_z)
+	{
+		SimdVector values[3];
+		for (Int32 column = 0; column < 3; ++column)
+		{
+			SimdVector value = SimdMul(x, matrix.rows[0][column]);
+			value = SimdAdd(value, SimdMul(y, matrix.rows[1][column]));
+			value = SimdAdd(value, SimdMul(z, matrix.rows[2][column]));
+			if (translate)
+				value = SimdAdd(value, matrix.rows[3][column]);
+			values[column] = value;
+		}
+
+		result_x = values[0];
+		result_y = values[1];
+		result_z = values[2];
+	}
+
+	static inline const float* Advance(const float* values, const UInt32 num_bytes)
+	{
+		return reinterpret_cast<const float*>(reinterpret_cast<const UInt8*>(values) + num_bytes);
+	}
+
+	static inline float* Advance(float* values, const UInt32 num_bytes)
+	{
+		return reinterpret_cast<float*>(reinterpret_cast<UInt8*>(values) + num_bytes);
+	}
+
+	static void TransformBatch(const Matrix44& matrix, const bool translate, const float* positions, const UInt32 stride, float* results, const UInt32 result_stride, const Int32 num_positions)
+	{
+		SplatMatrix splat;
+		SplatMatrixElements(matrix, splat);
+
+		for (Int32 block_start = 0; block_start < num_positions; block_start += 4)
+		{
+			// gather up to four positions into x, y and z vectors, unused lanes are zero
+			const Int32 block_size = num_positions - block_start < 4 ? num_positions - block_start : 4;
+			float x[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			float y[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			float z[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for (Int32 lane = 0; lane < block_size; ++lane)
+			{
+				x[lane] = positions[0];
+				y[lane] = positions[1];
+				z[lane] = positions[2];
+				positions = Advance(positions, stride);
+			}
+
+			SimdVector result_x, result_y, result_z;
+			TransformBlock(splat, translate, SimdLoad(x), SimdLoad(y), SimdLoad(z), result_x, result_y, result_z);
+			SimdStore(x, result_x);
+			SimdStore(y, result_y);
+			SimdStore(z, result_z);
+
+			// all of the block has been read before anything is written, so in place transforms are safe
+			for (Int32 lane = 0; lane < block_size; ++lane)
+			{
+				results[0] = x[lane];
+				results[1] = y[lane];
+				results[2] = z[lane];
+				results = Advance(results, result_stride);
+			}
+		}
+	}
+
+	static void TransformBatchSoA(const Matrix44& matrix, const bool translate, const float* x, const float* y, const float* z,
+		float* result_x, float* result_y, float* result_z, const Int32 num_positions)
+	{
+		SplatMatrix splat;
+		SplatMatrixElements(matrix, splat);
+
+		Int32 index = 0;
+		for (; index + 4 <= num_positions; index += 4)
+		{
+			SimdVector transformed_x, transformed_y, transformed_z;
+			TransformBlock(splat, translate, SimdLoad(x + index), SimdLoad(y + index), SimdLoad(z + index), transformed_x, transformed_y, transformed_z);
+			SimdStore(result_x + index, transformed_x);
+			SimdStore(result_y + index, transformed_y);
+			SimdStore(result_z + index, transformed_z);
+		}
+
+		// pad the last few positions out to a full block
+		if (index < num_positions)
+		{
+			const Int32 block_size = num_positions - index;
+			float tail_x[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			float tail_y[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			float tail_z[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+			for (Int32 lane = 0; lane < block_size; ++lane)
+			{
+				tail_x[lane] = x[index + lane];
+				tail_y[lane] = y[index + lane];
+				tail_z[lane] = z[index + lane];
+			}
+
+			SimdVector transformed_x, transformed_y, transformed_z;
+			TransformBlock(splat, translate, SimdLoad(tail_x), SimdLoad(tail_y), SimdLoad(tail_z), transformed_x, transformed_y, transformed_z);
+			SimdStore(tail_x, transformed_x);
+			SimdStore(tail_y, transformed_y);
+			SimdStore(tail_z, transformed_z);
+
+			for (Int32 lane = 0; lane < block_size; ++lane)
+			{
+				result_x[index + lane] = tail_x[lane];
+				result_y[index + lane] = tail_y[lane];
+				result_z[index + lane] = tail_z[lane];
+			}
+		}
+	}
+
+	void TransformPointsBatch(const Matrix44& matrix, const float* positions, const UInt32 stride, float* results, const UInt32 result_stride, const Int32 num_positions)
+	{
+		TransformBatch(matrix, true, positions, stride, results, result_stride, num_positions);
+	}
+
+	void TransformVectorsBatch(const Matrix44& matrix, const float* vectors, const UInt32 stride, float* results, const UInt32 result_stride, const Int32 num_vectors)
+	{
+		TransformBatch(matrix, false, vectors, stride, results, result_stride, num_vectors);
+	}
+
+	void TransformPointsBatchSoA(const Matrix44& matrix, const float* x, const float* y, const float* z,
+		float* result_x, float* result_y, float* result_z, const Int32 num_positions)
+	{
+		TransformBatchSoA(matrix, true, x, y, z, result_x, result_y, result_z, num_positions);
+	}
+
+	void TransformVectorsBatchSoA(const Matrix44& matrix, const float* x, const float* y, const float* z,
+		float* result_x, float* result_y, float* result_z, const Int32 num_vectors)
+	{
+		TransformBatchSoA(matrix, false, x, y, z, result_x, result_y, result_z, num_vectors);
+	}
+
+	Aabb CalculateBoundsBatch(const float* positions, const UInt32 stride, const Int32 num_positions)
+	{
+		if (num_positions <= 0)
+			return Aabb();
+
+		// the first position seeds every lane, so a partial last block can repeat it
+		const float first_x = positions[0];
+		const float first_y = positions[1];
+		const float first_z = positions[2];
+		SimdVector min_x = SimdSplat(first_x), min_y = SimdSplat(first_y), min_z = SimdSplat(first_z);
+		SimdVector max_x = min_x, max_y = min_y, max_z = min_z;
+
+		for (Int32 block_start = 0; block_start < num_positions; block_start += 4)
+		{
+			const Int32 block_size = num_positions - block_start < 4 ? num_positions - block_start : 4;
+			float x[4] = { first_x, first_x, first_x, first_x };
+			float y[4] = { first_y, first_y, first_y, first_y };
+			float z[4] = { first_z, first_z, first_z, first_z };
+			for (Int32 lane = 0; lane < block_size; ++lane)
+			{
+				x[lane] = positions[0];
+				y[lane] = positions[1];
+				z[lane] = positions[2];
+				positions = Advance(positions, stride);
+			}
+
+			const SimdVector block_x = SimdLoad(x), block_y = SimdLoad(y), block_z = SimdLoad(z);
+			min_x = SimdMin(min_x, block_x);
+			min_y = SimdMin(min_y, block_y);
+			min_z = SimdMin(min_z, block_z);
+			max_x = SimdMax(max_x, block_x);
+			max_y = SimdMax(max_y, block_y);
+			max_z = SimdMax(max_z, block_z);
+		}
+
+		// reduce the four lanes down to one
+		min_x = SimdMin(min_x, SimdSwizzle<2, 3, 0, 1>(min_x));
+		min_y = SimdMin(min_y, SimdSwizzle<2, 3, 0, 1>(min_y));
+		min_z = SimdMin(min_z, SimdSwizzle<2, 3, 0, 1>(min_z));
+		max_x = SimdMax(max_x, SimdSwizzle<2, 3, 0, 1>(max_x));
+		max_y = SimdMax(max_y, SimdSwizzle<2, 3, 0, 1>(max_y));
+		max_z = SimdMax(max_z, SimdSwizzle<2, 3, 0, 1>(max_z));
+
+		// then gather the x, y and z results, the two halves still need combining
+		const SimdVector min_xy = SimdCombineLow(min_x, min_y), min_zz = SimdCombineLow(min_z, min_z);
+		const SimdVector max_xy = SimdCombineLow(max_x, max_y), max_zz = SimdCombineLow(max_z, max_z);
+		const SimdVector min_values_low = SimdEvenLanes(min_xy, min_zz), min_values_high = SimdOddLanes(min_xy, min_zz);
+		const SimdVector max_values_low = SimdEvenLanes(max_xy, max_zz), max_values_high = SimdOddLanes(max_xy, max_zz);
+
+		float min_values[4], max_values[4];
+		SimdStore(min_values, SimdMin(min_values_low, min_values_high));
+		SimdStore(max_values, SimdMax(max_values_low, max_values_high));
+
+		return Aabb(Vector4(min_values[0], min_values[1], min_values[2]), Vector4(max_values[0], max_values[1], max_values[2]));
+	}
+
+	// Arvo's method: each output axis is the translation plus, for every input axis, the smaller
+	// (or larger) of the matrix row scaled by the box min and max. Rounding is monotonic and the
+	// terms are summed in the same order as Vector4::Transform, so this gives exactly the bounds
+	// of the eight transformed corners.
+	static inline void TransformAabb(const SimdVector row0, const SimdVector row1, const SimdVector row2, const SimdVector row3, const Aabb& box, Aabb& result)
+	{
+		const SimdVector box_min = box.min_vtx().simd_values();
+		const SimdVector box_max = box.max_vtx().simd_values();
+
+		const SimdVector x_min = SimdMul(SimdSplatX(box_min), row0), x_max = SimdMul(SimdSplatX(box_max), row0);
+		const SimdVector y_min = SimdMul(SimdSplatY(box_min), row1), y_max = SimdMul(SimdSplatY(box_max), row1);
+		const SimdVector z_min = SimdMul(SimdSplatZ(box_min), row2), z_max = SimdMul(SimdSplatZ(box_max), row2);
+
+		SimdVector result_min = SimdAdd(SimdMin(x_min, x_max), SimdMin(y_min, y_max));
+		result_min = SimdAdd(result_min, SimdMin(z_min, z_max));
+		result_min = SimdAdd(result_min, row3);
+
+		SimdVector result_max = SimdAdd(SimdMax(x_min, x_max), SimdMax(y_min, y_max));
+		result_max = SimdAdd(result_max, SimdMax(z_min, z_max));
+		result_max = SimdAdd(result_max, row3);
+
+		const SimdVector zero = SimdZero();
+		Vector4 min_vtx, max_vtx;
+		min_vtx.set_simd_values(SimdSelectXYZ(result_min, zero));
+		max_vtx.set_simd_values(SimdSelectXYZ(result_max, zero));
+		result = Aabb(min_vtx, max_vtx);
+	}
+
+	void TransformAabbsBatch(const Matrix44& matrix, const Aabb* boxes, Aabb* results, const Int32 num_boxes)
+	{
+		const SimdVector row0 = matrix.GetRow(0).simd_values();
+		const SimdVector row1 = matrix.GetRow(1).simd_values();
+		const SimdVector row2 = matrix.GetRow(2).simd_values();
+		const SimdVector row3 = matrix.GetRow(3).simd_values();
+
+		for (Int32 box_num = 0; box_num < num_boxes; ++box_num)
+			TransformAabb(row0, row1, row2, row3, boxes[box_num], results[box_num]);
+	}
+
+	void TransformAabbsBatch(const Matrix44* matrices, const Aabb* boxes, Aabb* results, const Int32 num_boxes)
+	{
+		for (Int32 box_num = 0; box_num < num_boxes; ++box_num)
+		{
+			const Matrix44& matrix = matrices[box_num];
+			TransformAabb(matrix.GetRow(0).simd_values(), matrix.GetRow(1).simd_values(), matrix.GetRow(2).simd_values(), matrix.GetRow(3).simd_values(),
+				boxes[box_num], results[box_num]);
+		}
+	}
+
+	// the radius is measured along the transformed (1, 1, 1) diagonal, the same as Sphere::Transform
+	static inline void TransformSphere(const SimdVector row0, const SimdVector row1, const SimdVector row2, const SimdVector row3, const float diagonal, const Sphere& sphere, Sphere& result)
+	{
+		const SimdVector position = sphere.position().simd_values();
+		SimdVector transformed_position = SimdMul(SimdSplatX(position), row0);
+		transformed_position = SimdAdd(transformed_position, SimdMul(SimdSplatY(position), row1));
+		transformed_position = SimdAdd(transformed_position, SimdMul(SimdSplatZ(position), row2));
+		transformed_position = SimdAdd(transformed_position, row3);
+
+		const SimdVector point_on_sphere = SimdSplat(diagonal * sphere.radius());
+		SimdVector transformed_point = SimdMul(point_on_sphere, row0);
+		transformed_point = SimdAdd(transformed_point, SimdMul(point_on_sphere, row1));
+		transformed_point = SimdAdd(transformed_point, SimdMul(point_on_sphere, row2));
+
+		float point[4];
+		SimdStore(point, transformed_point);
+
+		Vector4 result_position;
+		result_position.set_simd_values(SimdSelectXYZ(transformed_position, SimdZero()));
+		result = Sphere(result_position, sqrtf(point[0]*point[0] + point[1]*point[1] + point[2]*point[2]));
+	}
+
+	static float SphereDiagonal()
+	{
+		Vector4 diagonal(1.0f, 1.0f, 1.0f);
+		diagonal.Normalise();
+		return diagonal.x();
+	}
+
+	void TransformSpheresBatch(const Matrix44& matrix, const Sphere* spheres, Sphere* results, const Int32 num_spheres)
+	{
+		const SimdVector row0 = matrix.GetRow(0).simd_values();
+		const SimdVector row1 = matrix.GetRow(1).simd_values();
+		const SimdVector row2 = matrix.GetRow(2).simd_values();
+		const SimdVector row3 = matrix.GetRow(3).simd_values();
+		const float diagonal = SphereDiagonal();
+
+		for (Int32 sphere_num = 0; sphere_num < num_spheres; ++sphere_num)
+			TransformSphere(row0, row1, row2, row3, diagonal, spheres[sphere_num], results[sphere_num]);
+	}
+
+	void TransformSpheresBatch(const Matrix44* matrices, const Sphere* spheres, Sphere* results, const Int32 num_spheres)
+	{
+		const float diagonal = SphereDiagonal();
+
+		for (Int32 sphere_num = 0; sphere_num < num_spheres; ++sphere_num)
+		{
+			const Matrix44& matrix = matrices[sphere_num];
+			TransformSphere(matrix.GetRow(0).simd_values(), matrix.GetRow(1).simd_values(), matrix.GetRow(2).simd_values(), matrix.GetRow(3).simd_values(),
+				diagonal, spheres[sphere_num], results[sphere_num]);
+		}
+	}
+
+	static inline void SetRow(Matrix44& matrix, const int row, const SimdVector values)
+	{
+		Vector4 row_values;
+		row_values.set_simd_values(values);
+		matrix.SetRow(row, row_values);
+	}
+
+	// the rotation terms of Matrix44::Rotation for four quaternions at once, each row scaled like Scale(scale) * Rotation(rotation)
+	// the terms are summed in the same order as Matrix44::Rotation, -a - b + c is c - (a + b)
+	static inline void TransformMatrixBlock(const Quaternion* rotations, const Vector4* translations, const Vector4* scales, Matrix44* results)
+	{
+		SimdVector x = SimdLoad(&rotations[0].x), y = SimdLoad(&rotations[1].x), z = SimdLoad(&rotations[2].x), w = SimdLoad(&rotations[3].x);
+		SimdTranspose4x4(x, y, z, w);
+		SimdVector scale_x = scales[0].simd_values(), scale_y = scales[1].simd_values(), scale_z = scales[2].simd_values(), scale_w = scales[3].simd_values();
+		SimdTranspose4x4(scale_x, scale_y, scale_z, scale_w);
+
+		const SimdVector sqw = SimdMul(w, w);
+		const SimdVector sqx = SimdMul(x, x);
+		const SimdVector sqy = SimdMul(y, y);
+		const SimdVector sqz = SimdMul(z, z);
+		const SimdVector two = SimdSplat(2.0f);
+
+		const SimdVector xy = SimdMul(x, y), zw = SimdMul(z, w);
+		const SimdVector xz = SimdMul(x, z), yw = SimdMul(y, w);
+		const SimdVector yz = SimdMul(y, z), xw = SimdMul(x, w);
+
+		SimdVector row0_x = SimdMul(scale_x, SimdAdd(SimdSub(SimdSub(sqx, sqy), sqz), sqw));
+		SimdVector row0_y = SimdMul(scale_x, SimdMul(two, SimdAdd(xy, zw)));
+		SimdVector row0_z = SimdMul(scale_x, SimdMul(two, SimdSub(xz, yw)));
+		SimdVector row1_x = SimdMul(scale_y, SimdMul(two, SimdSub(xy, zw)));
+		SimdVector row1_y = SimdMul(scale_y, SimdAdd(SimdSub(SimdSub(sqy, sqx), sqz), sqw));
+		SimdVector row1_z = SimdMul(scale_y, SimdMul(two, SimdAdd(yz, xw)));
+		SimdVector row2_x = SimdMul(scale_z, SimdMul(two, SimdAdd(xz, yw)));
+		SimdVector row2_y = SimdMul(scale_z, SimdMul(two, SimdSub(yz, xw)));
+		SimdVector row2_z = SimdMul(scale_z, SimdAdd(SimdSub(sqz, SimdAdd(sqx, sqy)), sqw));
+
+		// back to one row per matrix, the w column is zero
+		SimdVector row0_w = SimdZero(), row1_w = SimdZero(), row2_w = SimdZero();
+		SimdTranspose4x4(row0_x, row0_y, row0_z, row0_w);
+		SimdTranspose4x4(row1_x, row1_y, row1_z, row1_w);
+		SimdTranspose4x4(row2_x, row2_y, row2_z, row2_w);
+		const SimdVector row0[4] = { row0_x, row0_y, row0_z, row0_w };
+		const SimdVector row1[4] = { row1_x, row1_y, row1_z, row1_w };
+		const SimdVector row2[4] = { row2_x, row2_y, row2_z, row2_w };
+
+		const SimdVector one = SimdSet(0.0f, 0.0f, 0.0f, 1.0f);
+		for (Int32 transform_num = 0; transform_num < 4; ++transform_num)
+		{
+			Matrix44& result = results[transform_num];
+			SetRow(result, 0, row0[transform_num]);
+			SetRow(result, 1, row1[transform_num]);
+			SetRow(result, 2, row2[transform_num]);
+			SetRow(result, 3, SimdSelectXYZ(translations[transform_num].simd_values(), one));
+		}
+	}
+
+	void TransformMatricesBatch(const Quaternion* rotations, const Vector4* translations, const Vector4* scales, Matrix44* results, const Int32 num_transforms)
+	{
+		Int32 transform_num = 0;
+		for (; transform_num + 4 <= num_transforms; transform_num += 4)
+			TransformMatrixBlock(rotations + transform_num, translations + transform_num, scales + transform_num, results + transform_num);
+
+		// pad the last block with copies of the last transform
+		if (transform_num < num_transforms)
+		{
+			Quaternion block_rotations[4];
+			Vector4 block_translations[4], block_scales[4];
+			Matrix44 block_results[4];
+			for (Int32 lane = 0; lane < 4; ++lane)
+			{
+				const Int32 index = transform_num + lane < num_transforms ? transform_num + lane : num_transforms - 1;
+				block_rotations[lane] = rotations[index];
+				block_translations[lane] = translations[index];
+				block_scales[lane] = scales[index];
+			}
+
+			TransformMatrixBlock(block_rotations, block_translations, block_scales, block_results);
+			for (Int32 lane = 0; transform_num + lane < num_transforms; ++lane)
+				results[transform_num + lane] = block_results[lane];
+		}
+	}
+
+	void BlendMatricesBatch(const Matrix44* start, const Matrix44* end, const float time, Matrix44* results, const Int32 num_matrices)
+	{
+		// start*(1 - time) + time*end for every element, as Vector4::Lerp
+		const SimdVector start_scale = SimdSplat(1.0f - time);
+		const SimdVector end_scale = SimdSplat(time);
+		for (Int32 matrix_num = 0; matrix_num < num_matrices; ++matrix_num)
+		{
+			for (Int32 row = 0; row < 4; ++row)
+			{
+				const SimdVector blended = SimdAdd(
+					SimdMul(start[matrix_num].GetRow(row).simd_values(), start_scale),
+					SimdMul(end_scale, end[matrix_num].GetRow(row).simd_values()));
+				SetRow(results[matrix_num], row, blended);
+			}
+		}
+	}
+
+	// the rows of left * right, each x*row0 + y*row1 + z*row2 + w*row3 summed in the same order as Matrix44::operator*
+	static inline void MultiplyMatrix(const Matrix44& left, const Matrix44& right, SimdVector rows[4])
+	{
+		const SimdVector right0 = right.GetRow(0).simd_values();
+		const SimdVector right1 = right.GetRow(1).simd_values();
+		const SimdVector right2 = right.GetRow(2).simd_values();
+		const SimdVector right3 = right.GetRow(3).simd_values();
+
+		for (Int32 row = 0; row < 4; ++row)
+		{
+			const SimdVector values = left.GetRow(row).simd_values();
+			SimdVector product = SimdMul(SimdSplatX(values), right0);
+			product = SimdAdd(product, SimdMul(SimdSplatY(values), right1));
+			product = SimdAdd(product, SimdMul(SimdSplatZ(values), right2));
+			product = SimdAdd(product, SimdMul(SimdSplatW(values), right3));
+			rows[row] = product;
+		}
+	}
+
+	void MultiplyMatricesBatch(const Matrix44* left, const Matrix44* right, Matrix44* results, const Int32 num_matrices)
+	{
+		for (Int32 matrix_num = 0; matrix_num < num_matrices; ++matrix_num)
+		{
+			SimdVector rows[4];
+			MultiplyMatrix(left[matrix_num], right[matrix_num], rows);
+			for (Int32 row = 0; row < 4; ++row)
+				SetRow(results[matrix_num], row, rows[row]);
+		}
+	}
+
+	void MultiplyTransposeMatricesBatch(const Matrix44* left, const Matrix44* right, Matrix44* results, const Int32 num_matrices)
+	{
+		// the product stays in registers between the multiply and the transpose
+		for (Int32 matrix_num = 0; matrix_num < num_matrices; ++matrix_num)
+		{
+			SimdVector rows[4];
+			MultiplyMatrix(left[matrix_num], right[matrix_num], rows);
+			SimdTranspose4x4(rows[0], rows[1], rows[2], rows[3]);
+			for (Int32 row = 0; row < 4; ++row)
+				SetRow(results[matrix_num], row, rows[row]);
+		}
+	}
+}
@@ -0,0 +1,109 @@
+#ifndef _GEF_TRANSFORM_BATCH_H
+#define _GEF_TRANSFORM_BATCH_H
+
+#include <gef.h>
+
+namespace gef
+{
+	class Matrix44;
+	class Aabb;
+	class Sphere;
+	class Quaternion;
+	class Vector4;
+
+	/// @brief Transforms an array of positions by a matrix, including the translation.
+	/// @param[in] matrix			The transformation matrix.
+	/// @param[in] positions		Pointer to the x value of the first position, followed by y and z.
+	/// @param[in] stride			The number of bytes between the start of each position, e.g. sizeof(Mesh::Vertex).
+	/// @param[out] results			Pointer to the x value of the first transformed position.
+	/// @param[in] result_stride	The number of bytes between the start of each transformed position.
+	/// @param[in] num_positions	The number of positions to transform.
+	/// @note Only the x, y and z values are read and written, so the positions can be transformed in place.
+	/// Results are identical to Vector4::Transform.
+	void TransformPointsBatch(const Matrix44& matrix, const float* positions, const UInt32 stride, float* results, const UInt32 result_stride, const Int32 num_positions);
+
+	/// @brief Transforms an array of directions, such as normals, by a matrix, ignoring the translation.
+	/// @note Parameters are the same as TransformPointsBatch.
+	/// Results are identical to Vector4::TransformNoTranslation.
+	void TransformVectorsBatch(const Matrix44& matrix, const float* vectors, const UInt32 stride, float* results, const UInt32 result_stride, const Int32 num_vectors);
+
+	/// @brief Transforms positions held in separate x, y and z arrays by a matrix, including the translation.
+	/// @param[in] matrix			The transformation matrix.
+	/// @param[in] x, y, z			Arrays holding num_positions values for each axis.
+	/// @param[out] result_x, result_y, result_z	Arrays that receive the transformed values. These can be the input arrays.
+	/// @param[in] num_positions	The number of positions to transform.
+	void TransformPointsBatchSoA(const Matrix44& matrix, const float* x, const float* y, const float* z,
+		float* result_x, float* result_y, float* result_z, const Int32 num_positions);
+
+	/// @brief Transforms directions held in separate x, y and z arrays by a matrix, ignoring the translation.
+	/// @note Parameters are the same as TransformPointsBatchSoA.
+	void TransformVectorsBatchSoA(const Matrix44& matrix, const float* x, const float* y, const float* z,
+		float* result_x, float* result_y, float* result_z, const Int32 num_vectors);
+
+	/// @brief Calculates the axis aligned bounding box of an array of positions.
+	/// @param[in] positions		Pointer to the x value of the first position, followed by y and z.
+	/// @param[in] stride			The number of bytes between the start of each position.
+	/// @param[in] num_positions	The number of positions.
+	/// @return The bounds of the positions. An empty array gives the same bounds as the Aabb default constructor.
+	Aabb CalculateBoundsBatch(const float* positions, const UInt32 stride, const Int32 num_positions);
+
+	/// @brief Transforms an array of axis aligned bounding boxes by a matrix.
+	/// @param[in] matrix		The transformation matrix.
+	/// @param[in] boxes		The boxes to transform.
+	/// @param[out] results		Array that receives the transformed boxes. This can be the boxes array.
+	/// @param[in] num_boxes	The number of boxes to transform.
+	/// @note Each box is transformed in constant time using Arvo's method, the result is the same as
+	/// the bounds of the eight transformed corners.
+	void TransformAabbsBatch(const Matrix44& matrix, const Aabb* boxes, Aabb* results, const Int32 num_boxes);
+
+	/// @brief Transforms each box in an array by its own matrix, e.g. local bounds by world transforms.
+	/// @param[in] matrices		Array of num_boxes transformation matrices.
+	/// @note The other parameters are the same as the single matrix version.
+	void TransformAabbsBatch(const Matrix44* matrices, const Aabb* boxes, Aabb* results, const Int32 num_boxes);
+
+	/// @brief Transforms an array of bounding spheres by a matrix.
+	/// @param[in] matrix		The transformation matrix.
+	/// @param[in] spheres		The spheres to transform.
+	/// @param[out] results		Array that receives the transformed spheres. This can be the spheres array.
+	/// @param[in] num_spheres	The number of spheres to transform.
+	/// @note Results are identical to Sphere::Transform.
+	void TransformSpheresBatch(const Matrix44& matrix, const Sphere* spheres, Sphere* results, const Int32 num_spheres);
+
+	/// @brief Transforms each sphere in an array by its own matrix.
+	/// @param[in] matrices		Array of num_spheres transformation matrices.
+	/// @note The other parameters are the same as the single matrix version.
+	void TransformSpheresBatch(const Matrix44* matrices, const Sphere* spheres, Sphere* results, const Int32 num_spheres);
+
+	/// @brief Builds the matrices of transforms held in separate rotation, translation and scale arrays, e.g. the joints of a pose.
+	/// @param[in] rotations		Array of num_transforms unit quaternions.
+	/// @param[in] translations		Array of num_transforms translations.
+	/// @param[in] scales			Array of num_transforms scales.
+	/// @param[out] results			Array that receives the matrices.
+	/// @param[in] num_transforms	The number of transforms.
+	/// @note Each matrix has the same values as Transform::GetMatrix, a zero element may have the opposite sign.
+	void TransformMatricesBatch(const Quaternion* rotations, const Vector4* translations, const Vector4* scales, Matrix44* results, const Int32 num_transforms);
+
+	/// @brief Linearly blends each element of two arrays of matrices, e.g. the skinning matrices of two poses.
+	/// @param[in] start			The matrices at time 0.
+	/// @param[in] end				The matrices at time 1.
+	/// @param[in] time				The blend amount.
+	/// @param[out] results			Array that receives the blended matrices. This can be either input array.
+	/// @param[in] num_matrices		The number of matrices to blend.
+	/// @note Blending rotations element by element shrinks them slightly, which is only small for similar matrices.
+	void BlendMatricesBatch(const Matrix44* start, const Matrix44* end, const float time, Matrix44* results, const Int32 num_matrices);
+
+	/// @brief Multiplies each element of one array of matrices by the same element of another, e.g. inverse bind poses by global poses.
+	/// @param[in] left				The matrices on the left of each product.
+	/// @param[in] right			The matrices on the right of each product.
+	/// @param[out] results			Array that receives left[i] * right[i]. This can be either input array.
+	/// @param[in] num_matrices		The number of matrices to multiply.
+	/// @note Results are identical to Matrix44::operator*.
+	void MultiplyMatricesBatch(const Matrix44* left, const Matrix44* right, Matrix44* results, const Int32 num_matrices);
+
+	/// @brief Multiplies matrices like MultiplyMatricesBatch and transposes each product in the same pass, e.g. for a skinning shader.
+	/// @note Parameters are the same as MultiplyMatricesBatch.
+	/// Results are identical to Matrix44::Transpose of Matrix44::operator*.
+	void MultiplyTransposeMatricesBatch(const Matrix44* left, const Matrix44* right, Matrix44* results, const Int32 num_matrices);
+}
+
+#endif // _GEF_TRANSFORM_BATCH_H
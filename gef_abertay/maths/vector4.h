@@ -1,6 +1,7 @@
 #ifndef _GEF_VECTOR3_H
 #define _GEF_VECTOR3_H
 
+#include <maths/simd.h>
 
 namespace gef
 {
@@ -48,9 +49,15 @@ public:
 	void set_w(float w);
 	void set_value(float x, float y, float z);
 	void set_value(float x, float y, float z, float w);
+
+	/// @return the x, y, z and w values in a SIMD register
+	SimdVector simd_values() const;
+	/// @param[in] values	the x, y, z and w values in a SIMD register
+	void set_simd_values(SimdVector values);
 protected:
-	// store values as an array of floats so the implementation
-	// can be changed at a later date to support use SIMD instructions
+	// values are stored as a packed array of floats and moved in and out of SIMD registers with unaligned loads
+	// Vector4 is part of structures that are read and written to files as raw memory, e.g. skeleton joints and
+	// animation keys, so over aligning it would change their layout
 	float values_[4];
 public:
 	static const Vector4 kZero;
@@ -59,5 +66,6 @@ public:
 }
 
 #include "maths/vector4.inl"
+#include <maths/matrix44.h>
 
 #endif // _GEF_VECTOR3_H
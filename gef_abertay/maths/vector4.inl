@@ -29,61 +29,95 @@ namespace gef
 
 	inline const Vector4 Vector4::operator-(const Vector4& _vec) const
 	{
-		return Vector4(values_[0] - _vec.x(), values_[1] - _vec.y(), values_[2] - _vec.z());
+		Vector4 result;
+		result.set_simd_values(SimdSelectXYZ(SimdSub(simd_values(), _vec.simd_values()), SimdZero()));
+		return result;
 	}
 
 	inline const Vector4 Vector4::operator+(const Vector4& _vec) const
 	{
-		return Vector4(values_[0] + _vec.x(), values_[1] + _vec.y(), values_[2] + _vec.z());
+		Vector4 result;
+		result.set_simd_values(SimdSelectXYZ(SimdAdd(simd_values(), _vec.simd_values()), SimdZero()));
+		return result;
 	}
 
 	inline Vector4& Vector4::operator+=(const Vector4& _vec)
 	{
-		values_[0] += _vec.x();
-		values_[1] += _vec.y();
-		values_[2] += _vec.z();
+		const SimdVector values = simd_values();
+		set_simd_values(SimdSelectXYZ(SimdAdd(values, _vec.simd_values()), values));
 
 		return *this;
 	}
 
 	inline Vector4& Vector4::operator-=(const Vector4& _vec)
 	{
-		values_[0] -= _vec.x();
-		values_[1] -= _vec.y();
-		values_[2] -= _vec.z();
+		const SimdVector values = simd_values();
+		set_simd_values(SimdSelectXYZ(SimdSub(values, _vec.simd_values()), values));
 
 		return *this;
 	}
 
 	inline const Vector4 Vector4::operator*(const float _scalar) const
 	{
-		return Vector4(values_[0] * _scalar, values_[1] * _scalar, values_[2] * _scalar);
+		Vector4 result;
+		result.set_simd_values(SimdSelectXYZ(SimdMul(simd_values(), SimdSplat(_scalar)), SimdZero()));
+		return result;
 	}
 
 	inline const Vector4 Vector4::operator/(const float _scalar) const
 	{
-		return Vector4(values_[0] / _scalar, values_[1] / _scalar, values_[2] / _scalar);
+		Vector4 result;
+		result.set_simd_values(SimdSelectXYZ(SimdDiv(simd_values(), SimdSplat(_scalar)), SimdZero()));
+		return result;
 	}
 	
 
 	inline Vector4& Vector4::operator*=(const float _scalar)
 	{
-		values_[0] *= _scalar;
-		values_[1] *= _scalar;
-		values_[2] *= _scalar;
+		const SimdVector values = simd_values();
+		set_simd_values(SimdSelectXYZ(SimdMul(values, SimdSplat(_scalar)), values));
 
 		return *this;
 	}
 
 	inline Vector4& Vector4::operator/=(const float _scalar)
 	{
-		values_[0] /= _scalar;
-		values_[1] /= _scalar;
-		values_[2] /= _scalar;
+		const SimdVector values = simd_values();
+		set_simd_values(SimdSelectXYZ(SimdDiv(values, SimdSplat(_scalar)), values));
 
 		return *this;
 	}
 
+	inline const Vector4 Vector4::CrossProduct(const Vector4& _vec) const
+	{
+		Vector4 result;
+
+		// a*b.yzx - a.yzx*b gives (z, x, y) of the cross product, rotate it back into place
+		const SimdVector a = simd_values();
+		const SimdVector b = _vec.simd_values();
+		const SimdVector cross_zxy = SimdSub(
+			SimdMul(a, SimdSwizzleYZXW(b)),
+			SimdMul(SimdSwizzleYZXW(a), b));
+		result.set_simd_values(SimdSelectXYZ(SimdSwizzleYZXW(cross_zxy), SimdZero()));
+
+		return result;
+	}
+
+	inline void Vector4::Lerp(const Vector4& start, const Vector4& end, const float time)
+	{
+		// start*(1 - time) + time*end, as gef::Lerp
+		const SimdVector lerped = SimdAdd(
+			SimdMul(start.simd_values(), SimdSplat(1.0f - time)),
+			SimdMul(SimdSplat(time), end.simd_values()));
+
+		// w is left untouched, without reading it as it's often uninitialised
+		float lerped_values[4];
+		SimdStore(lerped_values, lerped);
+		values_[0] = lerped_values[0];
+		values_[1] = lerped_values[1];
+		values_[2] = lerped_values[2];
+	}
+
 	inline const float Vector4::operator[] (const int index) const
 	{
 		return values_[index];
@@ -144,4 +178,14 @@ namespace gef
 		values_[2] = z;
 		values_[3] = w;
 	}
+
+	inline SimdVector Vector4::simd_values() const
+	{
+		return SimdLoad(values_);
+	}
+
+	inline void Vector4::set_simd_values(SimdVector values)
+	{
+		SimdStore(values_, values);
+	}
 }
\ No newline at end of file
@@ -5,12 +5,12 @@
 
 namespace gef
 {
-	RenderTarget* RenderTarget::Create(const Platform& platform, const Int32 width, const Int32 height)
+	RenderTarget* RenderTarget::Create(const Platform& platform, const Int32 width, const Int32 height, const RenderTargetFormat format)
 	{
-		return new RenderTargetD3D11(platform, width, height);
+		return new RenderTargetD3D11(platform, width, height, format);
 	}
 
-	RenderTargetD3D11::RenderTargetD3D11(const Platform& platform, const Int32 width, const Int32 height) :
+	RenderTargetD3D11::RenderTargetD3D11(const Platform& platform, const Int32 width, const Int32 height, const RenderTargetFormat format) :
 		RenderTarget(platform, width, height),
 		render_target_view_(NULL)
 	{
@@ -32,7 +32,7 @@ namespace gef
 		textureDesc.Height = height;
 		textureDesc.MipLevels = 1;
 		textureDesc.ArraySize = 1;
-		textureDesc.Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+		textureDesc.Format = format == kRenderTargetRGBA8 ? DXGI_FORMAT_R8G8B8A8_UNORM : DXGI_FORMAT_R32G32B32A32_FLOAT;
 		textureDesc.SampleDesc.Count = 1;
 		textureDesc.Usage = D3D11_USAGE_DEFAULT;
 		textureDesc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
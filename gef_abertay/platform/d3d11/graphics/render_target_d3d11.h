@@ -11,7 +11,7 @@ namespace gef
 	class RenderTargetD3D11 : public RenderTarget
 	{
 	public:
-		RenderTargetD3D11(const Platform& platform, const Int32 width, const Int32 height);
+		RenderTargetD3D11(const Platform& platform, const Int32 width, const Int32 height, const RenderTargetFormat format);
 		~RenderTargetD3D11();
 
 		void Begin(const Platform& platform);
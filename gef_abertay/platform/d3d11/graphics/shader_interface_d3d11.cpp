@@ -184,10 +184,11 @@ namespace gef
 
 		if (SUCCEEDED(hresult))
 		{
+			// only copy up to the last element set, e.g. the bone matrices a mesh uses, the shader never reads past them
 			if (vs_data)
-				memcpy(vs_data, vertex_shader_variable_data_, vertex_shader_variable_data_size_);
+				memcpy(vs_data, vertex_shader_variable_data_, GetVariableDataUploadSize(vertex_shader_variables_));
 			if (ps_data)
-				memcpy(ps_data, pixel_shader_variable_data_, pixel_shader_variable_data_size_);
+				memcpy(ps_data, pixel_shader_variable_data_, GetVariableDataUploadSize(pixel_shader_variables_));
 
 			// Unlock the constant buffer.
 			if (vs_constant_buffer_)
@@ -18,10 +18,13 @@ namespace gef
 		:SpriteRenderer(platform)
 		,vertex_buffer_(NULL)
 		,default_render_state_(NULL)
-		,default_blend_state_(NULL)
 		,default_depth_stencil_state_(NULL)
+		,bound_blend_mode_(kSpriteBlendAlpha)
 
 	{
+		for (Int32 blend_mode = 0; blend_mode < kNumSpriteBlendModes; ++blend_mode)
+			blend_states_[blend_mode] = NULL;
+
 		vertex_buffer_ = gef::VertexBuffer::Create(platform);
 
 		float vertices[] = {-0.5f,-0.5f,0.0f, 0.5f,-0.5f,0.0f, 0.5f,0.5f,0.0f,    // triangle 1
@@ -66,7 +69,23 @@ namespace gef
 			ZeroMemory(&blendDesc, sizeof(blendDesc));
 			blendDesc.RenderTarget[0] = rtbd;
 
-			hresult = platform_d3d.device()->CreateBlendState(&blendDesc, &default_blend_state_);
+			hresult = platform_d3d.device()->CreateBlendState(&blendDesc, &blend_states_[kSpriteBlendAlpha]);
+
+			// drawing into a layer, the alpha covered by each sprite is accumulated rather than replaced
+			// so transparent texels don't cut holes in what's underneath. With the colour blended by
+			// the source alpha, the layer ends up with its colour premultiplied by its alpha
+			if (SUCCEEDED(hresult))
+			{
+				blendDesc.RenderTarget[0].DestBlendAlpha = D3D11_BLEND_INV_SRC_ALPHA;
+				hresult = platform_d3d.device()->CreateBlendState(&blendDesc, &blend_states_[kSpriteBlendLayer]);
+			}
+
+			// compositing a premultiplied layer, its colour mustn't be multiplied by alpha a second time
+			if (SUCCEEDED(hresult))
+			{
+				blendDesc.RenderTarget[0].SrcBlend = D3D11_BLEND_ONE;
+				hresult = platform_d3d.device()->CreateBlendState(&blendDesc, &blend_states_[kSpriteBlendPremultiplied]);
+			}
 		}
 
 		if (SUCCEEDED(hresult))
@@ -100,7 +119,8 @@ namespace gef
 
 	void SpriteRendererD3D11::CleanUp()
 	{
-		ReleaseNull(default_blend_state_);
+		for (Int32 blend_mode = 0; blend_mode < kNumSpriteBlendModes; ++blend_mode)
+			ReleaseNull(blend_states_[blend_mode]);
 		ReleaseNull(default_render_state_);
 		ReleaseNull(default_depth_stencil_state_);
 
@@ -141,7 +161,8 @@ namespace gef
 
 		const PlatformD3D11& platform_d3d = static_cast<const PlatformD3D11&>(platform_);
 		platform_d3d.device_context()->RSSetState(default_render_state_);
-		platform_d3d.device_context()->OMSetBlendState(default_blend_state_, NULL, 0xffffffff);
+		platform_d3d.device_context()->OMSetBlendState(blend_states_[blend_mode_], NULL, 0xffffffff);
+		bound_blend_mode_ = blend_mode_;
 		platform_d3d.device_context()->OMSetDepthStencilState(default_depth_stencil_state_, 0);
 	}
 
@@ -161,6 +182,12 @@ namespace gef
 
 		const PlatformD3D11& platform_d3d = static_cast<const PlatformD3D11&>(platform_);
 
+		// the blend mode may have been changed since Begin
+		if (blend_mode_ != bound_blend_mode_)
+		{
+			platform_d3d.device_context()->OMSetBlendState(blend_states_[blend_mode_], NULL, 0xffffffff);
+			bound_blend_mode_ = blend_mode_;
+		}
 
 		platform_d3d.device_context()->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 		platform_d3d.device_context()->Draw(6, 0);
@@ -27,8 +27,9 @@ namespace gef
 		VertexBuffer* vertex_buffer_;
 
 		ID3D11RasterizerState* default_render_state_;
-		ID3D11BlendState* default_blend_state_;
+		ID3D11BlendState* blend_states_[kNumSpriteBlendModes];
 		ID3D11DepthStencilState* default_depth_stencil_state_;
+		SpriteBlendMode bound_blend_mode_;
 
 	};
 }
@@ -75,8 +75,11 @@ namespace gef
 				memcpy(resource.pData, vertex_data_, num_vertices()*vertex_byte_size());
 				platform_d3d.device_context()->Unmap(vertex_buffer_, 0);
 			}
+			else
+				success = false;
 		}
-		success = false;
+		else
+			success = false;
 		return success;
 	}
 
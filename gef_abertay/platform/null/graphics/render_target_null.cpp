@@ -3,7 +3,7 @@
 
 namespace gef
 {
-	RenderTarget* RenderTarget::Create(const Platform& platform, Int32 width, Int32 height)
+	RenderTarget* RenderTarget::Create(const Platform& platform, Int32 width, Int32 height, RenderTargetFormat format)
 	{
 		return NULL;
 	}
@@ -8,7 +8,7 @@ void graphicsFree(SceUID uid);
 
 namespace gef
 {
-	RenderTarget* RenderTarget::Create(const Platform& platform, const Int32 width, const Int32 height)
+	RenderTarget* RenderTarget::Create(const Platform& platform, const Int32 width, const Int32 height, const RenderTargetFormat format)
 	{
 		return new RenderTargetVita(platform, width, height);
 	}
@@ -102,6 +102,28 @@ namespace gef
 
 		return true;
 	}
+	SceGxmFragmentProgram* ShaderInterfaceVita::CreateFragmentProgram(const SceGxmBlendInfo& blend_info)
+	{
+		SceGxmFragmentProgram* fragment_program = NULL;
+		Int32 err = sceGxmShaderPatcherCreateFragmentProgram(
+			shader_patcher_,
+			fragment_program_id_,
+			SCE_GXM_OUTPUT_REGISTER_FORMAT_UCHAR4,
+			MSAA_MODE,
+			&blend_info,
+			sceGxmVertexProgramGetProgram(vertex_program_),
+			&fragment_program);
+		SCE_DBG_ASSERT(err == SCE_OK);
+
+		return err == SCE_OK ? fragment_program : NULL;
+	}
+
+	void ShaderInterfaceVita::ReleaseFragmentProgram(SceGxmFragmentProgram* fragment_program)
+	{
+		if (fragment_program)
+			sceGxmShaderPatcherReleaseFragmentProgram(shader_patcher_, fragment_program);
+	}
+
 	void ShaderInterfaceVita::CreateVertexFormat()
 	{
 		const SceGxmProgram *const vertex_program = (const SceGxmProgram *)vs_shader_source_;
@@ -140,6 +162,7 @@ namespace gef
 		{
 			if (variable_count == -1)
 				variable_count = shader_variable.count;
+			shader_variable.upload_count = variable_count;
 
 			const Matrix44* src_matrices = static_cast<const Matrix44*>(value);
 			Matrix44* dest_matrices = static_cast<Matrix44*>(variable_data);
@@ -163,7 +186,7 @@ namespace gef
 
 			// GRC FIXME - assuming all variables are float type
 			const SceGxmProgramParameter* param = *vertex_shader_parameter;
-			sceGxmSetUniformDataF(vertex_shader_data_buffer, param, 0, shader_variable->count*GetVertexAttributeComponentCount(shader_variable->type), (const float *)data);
+			sceGxmSetUniformDataF(vertex_shader_data_buffer, param, 0, shader_variable->upload_count*GetVertexAttributeComponentCount(shader_variable->type), (const float *)data);
 		}
 
 		void *fragment_shader_data_buffer;
@@ -175,7 +198,7 @@ namespace gef
 			const UInt8* data = &pixel_shader_variable_data_[shader_variable->byte_offset];
 
 			// GRC FIXME - assuming all variables are float type
-			sceGxmSetUniformDataF(fragment_shader_data_buffer, *fragment_shader_parameter, 0, shader_variable->count*GetVertexAttributeComponentCount(shader_variable->type), (const float *)data);
+			sceGxmSetUniformDataF(fragment_shader_data_buffer, *fragment_shader_parameter, 0, shader_variable->upload_count*GetVertexAttributeComponentCount(shader_variable->type), (const float *)data);
 		}
 	}
 
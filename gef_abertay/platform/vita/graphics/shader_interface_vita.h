@@ -26,6 +26,13 @@ namespace gef
 		void BindTextureResources(const Platform& platform) const;
 		void UnbindTextureResources(const Platform& platform) const;
 
+		/// @brief Creates another fragment program from the pixel shader, blending with blend_info instead.
+		/// @note Call after CreateProgram. Release it with ReleaseFragmentProgram.
+		SceGxmFragmentProgram* CreateFragmentProgram(const SceGxmBlendInfo& blend_info);
+		void ReleaseFragmentProgram(SceGxmFragmentProgram* fragment_program);
+
+		inline SceGxmFragmentProgram* fragment_program() const { return fragment_program_; }
+
 	protected:
 //		void SetInputAssemblyElement(const ShaderParameter& shader_parameter, D3D11_INPUT_ELEMENT_DESC& element);
 //		void CreateVertexShaderConstantBuffer();
@@ -9,6 +9,7 @@
 #include <system/platform.h>
 #include <graphics/vertex_buffer.h>
 #include <graphics/shader_interface.h>
+#include <platform/vita/graphics/shader_interface_vita.h>
 
 
 extern const SceGxmProgram _binary_textured_sprite_v_gxp_start;
@@ -27,8 +28,12 @@ namespace gef
 	SpriteRendererVita::SpriteRendererVita(Platform& platform) :
 	SpriteRenderer(platform),
 	colouredSpriteIndicesUid(0),
-	default_texture_(NULL)
+	default_texture_(NULL),
+	bound_blend_mode_(kSpriteBlendAlpha)
 	{
+		for (Int32 blend_mode = 0; blend_mode < kNumSpriteBlendModes; ++blend_mode)
+			blend_fragment_programs_[blend_mode] = NULL;
+
 		colouredSpriteIndices = (uint16_t *)graphicsAlloc(
 			SCE_KERNEL_MEMBLOCK_TYPE_USER_RWDATA_UNCACHE,
 			4*sizeof(uint16_t),
@@ -60,10 +65,31 @@ namespace gef
 
 		projection_matrix_ = platform_.OrthographicFrustum(0, platform_.width(), 0, platform_.height(), -1, 1);
 		SetShader(NULL);
+
+		ShaderInterfaceVita* shader_interface = static_cast<ShaderInterfaceVita*>(default_shader_.device_interface());
+		SceGxmBlendInfo blend_info;
+		blend_info.colorFunc = SCE_GXM_BLEND_FUNC_ADD;
+		blend_info.alphaFunc = SCE_GXM_BLEND_FUNC_ADD;
+		blend_info.colorSrc = SCE_GXM_BLEND_FACTOR_SRC_ALPHA;
+		blend_info.colorDst = SCE_GXM_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		blend_info.alphaSrc = SCE_GXM_BLEND_FACTOR_ONE;
+		blend_info.alphaDst = SCE_GXM_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		blend_info.colorMask = SCE_GXM_COLOR_MASK_ALL;
+
+		// drawing into a layer, the alpha covered by each sprite is accumulated so the layer ends up premultiplied
+		blend_fragment_programs_[kSpriteBlendLayer] = shader_interface->CreateFragmentProgram(blend_info);
+
+		// compositing a premultiplied layer, its colour mustn't be multiplied by alpha a second time
+		blend_info.colorSrc = SCE_GXM_BLEND_FACTOR_ONE;
+		blend_fragment_programs_[kSpriteBlendPremultiplied] = shader_interface->CreateFragmentProgram(blend_info);
 	}
 
 	SpriteRendererVita::~SpriteRendererVita()
 	{
+		ShaderInterfaceVita* shader_interface = static_cast<ShaderInterfaceVita*>(default_shader_.device_interface());
+		for (Int32 blend_mode = 0; blend_mode < kNumSpriteBlendModes; ++blend_mode)
+			shader_interface->ReleaseFragmentProgram(blend_fragment_programs_[blend_mode]);
+
 		delete default_texture_;
 
 		graphicsFree(colouredSpriteIndicesUid);
@@ -82,9 +108,20 @@ namespace gef
 			default_shader_.SetSceneData(projection_matrix_);
 			default_shader_.device_interface()->UseProgram();
 			default_shader_.device_interface()->SetVertexFormat();
+			BindBlendMode();
 		}
 	}
 
+	void SpriteRendererVita::BindBlendMode()
+	{
+		const ShaderInterfaceVita* shader_interface = static_cast<const ShaderInterfaceVita*>(default_shader_.device_interface());
+		SceGxmFragmentProgram* fragment_program = blend_fragment_programs_[blend_mode_] ? blend_fragment_programs_[blend_mode_] : shader_interface->fragment_program();
+
+		const PlatformVita& platform_vita = static_cast<const PlatformVita&>(platform_);
+		sceGxmSetFragmentProgram(platform_vita.context(), fragment_program);
+		bound_blend_mode_ = blend_mode_;
+	}
+
 	void SpriteRendererVita::End()
 	{
 		vertex_buffer_->Unbind(platform_);
@@ -97,6 +134,10 @@ namespace gef
 	{
 		if (shader_ == &default_shader_)
 		{
+			// the blend mode may have been changed since Begin
+			if (blend_mode_ != bound_blend_mode_)
+				BindBlendMode();
+
 			const Texture* texture = sprite.texture();
 			if (!texture)
 				texture = default_texture_;
@@ -23,6 +23,8 @@ public:
 	void End();
 	void DrawSprite(const Sprite& sprite);
 private:
+	void BindBlendMode();
+
 //	SceGxmShaderPatcherId colouredSpriteVertexProgramId;
 //	SceGxmShaderPatcherId colouredSpriteFragmentProgramId;
 //	SceUID colouredSpriteVerticesUid;
@@ -38,6 +40,11 @@ private:
 	// default texture
 	Texture* default_texture_;
 	VertexBuffer* vertex_buffer_;
+
+	// the default shader's fragment program with each blend, the blend is part of the fragment program on the Vita
+	// kSpriteBlendAlpha is the shader's own program, so it's left NULL
+	SceGxmFragmentProgram* blend_fragment_programs_[kNumSpriteBlendModes];
+	SpriteBlendMode bound_blend_mode_;
 };
 
 }
@@ -56,20 +56,18 @@ void AnimApp::Init()
 	}
 
 	// check to see if there is a skeleton in the the scene file
-	// if so, pull out the bind pose and create an array of matrices
-	// that wil be used to store the bone transformations
+	// if so, pull out the bind pose and create the character from it
+	// the character starts in the bind pose until it's given a clip to play
 	if (model_scene_->skeletons.size() > 0)
 	{
 		skeleton_ = model_scene_->skeletons.front();
 		bind_pose_.CreateBindPose(skeleton_);
-		bone_matrices_.resize(skeleton_->joints().size());
+		soa_bind_pose_.Create(bind_pose_);
+		anim_player_.Init(soa_bind_pose_, animation_system_);
 	}
 
 	// anims
 
-	// initialise the animation player with the bind pose
-	anim_player_.Update(0.0f, bind_pose_);
-
 	running_anim_ = LoadAnimation("running_InPlace.scn");
 	idle_anim_ = LoadAnimation("idle.scn");
 
@@ -82,7 +80,7 @@ void AnimApp::Init()
 
 void AnimApp::CleanUp()
 {
-	bone_matrices_.clear();
+	anim_player_.CleanUp(animation_system_);
 
 	delete running_anim_;
 	running_anim_ = NULL;
@@ -142,22 +140,12 @@ bool AnimApp::Update(float frame_time)
 		}
 	}
 
-	// store the animation used on the last frame so we can detect if
-	// we need to trigger a animation change in this frame
-	const gef::Animation* previous_anim = anim_player_.clip();
-
 	// forward == 0.0f, character is in idle state
 	// otherwise the character is moving left or right
+	// Play starts a clip from the beginning when the character changes to it
 	if (forward == 0.0f)
 	{
-		// check to see if we are transiting to idle from a different animation
-		// if so start playing idle from the beginning
-		if (previous_anim != idle_anim_)
-		{
-			anim_player_.set_clip(idle_anim_);
-			anim_player_.set_looping(true);
-			anim_player_.set_anim_time(0.0f);
-		}
+		anim_player_.Play(idle_anim_, true);
 	}
 	else
 	{
@@ -166,28 +154,14 @@ bool AnimApp::Update(float frame_time)
 		else
 			face_right_ = false;
 
-		// if previous animation is different from running animation the
-		// start playing the run animation from the start
-		if (previous_anim != running_anim_)
-		{
-			anim_player_.set_clip(running_anim_);
-			anim_player_.set_looping(true);
-			anim_player_.set_anim_time(0.0f);
-		}
+		anim_player_.Play(running_anim_, true);
 	}
 
-	if (skeleton_)
-	{
-		anim_player_.Update(frame_time, bind_pose_);
-
-		// calculate bone matrices that need to be passed to the shader
-		// this should be the final pose if multiple animations are blended together
-		std::vector<gef::Matrix44>::const_iterator pose_matrix_iter = anim_player_.pose().global_pose().begin();
-		std::vector<gef::Joint>::const_iterator joint_iter = skeleton_->joints().begin();
-
-		for (std::vector<gef::Matrix44>::iterator bone_matrix_iter = bone_matrices_.begin(); bone_matrix_iter != bone_matrices_.end(); ++bone_matrix_iter, ++joint_iter, ++pose_matrix_iter)
-			*bone_matrix_iter = (joint_iter->inv_bind_pose * *pose_matrix_iter);
-	}
+	// sample the clips, calculate the global poses and the bone matrices that need to be passed to the shader
+	// for every character, then hand the new bone matrices over to the renderer
+	// with a single character there's nothing to spread across a job system, so it's updated on this thread
+	animation_system_.Update(frame_time);
+	animation_system_.SwapBuffers();
 
 	// set the transformation matrix for the character based on the way they are facing
 	gef::Matrix44 player_transform;
@@ -214,7 +188,7 @@ void AnimApp::Render()
 	renderer_3d_->Begin();
 
 	// draw the player, the pose is defined by the bone matrices
-	renderer_3d_->DrawSkinnedMesh(player_, bone_matrices_);
+	renderer_3d_->DrawSkinnedMesh(player_, anim_player_.skinning_matrices());
 	renderer_3d_->End();
 
 	// setup the sprite renderer, but don't clear the frame buffer
@@ -266,24 +240,16 @@ void AnimApp::SetupCamera()
 	far_plane = 1000.f;
 }
 
-gef::Animation* AnimApp::LoadAnimation(const char* anim_scene_filename, const char* anim_name)
+gef::Animation* AnimApp::LoadAnimation(const char* anim_scene_filename, const gef::StringId anim_name_id)
 {
 	gef::Animation* anim = NULL;
 
+	// only the animation is read from the file, not the meshes and skeleton it was exported with
+	// if the animation name is specified then try and find the named anim
+	// otherwise return the first animation if there is one
 	gef::Scene anim_scene;
-	if (anim_scene.ReadSceneFromFile(platform_, anim_scene_filename))
-	{
-		// if the animation name is specified then try and find the named anim
-		// otherwise return the first animation if there is one
-		std::map<gef::StringId, gef::Animation*>::const_iterator anim_node_iter;
-		if (anim_name)
-			anim_node_iter = anim_scene.animations.find(gef::GetStringId(anim_name));
-		else
-			anim_node_iter = anim_scene.animations.begin();
-
-		if (anim_node_iter != anim_scene.animations.end())
-			anim = new gef::Animation(*anim_node_iter->second);
-	}
+	if (anim_scene.ReadAnimationFromFile(platform_, anim_scene_filename, anim_name_id))
+		anim = new gef::Animation(*anim_scene.animations.begin()->second);
 
 	return anim;
 }
@@ -9,6 +9,8 @@
 #include <vector>
 #include <graphics/mesh_instance.h>
 #include <animation/skeleton.h>
+#include <animation/skeleton_pose_soa.h>
+#include <animation/animation_system.h>
 #include "motion_clip_player.h"
 
 // FRAMEWORK FORWARD DECLARATIONS
@@ -38,7 +40,8 @@ private:
 	void DrawHUD();
 	void SetupLights();
 	void SetupCamera();
-	gef::Animation* LoadAnimation(const char* anim_scene_file, const char* anim_name = NULL);
+	// anim_name_id is the name of the animation to load, e.g. GEF_STRING_ID("mixamo.com"), or 0 for the first
+	gef::Animation* LoadAnimation(const char* anim_scene_file, const gef::StringId anim_name_id = 0);
 
 	gef::SpriteRenderer* sprite_renderer_;
 	gef::Renderer3D* renderer_3d_;
@@ -60,10 +63,12 @@ private:
 	float far_plane;
 
 	const gef::Skeleton* skeleton_;
-	std::vector<gef::Matrix44> bone_matrices_;
 	gef::SkeletonPose bind_pose_;
+	gef::SkeletonPoseSoA soa_bind_pose_;
 
+	// the character's playback, poses and bone matrices, updated by the animation system
 	MotionClipPlayer anim_player_;
+	gef::AnimationSystem animation_system_;
 
 	gef::Animation* running_anim_;
 
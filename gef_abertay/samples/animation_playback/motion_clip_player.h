@@ -1,52 +1,43 @@
 #ifndef _MOTION_CLIP_PLAYER_H
 #define _MOTION_CLIP_PLAYER_H
 
-#include <animation/skeleton.h>
-
-namespace gef
-{
-
-};
+#include <animation/animation_system.h>
+#include <vector>
 
 class MotionClipPlayer
 {
 public:
 	MotionClipPlayer();
 
-	/// @brief Update the pose by sampling current animation clip
-	/// @param[in] delta_time	The amount of time to update the playback time by.
-	/// @param[in] bind_pose	The bind pose for the skeleton being animated.
-	bool Update(const float delta_time, const gef::SkeletonPose& bind_pose);
+	/// @brief Creates the character the player drives and adds it to an animation system, which updates it.
+	/// @param[in] bind_pose			The bind pose for the skeleton being animated. It must outlive the player.
+	/// @param[in] animation_system		The system the character is updated by.
+	void Init(const gef::SkeletonPoseSoA& bind_pose, gef::AnimationSystem& animation_system);
 
-	const float anim_time() const { return anim_time_; }
-	void set_anim_time(const float anim_time) { anim_time_ = anim_time; }
+	/// @brief Removes the character from the animation system it was added to.
+	void CleanUp(gef::AnimationSystem& animation_system);
 
-	const float playback_speed() const { return playback_speed_; }
-	void set_playback_speed(const float playback_speed) { playback_speed_ = playback_speed; }
+	/// @brief Starts a clip from the beginning, unless it's already playing
+	void Play(const gef::Animation* clip, const bool looping = true) { character_.Play(clip, looping); }
 
-	const bool looping() const { return looping_; }
-	void set_looping(const bool looping) { looping_ = looping; }
+	const float anim_time() const { return character_.playback().anim_time; }
+	void set_anim_time(const float anim_time) { character_.playback().anim_time = anim_time; }
 
-	const gef::Animation* clip() const { return clip_; }
-	void set_clip(const gef::Animation* clip) { clip_ = clip; }
+	const float playback_speed() const { return character_.playback().playback_speed; }
+	void set_playback_speed(const float playback_speed) { character_.playback().playback_speed = playback_speed; }
 
-	const gef::SkeletonPose& pose() const { return pose_; }
+	const bool looping() const { return character_.playback().looping; }
+	void set_looping(const bool looping) { character_.playback().looping = looping; }
 
-private:
-	/// The pose created by sampling the animation clip
-	gef::SkeletonPose pose_;
-
-	/// A pointer to the animation clip to be sampled
-	const gef::Animation* clip_;
+	const gef::Animation* clip() const { return character_.playback().clip; }
 
-	/// The current playback time the animation clip is being sampled at
-	float anim_time_;
+	/// @brief The pose of the last update and the bone matrices to draw the skinned mesh with
+	const gef::SkeletonPoseSoA& pose() const { return character_.pose(); }
+	const std::vector<gef::Matrix44>& skinning_matrices() const { return character_.skinning_matrices(); }
 
-	/// The playback speed scaling factor used to adjust the speed the animation is played at
-	float playback_speed_;
-
-	/// The flag indicating whether the playback is to be looped or not
-	bool looping_;
+private:
+	/// The playback, poses and bone matrices of the character, sampled by the animation system's update
+	gef::AnimCharacter character_;
 };
 
-#endif // _MOTION_CLIP_PLAYER_H
\ No newline at end of file
+#endif // _MOTION_CLIP_PLAYER_H
@@ -4,6 +4,81 @@
 
 namespace gef
 {
+	// Lookup tables for the slicing-by-8 CRC
+	// http://create.stephan-brumme.com/crc32/
+	// table[0] is the usual byte at a time table, table[n] gives the effect of a byte n bytes further back.
+	// The tables are built from Clk, so they always match the bit at a time version.
+	struct CRCTables
+	{
+		CRCTables()
+		{
+			for (UInt32 byte = 0; byte < 256; ++byte)
+			{
+				CRC crc(byte);
+				for (Int32 bit = 0; bit < 8; ++bit)
+					crc.Clk();
+				table[0][byte] = crc.r;
+
+				// only ASCII letters change case, the same as std::toupper in the "C" locale
+				upper[byte] = byte < 128 ? static_cast<UInt8>(std::toupper(byte)) : static_cast<UInt8>(byte);
+			}
+
+			for (Int32 slice = 1; slice < 8; ++slice)
+			{
+				for (UInt32 byte = 0; byte < 256; ++byte)
+				{
+					const UInt32 previous = table[slice-1][byte];
+					table[slice][byte] = (previous >> 8) ^ table[0][previous & 0xff];
+				}
+			}
+		}
+
+		UInt32 table[8][256];
+		UInt8 upper[256];
+	};
+
+	static const CRCTables& GetCRCTables()
+	{
+		static const CRCTables tables;
+		return tables;
+	}
+
+	template<bool kToUpper>
+	static inline UInt32 ReadByte(const CRCTables& tables, const UInt8* bytes, const Int32 index)
+	{
+		return kToUpper ? tables.upper[bytes[index]] : bytes[index];
+	}
+
+	// bytes are assembled into little endian words so the result doesn't depend on the platform
+	template<bool kToUpper>
+	static inline UInt32 ReadWord(const CRCTables& tables, const UInt8* bytes)
+	{
+		return ReadByte<kToUpper>(tables, bytes, 0) | (ReadByte<kToUpper>(tables, bytes, 1) << 8) |
+			(ReadByte<kToUpper>(tables, bytes, 2) << 16) | (ReadByte<kToUpper>(tables, bytes, 3) << 24);
+	}
+
+	template<bool kToUpper>
+	static UInt32 UpdateSlicingBy8(UInt32 residual, const UInt8* bytes, size_t length)
+	{
+		const CRCTables& tables = GetCRCTables();
+
+		for (; length >= 8; length -= 8, bytes += 8)
+		{
+			const UInt32 low = ReadWord<kToUpper>(tables, bytes) ^ residual;
+			const UInt32 high = ReadWord<kToUpper>(tables, bytes + 4);
+			residual =
+				tables.table[7][low & 0xff] ^ tables.table[6][(low >> 8) & 0xff] ^
+				tables.table[5][(low >> 16) & 0xff] ^ tables.table[4][low >> 24] ^
+				tables.table[3][high & 0xff] ^ tables.table[2][(high >> 8) & 0xff] ^
+				tables.table[1][(high >> 16) & 0xff] ^ tables.table[0][high >> 24];
+		}
+
+		for (; length > 0; --length, ++bytes)
+			residual = (residual >> 8) ^ tables.table[0][(residual ^ ReadByte<kToUpper>(tables, bytes, 0)) & 0xff];
+
+		return residual;
+	}
+
 	UInt32 CRC::GetCRC(const char* string)
 	{
 		CRC crc;
@@ -30,6 +105,13 @@ namespace gef
 		return crc.GetU32();
 	}
 
+	UInt32 CRC::GetCRC(const void* data, const size_t size, const UInt32 previous_crc)
+	{
+		CRC crc(~previous_crc);
+		crc.r = UpdateSlicingBy8<false>(crc.r, static_cast<const UInt8*>(data), size);
+		return crc.GetU32();
+	}
+
 
 	CRC::CRC(UInt32 _r) : r(_r)
 	{
@@ -60,20 +142,14 @@ namespace gef
 			r >>= 1;
 	}
 
-	// This does a byte at a time by calculating the
-	// crc bit by bit, lsb first. Slow, but clear.
+	// This does eight bytes at a time with the slicing-by-8 tables,
+	// giving the same result as clocking in each bit, lsb first.
 	void CRC::Update(const char *buffer, int len, bool toUpper)
 	{
-		while (len--)
-		{
-			int bitcnt, byte = *buffer++;
-			if(toUpper)
-				byte = std::toupper(byte);
-			for (bitcnt=0; bitcnt < 8; bitcnt++)
-			{
-				Clk(byte & 1);
-				byte >>= 1;
-			}
-		}
+		const UInt8* bytes = reinterpret_cast<const UInt8*>(buffer);
+		if(toUpper)
+			r = UpdateSlicingBy8<true>(r, bytes, len);
+		else
+			r = UpdateSlicingBy8<false>(r, bytes, len);
 	}
 }
@@ -2,6 +2,7 @@
 #define _GEF_CRC_H
 
 #include <gef.h>
+#include <stddef.h>
 
 namespace gef
 {
@@ -12,8 +13,35 @@ namespace gef
 	public:
 		static UInt32 GetCRC(const char* _pString);
 		static UInt32 GetICRC(const char* _pString);
+
+		/// @brief Calculates the CRC of a block of memory, e.g. to checksum a file.
+		/// @param[in] data			The data to checksum.
+		/// @param[in] size			The size of the data in bytes.
+		/// @param[in] previous_crc	The CRC of the preceding data when checksumming in pieces, otherwise 0.
+		/// @return The CRC, the same as GetCRC for a string of the same bytes.
+		static UInt32 GetCRC(const void* data, const size_t size, const UInt32 previous_crc = 0);
+
+		/// @brief Compile time version of GetICRC, so string literals can be hashed by the compiler.
+		/// @note Only ASCII letters are converted to uppercase, the same as std::toupper in the "C" locale.
+		static constexpr UInt32 GetICRCConstant(const char* string) { return ~UpdateConstant(string, 0xffffffff); }
+
 		CRC(UInt32 _r=~0);
 	private:
+		// constexpr versions of Clk and Update, written as single expressions for C++11
+		static constexpr UInt32 ClkConstant(const UInt32 residual) { return (residual & 1) ? ((residual^gf) >> 1) | 0x80000000 : residual >> 1; }
+		static constexpr UInt32 ClkByteConstant(const UInt32 residual)
+		{
+			return ClkConstant(ClkConstant(ClkConstant(ClkConstant(ClkConstant(ClkConstant(ClkConstant(ClkConstant(residual))))))));
+		}
+		static constexpr UInt32 ToUpperConstant(const char character)
+		{
+			return static_cast<UInt8>((character >= 'a' && character <= 'z') ? character - ('a' - 'A') : character);
+		}
+		static constexpr UInt32 UpdateConstant(const char* string, const UInt32 residual)
+		{
+			return *string ? UpdateConstant(string + 1, ClkByteConstant(residual ^ ToUpperConstant(*string))) : residual;
+		}
+
 		void Update(const char *pbuf, int len, bool toUpper = false); // update crc residual 
 		inline UInt32 GetU32() { return ~r; } // object yields current CRC
 
@@ -22,6 +50,8 @@ namespace gef
 
 		enum{gf=0xdb710641};  // This is the generator
 		UInt32 r;                // residual, polynomial mod gf
+
+		friend struct CRCTables;
 	};
 }
 #endif // _CRC_H
\ No newline at end of file
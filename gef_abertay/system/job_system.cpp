@@ -0,0 +1,206 @@
+#include <system/job_system.h>
+
+// the PS Vita toolchain has no std::thread, jobs run on the calling thread there
+#if !defined(__psp2__)
+#define GEF_JOB_SYSTEM_THREADS
+#endif
+
+#ifdef GEF_JOB_SYSTEM_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#endif
+
+namespace gef
+{
+#ifdef GEF_JOB_SYSTEM_THREADS
+	// each thread gets this many jobs on average, so uneven jobs still balance out
+	static const Int32 kJobsPerThread = 4;
+
+	struct JobSystemThreads
+	{
+		JobSystemThreads() :
+			function(NULL),
+			data(NULL),
+			num_items(0),
+			items_per_job(0),
+			num_jobs(0),
+			next_job(0),
+			jobs_remaining(0),
+			busy(false),
+			quit(false)
+		{
+		}
+
+		// grabs the next job and runs it, returns false when there are no jobs left to start
+		bool RunNextJob()
+		{
+			JobFunction job_function;
+			void* job_data;
+			Int32 begin, end;
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (next_job >= num_jobs)
+					return false;
+
+				begin = next_job*items_per_job;
+				end = begin + items_per_job < num_items ? begin + items_per_job : num_items;
+				job_function = function;
+				job_data = data;
+				++next_job;
+			}
+
+			job_function(job_data, begin, end);
+
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				if (--jobs_remaining == 0)
+					jobs_done.notify_all();
+			}
+
+			return true;
+		}
+
+		void WorkerLoop()
+		{
+			for (;;)
+			{
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					work_ready.wait(lock, [this]() { return quit || next_job < num_jobs; });
+					if (quit)
+						return;
+				}
+
+				while (RunNextJob())
+				{
+				}
+			}
+		}
+
+		std::vector<std::thread> workers;
+		std::mutex mutex;
+		std::condition_variable work_ready;
+		std::condition_variable jobs_done;
+
+		JobFunction function;
+		void* data;
+		Int32 num_items;
+		Int32 items_per_job;
+		Int32 num_jobs;
+		Int32 next_job;
+		Int32 jobs_remaining;
+		bool busy;
+		bool quit;
+	};
+#else
+	struct JobSystemThreads
+	{
+	};
+#endif
+
+	JobSystem::JobSystem(const Int32 num_worker_threads) :
+		threads_(NULL)
+	{
+		threads_ = new JobSystemThreads();
+
+#ifdef GEF_JOB_SYSTEM_THREADS
+		const Int32 num_workers = num_worker_threads < 0 ? HardwareThreadCount() - 1 : num_worker_threads;
+		for (Int32 thread_num = 0; thread_num < num_workers; ++thread_num)
+			threads_->workers.push_back(std::thread(&JobSystemThreads::WorkerLoop, threads_));
+#endif
+	}
+
+	JobSystem::~JobSystem()
+	{
+#ifdef GEF_JOB_SYSTEM_THREADS
+		{
+			std::lock_guard<std::mutex> lock(threads_->mutex);
+			threads_->quit = true;
+		}
+		threads_->work_ready.notify_all();
+		for (size_t thread_num = 0; thread_num < threads_->workers.size(); ++thread_num)
+			threads_->workers[thread_num].join();
+#endif
+
+		DeleteNull(threads_);
+	}
+
+	void JobSystem::ParallelFor(const Int32 num_items, const Int32 min_items_per_job, JobFunction function, void* data)
+	{
+		if (num_items <= 0)
+			return;
+
+#ifdef GEF_JOB_SYSTEM_THREADS
+		const Int32 items_per_job_min = min_items_per_job > 0 ? min_items_per_job : 1;
+		Int32 num_jobs = (num_items + items_per_job_min - 1) / items_per_job_min;
+		const Int32 max_jobs = (num_worker_threads() + 1) * kJobsPerThread;
+		if (num_jobs > max_jobs)
+			num_jobs = max_jobs;
+
+		// a job that starts more jobs while the pool is busy runs them itself
+		bool run_serially = num_jobs <= 1 || threads_->workers.empty();
+		if (!run_serially)
+		{
+			std::lock_guard<std::mutex> lock(threads_->mutex);
+			if (threads_->busy)
+			{
+				run_serially = true;
+			}
+			else
+			{
+				// round the range size up so ranges start on a multiple of the minimum size
+				Int32 items_per_job = (num_items + num_jobs - 1) / num_jobs;
+				items_per_job = ((items_per_job + items_per_job_min - 1) / items_per_job_min) * items_per_job_min;
+
+				threads_->busy = true;
+				threads_->function = function;
+				threads_->data = data;
+				threads_->num_items = num_items;
+				threads_->items_per_job = items_per_job;
+				threads_->num_jobs = (num_items + items_per_job - 1) / items_per_job;
+				threads_->next_job = 0;
+				threads_->jobs_remaining = threads_->num_jobs;
+			}
+		}
+
+		if (!run_serially)
+		{
+			threads_->work_ready.notify_all();
+
+			while (threads_->RunNextJob())
+			{
+			}
+
+			std::unique_lock<std::mutex> lock(threads_->mutex);
+			threads_->jobs_done.wait(lock, [this]() { return threads_->jobs_remaining == 0; });
+			threads_->busy = false;
+			threads_->num_jobs = 0;
+			threads_->next_job = 0;
+			return;
+		}
+#endif
+
+		function(data, 0, num_items);
+	}
+
+	Int32 JobSystem::num_worker_threads() const
+	{
+#ifdef GEF_JOB_SYSTEM_THREADS
+		return static_cast<Int32>(threads_->workers.size());
+#else
+		return 0;
+#endif
+	}
+
+	Int32 JobSystem::HardwareThreadCount()
+	{
+#ifdef GEF_JOB_SYSTEM_THREADS
+		const Int32 num_threads = static_cast<Int32>(std::thread::hardware_concurrency());
+		return num_threads > 0 ? num_threads : 1;
+#else
+		return 1;
+#endif
+	}
+}
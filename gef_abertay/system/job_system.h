@@ -0,0 +1,49 @@
+#ifndef _GEF_JOB_SYSTEM_H
+#define _GEF_JOB_SYSTEM_H
+
+#include <gef.h>
+
+namespace gef
+{
+	/// @brief Function run by the job system on a range of items.
+	/// @param[in] data		The user data passed to JobSystem::ParallelFor.
+	/// @param[in] begin	The first item in the range.
+	/// @param[in] end		One past the last item in the range.
+	typedef void (*JobFunction)(void* data, const Int32 begin, const Int32 end);
+
+	struct JobSystemThreads;
+
+	/**
+	A pool of worker threads that share out ranges of items between themselves and the calling thread.
+	On platforms without thread support all jobs are run on the calling thread.
+	*/
+	class JobSystem
+	{
+	public:
+		/// @brief Creates the worker threads.
+		/// @param[in] num_worker_threads	The number of threads to create in addition to the calling thread.
+		/// A negative number creates one less than the number of hardware threads.
+		JobSystem(const Int32 num_worker_threads = -1);
+		~JobSystem();
+
+		/// @brief Splits the items 0 to num_items-1 into ranges and runs a function on each range.
+		/// @param[in] num_items			The number of items to process.
+		/// @param[in] min_items_per_job	The smallest range worth running as a separate job.
+		/// @param[in] function				The function to run on each range.
+		/// @param[in] data					User data passed to the function.
+		/// @note The calling thread works on jobs too and the call returns when every range is finished.
+		/// Ranges always start on a multiple of min_items_per_job.
+		void ParallelFor(const Int32 num_items, const Int32 min_items_per_job, JobFunction function, void* data);
+
+		/// @return The number of worker threads, not counting the calling thread.
+		Int32 num_worker_threads() const;
+
+		/// @return The number of threads the hardware can run at once.
+		static Int32 HardwareThreadCount();
+
+	private:
+		JobSystemThreads* threads_;
+	};
+}
+
+#endif // _GEF_JOB_SYSTEM_H
@@ -0,0 +1,338 @@
+#include <system/load_queue.h>
+#include <deque>
+#include <cstddef>
+
+// the PS Vita toolchain has no std::thread, loads are read by Update there
+#if !defined(__psp2__)
+#define GEF_LOAD_QUEUE_THREADS
+#endif
+
+#ifdef GEF_LOAD_QUEUE_THREADS
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#endif
+
+namespace gef
+{
+#ifdef GEF_LOAD_QUEUE_THREADS
+	typedef std::mutex LoadQueueMutex;
+	typedef std::lock_guard<std::mutex> LoadQueueLock;
+#else
+	struct LoadQueueMutex
+	{
+	};
+
+	struct LoadQueueLock
+	{
+		LoadQueueLock(LoadQueueMutex&) {}
+	};
+#endif
+
+	struct LoadRequest
+	{
+		Int32 id;
+		LoadQueue::ReadFunction read_function;
+		LoadQueue::FinishFunction finish_function;
+		void* data;
+		LoadQueue::Status status;
+		float progress;
+		bool cancelled;
+	};
+
+	struct LoadQueueThreads
+	{
+		LoadQueueThreads(LoadQueue& load_queue) :
+			queue(load_queue),
+			next_id(0),
+			batch_count(0),
+			batch_finished_count(0),
+			quit(false)
+		{
+		}
+
+		// the request with an id, or NULL if it has been finished, called with the mutex locked
+		LoadRequest* Find(const Int32 id) const
+		{
+			for (std::deque<LoadRequest*>::const_iterator request = requests.begin(); request != requests.end(); ++request)
+			{
+				if ((*request)->id == id)
+					return *request;
+			}
+			return NULL;
+		}
+
+		// the oldest request waiting to be read, called with the mutex locked
+		LoadRequest* NextQueued() const
+		{
+			for (std::deque<LoadRequest*>::const_iterator request = requests.begin(); request != requests.end(); ++request)
+			{
+				if ((*request)->status == LoadQueue::kQueued)
+					return *request;
+			}
+			return NULL;
+		}
+
+		// removes the oldest request that is ready to finish, called with the mutex locked
+		LoadRequest* TakeNextReady()
+		{
+			for (std::deque<LoadRequest*>::iterator request = requests.begin(); request != requests.end(); ++request)
+			{
+				const LoadQueue::Status status = (*request)->status;
+				if (status != LoadQueue::kQueued && status != LoadQueue::kReading)
+				{
+					LoadRequest* ready_request = *request;
+					requests.erase(request);
+					++batch_finished_count;
+					return ready_request;
+				}
+			}
+			return NULL;
+		}
+
+		// reads a request the caller has marked as kReading, without the mutex locked
+		void Read(LoadRequest* request)
+		{
+			const bool success = request->read_function(queue, request->id, request->data);
+
+			LoadQueueLock lock(mutex);
+			if (request->cancelled)
+				request->status = LoadQueue::kCancelled;
+			else if (success)
+			{
+				request->status = LoadQueue::kRead;
+				request->progress = 1.0f;
+			}
+			else
+				request->status = LoadQueue::kFailed;
+		}
+
+#ifdef GEF_LOAD_QUEUE_THREADS
+		void WorkerLoop()
+		{
+			for (;;)
+			{
+				LoadRequest* request = NULL;
+				{
+					std::unique_lock<std::mutex> lock(mutex);
+					work_ready.wait(lock, [this, &request]() { return quit || (request = NextQueued()) != NULL; });
+					if (quit)
+						return;
+
+					request->status = LoadQueue::kReading;
+				}
+
+				Read(request);
+				load_ready.notify_all();
+			}
+		}
+
+		std::vector<std::thread> workers;
+		std::condition_variable work_ready;
+		std::condition_variable load_ready;
+#endif
+
+		LoadQueue& queue;
+		mutable LoadQueueMutex mutex;
+		std::deque<LoadRequest*> requests;	// every load not yet finished, oldest first
+		Int32 next_id;
+		Int32 batch_count;					// loads added since the queue was last empty
+		Int32 batch_finished_count;			// how many of them have been finished
+		bool quit;
+	};
+
+	LoadQueue::LoadQueue(const Int32 num_worker_threads) :
+		threads_(NULL)
+	{
+		threads_ = new LoadQueueThreads(*this);
+
+#ifdef GEF_LOAD_QUEUE_THREADS
+		const Int32 num_workers = num_worker_threads > 0 ? num_worker_threads : 1;
+		for (Int32 thread_num = 0; thread_num < num_workers; ++thread_num)
+			threads_->workers.push_back(std::thread(&LoadQueueThreads::WorkerLoop, threads_));
+#endif
+	}
+
+	LoadQueue::~LoadQueue()
+	{
+		CancelAll();
+
+#ifdef GEF_LOAD_QUEUE_THREADS
+		{
+			std::lock_guard<std::mutex> lock(threads_->mutex);
+			threads_->quit = true;
+		}
+		threads_->work_ready.notify_all();
+		for (size_t thread_num = 0; thread_num < threads_->workers.size(); ++thread_num)
+			threads_->workers[thread_num].join();
+#endif
+
+		// every load is cancelled and no longer being read
+		Update();
+
+		DeleteNull(threads_);
+	}
+
+	Int32 LoadQueue::Add(ReadFunction read_function, FinishFunction finish_function, void* data)
+	{
+		LoadRequest* request = new LoadRequest();
+		request->read_function = read_function;
+		request->finish_function = finish_function;
+		request->data = data;
+		request->status = kQueued;
+		request->progress = 0.0f;
+		request->cancelled = false;
+
+		// once the lock is released a loading thread can finish and delete the request
+		Int32 id;
+		{
+			LoadQueueLock lock(threads_->mutex);
+			if (threads_->requests.empty())
+			{
+				threads_->batch_count = 0;
+				threads_->batch_finished_count = 0;
+			}
+
+			id = request->id = threads_->next_id++;
+			threads_->requests.push_back(request);
+			++threads_->batch_count;
+		}
+
+#ifdef GEF_LOAD_QUEUE_THREADS
+		threads_->work_ready.notify_one();
+#endif
+
+		return id;
+	}
+
+	Int32 LoadQueue::Update(const Int32 max_finished)
+	{
+#ifndef GEF_LOAD_QUEUE_THREADS
+		// there are no loading threads, so each update reads one load
+		LoadRequest* queued_request = threads_->NextQueued();
+		if (queued_request)
+		{
+			queued_request->status = kReading;
+			threads_->Read(queued_request);
+		}
+#endif
+
+		Int32 finished_count = 0;
+		while (max_finished < 0 || finished_count < max_finished)
+		{
+			LoadRequest* request = NULL;
+			{
+				LoadQueueLock lock(threads_->mutex);
+				request = threads_->TakeNextReady();
+			}
+
+			if (!request)
+				break;
+
+			// the request has left the queue, so the finish function runs without the mutex locked
+			request->finish_function(request->id, request->status, request->data);
+			delete request;
+			++finished_count;
+		}
+
+		return finished_count;
+	}
+
+	void LoadQueue::Flush()
+	{
+		while (pending_count() > 0)
+		{
+#ifdef GEF_LOAD_QUEUE_THREADS
+			{
+				std::unique_lock<std::mutex> lock(threads_->mutex);
+				threads_->load_ready.wait(lock, [this]()
+				{
+					for (std::deque<LoadRequest*>::const_iterator request = threads_->requests.begin(); request != threads_->requests.end(); ++request)
+					{
+						if ((*request)->status != kQueued && (*request)->status != kReading)
+							return true;
+					}
+					return threads_->requests.empty();
+				});
+			}
+#endif
+
+			Update();
+		}
+	}
+
+	bool LoadQueue::Cancel(const Int32 request_id)
+	{
+		LoadQueueLock lock(threads_->mutex);
+		LoadRequest* request = threads_->Find(request_id);
+		if (!request)
+			return false;
+
+		// a load being read is marked cancelled when its read function returns
+		request->cancelled = true;
+		if (request->status != kReading)
+			request->status = kCancelled;
+		return true;
+	}
+
+	void LoadQueue::CancelAll()
+	{
+		LoadQueueLock lock(threads_->mutex);
+		for (std::deque<LoadRequest*>::iterator request = threads_->requests.begin(); request != threads_->requests.end(); ++request)
+		{
+			(*request)->cancelled = true;
+			if ((*request)->status != kReading)
+				(*request)->status = kCancelled;
+		}
+	}
+
+	void LoadQueue::SetProgress(const Int32 request_id, const float progress)
+	{
+		LoadQueueLock lock(threads_->mutex);
+		LoadRequest* request = threads_->Find(request_id);
+		if (request)
+			request->progress = progress < 0.0f ? 0.0f : progress > 1.0f ? 1.0f : progress;
+	}
+
+	bool LoadQueue::IsCancelled(const Int32 request_id) const
+	{
+		LoadQueueLock lock(threads_->mutex);
+		const LoadRequest* request = threads_->Find(request_id);
+		return !request || request->cancelled;
+	}
+
+	float LoadQueue::GetProgress(const Int32 request_id) const
+	{
+		LoadQueueLock lock(threads_->mutex);
+		const LoadRequest* request = threads_->Find(request_id);
+		return request ? request->progress : 1.0f;
+	}
+
+	float LoadQueue::GetProgress() const
+	{
+		LoadQueueLock lock(threads_->mutex);
+		if (threads_->batch_count == 0)
+			return 1.0f;
+
+		float progress = (float)threads_->batch_finished_count;
+		for (std::deque<LoadRequest*>::const_iterator request = threads_->requests.begin(); request != threads_->requests.end(); ++request)
+			progress += (*request)->progress;
+		return progress / (float)threads_->batch_count;
+	}
+
+	Int32 LoadQueue::pending_count() const
+	{
+		LoadQueueLock lock(threads_->mutex);
+		return (Int32)threads_->requests.size();
+	}
+
+	Int32 LoadQueue::num_worker_threads() const
+	{
+#ifdef GEF_LOAD_QUEUE_THREADS
+		return static_cast<Int32>(threads_->workers.size());
+#else
+		return 0;
+#endif
+	}
+}
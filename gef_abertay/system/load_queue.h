@@ -0,0 +1,97 @@
+#ifndef _GEF_LOAD_QUEUE_H
+#define _GEF_LOAD_QUEUE_H
+
+#include <gef.h>
+
+namespace gef
+{
+	struct LoadQueueThreads;
+
+	/**
+	A queue of loads, each read on a loading thread then finished on the thread that calls Update.
+	A load's read function does its file reading and decoding, which needs no platform resources.
+	Its finish function then creates its platform resources, e.g. textures, on the main thread.
+	Loads are read in the order they were added.
+	On platforms without thread support, Update reads one load per call on the calling thread instead.
+	*/
+	class LoadQueue
+	{
+	public:
+		enum Status
+		{
+			kQueued = 0,	// waiting for a loading thread
+			kReading,		// being read on a loading thread
+			kRead,			// read, waiting for Update to finish it
+			kFailed,		// the read function failed
+			kCancelled		// cancelled before it was finished
+		};
+
+		/// @brief Function run on a loading thread to read a load.
+		/// @param[in] queue	The queue, to report progress with SetProgress and check IsCancelled.
+		/// @param[in] request	The load.
+		/// @param[in] data		The user data passed to Add.
+		/// @return false if the load failed
+		typedef bool (*ReadFunction)(LoadQueue& queue, const Int32 request, void* data);
+
+		/// @brief Function run by Update once a load has been read, failed or been cancelled.
+		/// @param[in] request	The load.
+		/// @param[in] status	kRead if the load was read and its resources can be created, otherwise kFailed or kCancelled.
+		/// @param[in] data		The user data passed to Add, which can be freed.
+		typedef void (*FinishFunction)(const Int32 request, const Status status, void* data);
+
+		/// @brief Creates the loading threads.
+		/// @param[in] num_worker_threads	The number of loading threads. Loads mostly wait on files, so one is usually enough.
+		LoadQueue(const Int32 num_worker_threads = 1);
+
+		/// @brief Cancels every load and waits for the loading threads to stop.
+		/// @note The finish function of each load not yet finished is called with kCancelled.
+		~LoadQueue();
+
+		/// @brief Adds a load to the end of the queue.
+		/// @return the id of the load, used by Cancel and GetProgress
+		Int32 Add(ReadFunction read_function, FinishFunction finish_function, void* data);
+
+		/// @brief Runs the finish function of loads that have been read, failed or cancelled, oldest first.
+		/// @param[in] max_finished	The most loads to finish, to spread creating resources over several frames.
+		/// A negative number finishes every load that is ready.
+		/// @return the number of loads finished
+		Int32 Update(const Int32 max_finished = -1);
+
+		/// @brief Waits for every load to be read and finishes them all.
+		void Flush();
+
+		/// @brief Cancels a load. A load being read stops at the read function's next IsCancelled check.
+		/// @note Its finish function is called with kCancelled by the next Update.
+		/// @return false if the load has already been finished
+		bool Cancel(const Int32 request);
+		void CancelAll();
+
+		/// @brief Reports how much of a load has been read. Called by read functions.
+		/// @param[in] progress		From 0 to 1.
+		void SetProgress(const Int32 request, const float progress);
+
+		/// @return true if a load has been cancelled, for read functions to stop early
+		bool IsCancelled(const Int32 request) const;
+
+		/// @return how much of a load has been read, from 0 to 1, 1 once it has been finished
+		float GetProgress(const Int32 request) const;
+
+		/// @return how much of every load added since the queue was last empty has been read, from 0 to 1
+		float GetProgress() const;
+
+		/// @return the number of loads that have not been finished
+		Int32 pending_count() const;
+
+		/// @return the number of loading threads
+		Int32 num_worker_threads() const;
+
+	private:
+		// not copyable, the loading threads hold a pointer to the queue
+		LoadQueue(const LoadQueue&);
+		LoadQueue& operator=(const LoadQueue&);
+
+		LoadQueueThreads* threads_;
+	};
+}
+
+#endif // _GEF_LOAD_QUEUE_H
@@ -0,0 +1,155 @@
+#include <system/mapped_file.h>
+
+#if defined(_WIN32)
+#define GEF_MAPPED_FILE_WIN32
+#include <Windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#define GEF_MAPPED_FILE_POSIX
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#else
+#include <system/file.h>
+#include <cstdlib>
+#endif
+
+namespace gef
+{
+	MappedFile::MappedFile() :
+		data_(NULL),
+		size_(0),
+		mapped_(false),
+		mapping_handle_(NULL)
+	{
+	}
+
+	MappedFile::~MappedFile()
+	{
+		Close();
+	}
+
+#if defined(GEF_MAPPED_FILE_WIN32)
+	bool MappedFile::Open(const char* const filename)
+	{
+		Close();
+
+		HANDLE file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (file == INVALID_HANDLE_VALUE)
+			return false;
+
+		LARGE_INTEGER file_size;
+		if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart <= 0 || file_size.HighPart != 0)
+		{
+			CloseHandle(file);
+			return false;
+		}
+
+		// the view keeps the mapping open, and the mapping keeps the file open
+		HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+		CloseHandle(file);
+		if (mapping == NULL)
+			return false;
+
+		data_ = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+		if (data_ == NULL)
+		{
+			CloseHandle(mapping);
+			return false;
+		}
+
+		mapping_handle_ = mapping;
+		size_ = (Int32)file_size.LowPart;
+		mapped_ = true;
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (data_)
+			UnmapViewOfFile(data_);
+		if (mapping_handle_)
+			CloseHandle((HANDLE)mapping_handle_);
+
+		data_ = NULL;
+		size_ = 0;
+		mapped_ = false;
+		mapping_handle_ = NULL;
+	}
+#elif defined(GEF_MAPPED_FILE_POSIX)
+	bool MappedFile::Open(const char* const filename)
+	{
+		Close();
+
+		const int file = open(filename, O_RDONLY);
+		if (file == -1)
+			return false;
+
+		struct stat file_status;
+		if (fstat(file, &file_status) != 0 || file_status.st_size <= 0 || file_status.st_size > 0x7fffffff)
+		{
+			close(file);
+			return false;
+		}
+
+		// the mapping stays valid after the file is closed
+		void* data = mmap(NULL, (size_t)file_status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		close(file);
+		if (data == MAP_FAILED)
+			return false;
+
+		data_ = data;
+		size_ = (Int32)file_status.st_size;
+		mapped_ = true;
+		return true;
+	}
+
+	void MappedFile::Close()
+	{
+		if (data_)
+			munmap(const_cast<void*>(data_), (size_t)size_);
+
+		data_ = NULL;
+		size_ = 0;
+		mapped_ = false;
+	}
+#else
+	bool MappedFile::Open(const char* const filename)
+	{
+		Close();
+
+		File* file = File::Create();
+		Int32 file_size = 0;
+		bool success = file->Open(filename);
+		if (success)
+		{
+			success = file->GetSize(file_size) && file_size > 0;
+
+			void* data = success ? malloc(file_size) : NULL;
+			Int32 bytes_read = 0;
+			success = data && file->Read(data, file_size, bytes_read) && bytes_read == file_size;
+			if (success)
+			{
+				data_ = data;
+				size_ = file_size;
+			}
+			else
+				free(data);
+
+			file->Close();
+		}
+		delete file;
+
+		return success;
+	}
+
+	void MappedFile::Close()
+	{
+		free(const_cast<void*>(data_));
+
+		data_ = NULL;
+		size_ = 0;
+		mapped_ = false;
+	}
+#endif
+}
@@ -0,0 +1,43 @@
+#ifndef _GEF_MAPPED_FILE_H
+#define _GEF_MAPPED_FILE_H
+
+#include <gef.h>
+
+namespace gef
+{
+	/// @brief A whole file mapped into memory read only, so its contents can be used in place without being copied.
+	/// @note Files are mapped with the operating system's file mapping on Windows and POSIX platforms.
+	/// Elsewhere, e.g. the PS Vita, the file is read into memory once instead, so the contents can still be used in place.
+	class MappedFile
+	{
+	public:
+		MappedFile();
+		~MappedFile();
+
+		/// @brief Maps a file, closing any file mapped before.
+		/// @param[in] filename		The file to map.
+		/// @return true if the file was mapped
+		bool Open(const char* const filename);
+
+		/// @brief Unmaps the file. Pointers into its contents are no longer valid.
+		void Close();
+
+		/// @return the contents of the file, or NULL if no file is open. Don't write to them.
+		inline const void* data() const { return data_; }
+		inline Int32 size() const { return size_; }
+
+		/// @return true if the contents are mapped, false if they were read into memory
+		inline bool mapped() const { return mapped_; }
+
+	private:
+		MappedFile(const MappedFile&);
+		MappedFile& operator=(const MappedFile&);
+
+		const void* data_;
+		Int32 size_;
+		bool mapped_;
+		void* mapping_handle_;		// the file mapping object on Windows
+	};
+}
+
+#endif // _GEF_MAPPED_FILE_H
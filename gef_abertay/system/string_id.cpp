@@ -1,34 +1,114 @@
 #include <system/string_id.h>
 #include <system/crc.h>
+#include <string.h>
 
 namespace gef
 {
+	// marks a slot that has never been used
+	static const UInt32 kEmptySlot = 0xffffffff;
+
+	// the table grows when it is more than this fraction full, numerator and denominator
+	static const UInt32 kMaxLoadNumerator = 3;
+	static const UInt32 kMaxLoadDenominator = 4;
+
+	static const UInt32 kMinSlots = 16;
+
+	StringIdTable::StringIdTable() :
+		num_strings_(0)
+	{
+	}
+
+	// string ids are already CRCs so the low bits are used as the hash directly
+	UInt32 StringIdTable::FindSlot(const StringId string_id) const
+	{
+		const UInt32 mask = static_cast<UInt32>(slots_.size()) - 1;
+		UInt32 slot_num = string_id & mask;
+		while (slots_[slot_num].string_offset != kEmptySlot && slots_[slot_num].string_id != string_id)
+			slot_num = (slot_num + 1) & mask;
+		return slot_num;
+	}
+
+	void StringIdTable::Grow()
+	{
+		std::vector<Slot> old_slots;
+		old_slots.swap(slots_);
+
+		Slot empty_slot;
+		empty_slot.string_id = 0;
+		empty_slot.string_offset = kEmptySlot;
+		slots_.resize(old_slots.empty() ? kMinSlots : old_slots.size() * 2, empty_slot);
+
+		for (size_t slot_num = 0; slot_num < old_slots.size(); ++slot_num)
+		{
+			if (old_slots[slot_num].string_offset != kEmptySlot)
+				slots_[FindSlot(old_slots[slot_num].string_id)] = old_slots[slot_num];
+		}
+	}
+
 	StringId StringIdTable::Add(const std::string& text)
 	{
 		// string id is generated from the string converted to uppercase
 		// the original string is stored
 		StringId string_id = GetStringId(text);
 
-		std::map<StringId, std::string>::iterator iter = table_.find(string_id);
-		if(iter == table_.end())
-			table_[string_id] = text;
+#ifndef GEF_NO_STRING_ID_TABLE
+		if (static_cast<UInt32>(num_strings_ + 1) * kMaxLoadDenominator > static_cast<UInt32>(slots_.size()) * kMaxLoadNumerator)
+			Grow();
+
+		Slot& slot = slots_[FindSlot(string_id)];
+		if (slot.string_offset == kEmptySlot)
+		{
+			slot.string_id = string_id;
+			slot.string_offset = static_cast<UInt32>(strings_.size());
+			strings_.insert(strings_.end(), text.c_str(), text.c_str() + text.length() + 1);
+			++num_strings_;
+		}
+#endif
+
 		return string_id;
 	}
 
-	bool StringIdTable::Find(const UInt32 string_id, std::string& result)
+	const char* StringIdTable::Find(const UInt32 string_id) const
+	{
+		if (slots_.empty())
+			return NULL;
+
+		const Slot& slot = slots_[FindSlot(string_id)];
+		if (slot.string_offset == kEmptySlot)
+			return NULL;
+
+		return &strings_[slot.string_offset];
+	}
+
+	bool StringIdTable::Find(const UInt32 string_id, std::string& result) const
 	{
-		std::map<StringId, std::string>::iterator iter = table_.find(string_id);
-		if(iter != table_.end())
+		const char* text = Find(string_id);
+		if (text)
 		{
-			result = iter->second;
+			result = text;
 			return true;
 		}
 		else
 			return false;
 	}
 
+	void StringIdTable::Clear()
+	{
+		slots_.clear();
+		strings_.clear();
+		num_strings_ = 0;
+	}
+
 	StringId GetStringId(const std::string& text)
 	{
 		return CRC::GetICRC(text.c_str());
 	}
-}
\ No newline at end of file
+
+	StringId GetStringId(const char* text)
+	{
+		return CRC::GetICRC(text);
+	}
+
+	// GEF_STRING_ID has to give the id GetStringId does, the standard CRC-32 check value has no lowercase letters to change
+	static_assert(GEF_STRING_ID("123456789") == 0xcbf43926, "GEF_STRING_ID doesn't match GetStringId");
+}
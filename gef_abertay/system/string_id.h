@@ -1,26 +1,88 @@
 #ifndef _STRING_ID_H
 #define _STRING_ID_H
 
-#include <map>
 #include <string>
+#include <vector>
+#include <type_traits>
 
 #include <gef.h>
+#include <system/crc.h>
+
+// define GEF_NO_STRING_ID_TABLE to stop StringIdTable storing strings, e.g. in release builds that
+// only look names up by id. Ids are still returned by Add but Find never finds a string.
+
+// the string id of a string literal, evaluated by the compiler, e.g. static const gef::StringId kWalk = GEF_STRING_ID("walk");
+// anything that isn't a constant expression, such as a char buffer filled at run time, fails to compile
+#define GEF_STRING_ID(literal) (std::integral_constant<gef::StringId, gef::GetStringIdConstant(literal)>::value)
 
 namespace gef
 {
 	typedef UInt32 StringId;
 
+	/**
+	Maps string ids back to the strings they were created from.
+	Strings are stored one after another in a single buffer and found with an open addressing hash table.
+	*/
 	class StringIdTable
 	{
 	public:
+		StringIdTable();
+
+		/// @brief Adds a string to the table.
+		/// @param[in] text		The string to add.
+		/// @return The string id of the text.
+		/// @note If a string with the same id has already been added, the original string is kept.
 		StringId Add(const std::string& text);
-		bool Find(const UInt32 string_id, std::string& result);
 
-		const std::map<StringId, std::string>& table() const { return table_; }
+		/// @brief Finds the string a string id was created from.
+		/// @param[in] string_id	The string id to look up.
+		/// @param[out] result		Receives the string if it is found.
+		/// @return true if the string is found
+		bool Find(const UInt32 string_id, std::string& result) const;
+
+		/// @brief Finds the string a string id was created from without copying it.
+		/// @return The null terminated string, or NULL if it is not found.
+		/// The pointer is valid until the next string is added.
+		const char* Find(const UInt32 string_id) const;
+
+		/// @brief Removes all strings from the table.
+		void Clear();
+
+		/// @return The number of strings in the table.
+		inline Int32 num_strings() const { return num_strings_; }
+
+		/// @return Every string in the table, each followed by a null terminator, in the order they were added.
+		inline const char* strings() const { return strings_.empty() ? NULL : &strings_[0]; }
+
+		/// @return The size of the buffer returned by strings(), in bytes.
+		inline UInt32 strings_size() const { return static_cast<UInt32>(strings_.size()); }
 	private:
-		std::map<StringId, std::string> table_;
+		struct Slot
+		{
+			StringId string_id;
+			UInt32 string_offset;
+		};
+
+		UInt32 FindSlot(const StringId string_id) const;
+		void Grow();
+
+		std::vector<Slot> slots_;
+		std::vector<char> strings_;
+		Int32 num_strings_;
 	};
 
 	extern StringId GetStringId(const std::string& text);
+
+	/// @brief Gets the string id of a null terminated string at run time, e.g. a name read from a file.
+	extern StringId GetStringId(const char* text);
+
+	/// @brief Gets the string id of a string literal in a constant expression.
+	/// @note Use GEF_STRING_ID, which only compiles if the id can be evaluated by the compiler.
+	/// Called directly at run time this takes the slow recursive constexpr CRC rather than GetStringId.
+	template<size_t Size>
+	constexpr StringId GetStringIdConstant(const char (&text)[Size])
+	{
+		return CRC::GetICRCConstant(text);
+	}
 }
-#endif // _STRING_ID_TABLE_H
\ No newline at end of file
+#endif // _STRING_ID_TABLE_H
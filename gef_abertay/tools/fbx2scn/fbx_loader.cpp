@@ -809,7 +809,8 @@ void AddMesh(FbxNode& node, Scene& scene, Platform& platform)
 		UInt32 triangle_count  = primitiveIter->second.size();
 		UInt32 index_count = triangle_count*3;
 
-		UInt8* indices = new UInt8[index_count*index_byte_size];
+		// freed by PrimitiveData with free
+		UInt8* indices = (UInt8*)malloc(index_count*index_byte_size);
 
 		for(UInt32 triangle_index=0;triangle_index<triangle_count;++triangle_index)
 		{
@@ -1,6 +1,7 @@
 #include <platform/win32/system/platform_win32_null_renderer.h>
 #include "fbx_loader.h"
 #include <graphics/scene.h>
+#include <animation/animation.h>
 #include <iostream>
 
 
@@ -13,6 +14,9 @@ int main(int argc, char* argv[])
 	char* output_filename = "output.scn";
 	char* input_filename = "";
 	bool animation_only = false;
+	float bake_frame_rate = 0.0f;
+	bool packed = false;
+	bool optimise_meshes = false;
 
 
 	gef::FBXLoader fbx_loader;
@@ -29,6 +33,11 @@ int main(int argc, char* argv[])
 			switch(argv[arg_num][1])
 			{
 			case 'o':
+				if(stricmp(&argv[arg_num][1], "optimise-meshes") == 0)
+				{
+					optimise_meshes = true;
+				}
+				else
 				{
 					if(arg_num < argc - 2)
 					{
@@ -127,6 +136,14 @@ int main(int argc, char* argv[])
 				}
 				break;
 
+			case 'b':
+				if (stricmp(&argv[arg_num][1], "bake-animations") == 0)
+				{
+					if (arg_num < argc - 2)
+						bake_frame_rate = (float)atof(argv[arg_num + 1]);
+				}
+				break;
+
 			case 'e':
 				if(stricmp(&argv[arg_num][1], "enable-skinning") == 0)
 				{
@@ -134,6 +151,13 @@ int main(int argc, char* argv[])
 				}
 				break;
 
+			case 'p':
+				if(stricmp(&argv[arg_num][1], "packed") == 0)
+				{
+					packed = true;
+				}
+				break;
+
 			case 's':
 				if(stricmp(&argv[arg_num][1], "strip-texture-path") == 0)
 				{
@@ -175,8 +199,30 @@ int main(int argc, char* argv[])
 	if(success)
 	{
 		std::cout << "file: " << input_filename << " loaded." << std::endl << std::endl;
+
+		// resample the clips at a fixed rate so they're sampled without key searches at run time
+		if (bake_frame_rate > 0.0f)
+		{
+			std::cout << "Baking animations at " << bake_frame_rate << " frames per second" << std::endl;
+			for (std::map<gef::StringId, gef::Animation*>::iterator animation_iter = scene.animations.begin(); animation_iter != scene.animations.end(); ++animation_iter)
+				animation_iter->second->Bake(bake_frame_rate);
+		}
+
+		// reorder the meshes for the vertex cache and overdraw, and use 16 bit indices where they fit
+		if (optimise_meshes)
+		{
+			gef::MeshOptimiserStats stats;
+			scene.OptimiseMeshes(gef::MeshOptimiserSettings(), &stats);
+			std::cout << "Optimised meshes: ACMR " << stats.acmr_before << " -> " << stats.acmr_after
+				<< ", " << stats.bytes_before << " -> " << stats.bytes_after << " bytes" << std::endl;
+		}
+
 		std::cout << "Writing output file: " << output_filename << std::endl;
-		success = scene.WriteSceneToFile(platform, output_filename);
+		// packed scenes are mapped and used in place when they're loaded
+		if (packed)
+			success = scene.WritePackedSceneToFile(output_filename);
+		else
+			success = scene.WriteSceneToFile(platform, output_filename);
 		if(success)
 			std::cout << "Success." << std::endl;
 		else
@@ -0,0 +1,881 @@
+#include "bench.h"
+#include "scene_file.h"
+#include <animation/animation.h>
+#include <animation/skeleton.h>
+#include <animation/anim_binding.h>
+#include <animation/compressed_animation.h>
+#include <animation/baked_animation.h>
+#include <animation/skeleton_pose_soa.h>
+#include <maths/transform_batch.h>
+#include <maths/transform.h>
+#include <maths/vector4.h>
+#include <maths/quaternion.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <sstream>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+namespace gef_bench
+{
+	// the TransformAnimNode samplers before the cursors, which scan every track from the first key
+	namespace reference
+	{
+		template<typename Key>
+		static void FindKeys(const std::vector<Key>& keys, const float time, const Key*& prev_key, const Key*& next_key)
+		{
+			prev_key = NULL;
+			next_key = NULL;
+			UInt32 key_index;
+			for (key_index = 0; key_index < keys.size(); key_index++)
+			{
+				if (keys[key_index].time > time)
+				{
+					next_key = &keys[key_index];
+					if (key_index > 0)
+						prev_key = &keys[key_index - 1];
+					break;
+				}
+			}
+
+			if (key_index == keys.size())
+				next_key = &keys[key_index - 1];
+		}
+
+		static gef::Vector4 GetVector(const std::vector<gef::Vector3Key>& keys, const float time)
+		{
+			gef::Vector4 result(0.f, 0.f, 0.f);
+			const gef::Vector3Key* prev_key;
+			const gef::Vector3Key* next_key;
+			FindKeys(keys, time, prev_key, next_key);
+			if (prev_key)
+				result.Lerp(prev_key->value, next_key->value, (time - prev_key->time) / (next_key->time - prev_key->time));
+			else
+				result = next_key->value;
+			return result;
+		}
+
+		static gef::Quaternion GetRotation(const std::vector<gef::QuaternionKey>& keys, const float time, const gef::QuaternionBlend blend)
+		{
+			gef::Quaternion result;
+			result.Identity();
+			const gef::QuaternionKey* prev_key;
+			const gef::QuaternionKey* next_key;
+			FindKeys(keys, time, prev_key, next_key);
+			if (prev_key)
+				gef::BlendQuaternion(prev_key->value, next_key->value, (time - prev_key->time) / (next_key->time - prev_key->time), result, blend);
+			else
+				result = next_key->value;
+			return result;
+		}
+	}
+
+	// the scale, rotation and translation of one node, like a joint pose
+	struct NodeSample
+	{
+		gef::Vector4 scale;
+		gef::Quaternion rotation;
+		gef::Vector4 translation;
+	};
+
+	class ClipSampler
+	{
+	public:
+		explicit ClipSampler(const gef::Animation& animation, const gef::QuaternionBlend blend = gef::QB_SLERP) :
+			blend_(blend)
+		{
+			for (std::map<gef::StringId, gef::AnimNode*>::const_iterator node_iter = animation.anim_nodes().begin(); node_iter != animation.anim_nodes().end(); ++node_iter)
+			{
+				if (node_iter->second->type() == gef::AnimNode::kTransform)
+					nodes_.push_back(static_cast<const gef::TransformAnimNode*>(node_iter->second));
+			}
+			cursors_.resize(nodes_.size());
+			samples_.resize(nodes_.size());
+		}
+
+		void SampleReference(const float time)
+		{
+			for (size_t node_num = 0; node_num < nodes_.size(); ++node_num)
+			{
+				const gef::TransformAnimNode& node = *nodes_[node_num];
+				NodeSample& sample = samples_[node_num];
+				if (!node.scale_keys().empty())
+					sample.scale = reference::GetVector(node.scale_keys(), time);
+				if (!node.rotation_keys().empty())
+					sample.rotation = reference::GetRotation(node.rotation_keys(), time, blend_);
+				if (!node.translation_keys().empty())
+					sample.translation = reference::GetVector(node.translation_keys(), time);
+			}
+		}
+
+		void Sample(const float time)
+		{
+			for (size_t node_num = 0; node_num < nodes_.size(); ++node_num)
+			{
+				const gef::TransformAnimNode& node = *nodes_[node_num];
+				NodeSample& sample = samples_[node_num];
+				if (!node.scale_keys().empty())
+					sample.scale = node.GetScale(time);
+				if (!node.rotation_keys().empty())
+					sample.rotation = node.GetRotation(time, blend_);
+				if (!node.translation_keys().empty())
+					sample.translation = node.GetTranslation(time);
+			}
+		}
+
+		void SampleWithCursors(const float time)
+		{
+			for (size_t node_num = 0; node_num < nodes_.size(); ++node_num)
+			{
+				const gef::TransformAnimNode& node = *nodes_[node_num];
+				gef::TransformAnimCursor& cursor = cursors_[node_num];
+				NodeSample& sample = samples_[node_num];
+				if (!node.scale_keys().empty())
+					sample.scale = node.GetScale(time, cursor);
+				if (!node.rotation_keys().empty())
+					sample.rotation = node.GetRotation(time, cursor, blend_);
+				if (!node.translation_keys().empty())
+					sample.translation = node.GetTranslation(time, cursor);
+			}
+		}
+
+		// the number of keys in every track, what the linear scan has to search
+		Int32 NumKeys() const
+		{
+			size_t num_keys = 0;
+			for (size_t node_num = 0; node_num < nodes_.size(); ++node_num)
+				num_keys += nodes_[node_num]->scale_keys().size() + nodes_[node_num]->rotation_keys().size() + nodes_[node_num]->translation_keys().size();
+			return static_cast<Int32>(num_keys);
+		}
+
+		Int32 num_nodes() const { return static_cast<Int32>(nodes_.size()); }
+		const std::vector<const gef::TransformAnimNode*>& nodes() const { return nodes_; }
+		const std::vector<NodeSample>& samples() const { return samples_; }
+
+	private:
+		std::vector<const gef::TransformAnimNode*> nodes_;
+		std::vector<gef::TransformAnimCursor> cursors_;
+		std::vector<NodeSample> samples_;
+		gef::QuaternionBlend blend_;
+	};
+
+	// samples every node of a compressed clip, in the same order as ClipSampler
+	class CompressedClipSampler
+	{
+	public:
+		explicit CompressedClipSampler(const gef::CompressedAnimation& animation) :
+			animation_(animation),
+			cursors_(animation.node_count()),
+			samples_(animation.node_count())
+		{
+		}
+
+		void Sample(const float time)
+		{
+			for (Int32 node_num = 0; node_num < animation_.node_count(); ++node_num)
+			{
+				gef::TransformAnimCursor& cursor = cursors_[node_num];
+				NodeSample& sample = samples_[node_num];
+				if (animation_.scale_key_count(node_num) > 0)
+					sample.scale = animation_.GetScale(node_num, time, cursor);
+				if (animation_.rotation_key_count(node_num) > 0)
+					sample.rotation = animation_.GetRotation(node_num, time, cursor);
+				if (animation_.translation_key_count(node_num) > 0)
+					sample.translation = animation_.GetTranslation(node_num, time, cursor);
+			}
+		}
+
+		const std::vector<NodeSample>& samples() const { return samples_; }
+
+	private:
+		const gef::CompressedAnimation& animation_;
+		std::vector<gef::TransformAnimCursor> cursors_;
+		std::vector<NodeSample> samples_;
+	};
+
+	// samples every track of a baked clip, in the same order as ClipSampler
+	class BakedClipSampler
+	{
+	public:
+		explicit BakedClipSampler(const gef::BakedAnimation& animation) :
+			animation_(animation),
+			samples_(animation.track_count())
+		{
+		}
+
+		void Sample(const float time)
+		{
+			const gef::BakedAnimation::FrameBlend frame_blend = animation_.GetFrameBlend(time);
+			for (Int32 track_num = 0; track_num < animation_.track_count(); ++track_num)
+			{
+				NodeSample& sample = samples_[track_num];
+				animation_.SampleTrack(track_num, frame_blend, sample.rotation, sample.translation);
+			}
+		}
+
+		const std::vector<NodeSample>& samples() const { return samples_; }
+
+	private:
+		const gef::BakedAnimation& animation_;
+		std::vector<NodeSample> samples_;
+	};
+
+	// a clip much longer than the samples, with smooth random tracks for a skeleton sized set of joints
+	static gef::Animation* CreateLongClip(std::mt19937& random, const Int32 num_joints, const float duration, const float keys_per_second)
+	{
+		std::uniform_real_distribution<float> offset(-0.05f, 0.05f);
+		const Int32 num_keys = static_cast<Int32>(duration*keys_per_second) + 1;
+
+		gef::Animation* animation = new gef::Animation();
+		for (Int32 joint_num = 0; joint_num < num_joints; ++joint_num)
+		{
+			gef::TransformAnimNode* node = new gef::TransformAnimNode();
+			node->set_name_id(static_cast<gef::StringId>(joint_num + 1));
+
+			gef::Quaternion rotation(0.0f, 0.0f, 0.0f, 1.0f);
+			gef::Vector4 translation(0.0f, 10.0f, 0.0f);
+			node->rotation_keys().resize(num_keys);
+			node->translation_keys().resize(num_keys);
+			for (Int32 key_num = 0; key_num < num_keys; ++key_num)
+			{
+				rotation = gef::Quaternion(rotation.x + offset(random), rotation.y + offset(random), rotation.z + offset(random), rotation.w + offset(random));
+				rotation.Normalise();
+				translation += gef::Vector4(offset(random), offset(random), offset(random));
+
+				const float time = key_num / keys_per_second;
+				node->rotation_keys()[key_num].value = rotation;
+				node->rotation_keys()[key_num].time = time;
+				node->translation_keys()[key_num].value = translation;
+				node->translation_keys()[key_num].time = time;
+			}
+			animation->AddNode(node);
+		}
+		animation->CalculateDuration();
+		return animation;
+	}
+
+	static Int32 CountMismatches(const std::vector<NodeSample>& samples, const std::vector<NodeSample>& expected)
+	{
+		Int32 num_mismatches = 0;
+		for (size_t node_num = 0; node_num < samples.size(); ++node_num)
+			num_mismatches += memcmp(&samples[node_num], &expected[node_num], sizeof(NodeSample)) == 0 ? 0 : 1;
+		return num_mismatches;
+	}
+
+	// plays a clip through twice at 60 fps, so the cursors have to cope with looping back to the start,
+	// then samples it at random times like seeks
+	static bool CheckClip(const char* name, const gef::Animation& animation, std::mt19937& random)
+	{
+		ClipSampler reference_sampler(animation), sampler(animation), cursor_sampler(animation);
+
+		const float frame_time = 1.0f / 60.0f;
+		const Int32 num_frames = static_cast<Int32>(animation.duration() / frame_time) + 1;
+		std::vector<float> times;
+		for (Int32 loop = 0; loop < 2; ++loop)
+		{
+			for (Int32 frame_num = 0; frame_num < num_frames + 2; ++frame_num)
+				times.push_back(animation.start_time() + frame_num*frame_time - frame_time);
+		}
+
+		std::uniform_real_distribution<float> time_range(animation.start_time() - 0.1f, animation.end_time() + 0.1f);
+		for (Int32 seek_num = 0; seek_num < 1000; ++seek_num)
+			times.push_back(time_range(random));
+
+		// key times themselves, where the search has to pick the right side of the key
+		if (reference_sampler.num_nodes() > 0)
+		{
+			const gef::TransformAnimNode* first_node = static_cast<const gef::TransformAnimNode*>(animation.anim_nodes().begin()->second);
+			for (size_t key_num = 0; key_num < first_node->rotation_keys().size(); ++key_num)
+				times.push_back(first_node->rotation_keys()[key_num].time);
+		}
+
+		Int32 num_mismatches = 0;
+		for (size_t time_num = 0; time_num < times.size(); ++time_num)
+		{
+			reference_sampler.SampleReference(times[time_num]);
+			sampler.Sample(times[time_num]);
+			cursor_sampler.SampleWithCursors(times[time_num]);
+			num_mismatches += CountMismatches(sampler.samples(), reference_sampler.samples());
+			num_mismatches += CountMismatches(cursor_sampler.samples(), reference_sampler.samples());
+		}
+
+		char check_name[96];
+		sprintf(check_name, "Anim cursor matches linear scan (%s)", name);
+		return ReportMismatches(check_name, num_mismatches);
+	}
+
+	// 60 fps playback of the whole clip, sampling every node each frame
+	static void BenchmarkPlayback(const char* name, const gef::Animation& animation)
+	{
+		ClipSampler sampler(animation);
+
+		const float frame_time = 1.0f / 60.0f;
+		const Int32 num_frames = static_cast<Int32>(animation.duration() / frame_time) + 1;
+		const Int32 num_samples = num_frames*sampler.num_nodes();
+		printf("Anim %s: %d nodes, %d keys, %.2f seconds\n", name, sampler.num_nodes(), sampler.NumKeys(), animation.duration());
+
+		const Int32 num_runs = 5;
+		double reference_time, search_time, cursor_time;
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+				sampler.SampleReference(animation.start_time() + frame_num*frame_time);
+			DoNotOptimise(&sampler.samples()[0]);
+		});
+		search_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+				sampler.Sample(animation.start_time() + frame_num*frame_time);
+			DoNotOptimise(&sampler.samples()[0]);
+		});
+		cursor_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+				sampler.SampleWithCursors(animation.start_time() + frame_num*frame_time);
+			DoNotOptimise(&sampler.samples()[0]);
+		});
+
+		char report_name[96];
+		sprintf(report_name, "Anim %s linear scan", name);
+		ReportTime(report_name, num_samples, reference_time, "nodes");
+		sprintf(report_name, "Anim %s binary search", name);
+		ReportTime(report_name, num_samples, search_time, "nodes");
+		sprintf(report_name, "Anim %s cursor", name);
+		ReportTime(report_name, num_samples, cursor_time, "nodes");
+		sprintf(report_name, "Anim %s cursor speed up", name);
+		ReportSpeedUp(report_name, reference_time, cursor_time);
+	}
+
+	// the angle between two rotations in radians
+	static double RotationError(const gef::Quaternion& a, const gef::Quaternion& b)
+	{
+		const double values_a[4] = { a.x, a.y, a.z, a.w }, values_b[4] = { b.x, b.y, b.z, b.w };
+		double same = 0.0, opposite = 0.0;
+		for (Int32 component = 0; component < 4; ++component)
+		{
+			same += (values_a[component] - values_b[component])*(values_a[component] - values_b[component]);
+			opposite += (values_a[component] + values_b[component])*(values_a[component] + values_b[component]);
+		}
+		const double chord = sqrt(same < opposite ? same : opposite);
+		return 4.0*asin(chord < 2.0 ? chord*0.5 : 1.0);
+	}
+
+	static double VectorError(const gef::Vector4& a, const gef::Vector4& b)
+	{
+		const gef::Vector4 difference = a - b;
+		return sqrt(static_cast<double>(difference.x())*difference.x() + static_cast<double>(difference.y())*difference.y() + static_cast<double>(difference.z())*difference.z());
+	}
+
+	// the largest errors of a compressed clip, over rotations, translations and scales
+	struct CompressionErrors
+	{
+		CompressionErrors() : rotation(0.0), translation(0.0), scale(0.0) {}
+
+		void Add(const ClipSampler& sampler, const CompressedClipSampler& compressed_sampler)
+		{
+			for (size_t node_num = 0; node_num < sampler.nodes().size(); ++node_num)
+			{
+				const gef::TransformAnimNode& node = *sampler.nodes()[node_num];
+				const NodeSample& sample = sampler.samples()[node_num];
+				const NodeSample& compressed_sample = compressed_sampler.samples()[node_num];
+				if (!node.rotation_keys().empty())
+					rotation = std::max(rotation, RotationError(sample.rotation, compressed_sample.rotation));
+				if (!node.translation_keys().empty())
+					translation = std::max(translation, VectorError(sample.translation, compressed_sample.translation));
+				if (!node.scale_keys().empty())
+					scale = std::max(scale, VectorError(sample.scale, compressed_sample.scale));
+			}
+		}
+
+		bool Within(const gef::AnimCompressionSettings& settings, const double scale_by) const
+		{
+			// a little slack for rounding in the error calculations
+			return rotation <= settings.rotation_error*scale_by + 1e-6 && translation <= settings.translation_error*scale_by + 1e-6 && scale <= settings.scale_error*scale_by + 1e-6;
+		}
+
+		double rotation;
+		double translation;
+		double scale;
+	};
+
+	// the memory Animation uses for the keys of a clip's transform nodes
+	static size_t GetKeyMemorySize(const ClipSampler& sampler)
+	{
+		size_t num_bytes = 0;
+		for (size_t node_num = 0; node_num < sampler.nodes().size(); ++node_num)
+		{
+			const gef::TransformAnimNode& node = *sampler.nodes()[node_num];
+			num_bytes += node.scale_keys().size()*sizeof(gef::Vector3Key) + node.rotation_keys().size()*sizeof(gef::QuaternionKey) + node.translation_keys().size()*sizeof(gef::Vector3Key);
+		}
+		return num_bytes;
+	}
+
+	// compresses a clip, checks its errors at the original key times, where they are bounded, and at 60 fps,
+	// then compares the speed of the compressed sampler with the cursor sampler for 60 fps playback
+	static bool BenchmarkCompression(const char* name, const gef::Animation& animation)
+	{
+		const gef::AnimCompressionSettings settings;
+		gef::CompressedAnimation compressed;
+		char report_name[96];
+		sprintf(report_name, "Anim compress %s", name);
+		if (!compressed.Compress(animation, settings))
+			return ReportCheck(report_name, false, 0.0);
+
+		// the compressor fits its keys with fast slerp between them, so that's how the clip is compared
+		ClipSampler sampler(animation, gef::QB_FAST_SLERP);
+		CompressedClipSampler compressed_sampler(compressed);
+
+		std::vector<float> key_times;
+		for (size_t node_num = 0; node_num < sampler.nodes().size(); ++node_num)
+		{
+			const gef::TransformAnimNode& node = *sampler.nodes()[node_num];
+			for (size_t key_num = 0; key_num < node.rotation_keys().size(); ++key_num)
+				key_times.push_back(node.rotation_keys()[key_num].time);
+			for (size_t key_num = 0; key_num < node.translation_keys().size(); ++key_num)
+				key_times.push_back(node.translation_keys()[key_num].time);
+			for (size_t key_num = 0; key_num < node.scale_keys().size(); ++key_num)
+				key_times.push_back(node.scale_keys()[key_num].time);
+		}
+		std::sort(key_times.begin(), key_times.end());
+		key_times.erase(std::unique(key_times.begin(), key_times.end()), key_times.end());
+
+		CompressionErrors key_errors;
+		for (size_t time_num = 0; time_num < key_times.size(); ++time_num)
+		{
+			sampler.Sample(key_times[time_num]);
+			compressed_sampler.Sample(key_times[time_num]);
+			key_errors.Add(sampler, compressed_sampler);
+		}
+
+		const float frame_time = 1.0f / 60.0f;
+		const Int32 num_frames = static_cast<Int32>(animation.duration() / frame_time) + 1;
+		CompressionErrors frame_errors;
+		for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+		{
+			const float time = animation.start_time() + frame_num*frame_time;
+			sampler.SampleWithCursors(time);
+			compressed_sampler.Sample(time);
+			frame_errors.Add(sampler, compressed_sampler);
+		}
+
+		printf("Anim %s compressed: %d -> %d keys, max rotation error %.2e rad, translation %.2e, scale %.2e at 60 fps\n", name, sampler.NumKeys(), compressed.GetKeyCount(),
+			frame_errors.rotation, frame_errors.translation, frame_errors.scale);
+
+		sprintf(report_name, "Anim %s compressed size", name);
+		ReportMemory(report_name, GetKeyMemorySize(sampler), compressed.GetMemorySize());
+
+		bool passed = true;
+		sprintf(report_name, "Anim compression error at keys (%s)", name);
+		passed = ReportCheck(report_name, key_errors.Within(settings, 1.0), key_errors.rotation) && passed;
+
+		// between keys the errors are interpolated, fast slerp can take them slightly over the bound
+		sprintf(report_name, "Anim compression error at 60 fps (%s)", name);
+		passed = ReportCheck(report_name, frame_errors.Within(settings, 1.5), frame_errors.rotation) && passed;
+
+		const Int32 num_samples = num_frames*sampler.num_nodes();
+		const Int32 num_runs = 5;
+		double cursor_time, compressed_time;
+
+		cursor_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+				sampler.SampleWithCursors(animation.start_time() + frame_num*frame_time);
+			DoNotOptimise(&sampler.samples()[0]);
+		});
+		compressed_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+				compressed_sampler.Sample(animation.start_time() + frame_num*frame_time);
+			DoNotOptimise(&compressed_sampler.samples()[0]);
+		});
+
+		// the cursor sampler here blends with fast slerp, so it has a different name from the one timed in BenchmarkPlayback
+		sprintf(report_name, "Anim %s cursor fast slerp", name);
+		ReportTime(report_name, num_samples, cursor_time, "nodes");
+		sprintf(report_name, "Anim %s compressed", name);
+		ReportTime(report_name, num_samples, compressed_time, "nodes");
+		sprintf(report_name, "Anim %s compressed speed up", name);
+		ReportSpeedUp(report_name, cursor_time, compressed_time);
+
+		return passed;
+	}
+
+	// the largest rotation and translation errors of a baked clip against its keys
+	static void AddBakingErrors(const ClipSampler& sampler, const BakedClipSampler& baked_sampler, double& rotation_error, double& translation_error)
+	{
+		for (size_t node_num = 0; node_num < sampler.nodes().size(); ++node_num)
+		{
+			const gef::TransformAnimNode& node = *sampler.nodes()[node_num];
+			if (!node.rotation_keys().empty())
+				rotation_error = std::max(rotation_error, RotationError(sampler.samples()[node_num].rotation, baked_sampler.samples()[node_num].rotation));
+			if (!node.translation_keys().empty())
+				translation_error = std::max(translation_error, VectorError(sampler.samples()[node_num].translation, baked_sampler.samples()[node_num].translation));
+		}
+	}
+
+	// bakes a clip at 30 and 60 fps, checks the baked frames against the keys and that they survive Animation::Write and Read,
+	// then compares the speed of baked sampling with the key searches for random seeks and for 60 fps playback
+	static bool BenchmarkBaking(const char* name, const gef::Animation& animation, std::mt19937& random)
+	{
+		char report_name[96];
+		bool passed = true;
+
+		ClipSampler sampler(animation);
+		std::uniform_real_distribution<float> time_range(animation.start_time(), animation.end_time());
+		std::vector<float> seek_times(1000);
+		for (size_t time_num = 0; time_num < seek_times.size(); ++time_num)
+			seek_times[time_num] = time_range(random);
+
+		const float frame_rates[] = { 30.0f, 60.0f };
+		for (Int32 rate_num = 0; rate_num < 2; ++rate_num)
+		{
+			gef::Animation baked_animation(animation);
+			sprintf(report_name, "Anim bake %s at %.0f fps", name, frame_rates[rate_num]);
+			if (!baked_animation.Bake(frame_rates[rate_num]) || baked_animation.baked()->track_count() != sampler.num_nodes())
+			{
+				passed = ReportCheck(report_name, false, 0.0) && passed;
+				continue;
+			}
+			const gef::BakedAnimation& baked = *baked_animation.baked();
+			BakedClipSampler baked_sampler(baked);
+
+			// on the baked frames the only error is rounding in the frame time
+			double frame_rotation_error = 0.0, frame_translation_error = 0.0;
+			for (Int32 frame_num = 0; frame_num < baked.frame_count(); ++frame_num)
+			{
+				const float time = std::min(animation.start_time() + frame_num / baked.frame_rate(), animation.end_time());
+				sampler.Sample(time);
+				baked_sampler.Sample(time);
+				AddBakingErrors(sampler, baked_sampler, frame_rotation_error, frame_translation_error);
+			}
+			sprintf(report_name, "Anim baked frames match keys (%s, %.0f fps)", name, frame_rates[rate_num]);
+			passed = ReportCheck(report_name, frame_rotation_error < 1e-4 && frame_translation_error < 1e-4, frame_rotation_error) && passed;
+
+			// between frames the error depends on how much the clip moves in a frame, so it is only reported
+			double seek_rotation_error = 0.0, seek_translation_error = 0.0;
+			for (size_t time_num = 0; time_num < seek_times.size(); ++time_num)
+			{
+				sampler.Sample(seek_times[time_num]);
+				baked_sampler.Sample(seek_times[time_num]);
+				AddBakingErrors(sampler, baked_sampler, seek_rotation_error, seek_translation_error);
+			}
+			printf("Anim %s baked at %.0f fps: %d frames, max rotation error %.2e rad, translation %.2e between frames\n", name, baked.frame_rate(), baked.frame_count(),
+				seek_rotation_error, seek_translation_error);
+			sprintf(report_name, "Anim %s baked size at %.0f fps", name, frame_rates[rate_num]);
+			ReportMemory(report_name, GetKeyMemorySize(sampler), baked.GetMemorySize());
+
+			// the baked frames are written after the nodes, and read back identically
+			std::stringstream stream;
+			baked_animation.Write(stream);
+			gef::Animation read_animation;
+			Int32 num_mismatches = 0;
+			if (read_animation.Read(stream) && read_animation.baked() && read_animation.anim_nodes().size() == animation.anim_nodes().size())
+			{
+				BakedClipSampler read_sampler(*read_animation.baked());
+				for (size_t time_num = 0; time_num < seek_times.size(); ++time_num)
+				{
+					baked_sampler.Sample(seek_times[time_num]);
+					read_sampler.Sample(seek_times[time_num]);
+					num_mismatches += CountMismatches(read_sampler.samples(), baked_sampler.samples());
+				}
+			}
+			else
+				num_mismatches = 1;
+			sprintf(report_name, "Anim baked clip reads back (%s, %.0f fps)", name, frame_rates[rate_num]);
+			passed = ReportMismatches(report_name, num_mismatches) && passed;
+
+			const Int32 num_runs = 5;
+			const Int32 num_seeks = static_cast<Int32>(seek_times.size());
+			double search_time, baked_time;
+
+			search_time = TimeBestOf(num_runs, [&]()
+			{
+				for (Int32 seek_num = 0; seek_num < num_seeks; ++seek_num)
+					sampler.Sample(seek_times[seek_num]);
+				DoNotOptimise(&sampler.samples()[0]);
+			});
+			baked_time = TimeBestOf(num_runs, [&]()
+			{
+				for (Int32 seek_num = 0; seek_num < num_seeks; ++seek_num)
+					baked_sampler.Sample(seek_times[seek_num]);
+				DoNotOptimise(&baked_sampler.samples()[0]);
+			});
+
+			sprintf(report_name, "Anim %s seek binary search %.0f fps run", name, frame_rates[rate_num]);
+			ReportTime(report_name, num_seeks*sampler.num_nodes(), search_time, "nodes");
+			sprintf(report_name, "Anim %s seek baked %.0f fps", name, frame_rates[rate_num]);
+			ReportTime(report_name, num_seeks*sampler.num_nodes(), baked_time, "nodes");
+			sprintf(report_name, "Anim %s seek baked %.0f fps speed up", name, frame_rates[rate_num]);
+			ReportSpeedUp(report_name, search_time, baked_time);
+
+			const float frame_time = 1.0f / 60.0f;
+			const Int32 num_frames = static_cast<Int32>(animation.duration() / frame_time) + 1;
+			double cursor_time, baked_playback_time;
+
+			cursor_time = TimeBestOf(num_runs, [&]()
+			{
+				for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+					sampler.SampleWithCursors(animation.start_time() + frame_num*frame_time);
+				DoNotOptimise(&sampler.samples()[0]);
+			});
+			baked_playback_time = TimeBestOf(num_runs, [&]()
+			{
+				for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+					baked_sampler.Sample(animation.start_time() + frame_num*frame_time);
+				DoNotOptimise(&baked_sampler.samples()[0]);
+			});
+
+			sprintf(report_name, "Anim %s playback baked %.0f fps speed up", name, frame_rates[rate_num]);
+			ReportSpeedUp(report_name, cursor_time, baked_playback_time);
+		}
+
+		// a clip that isn't baked still writes the original format, and reading it drops an earlier bake
+		std::stringstream stream;
+		animation.Write(stream);
+		gef::Animation read_animation(animation);
+		read_animation.Bake(frame_rates[0]);
+		sprintf(report_name, "Anim unbaked clip reads back (%s)", name);
+		passed = ReportCheck(report_name, read_animation.Read(stream) && !read_animation.baked() && stream.peek() == EOF, 0.0) && passed;
+
+		// tracks with no frames are rejected rather than sampled out of range
+		std::stringstream empty_stream;
+		const Int32 empty_header[] = { 1, 0, 0, 0, 0, 0 };
+		empty_stream.write((const char*)empty_header, sizeof(empty_header));
+		gef::BakedAnimation empty_baked;
+		sprintf(report_name, "Anim baked tracks without frames rejected (%s)", name);
+		passed = ReportCheck(report_name, !empty_baked.Read(empty_stream) && empty_baked.track_count() == 0, 0.0) && passed;
+
+		return passed;
+	}
+
+	static Int32 CountMismatches(const gef::SkeletonPose& pose, const gef::SkeletonPose& expected)
+	{
+		Int32 num_mismatches = 0;
+		for (size_t joint_num = 0; joint_num < pose.local_pose().size(); ++joint_num)
+		{
+			num_mismatches += memcmp(&pose.local_pose()[joint_num], &expected.local_pose()[joint_num], sizeof(gef::JointPose)) == 0 ? 0 : 1;
+			num_mismatches += memcmp(&pose.global_pose()[joint_num], &expected.global_pose()[joint_num], sizeof(gef::Matrix44)) == 0 ? 0 : 1;
+		}
+		return num_mismatches;
+	}
+
+	// SetPoseFromAnim with a binding against the node lookups per joint, for 60 fps playback of a clip on a skeleton
+	static bool BenchmarkPose(const char* name, const gef::Skeleton& skeleton, const gef::Animation& animation, const gef::Animation& other_animation)
+	{
+		gef::SkeletonPose bind_pose;
+		bind_pose.CreateBindPose(&skeleton);
+		gef::SkeletonPose pose = bind_pose, bound_pose = bind_pose;
+		gef::AnimBinding binding;
+
+		const float frame_time = 1.0f / 60.0f;
+		const Int32 num_frames = static_cast<Int32>(animation.duration() / frame_time) + 1;
+
+		// loops twice, then switches clips so the binding has to be rebuilt
+		Int32 num_mismatches = 0;
+		for (Int32 frame_num = 0; frame_num < num_frames*2; ++frame_num)
+		{
+			const float time = animation.start_time() + (frame_num % num_frames)*frame_time;
+			pose.SetPoseFromAnim(animation, bind_pose, time);
+			bound_pose.SetPoseFromAnim(animation, bind_pose, time, binding);
+			num_mismatches += CountMismatches(bound_pose, pose);
+		}
+		pose.SetPoseFromAnim(other_animation, bind_pose, 0.5f);
+		bound_pose.SetPoseFromAnim(other_animation, bind_pose, 0.5f, binding);
+		num_mismatches += CountMismatches(bound_pose, pose);
+		num_mismatches += binding.IsBound(skeleton, other_animation) ? 0 : 1;
+
+		char report_name[96];
+		sprintf(report_name, "Anim binding matches node lookups (%s)", name);
+		const bool passed = ReportMismatches(report_name, num_mismatches);
+
+		const Int32 num_runs = 5;
+		double lookup_time, binding_time;
+
+		// the local pose only, the global pose costs the same either way
+		lookup_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+				pose.SetPoseFromAnim(animation, bind_pose, animation.start_time() + frame_num*frame_time, false);
+			DoNotOptimise(&pose.local_pose()[0]);
+		});
+		binding_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+				bound_pose.SetPoseFromAnim(animation, bind_pose, animation.start_time() + frame_num*frame_time, binding, false);
+			DoNotOptimise(&bound_pose.local_pose()[0]);
+		});
+
+		sprintf(report_name, "Anim %s pose node lookups", name);
+		ReportTime(report_name, num_frames, lookup_time, "frames");
+		sprintf(report_name, "Anim %s pose binding", name);
+		ReportTime(report_name, num_frames, binding_time, "frames");
+		sprintf(report_name, "Anim %s pose binding speed up", name);
+		ReportSpeedUp(report_name, lookup_time, binding_time);
+
+		return passed;
+	}
+
+	// the batched local matrices can only differ from Transform::GetMatrix in the sign of zeros, which == ignores
+	static Int32 CountMismatches(const gef::Matrix44& matrix, const gef::Matrix44& expected)
+	{
+		Int32 num_mismatches = 0;
+		for (Int32 row = 0; row < 4; ++row)
+		{
+			for (Int32 column = 0; column < 4; ++column)
+				num_mismatches += matrix.m(row, column) == expected.m(row, column) ? 0 : 1;
+		}
+		return num_mismatches;
+	}
+
+	// the SoA pose's batched global pose pass against SkeletonPose::CalculateGlobalPose, for 60 fps playback of a clip on a skeleton
+	static bool BenchmarkSoAPose(const char* name, const gef::Skeleton& skeleton, const gef::Animation& animation)
+	{
+		gef::SkeletonPose bind_pose;
+		bind_pose.CreateBindPose(&skeleton);
+		gef::SkeletonPose pose = bind_pose;
+		gef::SkeletonPoseSoA soa_bind_pose, soa_pose;
+		soa_bind_pose.Create(bind_pose);
+		soa_pose.Create(bind_pose);
+		gef::AnimBinding binding, soa_binding;
+
+		const float frame_time = 1.0f / 60.0f;
+		const Int32 num_frames = static_cast<Int32>(animation.duration() / frame_time) + 1;
+
+		// with and without a transform on the root joints
+		gef::Matrix44 pose_transform;
+		pose_transform.RotationY(0.75f);
+		pose_transform.SetTranslation(gef::Vector4(10.0f, 0.0f, -5.0f));
+
+		Int32 num_mismatches = 0;
+		for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+		{
+			const float time = animation.start_time() + frame_num*frame_time;
+			const gef::Matrix44* const transform = (frame_num & 1) ? &pose_transform : NULL;
+			pose.SetPoseFromAnim(animation, bind_pose, time, binding, false);
+			pose.CalculateGlobalPose(transform);
+			soa_pose.SetPoseFromAnim(animation, soa_bind_pose, time, soa_binding, false);
+			soa_pose.CalculateGlobalPose(transform);
+			for (Int32 joint_num = 0; joint_num < soa_pose.joint_count(); ++joint_num)
+				num_mismatches += CountMismatches(soa_pose.global_pose()[joint_num], pose.global_pose()[joint_num]);
+		}
+
+		char report_name[96];
+		sprintf(report_name, "SoA global pose matches SkeletonPose (%s)", name);
+		const bool passed = ReportMismatches(report_name, num_mismatches);
+
+		const Int32 num_runs = 5;
+		double aos_time, soa_time;
+
+		// the global pose pass only, from the same local pose
+		aos_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+				pose.CalculateGlobalPose();
+			DoNotOptimise(&pose.global_pose()[0]);
+		});
+		soa_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+				soa_pose.CalculateGlobalPose();
+			DoNotOptimise(&soa_pose.global_pose()[0]);
+		});
+
+		sprintf(report_name, "Anim %s global pose AoS", name);
+		ReportTime(report_name, num_frames*soa_pose.joint_count(), aos_time, "joints");
+		sprintf(report_name, "Anim %s global pose SoA", name);
+		ReportTime(report_name, num_frames*soa_pose.joint_count(), soa_time, "joints");
+		sprintf(report_name, "Anim %s global pose SoA speed up", name);
+		ReportSpeedUp(report_name, aos_time, soa_time);
+
+		return passed;
+	}
+
+	// TransformMatricesBatch against Transform::GetMatrix for random joint transforms, including a partial block at the end
+	static bool CheckTransformMatricesBatch(std::mt19937& random)
+	{
+		const Int32 num_transforms = 103;
+		std::normal_distribution<float> normal;
+		std::uniform_real_distribution<float> range(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> scale_range(0.5f, 2.0f);
+
+		std::vector<gef::Quaternion> rotations(num_transforms);
+		std::vector<gef::Vector4> translations(num_transforms), scales(num_transforms);
+		std::vector<gef::Matrix44> matrices(num_transforms);
+		for (Int32 transform_num = 0; transform_num < num_transforms; ++transform_num)
+		{
+			rotations[transform_num] = gef::Quaternion(normal(random), normal(random), normal(random), normal(random));
+			rotations[transform_num].Normalise();
+			translations[transform_num] = gef::Vector4(range(random), range(random), range(random));
+			scales[transform_num] = gef::Vector4(scale_range(random), scale_range(random), scale_range(random));
+		}
+
+		gef::TransformMatricesBatch(&rotations[0], &translations[0], &scales[0], &matrices[0], num_transforms);
+
+		Int32 num_mismatches = 0;
+		for (Int32 transform_num = 0; transform_num < num_transforms; ++transform_num)
+		{
+			gef::Transform transform;
+			transform.set_rotation(rotations[transform_num]);
+			transform.set_translation(translations[transform_num]);
+			transform.set_scale(scales[transform_num]);
+			num_mismatches += CountMismatches(matrices[transform_num], transform.GetMatrix());
+		}
+
+		return ReportMismatches("TransformMatricesBatch matches Transform GetMatrix", num_mismatches);
+	}
+
+	bool RunAnimationBenchmarks()
+	{
+		std::mt19937 random(2468);
+		bool passed = true;
+
+		passed = CheckTransformMatricesBatch(random) && passed;
+
+		const char* const clip_filenames[] = { "running_InPlace.scn", "idle.scn" };
+		for (Int32 clip_num = 0; clip_num < static_cast<Int32>(sizeof(clip_filenames) / sizeof(clip_filenames[0])); ++clip_num)
+		{
+			SceneFile scene;
+			if (!scene.Read(clip_filenames[clip_num]) || scene.animations.empty())
+			{
+				printf("Anim %s: can't read %s, skipped\n", clip_filenames[clip_num], GetMediaFilename(clip_filenames[clip_num]).c_str());
+				continue;
+			}
+
+			passed = CheckClip(clip_filenames[clip_num], *scene.animations[0], random) && passed;
+			BenchmarkPlayback(clip_filenames[clip_num], *scene.animations[0]);
+			passed = BenchmarkCompression(clip_filenames[clip_num], *scene.animations[0]) && passed;
+			passed = BenchmarkBaking(clip_filenames[clip_num], *scene.animations[0], random) && passed;
+		}
+
+		// the sample clips played on the sample character
+		SceneFile character, running, idle;
+		if (character.Read("Y_Bot.scn") && !character.skeletons.empty() &&
+			running.Read("running_InPlace.scn") && !running.animations.empty() &&
+			idle.Read("idle.scn") && !idle.animations.empty())
+		{
+			passed = BenchmarkPose("Y_Bot running_InPlace.scn", *character.skeletons[0], *running.animations[0], *idle.animations[0]) && passed;
+			passed = BenchmarkPose("Y_Bot idle.scn", *character.skeletons[0], *idle.animations[0], *running.animations[0]) && passed;
+			passed = BenchmarkSoAPose("Y_Bot running_InPlace.scn", *character.skeletons[0], *running.animations[0]) && passed;
+
+			// the same with the baked frames sampled through the bindings
+			gef::Animation baked_running(*running.animations[0]);
+			baked_running.Bake(30.0f);
+			passed = BenchmarkSoAPose("Y_Bot running_InPlace.scn baked", *character.skeletons[0], baked_running) && passed;
+		}
+		else
+			printf("Anim Y_Bot: can't read the character or its clips from %s, skipped\n", GetMediaFilename("").c_str());
+
+		// a minute of motion capture rate keys for a Y_Bot sized skeleton
+		gef::Animation* long_clip = CreateLongClip(random, 65, 60.0f, 30.0f);
+		passed = CheckClip("60 second clip", *long_clip, random) && passed;
+		BenchmarkPlayback("60 second clip", *long_clip);
+		passed = BenchmarkCompression("60 second clip", *long_clip) && passed;
+		passed = BenchmarkBaking("60 second clip", *long_clip, random) && passed;
+		delete long_clip;
+
+		return passed;
+	}
+}
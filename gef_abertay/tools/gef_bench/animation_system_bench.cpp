@@ -0,0 +1,434 @@
+#include "bench.h"
+#include "scene_file.h"
+#include <animation/animation_system.h>
+#include <animation/animation.h>
+#include <animation/skeleton.h>
+#include <animation/skeleton_pose_soa.h>
+#include <animation/anim_binding.h>
+#include <animation/anim_lod.h>
+#include <system/job_system.h>
+#include <maths/matrix44.h>
+#include <vector>
+#include <random>
+#include <stdio.h>
+#include <string.h>
+
+namespace gef_bench
+{
+	// a crowd of characters playing the sample clips at different times and speeds, every third one blending the other clip in
+	static void CreateCrowd(std::vector<gef::AnimCharacter>& characters, const gef::SkeletonPoseSoA& bind_pose, const gef::Animation& running, const gef::Animation& idle, std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		std::uniform_real_distribution<float> speed_range(0.8f, 1.2f);
+
+		for (size_t character_num = 0; character_num < characters.size(); ++character_num)
+		{
+			gef::AnimCharacter& character = characters[character_num];
+			const gef::Animation& clip = (character_num & 1) ? idle : running;
+			const gef::Animation& other_clip = (character_num & 1) ? running : idle;
+
+			character.Create(bind_pose);
+			character.Play(&clip);
+			character.playback().anim_time = unit(random)*clip.duration();
+			character.playback().playback_speed = speed_range(random);
+			if (character_num % 3 == 0)
+			{
+				character.blend_playback().clip = &other_clip;
+				character.blend_playback().looping = true;
+				character.blend_playback().anim_time = unit(random)*other_clip.duration();
+				character.set_blend(unit(random));
+			}
+		}
+	}
+
+	static Int32 CountMismatches(const std::vector<gef::Matrix44>& matrices, const std::vector<gef::Matrix44>& expected)
+	{
+		Int32 num_mismatches = matrices.size() == expected.size() ? 0 : 1;
+		for (size_t matrix_num = 0; matrix_num < matrices.size() && matrix_num < expected.size(); ++matrix_num)
+			num_mismatches += memcmp(&matrices[matrix_num], &expected[matrix_num], sizeof(gef::Matrix44)) == 0 ? 0 : 1;
+		return num_mismatches;
+	}
+
+	// the skinning matrices of a character playing one clip, calculated with SkeletonPose the way the sample did before the animation system
+	static Int32 CountReferenceMismatches(const gef::AnimCharacter& character, const gef::SkeletonPose& bind_pose, gef::SkeletonPose& pose, gef::AnimBinding& binding)
+	{
+		const gef::Skeleton& skeleton = *bind_pose.skeleton();
+		pose.SetPoseFromAnim(*character.playback().clip, bind_pose, character.playback().SampleTime(), binding);
+
+		Int32 num_mismatches = 0;
+		for (Int32 joint_num = 0; joint_num < skeleton.joint_count(); ++joint_num)
+		{
+			// the batched matrices can only differ from SkeletonPose's in the sign of zeros, which == ignores
+			const gef::Matrix44 expected = skeleton.joint(joint_num).inv_bind_pose * pose.global_pose()[joint_num];
+			const gef::Matrix44& matrix = character.skinning_matrices()[joint_num];
+			for (Int32 row = 0; row < 4; ++row)
+			{
+				for (Int32 column = 0; column < 4; ++column)
+					num_mismatches += matrix.m(row, column) == expected.m(row, column) ? 0 : 1;
+			}
+		}
+		return num_mismatches;
+	}
+
+	// updates a crowd on one thread and with a job system, checking the results are the same and that the
+	// renderer's skinning matrices only change on SwapBuffers
+	static bool CheckAnimationSystem(const gef::SkeletonPose& bind_pose, const gef::SkeletonPoseSoA& soa_bind_pose, const gef::Animation& running, const gef::Animation& idle, gef::JobSystem& job_system)
+	{
+		const Int32 num_characters = 37;
+		const Int32 num_frames = 90;
+		const float frame_time = 1.0f / 60.0f;
+
+		std::vector<gef::AnimCharacter> characters(num_characters), job_characters(num_characters);
+		std::mt19937 random(1357), job_random(1357);
+		CreateCrowd(characters, soa_bind_pose, running, idle, random);
+		CreateCrowd(job_characters, soa_bind_pose, running, idle, job_random);
+
+		gef::AnimationSystem animation_system, job_animation_system;
+		for (Int32 character_num = 0; character_num < num_characters; ++character_num)
+		{
+			animation_system.AddCharacter(&characters[character_num]);
+			job_animation_system.AddCharacter(&job_characters[character_num]);
+		}
+
+		// an inactive character keeps its bind pose
+		characters[num_characters - 1].set_active(false);
+		job_characters[num_characters - 1].set_active(false);
+
+		gef::SkeletonPose reference_pose = bind_pose;
+		gef::AnimBinding reference_binding;
+		std::vector<gef::Matrix44> last_frame;
+
+		Int32 num_mismatches = 0, num_reference_mismatches = 0;
+		for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+		{
+			last_frame = job_characters[0].skinning_matrices();
+			animation_system.Update(frame_time);
+			job_animation_system.Update(frame_time, job_system);
+			num_mismatches += CountMismatches(job_characters[0].skinning_matrices(), last_frame);
+
+			animation_system.SwapBuffers();
+			job_animation_system.SwapBuffers();
+			for (Int32 character_num = 0; character_num < num_characters; ++character_num)
+				num_mismatches += CountMismatches(job_characters[character_num].skinning_matrices(), characters[character_num].skinning_matrices());
+
+			// character 2 isn't blended
+			num_reference_mismatches += CountReferenceMismatches(characters[2], bind_pose, reference_pose, reference_binding);
+		}
+
+		std::vector<gef::Matrix44> bind_matrices(soa_bind_pose.joint_count());
+		soa_bind_pose.CalculateSkinningMatrices(&bind_matrices[0]);
+		num_mismatches += CountMismatches(job_characters[num_characters - 1].skinning_matrices(), bind_matrices);
+
+		bool passed = ReportMismatches("Anim system jobs match one thread", num_mismatches);
+		passed = ReportMismatches("Anim system matches SkeletonPose", num_reference_mismatches) && passed;
+		return passed;
+	}
+
+	// the time to update a crowd on one thread, then with job systems of increasing numbers of threads
+	static void BenchmarkAnimationSystem(const gef::SkeletonPoseSoA& bind_pose, const gef::Animation& running, const gef::Animation& idle, const Int32 num_characters)
+	{
+		const Int32 num_frames = 10;
+		const Int32 num_runs = 5;
+		const float frame_time = 1.0f / 60.0f;
+
+		std::vector<gef::AnimCharacter> characters(num_characters);
+		std::mt19937 random(2468);
+		CreateCrowd(characters, bind_pose, running, idle, random);
+
+		gef::AnimationSystem animation_system;
+		for (Int32 character_num = 0; character_num < num_characters; ++character_num)
+			animation_system.AddCharacter(&characters[character_num]);
+
+		char report_name[96];
+		const double serial_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+			{
+				animation_system.Update(frame_time);
+				animation_system.SwapBuffers();
+			}
+			DoNotOptimise(&characters[0].skinning_matrices()[0]);
+		});
+		sprintf(report_name, "Anim system %d characters, 1 thread", num_characters);
+		ReportTime(report_name, num_characters*num_frames, serial_time, "characters");
+
+		// per core scaling, doubling the threads up to every hardware thread
+		const Int32 max_threads = gef::JobSystem::HardwareThreadCount() > 1 ? gef::JobSystem::HardwareThreadCount() : 1;
+		for (Int32 num_threads = 1; ; num_threads = num_threads*2 < max_threads ? num_threads*2 : max_threads)
+		{
+			gef::JobSystem job_system(num_threads - 1);
+			const double job_time = TimeBestOf(num_runs, [&]()
+			{
+				for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+				{
+					animation_system.Update(frame_time, job_system);
+					animation_system.SwapBuffers();
+				}
+				DoNotOptimise(&characters[0].skinning_matrices()[0]);
+			});
+
+			sprintf(report_name, "Anim system %d characters, %d job threads", num_characters, num_threads);
+			ReportTime(report_name, num_characters*num_frames, job_time, "characters");
+			sprintf(report_name, "Anim system %d characters, %d job threads speed up", num_characters, num_threads);
+			ReportSpeedUp(report_name, serial_time, job_time);
+
+			if (num_threads == max_threads)
+				break;
+		}
+	}
+
+	// the levels of detail the benchmarks use for Y_Bot: every other frame, then every fourth frame without the finger tips,
+	// then every eighth frame without the last two joints of each chain
+	static void CreateLodSettings(const gef::Skeleton& skeleton, gef::AnimLodSettings& lod_settings)
+	{
+		lod_settings.Create(skeleton);
+		lod_settings.AddLevel(10.0f, 2, 0);
+		lod_settings.AddLevel(25.0f, 4, 1);
+		lod_settings.AddLevel(50.0f, 8, 2);
+	}
+
+	// the largest distance between the joints of a character skinned by two sets of skinning matrices,
+	// each joint's bind pose position is skinned to where the matrices put it
+	static float MaxJointDistance(const gef::SkeletonPoseSoA& bind_pose, const std::vector<gef::Matrix44>& matrices, const std::vector<gef::Matrix44>& expected)
+	{
+		float max_distance = 0.0f;
+		for (Int32 joint_num = 0; joint_num < bind_pose.joint_count(); ++joint_num)
+		{
+			const gef::Vector4 bind_position = bind_pose.global_pose()[joint_num].GetTranslation();
+			const float distance = (bind_position.Transform(matrices[joint_num]) - bind_position.Transform(expected[joint_num])).Length();
+			max_distance = distance > max_distance ? distance : max_distance;
+		}
+		return max_distance;
+	}
+
+	// level 0 has to match a character without levels of detail exactly, levels that skip joints have to sample
+	// the rest exactly, and interpolated levels have to stay close to sampling every frame
+	static bool CheckAnimLod(const gef::SkeletonPoseSoA& bind_pose, const gef::AnimLodSettings& lod_settings, const gef::Animation& running, const gef::Animation& idle)
+	{
+		const Int32 num_characters = 6;
+		const Int32 num_frames = 120;
+		const float frame_time = 1.0f / 60.0f;
+		bool passed = true;
+
+		for (Int32 level_num = 0; level_num < lod_settings.level_count(); ++level_num)
+		{
+			const gef::AnimLodLevel& level = lod_settings.level(level_num);
+			std::vector<gef::AnimCharacter> characters(num_characters), lod_characters(num_characters);
+			std::mt19937 random(3579), lod_random(3579);
+			CreateCrowd(characters, bind_pose, running, idle, random);
+			CreateCrowd(lod_characters, bind_pose, running, idle, lod_random);
+
+			gef::AnimationSystem animation_system, lod_animation_system;
+			for (Int32 character_num = 0; character_num < num_characters; ++character_num)
+			{
+				animation_system.AddCharacter(&characters[character_num]);
+				lod_animation_system.AddCharacter(&lod_characters[character_num]);
+				lod_characters[character_num].set_lod_settings(&lod_settings);
+				lod_characters[character_num].set_position(gef::Vector4(level.min_distance, 0.0f, 0.0f));
+			}
+			lod_animation_system.SelectLods(gef::Vector4(0.0f, 0.0f, 0.0f));
+
+			Int32 num_mismatches = 0;
+			float max_distance = 0.0f;
+			for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+			{
+				animation_system.Update(frame_time);
+				lod_animation_system.Update(frame_time);
+				animation_system.SwapBuffers();
+				lod_animation_system.SwapBuffers();
+
+				for (Int32 character_num = 0; character_num < num_characters; ++character_num)
+				{
+					const gef::SkeletonPoseSoA& pose = characters[character_num].pose();
+					const gef::SkeletonPoseSoA& lod_pose = lod_characters[character_num].pose();
+					num_mismatches += lod_characters[character_num].lod_level() == level_num ? 0 : 1;
+					if (level.update_interval == 1)
+					{
+						for (size_t index = 0; index < level.joints.size(); ++index)
+						{
+							const Int32 joint_num = level.joints[index];
+							num_mismatches += memcmp(&lod_pose.rotations()[joint_num], &pose.rotations()[joint_num], sizeof(gef::Quaternion)) == 0 ? 0 : 1;
+							num_mismatches += memcmp(&lod_pose.translations()[joint_num], &pose.translations()[joint_num], sizeof(gef::Vector4)) == 0 ? 0 : 1;
+						}
+					}
+					else
+					{
+						const float distance = MaxJointDistance(bind_pose, lod_characters[character_num].skinning_matrices(), characters[character_num].skinning_matrices());
+						max_distance = distance > max_distance ? distance : max_distance;
+					}
+				}
+			}
+
+			char report_name[96];
+			if (level.update_interval == 1)
+			{
+				sprintf(report_name, "Anim LOD %d sampled joints match full update", level_num);
+				passed = ReportMismatches(report_name, num_mismatches) && passed;
+			}
+			else
+			{
+				// the error is measured relative to the distance of the level, as that's how much of the screen it covers,
+				// 1/200 of the distance is around four pixels at 720p with a 45 degree field of view
+				const float relative_distance = max_distance / level.min_distance;
+				sprintf(report_name, "Anim LOD %d joints within 1/200 of distance", level_num);
+				passed = ReportCheck(report_name, num_mismatches == 0 && relative_distance < 0.005f, relative_distance) && passed;
+			}
+		}
+
+		return passed;
+	}
+
+	// characters that drop to a lower level partway through, after playing in full, the joints the level
+	// skips must hold the local pose they had when the level changed, blended or not
+	static bool CheckAnimLodChange(const gef::SkeletonPoseSoA& bind_pose, const gef::AnimLodSettings& lod_settings, const gef::Animation& running, const gef::Animation& idle)
+	{
+		const Int32 num_characters = 6;
+		const Int32 num_full_frames = 30;
+		const Int32 num_lod_frames = 90;
+		const float frame_time = 1.0f / 60.0f;
+		bool passed = true;
+
+		for (Int32 level_num = 1; level_num < lod_settings.level_count(); ++level_num)
+		{
+			if (lod_settings.SamplesAllJoints(level_num))
+				continue;
+
+			const gef::AnimLodLevel& level = lod_settings.level(level_num);
+			std::vector<bool> sampled(bind_pose.joint_count(), false);
+			for (size_t index = 0; index < level.joints.size(); ++index)
+				sampled[level.joints[index]] = true;
+
+			std::vector<gef::AnimCharacter> characters(num_characters);
+			std::mt19937 random(2468);
+			CreateCrowd(characters, bind_pose, running, idle, random);
+
+			gef::AnimationSystem animation_system;
+			for (Int32 character_num = 0; character_num < num_characters; ++character_num)
+			{
+				animation_system.AddCharacter(&characters[character_num]);
+				characters[character_num].set_lod_settings(&lod_settings);
+			}
+
+			for (Int32 frame_num = 0; frame_num < num_full_frames; ++frame_num)
+			{
+				animation_system.Update(frame_time);
+				animation_system.SwapBuffers();
+			}
+
+			// the poses the skipped joints should hold
+			std::vector<gef::SkeletonPoseSoA> held_poses(num_characters);
+			for (Int32 character_num = 0; character_num < num_characters; ++character_num)
+			{
+				held_poses[character_num] = characters[character_num].pose();
+				characters[character_num].set_lod_level(level_num);
+			}
+
+			Int32 num_mismatches = 0;
+			for (Int32 frame_num = 0; frame_num < num_lod_frames; ++frame_num)
+			{
+				animation_system.Update(frame_time);
+				animation_system.SwapBuffers();
+
+				for (Int32 character_num = 0; character_num < num_characters; ++character_num)
+				{
+					const gef::SkeletonPoseSoA& pose = characters[character_num].pose();
+					const gef::SkeletonPoseSoA& held_pose = held_poses[character_num];
+					for (Int32 joint_num = 0; joint_num < pose.joint_count(); ++joint_num)
+					{
+						if (sampled[joint_num])
+							continue;
+						num_mismatches += memcmp(&pose.rotations()[joint_num], &held_pose.rotations()[joint_num], sizeof(gef::Quaternion)) == 0 ? 0 : 1;
+						num_mismatches += memcmp(&pose.translations()[joint_num], &held_pose.translations()[joint_num], sizeof(gef::Vector4)) == 0 ? 0 : 1;
+					}
+				}
+			}
+
+			char report_name[96];
+			sprintf(report_name, "Anim LOD %d skipped joints hold after a level change", level_num);
+			passed = ReportMismatches(report_name, num_mismatches) && passed;
+		}
+
+		return passed;
+	}
+
+	// the update time of a crowd at each level of detail, against updating every character in full
+	static void BenchmarkAnimLod(const gef::SkeletonPoseSoA& bind_pose, const gef::AnimLodSettings& lod_settings, const gef::Animation& running, const gef::Animation& idle, const Int32 num_characters)
+	{
+		// a multiple of every update interval, so each level samples the same share of frames every run
+		const Int32 num_frames = 24;
+		const Int32 num_runs = 5;
+		const float frame_time = 1.0f / 60.0f;
+
+		std::vector<gef::AnimCharacter> characters(num_characters);
+		std::mt19937 random(4680);
+		CreateCrowd(characters, bind_pose, running, idle, random);
+
+		gef::AnimationSystem animation_system;
+		for (Int32 character_num = 0; character_num < num_characters; ++character_num)
+		{
+			animation_system.AddCharacter(&characters[character_num]);
+			characters[character_num].set_lod_settings(&lod_settings);
+		}
+
+		char report_name[96];
+		double full_time = 0.0;
+		for (Int32 level_num = 0; level_num < lod_settings.level_count(); ++level_num)
+		{
+			const gef::AnimLodLevel& level = lod_settings.level(level_num);
+			for (Int32 character_num = 0; character_num < num_characters; ++character_num)
+				characters[character_num].set_position(gef::Vector4(level.min_distance, 0.0f, 0.0f));
+			animation_system.SelectLods(gef::Vector4(0.0f, 0.0f, 0.0f));
+
+			const double time = TimeBestOf(num_runs, [&]()
+			{
+				for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+				{
+					animation_system.Update(frame_time);
+					animation_system.SwapBuffers();
+				}
+				DoNotOptimise(&characters[0].skinning_matrices()[0]);
+			});
+
+			sprintf(report_name, "Anim LOD %d, every %d frames, %d joints", level_num, level.update_interval, (Int32)level.joints.size());
+			ReportTime(report_name, num_characters*num_frames, time, "characters");
+			if (level_num == 0)
+				full_time = time;
+			else
+			{
+				sprintf(report_name, "Anim LOD %d speed up", level_num);
+				ReportSpeedUp(report_name, full_time, time);
+			}
+		}
+	}
+
+	bool RunAnimationSystemBenchmarks()
+	{
+		SceneFile character, running, idle;
+		if (!character.Read("Y_Bot.scn") || character.skeletons.empty() ||
+			!running.Read("running_InPlace.scn") || running.animations.empty() ||
+			!idle.Read("idle.scn") || idle.animations.empty())
+		{
+			printf("Anim system: can't read Y_Bot or its clips from %s, skipped\n", GetMediaFilename("").c_str());
+			return true;
+		}
+
+		gef::SkeletonPose bind_pose;
+		bind_pose.CreateBindPose(character.skeletons[0]);
+		gef::SkeletonPoseSoA soa_bind_pose;
+		soa_bind_pose.Create(bind_pose);
+
+		// workers even on a single core machine, so the check always runs jobs on other threads
+		gef::JobSystem job_system(3);
+		bool passed = CheckAnimationSystem(bind_pose, soa_bind_pose, *running.animations[0], *idle.animations[0], job_system);
+
+		BenchmarkAnimationSystem(soa_bind_pose, *running.animations[0], *idle.animations[0], 500);
+
+		gef::AnimLodSettings lod_settings;
+		CreateLodSettings(*character.skeletons[0], lod_settings);
+		passed = CheckAnimLod(soa_bind_pose, lod_settings, *running.animations[0], *idle.animations[0]) && passed;
+		passed = CheckAnimLodChange(soa_bind_pose, lod_settings, *running.animations[0], *idle.animations[0]) && passed;
+		BenchmarkAnimLod(soa_bind_pose, lod_settings, *running.animations[0], *idle.animations[0], 200);
+
+		return passed;
+	}
+}
@@ -0,0 +1,154 @@
+#include "bench.h"
+#include <maths/simd.h>
+#include <cstdio>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace gef_bench
+{
+	static volatile const void* g_sink = NULL;
+
+	// every reported result as a JSON object, written out by WriteJson
+	static std::vector<std::string> g_results;
+
+	static std::string g_media_path = "../../../../samples/media/";
+
+	static std::string JsonString(const char* text)
+	{
+		std::string result = "\"";
+		for (const char* character = text; *character; ++character)
+		{
+			if (*character == '"' || *character == '\\')
+				result.push_back('\\');
+			if (static_cast<unsigned char>(*character) >= ' ')
+				result.push_back(*character);
+		}
+		result.push_back('"');
+		return result;
+	}
+
+	// JSON has no infinity or NaN
+	static std::string JsonNumber(const double value)
+	{
+		if (!std::isfinite(value))
+			return "null";
+
+		char buffer[32];
+		sprintf(buffer, "%.9g", value);
+		return buffer;
+	}
+
+	static void RecordResult(const char* name, const char* type, const std::string& fields)
+	{
+		g_results.push_back("{\"name\": " + JsonString(name) + ", \"type\": \"" + type + "\", " + fields + "}");
+	}
+
+	Timer::Timer()
+	{
+		Start();
+	}
+
+	void Timer::Start()
+	{
+		start_ = std::chrono::high_resolution_clock::now();
+	}
+
+	double Timer::ElapsedSeconds() const
+	{
+		const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start_;
+		return elapsed.count();
+	}
+
+	void ReportTime(const char* name, const Int32 num_items, const double seconds, const char* unit)
+	{
+		const double items_per_second = seconds > 0.0 ? num_items / seconds : 0.0;
+		printf("%-48s %8d %-10s %10.3f ms %14.0f %s/sec\n", name, num_items, unit, seconds*1000.0, items_per_second, unit);
+
+		RecordResult(name, "time", "\"items\": " + JsonNumber(num_items) + ", \"unit\": " + JsonString(unit) +
+			", \"seconds\": " + JsonNumber(seconds) + ", \"items_per_second\": " + JsonNumber(items_per_second));
+	}
+
+	void ReportThroughput(const char* name, const Int32 num_bytes, const double seconds)
+	{
+		const double megabytes_per_second = seconds > 0.0 ? num_bytes / (seconds*1024.0*1024.0) : 0.0;
+		printf("%-48s %8d %-10s %10.3f ms %14.1f MB/sec\n", name, num_bytes, "bytes", seconds*1000.0, megabytes_per_second);
+
+		RecordResult(name, "throughput", "\"bytes\": " + JsonNumber(num_bytes) + ", \"seconds\": " + JsonNumber(seconds) +
+			", \"megabytes_per_second\": " + JsonNumber(megabytes_per_second));
+	}
+
+	void ReportSpeedUp(const char* name, const double reference_seconds, const double optimised_seconds)
+	{
+		const double speed_up = optimised_seconds > 0.0 ? reference_seconds / optimised_seconds : 0.0;
+		printf("%-48s %8.2fx\n", name, speed_up);
+
+		RecordResult(name, "speed_up", "\"speed_up\": " + JsonNumber(speed_up));
+	}
+
+	void ReportMemory(const char* name, const size_t reference_bytes, const size_t optimised_bytes)
+	{
+		const double ratio = optimised_bytes > 0 ? static_cast<double>(reference_bytes) / optimised_bytes : 0.0;
+		printf("%-48s %8u -> %8u bytes %8.2fx smaller\n", name, static_cast<UInt32>(reference_bytes), static_cast<UInt32>(optimised_bytes), ratio);
+
+		RecordResult(name, "memory", "\"reference_bytes\": " + JsonNumber(static_cast<double>(reference_bytes)) +
+			", \"bytes\": " + JsonNumber(static_cast<double>(optimised_bytes)) + ", \"ratio\": " + JsonNumber(ratio));
+	}
+
+	bool ReportCheck(const char* name, const bool passed, const double max_error)
+	{
+		printf("%-48s %s (max error %g)\n", name, passed ? "PASSED" : "FAILED", max_error);
+
+		RecordResult(name, "check", std::string("\"passed\": ") + (passed ? "true" : "false") + ", \"max_error\": " + JsonNumber(max_error));
+		return passed;
+	}
+
+	bool ReportMismatches(const char* name, const Int32 num_mismatches)
+	{
+		printf("%-48s %s (%d mismatches)\n", name, num_mismatches == 0 ? "PASSED" : "FAILED", num_mismatches);
+
+		RecordResult(name, "check", std::string("\"passed\": ") + (num_mismatches == 0 ? "true" : "false") + ", \"mismatches\": " + JsonNumber(num_mismatches));
+		return num_mismatches == 0;
+	}
+
+	void SetMediaPath(const char* media_path)
+	{
+		g_media_path = media_path;
+		if (!g_media_path.empty() && g_media_path[g_media_path.length() - 1] != '/' && g_media_path[g_media_path.length() - 1] != '\\')
+			g_media_path.push_back('/');
+	}
+
+	std::string GetMediaFilename(const char* filename)
+	{
+		return g_media_path + filename;
+	}
+
+	void DoNotOptimise(const void* data)
+	{
+		g_sink = data;
+	}
+
+	bool WriteJson(const char* filename, const bool passed)
+	{
+		FILE* file = fopen(filename, "w");
+		if (!file)
+			return false;
+
+#if defined(GEF_SIMD_SSE)
+		const char* simd = "sse";
+#elif defined(GEF_SIMD_NEON)
+		const char* simd = "neon";
+#else
+		const char* simd = "scalar";
+#endif
+
+		fprintf(file, "{\n  \"simd\": \"%s\",\n  \"passed\": %s,\n  \"results\": [\n", simd, passed ? "true" : "false");
+		for (size_t result_num = 0; result_num < g_results.size(); ++result_num)
+			fprintf(file, "    %s%s\n", g_results[result_num].c_str(), result_num + 1 < g_results.size() ? "," : "");
+		fprintf(file, "  ]\n}\n");
+
+		const bool written = ferror(file) == 0;
+		fclose(file);
+		return written;
+	}
+}
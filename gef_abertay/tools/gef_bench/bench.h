@@ -0,0 +1,103 @@
+#ifndef _GEF_BENCH_H
+#define _GEF_BENCH_H
+
+#include <gef.h>
+#include <chrono>
+#include <string>
+
+namespace gef_bench
+{
+	class Timer
+	{
+	public:
+		Timer();
+		void Start();
+		double ElapsedSeconds() const;
+	private:
+		std::chrono::high_resolution_clock::time_point start_;
+	};
+
+	/// @brief Runs a function several times and returns the fastest run.
+	/// @param[in] num_runs	The number of times to run the function.
+	/// @param[in] function	The function to time.
+	/// @return the time taken by the fastest run, in seconds
+	template<typename Function>
+	double TimeBestOf(const Int32 num_runs, Function function)
+	{
+		double best_time = 0.0;
+		for (Int32 run = 0; run < num_runs; ++run)
+		{
+			Timer timer;
+			function();
+			const double time = timer.ElapsedSeconds();
+			if (run == 0 || time < best_time)
+				best_time = time;
+		}
+		return best_time;
+	}
+
+	/// @brief Prints the time taken to process a number of items.
+	/// @param[in] name			The name of the benchmark.
+	/// @param[in] num_items	The number of items processed in the timed run.
+	/// @param[in] seconds		The time taken by the timed run.
+	/// @param[in] unit			The name of the items being processed, e.g. "sprites"
+	void ReportTime(const char* name, const Int32 num_items, const double seconds, const char* unit);
+
+	/// @brief Prints the rate a block of data was processed at, in megabytes per second.
+	/// @param[in] name			The name of the benchmark.
+	/// @param[in] num_bytes	The number of bytes processed in the timed run.
+	/// @param[in] seconds		The time taken by the timed run.
+	void ReportThroughput(const char* name, const Int32 num_bytes, const double seconds);
+
+	/// @brief Prints the speed up of an optimised version of a benchmark over the reference version.
+	void ReportSpeedUp(const char* name, const double reference_seconds, const double optimised_seconds);
+
+	/// @brief Prints the memory used by an optimised version of some data against the reference version.
+	/// @param[in] name				The name of the data.
+	/// @param[in] reference_bytes	The size of the reference version.
+	/// @param[in] optimised_bytes	The size of the optimised version.
+	void ReportMemory(const char* name, const size_t reference_bytes, const size_t optimised_bytes);
+
+	/// @brief Prints the result of a validation check.
+	/// @return passed
+	bool ReportCheck(const char* name, const bool passed, const double max_error);
+
+	/// @brief Prints the result of a validation check that counts mismatching results.
+	/// @return true if there were no mismatches
+	bool ReportMismatches(const char* name, const Int32 num_mismatches);
+
+	/// @brief Writes every result reported so far to a JSON file, so regressions can be tracked between builds.
+	/// @param[in] filename		The file to write.
+	/// @param[in] passed		Whether every check passed.
+	/// @return true if the file was written
+	bool WriteJson(const char* filename, const bool passed);
+
+	/// @brief Sets the directory the sample media is read from, see GetMediaFilename.
+	void SetMediaPath(const char* media_path);
+
+	/// @brief Returns the path of a file in the sample media directory.
+	/// @note The media path defaults to gef's samples/media directory, relative to the directories the project files are in.
+	std::string GetMediaFilename(const char* filename);
+
+	// stops the optimiser from throwing away results that are never read
+	void DoNotOptimise(const void* data);
+
+	bool RunSpriteBatchBenchmarks();
+	bool RunVector4Benchmarks();
+	bool RunMatrix44Benchmarks();
+	bool RunTransformBatchBenchmarks();
+	bool RunFrustumBenchmarks();
+	bool RunStringIdBenchmarks();
+	bool RunCRCBenchmarks();
+	bool RunQuaternionBenchmarks();
+	bool RunTransformBenchmarks();
+	bool RunAnimationBenchmarks();
+	bool RunAnimationSystemBenchmarks();
+	bool RunBlendTreeBenchmarks();
+	bool RunSkinningBenchmarks();
+	bool RunSceneBenchmarks();
+	bool RunMeshBenchmarks();
+	bool RunLoadBenchmarks();
+}
+
+#endif // _GEF_BENCH_H
@@ -0,0 +1,258 @@
+#include "bench.h"
+#include "scene_file.h"
+#include <animation/blend_tree.h>
+#include <animation/animation.h>
+#include <animation/skeleton.h>
+#include <animation/skeleton_pose_soa.h>
+#include <animation/anim_binding.h>
+#include <system/string_id.h>
+#include <maths/quaternion.h>
+#include <maths/vector4.h>
+#include <vector>
+#include <algorithm>
+#include <stdio.h>
+#include <math.h>
+
+namespace gef_bench
+{
+	// the largest difference between the local poses of two poses, over rotation and translation components
+	static double LocalPoseError(const gef::SkeletonPoseSoA& pose, const gef::SkeletonPoseSoA& expected, const std::vector<float>* joint_weights = NULL, const float joint_weight = 0.0f)
+	{
+		double max_error = 0.0;
+		for (Int32 joint_num = 0; joint_num < pose.joint_count(); ++joint_num)
+		{
+			if (joint_weights && (*joint_weights)[joint_num] != joint_weight)
+				continue;
+
+			const gef::Quaternion& rotation = pose.rotations()[joint_num];
+			const gef::Quaternion& expected_rotation = expected.rotations()[joint_num];
+			const float sign = rotation.x*expected_rotation.x + rotation.y*expected_rotation.y + rotation.z*expected_rotation.z + rotation.w*expected_rotation.w < 0.0f ? -1.0f : 1.0f;
+			max_error = std::max(max_error, (double)fabsf(rotation.x - sign*expected_rotation.x));
+			max_error = std::max(max_error, (double)fabsf(rotation.y - sign*expected_rotation.y));
+			max_error = std::max(max_error, (double)fabsf(rotation.z - sign*expected_rotation.z));
+			max_error = std::max(max_error, (double)fabsf(rotation.w - sign*expected_rotation.w));
+
+			const gef::Vector4 difference = pose.translations()[joint_num] - expected.translations()[joint_num];
+			max_error = std::max(max_error, (double)fabsf(difference.x()));
+			max_error = std::max(max_error, (double)fabsf(difference.y()));
+			max_error = std::max(max_error, (double)fabsf(difference.z()));
+		}
+		return max_error;
+	}
+
+	// each node type against the same blend done joint by joint from separately sampled poses
+	static bool CheckBlendTree(const gef::Skeleton& skeleton, const gef::SkeletonPoseSoA& bind_pose, const gef::Animation& running, const gef::Animation& idle)
+	{
+		const float running_time = running.start_time() + 0.3f*running.duration();
+		const float idle_time = idle.start_time() + 0.6f*idle.duration();
+
+		gef::SkeletonPoseSoA running_pose = bind_pose, idle_pose = bind_pose, expected = bind_pose, result = bind_pose;
+		gef::AnimBinding running_binding, idle_binding;
+		running_pose.SetPoseFromAnim(running, bind_pose, running_time, running_binding, false);
+		idle_pose.SetPoseFromAnim(idle, bind_pose, idle_time, idle_binding, false);
+
+		gef::PosePool pool;
+		bool passed = true;
+
+		// two way blend, the same as a normalised lerp
+		{
+			gef::BlendTree tree;
+			const Int32 running_node = tree.AddClipNode(&running);
+			const Int32 idle_node = tree.AddClipNode(&idle);
+			tree.playback(running_node).anim_time = running_time - running.start_time();
+			tree.playback(idle_node).anim_time = idle_time - idle.start_time();
+			const Int32 blend_node = tree.AddBlendNode();
+			tree.AddBlendInput(blend_node, running_node, 0.7f);
+			tree.AddBlendInput(blend_node, idle_node, 0.3f);
+
+			pool.Create(bind_pose, tree.GetPoolSizeNeeded());
+			const bool evaluated = tree.Evaluate(bind_pose, pool, result);
+
+			for (Int32 joint_num = 0; joint_num < bind_pose.joint_count(); ++joint_num)
+			{
+				expected.rotations()[joint_num].Nlerp(running_pose.rotations()[joint_num], idle_pose.rotations()[joint_num], 0.3f);
+				expected.translations()[joint_num].Lerp(running_pose.translations()[joint_num], idle_pose.translations()[joint_num], 0.3f);
+			}
+			const double error = LocalPoseError(result, expected);
+			passed = ReportCheck("Blend tree two way blend matches nlerp", evaluated && pool.used_count() == 0 && error < 1e-5, error) && passed;
+
+			// a zero weight input is skipped, leaving the other input exactly
+			tree.set_input_weight(blend_node, 1, 0.0f);
+			tree.Evaluate(bind_pose, pool, result);
+			const double skip_error = LocalPoseError(result, running_pose);
+			passed = ReportCheck("Blend tree zero weight input skipped", skip_error == 0.0, skip_error) && passed;
+		}
+
+		// additive, the difference between running and idle applied to idle gives running back
+		{
+			gef::BlendTree tree;
+			const Int32 base_node = tree.AddClipNode(&idle);
+			const Int32 additive_node = tree.AddClipNode(&running);
+			const Int32 reference_node = tree.AddClipNode(&idle);
+			tree.playback(base_node).anim_time = idle_time - idle.start_time();
+			tree.playback(additive_node).anim_time = running_time - running.start_time();
+			tree.playback(reference_node).anim_time = idle_time - idle.start_time();
+			tree.AddAdditiveNode(base_node, additive_node, reference_node, 1.0f);
+
+			pool.Create(bind_pose, tree.GetPoolSizeNeeded());
+			const bool evaluated = tree.Evaluate(bind_pose, pool, result);
+			const double error = LocalPoseError(result, running_pose);
+			passed = ReportCheck("Blend tree additive layer restores its clip", evaluated && pool.used_count() == 0 && error < 1e-4, error) && passed;
+
+			// too few pool poses fails, giving back every pose it borrowed
+			pool.Create(bind_pose, tree.GetPoolSizeNeeded() - 1);
+			passed = ReportCheck("Blend tree fails with too small a pool", !tree.Evaluate(bind_pose, pool, result) && pool.used_count() == 0, 0.0) && passed;
+		}
+
+		// mask, the joints below the spine take the layer and the rest keep the base
+		{
+			std::vector<float> joint_weights;
+			const bool found = gef::BlendTree::CreateJointMask(skeleton, GEF_STRING_ID("mixamorig:Spine"), joint_weights);
+			const Int32 num_masked = (Int32)std::count(joint_weights.begin(), joint_weights.end(), 1.0f);
+
+			gef::BlendTree tree;
+			const Int32 base_node = tree.AddClipNode(&idle);
+			const Int32 layer_node = tree.AddClipNode(&running);
+			tree.playback(base_node).anim_time = idle_time - idle.start_time();
+			tree.playback(layer_node).anim_time = running_time - running.start_time();
+			tree.AddMaskNode(base_node, layer_node, joint_weights);
+
+			pool.Create(bind_pose, tree.GetPoolSizeNeeded());
+			const bool evaluated = tree.Evaluate(bind_pose, pool, result);
+			const double error = std::max(LocalPoseError(result, running_pose, &joint_weights, 1.0f), LocalPoseError(result, idle_pose, &joint_weights, 0.0f));
+			printf("Blend tree mask: %d of %d joints below mixamorig:Spine\n", num_masked, bind_pose.joint_count());
+			passed = ReportCheck("Blend tree mask layer matches its joints", found && num_masked > 0 && num_masked < bind_pose.joint_count() && evaluated && error < 1e-5, error) && passed;
+
+			// masks shorter than the skeleton are padded with zero weights, an empty mask keeps the whole base
+			std::vector<float> short_weights(joint_weights.begin(), joint_weights.begin() + joint_weights.size() / 2);
+			gef::BlendTree short_tree;
+			const Int32 short_base_node = short_tree.AddClipNode(&idle);
+			const Int32 short_layer_node = short_tree.AddClipNode(&running);
+			short_tree.playback(short_base_node).anim_time = idle_time - idle.start_time();
+			short_tree.playback(short_layer_node).anim_time = running_time - running.start_time();
+			const Int32 short_mask_node = short_tree.AddMaskNode(short_base_node, short_layer_node, short_weights);
+			short_tree.AddMaskNode(short_mask_node, short_tree.AddClipNode(&running), std::vector<float>());
+
+			short_weights.resize(joint_weights.size(), 0.0f);
+			pool.Create(bind_pose, short_tree.GetPoolSizeNeeded());
+			const bool short_evaluated = short_tree.Evaluate(bind_pose, pool, result);
+			const double short_error = std::max(LocalPoseError(result, running_pose, &short_weights, 1.0f), LocalPoseError(result, idle_pose, &short_weights, 0.0f));
+			passed = ReportCheck("Blend tree short and empty masks padded with zeros", short_evaluated && short_error < 1e-5, short_error) && passed;
+		}
+
+		return passed;
+	}
+
+	// clips blended with SkeletonPose::Linear2PoseBlend, each input sampled through its binding into a pose copied from the bind pose every frame
+	static void ReferenceBlend(const gef::SkeletonPose& bind_pose, const gef::Animation* const* clips, gef::AnimBinding* bindings, const float* times, const float* weights, const Int32 num_clips, gef::SkeletonPose& result)
+	{
+		result.SetPoseFromAnim(*clips[0], bind_pose, times[0], bindings[0], false);
+		float total_weight = weights[0];
+		for (Int32 clip_num = 1; clip_num < num_clips; ++clip_num)
+		{
+			gef::SkeletonPose input = bind_pose;
+			input.SetPoseFromAnim(*clips[clip_num], bind_pose, times[clip_num], bindings[clip_num], false);
+			total_weight += weights[clip_num];
+			result.Linear2PoseBlend(result, input, weights[clip_num] / total_weight);
+		}
+	}
+
+	// a locomotion style tree: a four way blend of the clips at different times, an additive layer and an upper body mask,
+	// against the same four way blend done with SkeletonPose
+	static void BenchmarkBlendTree(const gef::Skeleton& skeleton, const gef::SkeletonPose& bind_pose, const gef::SkeletonPoseSoA& soa_bind_pose, const gef::Animation& running, const gef::Animation& idle)
+	{
+		const Int32 num_clips = 4;
+		const gef::Animation* const clips[num_clips] = { &running, &idle, &running, &idle };
+		const float weights[num_clips] = { 0.4f, 0.3f, 0.2f, 0.1f };
+		const float time_offsets[num_clips] = { 0.0f, 0.25f, 0.5f, 0.75f };
+
+		gef::BlendTree blend_tree;
+		const Int32 blend_node = blend_tree.AddBlendNode();
+		for (Int32 clip_num = 0; clip_num < num_clips; ++clip_num)
+		{
+			const Int32 clip_node = blend_tree.AddClipNode(clips[clip_num]);
+			blend_tree.playback(clip_node).anim_time = time_offsets[clip_num]*clips[clip_num]->duration();
+			blend_tree.AddBlendInput(blend_node, clip_node, weights[clip_num]);
+		}
+		blend_tree.set_root(blend_node);
+
+		gef::BlendTree layered_tree = blend_tree;
+		const Int32 additive_node = layered_tree.AddClipNode(&idle);
+		const Int32 reference_node = layered_tree.AddClipNode(&idle);
+		layered_tree.playback(reference_node).playback_speed = 0.0f;
+		const Int32 additive_layer = layered_tree.AddAdditiveNode(blend_node, additive_node, reference_node, 0.5f);
+		std::vector<float> joint_weights;
+		gef::BlendTree::CreateJointMask(skeleton, GEF_STRING_ID("mixamorig:Spine"), joint_weights);
+		const Int32 upper_body_node = layered_tree.AddClipNode(&running);
+		layered_tree.AddMaskNode(additive_layer, upper_body_node, joint_weights, 0.8f);
+
+		gef::PosePool pool;
+		pool.Create(soa_bind_pose, layered_tree.GetPoolSizeNeeded());
+		gef::SkeletonPoseSoA result = soa_bind_pose;
+		gef::SkeletonPose reference_result = bind_pose;
+		gef::AnimBinding reference_bindings[num_clips];
+
+		const Int32 num_frames = 200;
+		const float frame_time = 1.0f / 60.0f;
+		const Int32 num_runs = 5;
+		double reference_time, tree_time, layered_time;
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+			{
+				float times[num_clips];
+				for (Int32 clip_num = 0; clip_num < num_clips; ++clip_num)
+					times[clip_num] = fmodf(time_offsets[clip_num]*clips[clip_num]->duration() + frame_num*frame_time, clips[clip_num]->duration());
+				ReferenceBlend(bind_pose, clips, reference_bindings, times, weights, num_clips, reference_result);
+			}
+			DoNotOptimise(&reference_result.local_pose()[0]);
+		});
+		tree_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+			{
+				blend_tree.Update(frame_time);
+				blend_tree.Evaluate(soa_bind_pose, pool, result);
+			}
+			DoNotOptimise(&result.rotations()[0]);
+		});
+		layered_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 frame_num = 0; frame_num < num_frames; ++frame_num)
+			{
+				layered_tree.Update(frame_time);
+				layered_tree.Evaluate(soa_bind_pose, pool, result);
+			}
+			DoNotOptimise(&result.rotations()[0]);
+		});
+
+		printf("Blend tree: %d nodes, %d pool poses\n", layered_tree.node_count(), pool.pose_count());
+		ReportTime("Blend 4 clips SkeletonPose", num_frames, reference_time, "poses");
+		ReportTime("Blend 4 clips blend tree", num_frames, tree_time, "poses");
+		ReportSpeedUp("Blend 4 clips blend tree speed up", reference_time, tree_time);
+		ReportTime("Blend tree with additive and mask layers", num_frames, layered_time, "poses");
+	}
+
+	bool RunBlendTreeBenchmarks()
+	{
+		SceneFile character, running, idle;
+		if (!character.Read("Y_Bot.scn") || character.skeletons.empty() ||
+			!running.Read("running_InPlace.scn") || running.animations.empty() ||
+			!idle.Read("idle.scn") || idle.animations.empty())
+		{
+			printf("Blend tree: can't read Y_Bot or its clips from %s, skipped\n", GetMediaFilename("").c_str());
+			return true;
+		}
+
+		const gef::Skeleton& skeleton = *character.skeletons[0];
+		gef::SkeletonPose bind_pose;
+		bind_pose.CreateBindPose(&skeleton);
+		gef::SkeletonPoseSoA soa_bind_pose;
+		soa_bind_pose.Create(bind_pose);
+
+		const bool passed = CheckBlendTree(skeleton, soa_bind_pose, *running.animations[0], *idle.animations[0]);
+		BenchmarkBlendTree(skeleton, bind_pose, soa_bind_pose, *running.animations[0], *idle.animations[0]);
+		return passed;
+	}
+}
@@ -0,0 +1,132 @@
+#include "bench.h"
+#include <system/crc.h>
+#include <system/string_id.h>
+#include <vector>
+#include <random>
+#include <stdio.h>
+#include <string>
+#include <cctype>
+
+namespace gef_bench
+{
+	// the bit at a time CRC::Update that the tables replaced
+	namespace reference
+	{
+		static UInt32 GetCRC(const char* buffer, Int32 length, const bool to_upper)
+		{
+			UInt32 residual = 0xffffffff;
+			while (length--)
+			{
+				int byte = *buffer++;
+				if (to_upper)
+					byte = std::toupper(byte);
+				for (Int32 bit_num = 0; bit_num < 8; ++bit_num)
+				{
+					residual ^= byte & 1;
+					if (1 & residual)
+						residual = ((residual^0xdb710641) >> 1) | 0x80000000;
+					else
+						residual >>= 1;
+					byte >>= 1;
+				}
+			}
+			return ~residual;
+		}
+	}
+
+	static bool CheckCRC(std::mt19937& random)
+	{
+		Int32 num_failed = 0;
+
+		// printable names of every length up to a few slices, so every tail length is covered
+		std::uniform_int_distribution<Int32> character_range(' ', '~');
+		for (Int32 length = 0; length < 40; ++length)
+		{
+			std::string text;
+			for (Int32 character_num = 0; character_num < length; ++character_num)
+				text.push_back(static_cast<char>(character_range(random)));
+
+			num_failed += gef::CRC::GetCRC(text.c_str()) == reference::GetCRC(text.c_str(), length, false) ? 0 : 1;
+			num_failed += gef::CRC::GetICRC(text.c_str()) == reference::GetCRC(text.c_str(), length, true) ? 0 : 1;
+			num_failed += gef::CRC::GetCRC(text.c_str(), text.length()) == gef::CRC::GetCRC(text.c_str()) ? 0 : 1;
+			num_failed += gef::GetStringId(text) == reference::GetCRC(text.c_str(), length, true) ? 0 : 1;
+		}
+
+		// any byte values, checksummed in one go and in pieces
+		std::uniform_int_distribution<Int32> byte_range(1, 255);
+		std::vector<char> data(1000);
+		for (size_t byte_num = 0; byte_num < data.size(); ++byte_num)
+			data[byte_num] = static_cast<char>(byte_range(random));
+		const UInt32 expected = reference::GetCRC(&data[0], static_cast<Int32>(data.size()), false);
+		num_failed += gef::CRC::GetCRC(&data[0], data.size()) == expected ? 0 : 1;
+		num_failed += gef::CRC::GetCRC(&data[333], data.size() - 333, gef::CRC::GetCRC(&data[0], 333)) == expected ? 0 : 1;
+
+		// the standard CRC-32 check value
+		num_failed += gef::CRC::GetCRC("123456789") == 0xcbf43926 ? 0 : 1;
+
+		return ReportMismatches("CRC slicing-by-8 matches bit at a time", num_failed);
+	}
+
+	bool RunCRCBenchmarks()
+	{
+		std::mt19937 random(9753);
+		bool passed = CheckCRC(random);
+
+		const Int32 num_bytes = 1024*1024;
+		std::uniform_int_distribution<Int32> byte_range(0, 255);
+		std::vector<char> data(num_bytes);
+		for (Int32 byte_num = 0; byte_num < num_bytes; ++byte_num)
+			data[byte_num] = static_cast<char>(byte_range(random));
+
+		const Int32 num_runs = 10;
+		double reference_time, table_time;
+		UInt32 crc = 0;
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			crc = reference::GetCRC(&data[0], num_bytes, false);
+			DoNotOptimise(&crc);
+		});
+		table_time = TimeBestOf(num_runs, [&]()
+		{
+			crc = gef::CRC::GetCRC(&data[0], num_bytes);
+			DoNotOptimise(&crc);
+		});
+		ReportThroughput("CRC bit at a time", num_bytes, reference_time);
+		ReportThroughput("CRC slicing-by-8", num_bytes, table_time);
+		ReportSpeedUp("CRC slicing-by-8 speed up", reference_time, table_time);
+
+		// joint and animation names are short, so the tail loop matters as much as the slices
+		const Int32 num_names = 10000;
+		std::vector<std::string> names(num_names);
+		std::uniform_int_distribution<Int32> length_range(4, 32);
+		std::uniform_int_distribution<Int32> character_range('a', 'z');
+		Int32 total_name_bytes = 0;
+		for (Int32 name_num = 0; name_num < num_names; ++name_num)
+		{
+			const Int32 length = length_range(random);
+			for (Int32 character_num = 0; character_num < length; ++character_num)
+				names[name_num].push_back(static_cast<char>(character_range(random)));
+			total_name_bytes += length;
+		}
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 name_num = 0; name_num < num_names; ++name_num)
+				crc += reference::GetCRC(names[name_num].c_str(), static_cast<Int32>(names[name_num].length()), true);
+			DoNotOptimise(&crc);
+		});
+		table_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 name_num = 0; name_num < num_names; ++name_num)
+				crc += gef::GetStringId(names[name_num]);
+			DoNotOptimise(&crc);
+		});
+		ReportTime("GetStringId bit at a time", num_names, reference_time, "names");
+		ReportTime("GetStringId slicing-by-8", num_names, table_time, "names");
+		ReportThroughput("GetStringId slicing-by-8", total_name_bytes, table_time);
+		ReportSpeedUp("GetStringId speed up", reference_time, table_time);
+
+		return passed;
+	}
+}
@@ -0,0 +1,214 @@
+#include "bench.h"
+#include <maths/frustum.h>
+#include <maths/plane.h>
+#include <maths/matrix44.h>
+#include <maths/vector4.h>
+#include <maths/aabb.h>
+#include <maths/sphere.h>
+#include <system/job_system.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <stdio.h>
+#include <math.h>
+
+namespace gef_bench
+{
+	// one object at a time against the frustum planes, with the same order of operations as the batch kernels
+	namespace reference
+	{
+		static bool SphereVisible(const gef::Frustum& frustum, const float x, const float y, const float z, const float radius)
+		{
+			for (Int32 plane_num = 0; plane_num < gef::NUM_FRUSTUM_PLANES; ++plane_num)
+			{
+				const gef::Plane& plane = frustum.plane(static_cast<gef::FrustumPlane>(plane_num));
+				if (plane.DistanceFromPoint(gef::Vector4(x, y, z)) + radius < 0.0f)
+					return false;
+			}
+			return true;
+		}
+
+		static bool AabbVisible(const gef::Frustum& frustum, const float x, const float y, const float z, const float extent_x, const float extent_y, const float extent_z)
+		{
+			for (Int32 plane_num = 0; plane_num < gef::NUM_FRUSTUM_PLANES; ++plane_num)
+			{
+				const gef::Plane& plane = frustum.plane(static_cast<gef::FrustumPlane>(plane_num));
+				const float reach = extent_x*fabsf(plane.a()) + extent_y*fabsf(plane.b()) + extent_z*fabsf(plane.c());
+				if (plane.DistanceFromPoint(gef::Vector4(x, y, z)) + reach < 0.0f)
+					return false;
+			}
+			return true;
+		}
+	}
+
+	static bool IsVisible(const std::vector<UInt32>& visibility, const Int32 object_num)
+	{
+		return (visibility[object_num / 32] & (1u << (object_num % 32))) != 0;
+	}
+
+	// counts objects whose visibility bit differs from the reference, and any bits set past the last object
+	template<typename Visible>
+	static Int32 CountMismatches(const std::vector<UInt32>& visibility, const Int32 num_objects, Visible visible)
+	{
+		Int32 num_mismatches = 0;
+		for (Int32 object_num = 0; object_num < num_objects; ++object_num)
+			num_mismatches += IsVisible(visibility, object_num) == visible(object_num) ? 0 : 1;
+		if (num_objects % 32)
+			num_mismatches += (visibility[num_objects / 32] >> (num_objects % 32)) ? 1 : 0;
+		return num_mismatches;
+	}
+
+	static Int32 CountVisible(const std::vector<UInt32>& visibility, const Int32 num_objects)
+	{
+		Int32 num_visible = 0;
+		for (Int32 object_num = 0; object_num < num_objects; ++object_num)
+			num_visible += IsVisible(visibility, object_num) ? 1 : 0;
+		return num_visible;
+	}
+
+	bool RunFrustumBenchmarks()
+	{
+		const Int32 num_objects = 100000;
+		std::mt19937 random(2468);
+		std::uniform_real_distribution<float> range(-500.0f, 500.0f);
+		std::uniform_real_distribution<float> size_range(0.5f, 20.0f);
+
+		// objects are scattered all around the camera, so only some of them are in view
+		std::vector<float> x(num_objects), y(num_objects), z(num_objects), radii(num_objects);
+		std::vector<float> extent_x(num_objects), extent_y(num_objects), extent_z(num_objects);
+		for (Int32 object_num = 0; object_num < num_objects; ++object_num)
+		{
+			x[object_num] = range(random);
+			y[object_num] = range(random)*0.1f;
+			z[object_num] = range(random);
+			extent_x[object_num] = size_range(random);
+			extent_y[object_num] = size_range(random);
+			extent_z[object_num] = size_range(random);
+			radii[object_num] = sqrtf(extent_x[object_num]*extent_x[object_num] + extent_y[object_num]*extent_y[object_num] + extent_z[object_num]*extent_z[object_num]);
+		}
+
+		gef::Matrix44 view, projection;
+		view.LookAt(gef::Vector4(0.0f, 10.0f, 0.0f), gef::Vector4(100.0f, 0.0f, 100.0f), gef::Vector4(0.0f, 1.0f, 0.0f));
+		projection.PerspectiveFovD3D(1.0f, 16.0f / 9.0f, 1.0f, 400.0f);
+		gef::Frustum frustum;
+		frustum.ExtractPlanesD3D(view*projection, true);
+
+		gef::SphereBoundsSoA spheres;
+		spheres.centre_x = &x[0];
+		spheres.centre_y = &y[0];
+		spheres.centre_z = &z[0];
+		spheres.radii = &radii[0];
+
+		gef::AabbBoundsSoA boxes;
+		boxes.centre_x = &x[0];
+		boxes.centre_y = &y[0];
+		boxes.centre_z = &z[0];
+		boxes.extent_x = &extent_x[0];
+		boxes.extent_y = &extent_y[0];
+		boxes.extent_z = &extent_z[0];
+
+		gef::JobSystem job_system;
+		std::vector<UInt32> visibility(gef::VisibilityMaskSize(num_objects));
+		std::vector<UInt8> reference_visibility(num_objects);
+
+		bool passed = true;
+
+		// odd sizes check the partial last block and word
+		const Int32 sizes[] = { 1, 3, 33, 1000, num_objects - 5 };
+		Int32 num_failed = 0;
+		for (Int32 size_num = 0; size_num < static_cast<Int32>(sizeof(sizes) / sizeof(sizes[0])); ++size_num)
+		{
+			const Int32 size = sizes[size_num];
+			const auto sphere_visible = [&](const Int32 i) { return reference::SphereVisible(frustum, x[i], y[i], z[i], radii[i]); };
+			const auto aabb_visible = [&](const Int32 i) { return reference::AabbVisible(frustum, x[i], y[i], z[i], extent_x[i], extent_y[i], extent_z[i]); };
+
+			std::fill(visibility.begin(), visibility.end(), 0xffffffff);
+			frustum.CullSpheres(spheres, size, &visibility[0]);
+			num_failed += CountMismatches(visibility, size, sphere_visible);
+			std::fill(visibility.begin(), visibility.end(), 0xffffffff);
+			frustum.CullSpheres(spheres, size, &visibility[0], job_system);
+			num_failed += CountMismatches(visibility, size, sphere_visible);
+
+			std::fill(visibility.begin(), visibility.end(), 0xffffffff);
+			frustum.CullAabbs(boxes, size, &visibility[0]);
+			num_failed += CountMismatches(visibility, size, aabb_visible);
+			std::fill(visibility.begin(), visibility.end(), 0xffffffff);
+			frustum.CullAabbs(boxes, size, &visibility[0], job_system);
+			num_failed += CountMismatches(visibility, size, aabb_visible);
+		}
+		passed = ReportMismatches("Frustum cull matches scalar planes", num_failed) && passed;
+
+		// a sphere right in front of the camera is visible and one behind it is not
+		const float inside[] = { 100.0f, 0.0f, 100.0f, 1.0f };
+		const float behind[] = { -100.0f, 0.0f, -100.0f, 1.0f };
+		gef::SphereBoundsSoA known;
+		known.centre_x = &inside[0];
+		known.centre_y = &inside[1];
+		known.centre_z = &inside[2];
+		known.radii = &inside[3];
+		UInt32 known_visibility = 0;
+		frustum.CullSpheres(known, 1, &known_visibility);
+		bool known_passed = known_visibility == 1;
+		known.centre_x = &behind[0];
+		known.centre_y = &behind[1];
+		known.centre_z = &behind[2];
+		known.radii = &behind[3];
+		frustum.CullSpheres(known, 1, &known_visibility);
+		known_passed = known_passed && known_visibility == 0;
+		passed = ReportCheck("Frustum cull in front and behind camera", known_passed, 0.0) && passed;
+
+		frustum.CullSpheres(spheres, num_objects, &visibility[0]);
+		printf("%d of %d objects visible\n", CountVisible(visibility, num_objects), num_objects);
+
+		const Int32 num_runs = 10;
+		double reference_time, batch_time, threaded_time;
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 object_num = 0; object_num < num_objects; ++object_num)
+				reference_visibility[object_num] = frustum.Intersects(gef::Sphere(gef::Vector4(x[object_num], y[object_num], z[object_num]), radii[object_num])) != gef::FI_OUT;
+			DoNotOptimise(&reference_visibility[0]);
+		});
+		batch_time = TimeBestOf(num_runs, [&]()
+		{
+			frustum.CullSpheres(spheres, num_objects, &visibility[0]);
+			DoNotOptimise(&visibility[0]);
+		});
+		threaded_time = TimeBestOf(num_runs, [&]()
+		{
+			frustum.CullSpheres(spheres, num_objects, &visibility[0], job_system);
+			DoNotOptimise(&visibility[0]);
+		});
+		ReportTime("Cull spheres Frustum::Intersects", num_objects, reference_time, "spheres");
+		ReportTime("Cull spheres batch", num_objects, batch_time, "spheres");
+		ReportTime("Cull spheres batch job system", num_objects, threaded_time, "spheres");
+		ReportSpeedUp("Cull spheres batch speed up", reference_time, batch_time);
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 object_num = 0; object_num < num_objects; ++object_num)
+			{
+				const gef::Vector4 centre(x[object_num], y[object_num], z[object_num]);
+				const gef::Vector4 extent(extent_x[object_num], extent_y[object_num], extent_z[object_num]);
+				reference_visibility[object_num] = frustum.Intersects(gef::Aabb(centre - extent, centre + extent)) != gef::FI_OUT;
+			}
+			DoNotOptimise(&reference_visibility[0]);
+		});
+		batch_time = TimeBestOf(num_runs, [&]()
+		{
+			frustum.CullAabbs(boxes, num_objects, &visibility[0]);
+			DoNotOptimise(&visibility[0]);
+		});
+		threaded_time = TimeBestOf(num_runs, [&]()
+		{
+			frustum.CullAabbs(boxes, num_objects, &visibility[0], job_system);
+			DoNotOptimise(&visibility[0]);
+		});
+		ReportTime("Cull boxes Frustum::Intersects", num_objects, reference_time, "boxes");
+		ReportTime("Cull boxes batch", num_objects, batch_time, "boxes");
+		ReportTime("Cull boxes batch job system", num_objects, threaded_time, "boxes");
+		ReportSpeedUp("Cull boxes batch speed up", reference_time, batch_time);
+
+		return passed;
+	}
+}
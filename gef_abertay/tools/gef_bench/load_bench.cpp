@@ -0,0 +1,231 @@
+#include "bench.h"
+#include "scene_file.h"
+#include <system/load_queue.h>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace gef_bench
+{
+	// the scenes a state transition might load together
+	static const char* kSceneFilenames[] = { "Y_Bot.scn", "Y_Bot_no_skinning.scn", "triceratop.scn", "idle.scn", "running_InPlace.scn" };
+	static const Int32 kNumSceneFilenames = sizeof(kSceneFilenames) / sizeof(kSceneFilenames[0]);
+
+	// the main thread's work between loads, e.g. updating and drawing a loading screen
+	static const double kFrameSeconds = 0.002;
+
+	struct SceneLoad
+	{
+		SceneLoad() :
+			filename(NULL),
+			upload(NULL),
+			status(gef::LoadQueue::kQueued),
+			read_called(false),
+			finished(false)
+		{
+		}
+
+		const char* filename;
+		SceneFile scene;
+		std::vector<char>* upload;
+		gef::LoadQueue::Status status;
+		bool read_called;
+		bool finished;
+	};
+
+	// copies every vertex and index, as creating the vertex and index buffers on the main thread would
+	static void UploadMeshes(const SceneFile& scene, std::vector<char>& upload)
+	{
+		size_t upload_size = 0;
+		for (std::list<gef::MeshData>::const_iterator mesh = scene.meshes.begin(); mesh != scene.meshes.end(); ++mesh)
+		{
+			const size_t vertex_bytes = mesh->vertex_data.num_vertices*mesh->vertex_data.vertex_byte_size;
+			upload.resize(upload_size + vertex_bytes);
+			memcpy(&upload[upload_size], mesh->vertex_data.vertices, vertex_bytes);
+			upload_size += vertex_bytes;
+
+			for (size_t primitive_num = 0; primitive_num < mesh->primitives.size(); ++primitive_num)
+			{
+				const gef::PrimitiveData& primitive = *mesh->primitives[primitive_num];
+				const size_t index_bytes = primitive.num_indices*primitive.index_byte_size;
+				upload.resize(upload_size + index_bytes);
+				memcpy(&upload[upload_size], primitive.indices, index_bytes);
+				upload_size += index_bytes;
+			}
+		}
+	}
+
+	static bool ReadSceneLoad(gef::LoadQueue& queue, const Int32 request, void* data)
+	{
+		SceneLoad* load = static_cast<SceneLoad*>(data);
+		load->read_called = true;
+		return load->scene.Read(load->filename);
+	}
+
+	static void FinishSceneLoad(const Int32 request, const gef::LoadQueue::Status status, void* data)
+	{
+		SceneLoad* load = static_cast<SceneLoad*>(data);
+		if (status == gef::LoadQueue::kRead)
+			UploadMeshes(load->scene, *load->upload);
+		load->status = status;
+		load->finished = true;
+	}
+
+	// waits on the loading thread until the load is cancelled, to cancel a load part way through reading it
+	static bool ReadUntilCancelled(gef::LoadQueue& queue, const Int32 request, void* data)
+	{
+		std::atomic<bool>* reading = static_cast<std::atomic<bool>*>(data);
+		*reading = true;
+
+		Timer timer;
+		while (!queue.IsCancelled(request) && timer.ElapsedSeconds() < 1.0)
+		{
+		}
+		return true;
+	}
+
+	static gef::LoadQueue::Status g_cancelled_read_status = gef::LoadQueue::kQueued;
+
+	static void FinishCancelledRead(const Int32 request, const gef::LoadQueue::Status status, void* data)
+	{
+		g_cancelled_read_status = status;
+	}
+
+	static Int32 CountMismatches(const SceneFile& scene, const SceneFile& expected)
+	{
+		Int32 num_mismatches = 0;
+		num_mismatches += scene.meshes.size() == expected.meshes.size() ? 0 : 1;
+		num_mismatches += scene.skeletons.size() == expected.skeletons.size() ? 0 : 1;
+		num_mismatches += scene.animations.size() == expected.animations.size() ? 0 : 1;
+		if (num_mismatches > 0)
+			return num_mismatches;
+
+		std::list<gef::MeshData>::const_iterator expected_mesh = expected.meshes.begin();
+		for (std::list<gef::MeshData>::const_iterator mesh = scene.meshes.begin(); mesh != scene.meshes.end(); ++mesh, ++expected_mesh)
+		{
+			const gef::VertexData& vertex_data = mesh->vertex_data;
+			const gef::VertexData& expected_vertex_data = expected_mesh->vertex_data;
+			num_mismatches += vertex_data.num_vertices == expected_vertex_data.num_vertices && vertex_data.vertex_byte_size == expected_vertex_data.vertex_byte_size
+				&& memcmp(vertex_data.vertices, expected_vertex_data.vertices, vertex_data.num_vertices*vertex_data.vertex_byte_size) == 0 ? 0 : 1;
+		}
+
+		return num_mismatches;
+	}
+
+	static void WaitForFrame(const double frame_seconds)
+	{
+		Timer timer;
+		while (timer.ElapsedSeconds() < frame_seconds)
+		{
+		}
+	}
+
+	bool RunLoadBenchmarks()
+	{
+		std::vector<const char*> filenames;
+		for (Int32 filename_num = 0; filename_num < kNumSceneFilenames; ++filename_num)
+		{
+			SceneFile scene;
+			if (scene.Read(kSceneFilenames[filename_num]))
+				filenames.push_back(kSceneFilenames[filename_num]);
+		}
+
+		if (filenames.empty())
+		{
+			printf("Load: can't read the scenes in %s, skipped\n", GetMediaFilename("").c_str());
+			return true;
+		}
+
+		const Int32 num_scenes = (Int32)filenames.size();
+		std::vector<std::vector<char> > uploads(num_scenes);
+
+		// loading every scene on the main thread stalls it for the whole load
+		std::vector<SceneFile*> sync_scenes;
+		Timer sync_timer;
+		for (Int32 scene_num = 0; scene_num < num_scenes; ++scene_num)
+		{
+			sync_scenes.push_back(new SceneFile());
+			sync_scenes.back()->Read(filenames[scene_num]);
+			UploadMeshes(*sync_scenes.back(), uploads[scene_num]);
+		}
+		const double sync_stall = sync_timer.ElapsedSeconds();
+
+		// the loads are read on the loading thread while the main thread carries on with its frames,
+		// finishing one load per frame so the uploads are spread out too
+		std::vector<SceneLoad> loads(num_scenes + 1);
+		gef::LoadQueue queue;
+		Timer async_timer;
+		for (Int32 load_num = 0; load_num < num_scenes + 1; ++load_num)
+		{
+			// the last load is cancelled before it is read
+			SceneLoad& load = loads[load_num];
+			load.filename = load_num < num_scenes ? filenames[load_num] : filenames[0];
+			load.upload = &uploads[load_num < num_scenes ? load_num : 0];
+			const Int32 request = queue.Add(ReadSceneLoad, FinishSceneLoad, &load);
+			if (load_num == num_scenes)
+				queue.Cancel(request);
+		}
+
+		double async_stall = 0.0;
+		float last_progress = 0.0f;
+		bool progress_in_order = true;
+		Int32 num_frames = 0;
+		while (queue.pending_count() > 0)
+		{
+			Timer update_timer;
+			queue.Update(1);
+			const double update_time = update_timer.ElapsedSeconds();
+			async_stall = update_time > async_stall ? update_time : async_stall;
+
+			const float progress = queue.GetProgress();
+			progress_in_order = progress_in_order && progress >= last_progress && progress <= 1.0f;
+			last_progress = progress;
+
+			WaitForFrame(kFrameSeconds);
+			++num_frames;
+		}
+		const double async_time = async_timer.ElapsedSeconds();
+
+		Int32 num_mismatches = 0;
+		for (Int32 scene_num = 0; scene_num < num_scenes; ++scene_num)
+		{
+			num_mismatches += loads[scene_num].finished && loads[scene_num].status == gef::LoadQueue::kRead ? 0 : 1;
+			num_mismatches += CountMismatches(loads[scene_num].scene, *sync_scenes[scene_num]);
+		}
+		bool passed = ReportMismatches("Load async scenes match sync", num_mismatches);
+
+		const SceneLoad& cancelled_load = loads[num_scenes];
+		passed = ReportCheck("Load cancelled before reading", cancelled_load.finished && !cancelled_load.read_called
+			&& cancelled_load.status == gef::LoadQueue::kCancelled, 0.0) && passed;
+
+		// cancelling a load part way through still finishes it as cancelled, however the read turned out
+		std::atomic<bool> reading(false);
+		const Int32 reading_request = queue.Add(ReadUntilCancelled, FinishCancelledRead, &reading);
+		while (!reading && queue.num_worker_threads() > 0)
+		{
+		}
+		queue.Cancel(reading_request);
+		queue.Flush();
+		passed = ReportCheck("Load cancelled while reading", g_cancelled_read_status == gef::LoadQueue::kCancelled && queue.pending_count() == 0, 0.0) && passed;
+
+		SceneLoad missing_load;
+		missing_load.filename = "gef_bench_missing.scn";
+		queue.Add(ReadSceneLoad, FinishSceneLoad, &missing_load);
+		queue.Flush();
+		passed = ReportCheck("Load missing file fails", missing_load.status == gef::LoadQueue::kFailed, 0.0) && passed;
+
+		passed = ReportCheck("Load progress in order", progress_in_order && last_progress == 1.0f, 1.0f - last_progress) && passed;
+
+		ReportTime("Load scenes sync main thread stall", num_scenes, sync_stall, "scenes");
+		ReportTime("Load scenes async longest update", 1, async_stall, "updates");
+		ReportSpeedUp("Load main thread stall reduction", sync_stall, async_stall);
+		ReportTime("Load scenes async until finished", num_frames, async_time, "frames");
+
+		for (size_t scene_num = 0; scene_num < sync_scenes.size(); ++scene_num)
+			delete sync_scenes[scene_num];
+
+		return passed;
+	}
+}
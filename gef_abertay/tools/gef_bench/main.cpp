@@ -0,0 +1,58 @@
+#include "bench.h"
+#include <cstdio>
+#include <cstring>
+
+// Micro benchmarks for the CPU side of gef.
+// Every benchmark checks its optimised code path against a reference implementation,
+// the exit code is non-zero if any of those checks fail.
+// Run with --json <filename> to also write the results out in a machine readable form.
+// The animation benchmarks read clips from gef's samples/media directory, --media <path> reads them from somewhere else.
+int main(int argc, char* argv[])
+{
+	const char* json_filename = NULL;
+	for (int arg_num = 1; arg_num < argc; ++arg_num)
+	{
+		if (strcmp(argv[arg_num], "--json") == 0 && arg_num + 1 < argc)
+		{
+			json_filename = argv[++arg_num];
+		}
+		else if (strcmp(argv[arg_num], "--media") == 0 && arg_num + 1 < argc)
+		{
+			gef_bench::SetMediaPath(argv[++arg_num]);
+		}
+		else
+		{
+			printf("usage: %s [--json <filename>] [--media <path>]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	bool passed = true;
+
+	passed = gef_bench::RunSpriteBatchBenchmarks() && passed;
+	passed = gef_bench::RunVector4Benchmarks() && passed;
+	passed = gef_bench::RunMatrix44Benchmarks() && passed;
+	passed = gef_bench::RunTransformBatchBenchmarks() && passed;
+	passed = gef_bench::RunFrustumBenchmarks() && passed;
+	passed = gef_bench::RunStringIdBenchmarks() && passed;
+	passed = gef_bench::RunCRCBenchmarks() && passed;
+	passed = gef_bench::RunQuaternionBenchmarks() && passed;
+	passed = gef_bench::RunTransformBenchmarks() && passed;
+	passed = gef_bench::RunAnimationBenchmarks() && passed;
+	passed = gef_bench::RunAnimationSystemBenchmarks() && passed;
+	passed = gef_bench::RunBlendTreeBenchmarks() && passed;
+	passed = gef_bench::RunSkinningBenchmarks() && passed;
+	passed = gef_bench::RunSceneBenchmarks() && passed;
+	passed = gef_bench::RunMeshBenchmarks() && passed;
+	passed = gef_bench::RunLoadBenchmarks() && passed;
+
+	printf("%s\n", passed ? "All checks passed" : "Some checks FAILED");
+
+	if (json_filename && !gef_bench::WriteJson(json_filename, passed))
+	{
+		printf("Failed to write %s\n", json_filename);
+		return 1;
+	}
+
+	return passed ? 0 : 1;
+}
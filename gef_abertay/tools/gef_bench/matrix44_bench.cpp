@@ -0,0 +1,364 @@
+#include "bench.h"
+#include <maths/matrix44.h>
+#include <maths/vector4.h>
+#include <maths/quaternion.h>
+#include <vector>
+#include <random>
+#include <math.h>
+#include <string.h>
+
+namespace gef_bench
+{
+	// scalar versions of the Matrix44 operations, as they were before they were vectorised
+	namespace reference
+	{
+		static gef::Matrix44 Multiply(const gef::Matrix44& a, const gef::Matrix44& b)
+		{
+			gef::Matrix44 result;
+			for (Int32 row = 0; row < 4; ++row)
+			{
+				for (Int32 column = 0; column < 4; ++column)
+					result.set_m(row, column, a.m(row, 0) * b.m(0, column) + a.m(row, 1) * b.m(1, column) + a.m(row, 2) * b.m(2, column) + a.m(row, 3) * b.m(3, column));
+			}
+			return result;
+		}
+
+		static gef::Matrix44 Transpose(const gef::Matrix44& matrix)
+		{
+			gef::Matrix44 result;
+			for (Int32 row = 0; row < 4; ++row)
+				result.SetRow(row, matrix.GetColumn(row));
+			return result;
+		}
+
+		static gef::Matrix44 AffineInverse(const gef::Matrix44& matrix)
+		{
+			gef::Matrix44 result = Transpose(matrix);
+			result.set_m(3, 0, 0.0f);
+			result.set_m(3, 1, 0.0f);
+			result.set_m(3, 2, 0.0f);
+			result.set_m(0, 3, 0.0f);
+			result.set_m(1, 3, 0.0f);
+			result.set_m(2, 3, 0.0f);
+
+			const gef::Vector4 position(-matrix.m(3, 0), -matrix.m(3, 1), -matrix.m(3, 2));
+			for (Int32 column = 0; column < 3; ++column)
+				result.set_m(3, column, position.x()*result.m(0, column) + position.y()*result.m(1, column) + position.z()*result.m(2, column) + result.m(3, column));
+
+			return result;
+		}
+
+		static gef::Matrix44 LookAt(const gef::Vector4& eye, const gef::Vector4& lookat, const gef::Vector4& up)
+		{
+			gef::Matrix44 result;
+			result.SetIdentity();
+
+			gef::Vector4 forward = eye - lookat;
+			forward.Normalise();
+			gef::Vector4 side = up.CrossProduct(forward);
+			side.Normalise();
+			gef::Vector4 calculated_up = forward.CrossProduct(side);
+
+			for (Int32 row = 0; row < 3; ++row)
+			{
+				result.set_m(row, 0, side[row]);
+				result.set_m(row, 1, calculated_up[row]);
+				result.set_m(row, 2, forward[row]);
+			}
+			result.set_m(3, 0, -side.DotProduct(eye));
+			result.set_m(3, 1, -calculated_up.DotProduct(eye));
+			result.set_m(3, 2, -forward.DotProduct(eye));
+			return result;
+		}
+
+		static gef::Matrix44 Inverse(const gef::Matrix44& matrix, float* determinant)
+		{
+			gef::Matrix44 result;
+			result.SetZero();
+
+			const float det = matrix.CalculateDeterminant();
+			if (det != 0.0f)
+			{
+				for (Int32 i = 0; i < 4; i++)
+				{
+					gef::Vector4 vec[3];
+					for (Int32 j = 0, a = 0; j < 4; j++)
+					{
+						if (j != i)
+							vec[a++] = matrix.GetRow(j);
+					}
+
+					const gef::Vector4 v = vec[0].CrossProduct3(vec[1], vec[2]);
+					const float temp = powf(-1.0f, (float)i) / det;
+					result.SetColumn(i, gef::Vector4(temp*v.x(), temp*v.y(), temp*v.z(), temp*v.w()));
+				}
+			}
+
+			*determinant = det;
+			return result;
+		}
+	}
+
+	static bool BitEqual(const gef::Matrix44& a, const gef::Matrix44& b)
+	{
+		for (Int32 row = 0; row < 4; ++row)
+		{
+			for (Int32 column = 0; column < 4; ++column)
+			{
+				const float value_a = a.m(row, column);
+				const float value_b = b.m(row, column);
+				if (memcmp(&value_a, &value_b, sizeof(float)) != 0)
+					return false;
+			}
+		}
+		return true;
+	}
+
+	// largest difference between two matrices, relative to the size of the reference element
+	static float RelativeError(const gef::Matrix44& matrix, const gef::Matrix44& reference_matrix)
+	{
+		float max_error = 0.0f;
+		for (Int32 row = 0; row < 4; ++row)
+		{
+			for (Int32 column = 0; column < 4; ++column)
+			{
+				const float reference_value = reference_matrix.m(row, column);
+				const float scale = fabsf(reference_value) > 1.0f ? fabsf(reference_value) : 1.0f;
+				const float error = fabsf(matrix.m(row, column) - reference_value) / scale;
+				if (error > max_error)
+					max_error = error;
+			}
+		}
+		return max_error;
+	}
+
+	static float MaxElement(const gef::Matrix44& matrix)
+	{
+		float max_element = 0.0f;
+		for (Int32 row = 0; row < 4; ++row)
+		{
+			for (Int32 column = 0; column < 4; ++column)
+			{
+				if (fabsf(matrix.m(row, column)) > max_element)
+					max_element = fabsf(matrix.m(row, column));
+			}
+		}
+		return max_element;
+	}
+
+	static gef::Matrix44 RandomTransform(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> angle_range(-3.14159f, 3.14159f);
+		std::uniform_real_distribution<float> scale_range(0.25f, 4.0f);
+		std::uniform_real_distribution<float> position_range(-100.0f, 100.0f);
+
+		gef::Matrix44 rotation_x, rotation_y, rotation_z, scale;
+		rotation_x.RotationX(angle_range(random));
+		rotation_y.RotationY(angle_range(random));
+		rotation_z.RotationZ(angle_range(random));
+		scale.Scale(gef::Vector4(scale_range(random), scale_range(random), scale_range(random)));
+
+		gef::Matrix44 transform = reference::Multiply(reference::Multiply(reference::Multiply(scale, rotation_x), rotation_y), rotation_z);
+		transform.SetTranslation(gef::Vector4(position_range(random), position_range(random), position_range(random)));
+		return transform;
+	}
+
+	static gef::Matrix44 RandomMatrix(std::mt19937& random)
+	{
+		std::uniform_real_distribution<float> range(-10.0f, 10.0f);
+
+		gef::Matrix44 matrix;
+		for (Int32 row = 0; row < 4; ++row)
+			for (Int32 column = 0; column < 4; ++column)
+				matrix.set_m(row, column, range(random));
+		return matrix;
+	}
+
+	static bool CheckMatrix44Operations(const std::vector<gef::Matrix44>& a, const std::vector<gef::Matrix44>& b, const std::vector<gef::Matrix44>& transforms,
+		const std::vector<gef::Vector4>& eyes, const std::vector<gef::Vector4>& targets)
+	{
+		bool passed = true;
+		const Int32 num_matrices = static_cast<Int32>(a.size());
+		const gef::Vector4 up(0.0f, 1.0f, 0.0f);
+
+		Int32 num_failed = 0;
+		for (Int32 i = 0; i < num_matrices; ++i)
+			num_failed += BitEqual(a[i] * b[i], reference::Multiply(a[i], b[i])) ? 0 : 1;
+		passed = ReportMismatches("Matrix44 multiply matches scalar version", num_failed) && passed;
+
+		num_failed = 0;
+		for (Int32 i = 0; i < num_matrices; ++i)
+		{
+			gef::Matrix44 transposed;
+			transposed.Transpose(a[i]);
+			num_failed += BitEqual(transposed, reference::Transpose(a[i])) ? 0 : 1;
+		}
+		passed = ReportMismatches("Matrix44 Transpose matches scalar version", num_failed) && passed;
+
+		num_failed = 0;
+		for (Int32 i = 0; i < num_matrices; ++i)
+		{
+			gef::Matrix44 inverse;
+			inverse.AffineInverse(transforms[i]);
+			num_failed += BitEqual(inverse, reference::AffineInverse(transforms[i])) ? 0 : 1;
+		}
+		passed = ReportMismatches("Matrix44 AffineInverse matches scalar version", num_failed) && passed;
+
+		num_failed = 0;
+		for (Int32 i = 0; i < num_matrices; ++i)
+		{
+			gef::Matrix44 view;
+			view.LookAt(eyes[i], targets[i], up);
+			num_failed += BitEqual(view, reference::LookAt(eyes[i], targets[i], up)) ? 0 : 1;
+		}
+		passed = ReportMismatches("Matrix44 LookAt matches scalar version", num_failed) && passed;
+
+		// the block wise inverse rounds differently to the cofactor version, so compare against it and the identity
+		// with tolerances scaled by the condition of the matrix
+		float max_error = 0.0f, max_identity_error = 0.0f;
+		gef::Matrix44 identity;
+		identity.SetIdentity();
+		for (Int32 i = 0; i < num_matrices; ++i)
+		{
+			const gef::Matrix44& matrix = (i & 1) ? a[i] : transforms[i];
+
+			float determinant, reference_determinant;
+			gef::Matrix44 inverse;
+			inverse.Inverse(matrix, &determinant);
+			const gef::Matrix44 reference_inverse = reference::Inverse(matrix, &reference_determinant);
+
+			const float max_element = MaxElement(matrix);
+			const float condition = max_element * MaxElement(reference_inverse) * 4.0f;
+			float error = RelativeError(inverse, reference_inverse) / condition;
+			const float determinant_scale = max_element > 1.0f ? max_element*max_element*max_element*max_element : 1.0f;
+			const float determinant_error = fabsf(determinant - reference_determinant) / determinant_scale;
+			if (determinant_error > error)
+				error = determinant_error;
+			if (error > max_error)
+				max_error = error;
+
+			const float identity_error = RelativeError(reference::Multiply(matrix, inverse), identity) / condition;
+			if (identity_error > max_identity_error)
+				max_identity_error = identity_error;
+		}
+		passed = ReportCheck("Matrix44 Inverse matches scalar version", max_error < 1e-5f, max_error) && passed;
+		passed = ReportCheck("Matrix44 Inverse times matrix is identity", max_identity_error < 1e-5f, max_identity_error) && passed;
+
+		// a singular matrix leaves the result untouched and reports a zero determinant
+		gef::Matrix44 singular = a[0];
+		singular.SetRow(3, singular.GetRow(2));
+		gef::Matrix44 unchanged = b[0];
+		float singular_determinant = 1.0f;
+		unchanged.Inverse(singular, &singular_determinant);
+		passed = ReportCheck("Matrix44 Inverse of singular matrix", BitEqual(unchanged, b[0]) && singular_determinant == 0.0f, singular_determinant) && passed;
+
+		return passed;
+	}
+
+	bool RunMatrix44Benchmarks()
+	{
+		const Int32 num_matrices = 100000;
+		std::mt19937 random(5678);
+		std::uniform_real_distribution<float> position_range(-100.0f, 100.0f);
+
+		std::vector<gef::Matrix44> a(num_matrices), b(num_matrices), transforms(num_matrices), results(num_matrices);
+		std::vector<gef::Vector4> eyes(num_matrices), targets(num_matrices);
+		for (Int32 i = 0; i < num_matrices; ++i)
+		{
+			a[i] = RandomMatrix(random);
+			b[i] = RandomMatrix(random);
+			transforms[i] = RandomTransform(random);
+			eyes[i] = gef::Vector4(position_range(random), position_range(random), position_range(random));
+			targets[i] = gef::Vector4(position_range(random), position_range(random), position_range(random));
+		}
+
+		bool passed = CheckMatrix44Operations(a, b, transforms, eyes, targets);
+
+		const Int32 num_runs = 10;
+		double reference_time, simd_time;
+		float determinant;
+		const gef::Vector4 up(0.0f, 1.0f, 0.0f);
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_matrices; ++i)
+				results[i] = reference::Multiply(a[i], b[i]);
+			DoNotOptimise(&results[0]);
+		});
+		simd_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_matrices; ++i)
+				results[i] = a[i] * b[i];
+			DoNotOptimise(&results[0]);
+		});
+		ReportTime("Matrix44 multiply scalar", num_matrices, reference_time, "matrices");
+		ReportTime("Matrix44 multiply", num_matrices, simd_time, "matrices");
+		ReportSpeedUp("Matrix44 multiply speed up", reference_time, simd_time);
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_matrices; ++i)
+				results[i] = reference::Transpose(a[i]);
+			DoNotOptimise(&results[0]);
+		});
+		simd_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_matrices; ++i)
+				results[i].Transpose(a[i]);
+			DoNotOptimise(&results[0]);
+		});
+		ReportTime("Matrix44 Transpose scalar", num_matrices, reference_time, "matrices");
+		ReportTime("Matrix44 Transpose", num_matrices, simd_time, "matrices");
+		ReportSpeedUp("Matrix44 Transpose speed up", reference_time, simd_time);
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_matrices; ++i)
+				results[i] = reference::Inverse(a[i], &determinant);
+			DoNotOptimise(&results[0]);
+		});
+		simd_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_matrices; ++i)
+				results[i].Inverse(a[i], &determinant);
+			DoNotOptimise(&results[0]);
+		});
+		ReportTime("Matrix44 Inverse scalar", num_matrices, reference_time, "matrices");
+		ReportTime("Matrix44 Inverse", num_matrices, simd_time, "matrices");
+		ReportSpeedUp("Matrix44 Inverse speed up", reference_time, simd_time);
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_matrices; ++i)
+				results[i] = reference::AffineInverse(transforms[i]);
+			DoNotOptimise(&results[0]);
+		});
+		simd_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_matrices; ++i)
+				results[i].AffineInverse(transforms[i]);
+			DoNotOptimise(&results[0]);
+		});
+		ReportTime("Matrix44 AffineInverse scalar", num_matrices, reference_time, "matrices");
+		ReportTime("Matrix44 AffineInverse", num_matrices, simd_time, "matrices");
+		ReportSpeedUp("Matrix44 AffineInverse speed up", reference_time, simd_time);
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_matrices; ++i)
+				results[i] = reference::LookAt(eyes[i], targets[i], up);
+			DoNotOptimise(&results[0]);
+		});
+		simd_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_matrices; ++i)
+				results[i].LookAt(eyes[i], targets[i], up);
+			DoNotOptimise(&results[0]);
+		});
+		ReportTime("Matrix44 LookAt scalar", num_matrices, reference_time, "matrices");
+		ReportTime("Matrix44 LookAt", num_matrices, simd_time, "matrices");
+		ReportSpeedUp("Matrix44 LookAt speed up", reference_time, simd_time);
+
+		return passed;
+	}
+}
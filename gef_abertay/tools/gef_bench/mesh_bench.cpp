@@ -0,0 +1,291 @@
+#include "bench.h"
+#include "scene_file.h"
+#include <graphics/mesh_optimiser.h>
+#include <graphics/mesh_data.h>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace gef_bench
+{
+	static const char* kMeshSceneFilenames[] = { "Y_Bot.scn", "Y_Bot_no_skinning.scn", "triceratop.scn" };
+	static const Int32 kNumMeshSceneFilenames = sizeof(kMeshSceneFilenames) / sizeof(kMeshSceneFilenames[0]);
+
+	static void CopyMesh(const gef::MeshData& mesh, gef::MeshData& copy)
+	{
+		const gef::VertexData& vertex_data = mesh.vertex_data;
+		const size_t vertex_bytes = (size_t)vertex_data.num_vertices*vertex_data.vertex_byte_size;
+		copy.vertex_data.vertices = malloc(vertex_bytes);
+		memcpy(copy.vertex_data.vertices, vertex_data.vertices, vertex_bytes);
+		copy.vertex_data.num_vertices = vertex_data.num_vertices;
+		copy.vertex_data.vertex_byte_size = vertex_data.vertex_byte_size;
+		copy.name_id = mesh.name_id;
+
+		for (size_t primitive_num = 0; primitive_num < mesh.primitives.size(); ++primitive_num)
+		{
+			const gef::PrimitiveData& primitive = *mesh.primitives[primitive_num];
+			gef::PrimitiveData* primitive_copy = new gef::PrimitiveData();
+			const size_t index_bytes = (size_t)primitive.num_indices*primitive.index_byte_size;
+			primitive_copy->indices = malloc(index_bytes);
+			memcpy(primitive_copy->indices, primitive.indices, index_bytes);
+			primitive_copy->num_indices = primitive.num_indices;
+			primitive_copy->index_byte_size = primitive.index_byte_size;
+			primitive_copy->material_name_id = primitive.material_name_id;
+			primitive_copy->type = primitive.type;
+			copy.primitives.push_back(primitive_copy);
+		}
+	}
+
+	static UInt32 GetIndex(const gef::PrimitiveData& primitive, const Int32 index)
+	{
+		return primitive.index_byte_size == 2 ? static_cast<const UInt16*>(primitive.indices)[index] : static_cast<const UInt32*>(primitive.indices)[index];
+	}
+
+	// every triangle of a primitive as the bytes of its vertices, starting from the lowest vertex so
+	// the winding is kept, sorted so meshes drawing the same triangles in any order compare equal
+	static std::vector<std::string> GetTriangles(const gef::MeshData& mesh, const gef::PrimitiveData& primitive)
+	{
+		const Int32 vertex_byte_size = mesh.vertex_data.vertex_byte_size;
+		const char* vertices = static_cast<const char*>(mesh.vertex_data.vertices);
+		std::vector<std::string> triangles(primitive.num_indices / 3);
+		for (size_t triangle_num = 0; triangle_num < triangles.size(); ++triangle_num)
+		{
+			std::string corners[3];
+			for (Int32 corner = 0; corner < 3; ++corner)
+				corners[corner].assign(vertices + GetIndex(primitive, (Int32)triangle_num*3 + corner)*vertex_byte_size, vertex_byte_size);
+
+			const Int32 first = corners[1] < corners[0] ? (corners[2] < corners[1] ? 2 : 1) : (corners[2] < corners[0] ? 2 : 0);
+			triangles[triangle_num] = corners[first] + corners[(first + 1) % 3] + corners[(first + 2) % 3];
+		}
+		std::sort(triangles.begin(), triangles.end());
+		return triangles;
+	}
+
+	static Int32 CountMismatches(const gef::MeshData& mesh, const gef::MeshData& expected)
+	{
+		if (mesh.primitives.size() != expected.primitives.size())
+			return 1;
+
+		Int32 num_mismatches = 0;
+		for (size_t primitive_num = 0; primitive_num < mesh.primitives.size(); ++primitive_num)
+		{
+			const gef::PrimitiveData& primitive = *mesh.primitives[primitive_num];
+			const gef::PrimitiveData& expected_primitive = *expected.primitives[primitive_num];
+			num_mismatches += primitive.num_indices == expected_primitive.num_indices
+				&& GetTriangles(mesh, primitive) == GetTriangles(expected, expected_primitive) ? 0 : 1;
+
+			// the indices only need 16 bits if there are few enough vertices
+			num_mismatches += primitive.index_byte_size == (mesh.vertex_data.num_vertices <= 65536 ? 2 : 4) ? 0 : 1;
+		}
+		return num_mismatches;
+	}
+
+	// shuffles the triangles of each primitive, as an exporter that doesn't care about draw order might write them
+	static void ShuffleTriangles(gef::MeshData& mesh)
+	{
+		UInt32 seed = 12345;
+		for (size_t primitive_num = 0; primitive_num < mesh.primitives.size(); ++primitive_num)
+		{
+			gef::PrimitiveData& primitive = *mesh.primitives[primitive_num];
+			const Int32 index_byte_size = primitive.index_byte_size;
+			char* indices = static_cast<char*>(primitive.indices);
+			char triangle[12];
+			for (Int32 triangle_num = primitive.num_indices / 3 - 1; triangle_num > 0; --triangle_num)
+			{
+				seed = seed*1664525 + 1013904223;
+				const Int32 other_num = (Int32)((seed >> 8) % (UInt32)(triangle_num + 1));
+				memcpy(triangle, indices + triangle_num*3*index_byte_size, 3*index_byte_size);
+				memcpy(indices + triangle_num*3*index_byte_size, indices + other_num*3*index_byte_size, 3*index_byte_size);
+				memcpy(indices + other_num*3*index_byte_size, triangle, 3*index_byte_size);
+			}
+		}
+	}
+
+	struct MeshTotals
+	{
+		MeshTotals() :
+			num_triangles(0),
+			acmr_before(0.0),
+			acmr_after(0.0),
+			bytes_before(0),
+			bytes_after(0)
+		{
+		}
+
+		void Add(const gef::MeshData& mesh, const gef::MeshOptimiserStats& stats)
+		{
+			Int32 mesh_triangles = 0;
+			for (size_t primitive_num = 0; primitive_num < mesh.primitives.size(); ++primitive_num)
+				mesh_triangles += mesh.primitives[primitive_num]->num_indices / 3;
+
+			num_triangles += mesh_triangles;
+			acmr_before += stats.acmr_before*mesh_triangles;
+			acmr_after += stats.acmr_after*mesh_triangles;
+			bytes_before += stats.bytes_before;
+			bytes_after += stats.bytes_after;
+		}
+
+		Int32 num_triangles;
+		double acmr_before;	// weighted by triangles
+		double acmr_after;
+		size_t bytes_before;
+		size_t bytes_after;
+	};
+
+	static void ReportACMR(const char* name, const MeshTotals& totals)
+	{
+		printf("%-48s %6.3f -> %6.3f  %6.2fx fewer vertices transformed\n", name, totals.acmr_before / totals.num_triangles,
+			totals.acmr_after / totals.num_triangles, totals.acmr_after > 0.0 ? totals.acmr_before / totals.acmr_after : 0.0);
+	}
+
+	// the bytes of vertices read from memory for every byte in the vertex buffer, 1 when each vertex is read once.
+	// Vertices that miss the post-transform cache are read through a FIFO cache of 64 lines of 64 bytes
+	static double CalculateOverfetch(const gef::MeshData& mesh)
+	{
+		const Int32 kLineSize = 64, kNumLines = 64;
+		const gef::VertexData& vertex_data = mesh.vertex_data;
+		const size_t vertex_bytes = (size_t)vertex_data.num_vertices*vertex_data.vertex_byte_size;
+		if (vertex_bytes == 0)
+			return 0.0;
+
+		std::vector<UInt32> vertex_times(vertex_data.num_vertices, 0), line_times(vertex_bytes / kLineSize + 2, 0);
+		UInt32 vertex_time = gef::kMeshOptimiserCacheSize + 1, line_time = kNumLines + 1;
+		size_t lines_read = 0;
+		for (size_t primitive_num = 0; primitive_num < mesh.primitives.size(); ++primitive_num)
+		{
+			const gef::PrimitiveData& primitive = *mesh.primitives[primitive_num];
+			for (Int32 index = 0; index < primitive.num_indices; ++index)
+			{
+				const UInt32 vertex = GetIndex(primitive, index);
+				if (vertex_time - vertex_times[vertex] <= (UInt32)gef::kMeshOptimiserCacheSize)
+					continue;
+				vertex_times[vertex] = vertex_time++;
+
+				const size_t first_line = (size_t)vertex*vertex_data.vertex_byte_size / kLineSize;
+				const size_t last_line = ((size_t)(vertex + 1)*vertex_data.vertex_byte_size - 1) / kLineSize;
+				for (size_t line = first_line; line <= last_line; ++line)
+				{
+					if (line_time - line_times[line] > (UInt32)kNumLines)
+					{
+						line_times[line] = line_time++;
+						++lines_read;
+					}
+				}
+			}
+		}
+		return (double)(lines_read*kLineSize) / (double)vertex_bytes;
+	}
+
+	bool RunMeshBenchmarks()
+	{
+		std::vector<SceneFile*> scenes;
+		for (Int32 filename_num = 0; filename_num < kNumMeshSceneFilenames; ++filename_num)
+		{
+			scenes.push_back(new SceneFile());
+			if (!scenes.back()->Read(kMeshSceneFilenames[filename_num]))
+			{
+				printf("Mesh: can't read %s, skipped\n", GetMediaFilename(kMeshSceneFilenames[filename_num]).c_str());
+				delete scenes.back();
+				scenes.pop_back();
+			}
+		}
+
+		if (scenes.empty())
+			return true;
+
+		// the meshes as exported, and with their triangles shuffled
+		MeshTotals exported_totals, shuffled_totals, cache_only_totals;
+		double overfetch_before = 0.0, overfetch_after = 0.0;
+		Int32 num_mismatches = 0, num_worse = 0, num_meshes = 0;
+		std::vector<gef::MeshData*> meshes;
+		for (size_t scene_num = 0; scene_num < scenes.size(); ++scene_num)
+		{
+			for (std::list<gef::MeshData>::const_iterator mesh = scenes[scene_num]->meshes.begin(); mesh != scenes[scene_num]->meshes.end(); ++mesh)
+			{
+				gef::MeshOptimiserStats stats;
+				gef::MeshData optimised;
+				CopyMesh(*mesh, optimised);
+				num_mismatches += gef::OptimiseMesh(optimised, gef::MeshOptimiserSettings(), &stats) ? CountMismatches(optimised, *mesh) : 1;
+				num_worse += stats.acmr_after <= stats.acmr_before ? 0 : 1;
+				exported_totals.Add(*mesh, stats);
+				overfetch_before += CalculateOverfetch(*mesh);
+				overfetch_after += CalculateOverfetch(optimised);
+				++num_meshes;
+
+				gef::MeshData shuffled;
+				CopyMesh(*mesh, shuffled);
+				ShuffleTriangles(shuffled);
+				meshes.push_back(new gef::MeshData());
+				CopyMesh(shuffled, *meshes.back());
+
+				gef::MeshData shuffled_optimised;
+				CopyMesh(shuffled, shuffled_optimised);
+				num_mismatches += gef::OptimiseMesh(shuffled_optimised, gef::MeshOptimiserSettings(), &stats) ? CountMismatches(shuffled_optimised, shuffled) : 1;
+				shuffled_totals.Add(shuffled, stats);
+
+				// the overdraw pass gives up a little of the cache reuse, each cluster's is bounded by the threshold
+		// but the last cluster of a run of triangles may be worse
+				gef::MeshOptimiserSettings cache_only_settings;
+				cache_only_settings.optimise_overdraw = false;
+				gef::MeshData cache_only;
+				CopyMesh(shuffled, cache_only);
+				gef::OptimiseMesh(cache_only, cache_only_settings, &stats);
+				cache_only_totals.Add(shuffled, stats);
+			}
+		}
+
+		bool passed = ReportMismatches("Mesh optimised meshes draw the same triangles", num_mismatches);
+		passed = ReportCheck("Mesh optimised ACMR no worse", num_worse == 0, (double)num_worse) && passed;
+		const double overdraw_cost = shuffled_totals.acmr_after / cache_only_totals.acmr_after;
+		passed = ReportCheck("Mesh overdraw order keeps the cache reuse", overdraw_cost <= 1.1, overdraw_cost - 1.0) && passed;
+
+		// welding an unindexed copy of a mesh, as OBJLoader reads them, gets back its vertices
+		{
+			const gef::MeshData& mesh = scenes[0]->meshes.front();
+			const gef::PrimitiveData& primitive = *mesh.primitives[0];
+			const Int32 vertex_byte_size = mesh.vertex_data.vertex_byte_size;
+			std::vector<char> corners((size_t)primitive.num_indices*vertex_byte_size);
+			for (Int32 index = 0; index < primitive.num_indices; ++index)
+				memcpy(&corners[(size_t)index*vertex_byte_size], static_cast<const char*>(mesh.vertex_data.vertices) + GetIndex(primitive, index)*vertex_byte_size, vertex_byte_size);
+
+			std::vector<char> welded(corners);
+			std::vector<UInt32> indices;
+			const Int32 num_unique = gef::WeldVertices(&welded[0], primitive.num_indices, vertex_byte_size, indices);
+			Int32 num_weld_mismatches = num_unique <= mesh.vertex_data.num_vertices ? 0 : 1;
+			for (Int32 index = 0; index < primitive.num_indices; ++index)
+				num_weld_mismatches += memcmp(&welded[(size_t)indices[index]*vertex_byte_size], &corners[(size_t)index*vertex_byte_size], vertex_byte_size) == 0 ? 0 : 1;
+			passed = ReportMismatches("Mesh welded vertices match the corners", num_weld_mismatches) && passed;
+			ReportMemory("Mesh unindexed corners welded", corners.size(), (size_t)num_unique*vertex_byte_size + indices.size()*sizeof(UInt16));
+		}
+
+		ReportACMR("Mesh exported ACMR", exported_totals);
+		ReportACMR("Mesh shuffled ACMR", shuffled_totals);
+		ReportACMR("Mesh shuffled ACMR without overdraw order", cache_only_totals);
+		printf("%-48s %6.3f -> %6.3f  bytes read per vertex buffer byte\n", "Mesh vertex overfetch", overfetch_before / num_meshes, overfetch_after / num_meshes);
+		ReportMemory("Mesh vertices and indices", exported_totals.bytes_before, exported_totals.bytes_after);
+
+		// the cost of optimising at load time rather than when the scene is exported
+		const double optimise_time = TimeBestOf(5, [&]()
+		{
+			for (size_t mesh_num = 0; mesh_num < meshes.size(); ++mesh_num)
+			{
+				gef::MeshData mesh;
+				CopyMesh(*meshes[mesh_num], mesh);
+				gef::OptimiseMesh(mesh);
+				DoNotOptimise(mesh.vertex_data.vertices);
+			}
+		});
+		ReportTime("Mesh optimise", shuffled_totals.num_triangles, optimise_time, "triangles");
+
+		for (size_t mesh_num = 0; mesh_num < meshes.size(); ++mesh_num)
+			delete meshes[mesh_num];
+		for (size_t scene_num = 0; scene_num < scenes.size(); ++scene_num)
+			delete scenes[scene_num];
+
+		return passed;
+	}
+}
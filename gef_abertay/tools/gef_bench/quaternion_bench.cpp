@@ -0,0 +1,290 @@
+#include "bench.h"
+#include <maths/quaternion.h>
+#include <vector>
+#include <algorithm>
+#include <random>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+
+namespace gef_bench
+{
+	// slerp in double precision, the shortest path like Quaternion::Slerp
+	namespace reference
+	{
+		static void Slerp(const gef::Quaternion& start, const gef::Quaternion& end, const float time, double result[4])
+		{
+			const double start_values[4] = { start.x, start.y, start.z, start.w };
+			double end_values[4] = { end.x, end.y, end.z, end.w };
+			double dot = 0.0;
+			for (Int32 component = 0; component < 4; ++component)
+				dot += start_values[component]*end_values[component];
+			if (dot < 0.0)
+			{
+				dot = -dot;
+				for (Int32 component = 0; component < 4; ++component)
+					end_values[component] = -end_values[component];
+			}
+
+			const double angle = acos(dot < 1.0 ? dot : 1.0);
+			double start_weight = 1.0 - time, end_weight = time;
+			if (angle > 1e-9)
+			{
+				start_weight = sin(angle*(1.0 - time)) / sin(angle);
+				end_weight = sin(angle*time) / sin(angle);
+			}
+			for (Int32 component = 0; component < 4; ++component)
+				result[component] = start_values[component]*start_weight + end_values[component]*end_weight;
+		}
+	}
+
+	// the angle of the rotation between a blended quaternion and the exact one, in radians
+	static double RotationError(const gef::Quaternion& result, const double expected[4])
+	{
+		const double values[4] = { result.x, result.y, result.z, result.w };
+		double same = 0.0, opposite = 0.0;
+		for (Int32 component = 0; component < 4; ++component)
+		{
+			same += (values[component] - expected[component])*(values[component] - expected[component]);
+			opposite += (values[component] + expected[component])*(values[component] + expected[component]);
+		}
+		const double chord = sqrt(same < opposite ? same : opposite);
+		return 4.0*asin(chord < 2.0 ? chord*0.5 : 1.0);
+	}
+
+	static bool BitEqual(const gef::Quaternion& a, const gef::Quaternion& b)
+	{
+		return memcmp(&a, &b, sizeof(gef::Quaternion)) == 0;
+	}
+
+	static gef::Quaternion RandomRotation(std::mt19937& random)
+	{
+		std::normal_distribution<float> normal;
+		gef::Quaternion rotation(normal(random), normal(random), normal(random), normal(random));
+		rotation.Normalise();
+		return rotation;
+	}
+
+	// keeps the angle between successive rotations small, like neighbouring animation keys
+	static gef::Quaternion NearbyRotation(std::mt19937& random, const gef::Quaternion& rotation, const float max_offset)
+	{
+		std::uniform_real_distribution<float> offset(-max_offset, max_offset);
+		gef::Quaternion result(rotation.x + offset(random), rotation.y + offset(random), rotation.z + offset(random), rotation.w + offset(random));
+		result.Normalise();
+		return result;
+	}
+
+	static bool CheckBlendBatch(const std::vector<gef::Quaternion>& start, const std::vector<gef::Quaternion>& end, const std::vector<float>& times)
+	{
+		Int32 num_failed = 0;
+
+		const Int32 sizes[] = { 1, 3, 4, 7, static_cast<Int32>(start.size()) };
+		const gef::QuaternionBlend blends[] = { gef::QB_SLERP, gef::QB_FAST_SLERP, gef::QB_NLERP };
+		for (Int32 size_num = 0; size_num < static_cast<Int32>(sizeof(sizes) / sizeof(sizes[0])); ++size_num)
+		{
+			const Int32 num = sizes[size_num];
+			for (Int32 blend_num = 0; blend_num < static_cast<Int32>(sizeof(blends) / sizeof(blends[0])); ++blend_num)
+			{
+				std::vector<gef::Quaternion> results(num), results_times(num), in_place(start.begin(), start.begin() + num);
+				gef::BlendQuaternionsBatch(&start[0], &end[0], 0.3f, &results[0], num, blends[blend_num]);
+				gef::BlendQuaternionsBatch(&start[0], &end[0], &times[0], &results_times[0], num, blends[blend_num]);
+				gef::BlendQuaternionsBatch(&in_place[0], &end[0], &times[0], &in_place[0], num, blends[blend_num]);
+
+				for (Int32 index = 0; index < num; ++index)
+				{
+					gef::Quaternion expected, expected_times;
+					switch (blends[blend_num])
+					{
+					case gef::QB_SLERP:
+						expected.Slerp(start[index], end[index], 0.3f);
+						expected_times.Slerp(start[index], end[index], times[index]);
+						break;
+					case gef::QB_FAST_SLERP:
+						expected.FastSlerp(start[index], end[index], 0.3f);
+						expected_times.FastSlerp(start[index], end[index], times[index]);
+						break;
+					case gef::QB_NLERP:
+						expected.Nlerp(start[index], end[index], 0.3f);
+						expected_times.Nlerp(start[index], end[index], times[index]);
+						break;
+					}
+					num_failed += BitEqual(results[index], expected) ? 0 : 1;
+					num_failed += BitEqual(results_times[index], expected_times) ? 0 : 1;
+					num_failed += BitEqual(in_place[index], expected_times) ? 0 : 1;
+				}
+			}
+		}
+
+		return ReportMismatches("Quaternion blend batch matches scalar", num_failed);
+	}
+
+	// the weighted sum and additive batches against the same sums done one quaternion at a time with Quaternion
+	static bool CheckPoseBlendBatches()
+	{
+		std::mt19937 random(1357);
+		const Int32 num = 103;
+		std::vector<gef::Quaternion> a(num), b(num), c(num);
+		for (Int32 index = 0; index < num; ++index)
+		{
+			a[index] = RandomRotation(random);
+			b[index] = NearbyRotation(random, a[index], 0.5f);
+			c[index] = RandomRotation(random);
+		}
+
+		// three way weighted blend
+		const float weights[3] = { 0.5f, 0.3f, 0.2f };
+		const std::vector<gef::Quaternion>* inputs[3] = { &a, &b, &c };
+		std::vector<gef::Quaternion> sums(num, gef::Quaternion(0.0f, 0.0f, 0.0f, 0.0f));
+		for (Int32 input = 0; input < 3; ++input)
+			gef::AddWeightedQuaternionsBatch(&(*inputs[input])[0], weights[input], &sums[0], num);
+		gef::NormaliseQuaternionsBatch(&sums[0], num);
+
+		double max_sum_error = 0.0;
+		for (Int32 index = 0; index < num; ++index)
+		{
+			gef::Quaternion expected(0.0f, 0.0f, 0.0f, 0.0f);
+			for (Int32 input = 0; input < 3; ++input)
+			{
+				const gef::Quaternion& q = (*inputs[input])[index];
+				const float dot = expected.x*q.x + expected.y*q.y + expected.z*q.z + expected.w*q.w;
+				expected = expected + q*(dot < 0.0f ? -weights[input] : weights[input]);
+			}
+			expected.Normalise();
+			const double expected_values[4] = { expected.x, expected.y, expected.z, expected.w };
+			max_sum_error = std::max(max_sum_error, RotationError(sums[index], expected_values));
+		}
+
+		// a half weighted additive difference, then the whole difference applied to its own reference, which gives the additive rotations back
+		std::vector<gef::Quaternion> additive_results(num), identity_results(num);
+		gef::AddAdditiveQuaternionsBatch(&a[0], &b[0], &c[0], 0.5f, &additive_results[0], num);
+		gef::AddAdditiveQuaternionsBatch(&c[0], &b[0], &c[0], 1.0f, &identity_results[0], num);
+
+		double max_additive_error = 0.0;
+		for (Int32 index = 0; index < num; ++index)
+		{
+			gef::Quaternion inverse_reference;
+			inverse_reference.Conjugate(c[index]);
+			gef::Quaternion difference = b[index] * inverse_reference;
+			if (difference.w < 0.0f)
+				difference = -difference;
+			gef::Quaternion half_difference;
+			half_difference.Nlerp(gef::Quaternion(0.0f, 0.0f, 0.0f, 1.0f), difference, 0.5f);
+			const gef::Quaternion expected = half_difference * a[index];
+
+			const double expected_values[4] = { expected.x, expected.y, expected.z, expected.w };
+			const double additive_values[4] = { b[index].x, b[index].y, b[index].z, b[index].w };
+			max_additive_error = std::max(max_additive_error, RotationError(additive_results[index], expected_values));
+			max_additive_error = std::max(max_additive_error, RotationError(identity_results[index], additive_values));
+		}
+
+		bool passed = ReportCheck("Quaternion weighted sum batch matches scalar", max_sum_error < 1e-5, max_sum_error);
+		passed = ReportCheck("Quaternion additive batch matches scalar", max_additive_error < 1e-5, max_additive_error) && passed;
+		return passed;
+	}
+
+	// prints the largest rotation error of each blend, for keys far apart and for keys close together
+	static bool ReportBlendErrors(std::mt19937& random)
+	{
+		const Int32 num_samples = 100000;
+		std::uniform_real_distribution<float> time_range(0.0f, 1.0f);
+
+		bool passed = true;
+		const char* const spreads[] = { "any angle", "close keys" };
+		for (Int32 spread = 0; spread < 2; ++spread)
+		{
+			double max_slerp_error = 0.0, max_fast_error = 0.0, max_nlerp_error = 0.0;
+			for (Int32 sample = 0; sample < num_samples; ++sample)
+			{
+				const gef::Quaternion start = RandomRotation(random);
+				const gef::Quaternion end = spread == 0 ? RandomRotation(random) : NearbyRotation(random, start, 0.2f);
+				const float time = time_range(random);
+
+				double expected[4];
+				reference::Slerp(start, end, time, expected);
+
+				gef::Quaternion result;
+				result.Slerp(start, end, time);
+				const double slerp_error = RotationError(result, expected);
+				result.FastSlerp(start, end, time);
+				const double fast_error = RotationError(result, expected);
+				result.Nlerp(start, end, time);
+				const double nlerp_error = RotationError(result, expected);
+
+				max_slerp_error = slerp_error > max_slerp_error ? slerp_error : max_slerp_error;
+				max_fast_error = fast_error > max_fast_error ? fast_error : max_fast_error;
+				max_nlerp_error = nlerp_error > max_nlerp_error ? nlerp_error : max_nlerp_error;
+			}
+
+			printf("Quaternion blend max error, %-12s slerp %.2e  fast slerp %.2e  nlerp %.2e radians\n", spreads[spread], max_slerp_error, max_fast_error, max_nlerp_error);
+
+			// the bounds documented with QuaternionBlend
+			const double fast_bound = spread == 0 ? 1e-3 : 5e-5;
+			const double nlerp_bound = spread == 0 ? 0.15 : 2e-3;
+			char name[64];
+			sprintf(name, "Slerp error bound (%s)", spreads[spread]);
+			passed = ReportCheck(name, max_slerp_error < 1e-6, max_slerp_error) && passed;
+			sprintf(name, "Fast slerp error bound (%s)", spreads[spread]);
+			passed = ReportCheck(name, max_fast_error < fast_bound, max_fast_error) && passed;
+			sprintf(name, "Nlerp error bound (%s)", spreads[spread]);
+			passed = ReportCheck(name, max_nlerp_error < nlerp_bound, max_nlerp_error) && passed;
+		}
+
+		return passed;
+	}
+
+	bool RunQuaternionBenchmarks()
+	{
+		std::mt19937 random(8642);
+
+		const Int32 num_rotations = 10000;
+		std::uniform_real_distribution<float> time_range(0.0f, 1.0f);
+		std::vector<gef::Quaternion> start(num_rotations), end(num_rotations), results(num_rotations);
+		std::vector<float> times(num_rotations);
+		for (Int32 index = 0; index < num_rotations; ++index)
+		{
+			start[index] = RandomRotation(random);
+			end[index] = NearbyRotation(random, start[index], 0.5f);
+			times[index] = time_range(random);
+		}
+
+		bool passed = CheckBlendBatch(start, end, times);
+		passed = CheckPoseBlendBatches() && passed;
+		passed = ReportBlendErrors(random) && passed;
+
+		const Int32 num_runs = 10;
+		double slerp_time, fast_time, batch_time;
+
+		slerp_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 index = 0; index < num_rotations; ++index)
+				results[index].Slerp(start[index], end[index], times[index]);
+			DoNotOptimise(&results[0]);
+		});
+		fast_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 index = 0; index < num_rotations; ++index)
+				results[index].FastSlerp(start[index], end[index], times[index]);
+			DoNotOptimise(&results[0]);
+		});
+		batch_time = TimeBestOf(num_runs, [&]()
+		{
+			gef::BlendQuaternionsBatch(&start[0], &end[0], &times[0], &results[0], num_rotations, gef::QB_FAST_SLERP);
+			DoNotOptimise(&results[0]);
+		});
+		ReportTime("Quaternion Slerp", num_rotations, slerp_time, "blends");
+		ReportTime("Quaternion FastSlerp", num_rotations, fast_time, "blends");
+		ReportTime("Quaternion fast slerp batch", num_rotations, batch_time, "blends");
+		ReportSpeedUp("Quaternion FastSlerp speed up", slerp_time, fast_time);
+		ReportSpeedUp("Quaternion fast slerp batch speed up", slerp_time, batch_time);
+
+		batch_time = TimeBestOf(num_runs, [&]()
+		{
+			gef::BlendQuaternionsBatch(&start[0], &end[0], &times[0], &results[0], num_rotations, gef::QB_NLERP);
+			DoNotOptimise(&results[0]);
+		});
+		ReportTime("Quaternion nlerp batch", num_rotations, batch_time, "blends");
+		ReportSpeedUp("Quaternion nlerp batch speed up", slerp_time, batch_time);
+
+		return passed;
+	}
+}
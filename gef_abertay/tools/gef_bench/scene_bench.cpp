@@ -0,0 +1,507 @@
+#include "bench.h"
+#include "scene_file.h"
+#include <graphics/packed_scene.h>
+#include <animation/skeleton.h>
+#include <animation/animation.h>
+#include <system/mapped_file.h>
+#include <system/memory_stream_buffer.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace gef_bench
+{
+	namespace reference
+	{
+		// reads the whole file into a buffer and parses it from a stream, as Scene::ReadSceneFromFile did
+		static bool ReadScene(const char* filename, SceneFile& scene)
+		{
+			FILE* file = fopen(filename, "rb");
+			if (!file)
+				return false;
+
+			fseek(file, 0, SEEK_END);
+			const long file_size = ftell(file);
+			fseek(file, 0, SEEK_SET);
+
+			char* file_data = static_cast<char*>(malloc(file_size));
+			bool success = file_data && fread(file_data, 1, file_size, file) == (size_t)file_size;
+			fclose(file);
+
+			if (success)
+			{
+				gef::MemoryStreamBuffer stream_buffer(file_data, file_size);
+				std::istream stream(&stream_buffer);
+				success = scene.Read(stream);
+			}
+
+			free(file_data);
+			return success;
+		}
+
+		// appends to the file, 16 byte aligned, returning the offset the bytes were written at
+		static UInt32 AppendAligned(std::vector<char>& file, const void* data, const size_t size)
+		{
+			file.resize((file.size() + 15) & ~(size_t)15);
+			const UInt32 offset = (UInt32)file.size();
+			file.resize(file.size() + size);
+			if (size > 0)
+				memcpy(&file[offset], data, size);
+			return offset;
+		}
+
+		template<class T> static UInt32 AppendBlob(std::vector<char>& file, const T& element)
+		{
+			std::ostringstream stream(std::ios::out | std::ios::binary);
+			element.Write(stream);
+			const std::string bytes = stream.str();
+			return AppendAligned(file, bytes.data(), bytes.size());
+		}
+
+		// the version 2 layout fbx2scn -packed wrote before the table of contents, every element in a table of its type
+		static bool WritePackedSceneV2(const char* filename, const SceneFile& scene)
+		{
+			std::vector<char> file(sizeof(gef::PackedSceneHeaderV2));
+			gef::PackedSceneHeaderV2 header;
+			memset(&header, 0, sizeof(header));
+			header.magic = gef::kPackedSceneMagic;
+			header.version = gef::kPackedSceneVersion2;
+			header.string_count = scene.string_id_table.num_strings();
+			header.strings_size = (UInt32)scene.string_id_table.strings_size();
+			header.strings_offset = AppendAligned(file, scene.string_id_table.strings(), header.strings_size);
+
+			std::vector<gef::PackedMaterialData> materials;
+			std::vector<std::string> diffuse_textures;
+			for (std::list<gef::MaterialData>::const_iterator material = scene.material_data.begin(); material != scene.material_data.end(); ++material)
+			{
+				gef::PackedMaterialData packed_material;
+				packed_material.name_id = material->name_id;
+				packed_material.diffuse_texture_offset = AppendAligned(file, material->diffuse_texture.c_str(), material->diffuse_texture.length() + 1);
+				materials.push_back(packed_material);
+			}
+			header.material_count = (Int32)materials.size();
+
+			std::vector<gef::PackedMeshData> meshes;
+			for (std::list<gef::MeshData>::const_iterator mesh = scene.meshes.begin(); mesh != scene.meshes.end(); ++mesh)
+			{
+				std::vector<gef::PackedPrimitiveData> primitives;
+				for (size_t primitive_num = 0; primitive_num < mesh->primitives.size(); ++primitive_num)
+				{
+					const gef::PrimitiveData& primitive = *mesh->primitives[primitive_num];
+					gef::PackedPrimitiveData packed_primitive;
+					packed_primitive.material_name_id = primitive.material_name_id;
+					packed_primitive.type = (Int32)primitive.type;
+					packed_primitive.num_indices = primitive.num_indices;
+					packed_primitive.index_byte_size = primitive.index_byte_size;
+					packed_primitive.indices_offset = AppendAligned(file, primitive.indices, (size_t)primitive.num_indices*primitive.index_byte_size);
+					primitives.push_back(packed_primitive);
+				}
+
+				gef::PackedMeshData packed_mesh;
+				packed_mesh.name_id = mesh->name_id;
+				packed_mesh.primitive_count = (Int32)primitives.size();
+				packed_mesh.primitives_offset = AppendAligned(file, primitives.empty() ? NULL : &primitives[0], primitives.size()*sizeof(gef::PackedPrimitiveData));
+				packed_mesh.num_vertices = mesh->vertex_data.num_vertices;
+				packed_mesh.vertex_byte_size = mesh->vertex_data.vertex_byte_size;
+				packed_mesh.vertices_offset = AppendAligned(file, mesh->vertex_data.vertices, (size_t)mesh->vertex_data.num_vertices*mesh->vertex_data.vertex_byte_size);
+				for (Int32 axis = 0; axis < 3; ++axis)
+				{
+					packed_mesh.aabb_min[axis] = mesh->aabb.min_vtx()[axis];
+					packed_mesh.aabb_max[axis] = mesh->aabb.max_vtx()[axis];
+				}
+				meshes.push_back(packed_mesh);
+			}
+			header.mesh_count = (Int32)meshes.size();
+
+			std::vector<gef::PackedBlob> skeletons, animations;
+			for (size_t skeleton_num = 0; skeleton_num < scene.skeletons.size(); ++skeleton_num)
+			{
+				gef::PackedBlob blob;
+				blob.offset = AppendBlob(file, *scene.skeletons[skeleton_num]);
+				blob.size = (UInt32)file.size() - blob.offset;
+				skeletons.push_back(blob);
+			}
+			for (size_t animation_num = 0; animation_num < scene.animations.size(); ++animation_num)
+			{
+				gef::PackedBlob blob;
+				blob.offset = AppendBlob(file, *scene.animations[animation_num]);
+				blob.size = (UInt32)file.size() - blob.offset;
+				animations.push_back(blob);
+			}
+			header.skeleton_count = (Int32)skeletons.size();
+			header.animation_count = (Int32)animations.size();
+
+			header.materials_offset = AppendAligned(file, materials.empty() ? NULL : &materials[0], materials.size()*sizeof(gef::PackedMaterialData));
+			header.meshes_offset = AppendAligned(file, meshes.empty() ? NULL : &meshes[0], meshes.size()*sizeof(gef::PackedMeshData));
+			header.skeletons_offset = AppendAligned(file, skeletons.empty() ? NULL : &skeletons[0], skeletons.size()*sizeof(gef::PackedBlob));
+			header.animations_offset = AppendAligned(file, animations.empty() ? NULL : &animations[0], animations.size()*sizeof(gef::PackedBlob));
+			header.file_size = (UInt32)file.size();
+			memcpy(&file[0], &header, sizeof(header));
+
+			std::ofstream stream(filename, std::ios::out | std::ios::binary);
+			stream.write(&file[0], file.size());
+			return stream.is_open() && !stream.fail();
+		}
+	}
+
+	// maps the file and parses the stream format from the mapping, as Scene::ReadSceneFromFile does for unpacked scenes
+	static bool ReadMappedScene(const char* filename, SceneFile& scene)
+	{
+		gef::MappedFile mapped_file;
+		if (!mapped_file.Open(filename))
+			return false;
+
+		gef::MemoryStreamBuffer stream_buffer((char*)mapped_file.data(), mapped_file.size());
+		std::istream stream(&stream_buffer);
+		return scene.Read(stream);
+	}
+
+	static bool ReadPackedScene(gef::MappedFile& mapped_file, const char* filename, SceneFile& scene)
+	{
+		gef::PackedSceneReader reader;
+		return mapped_file.Open(filename) && reader.Open(mapped_file.data(), mapped_file.size()) && scene.ReadPacked(reader);
+	}
+
+	// copies every vertex and index the way VertexBuffer::Init and IndexBuffer::Init copy them to the GPU,
+	// so the pages of a mapped file are read in the timings rather than left untouched
+	static void UploadMeshes(const SceneFile& scene, std::vector<char>& upload)
+	{
+		size_t upload_size = 0;
+		for (std::list<gef::MeshData>::const_iterator mesh = scene.meshes.begin(); mesh != scene.meshes.end(); ++mesh)
+		{
+			const size_t vertex_bytes = mesh->vertex_data.num_vertices*mesh->vertex_data.vertex_byte_size;
+			if (upload_size + vertex_bytes <= upload.size())
+				memcpy(&upload[upload_size], mesh->vertex_data.vertices, vertex_bytes);
+			upload_size += vertex_bytes;
+
+			for (size_t primitive_num = 0; primitive_num < mesh->primitives.size(); ++primitive_num)
+			{
+				const gef::PrimitiveData& primitive = *mesh->primitives[primitive_num];
+				const size_t index_bytes = primitive.num_indices*primitive.index_byte_size;
+				if (upload_size + index_bytes <= upload.size())
+					memcpy(&upload[upload_size], primitive.indices, index_bytes);
+				upload_size += index_bytes;
+			}
+		}
+	}
+
+	static std::string WriteToString(const gef::Animation& animation)
+	{
+		std::ostringstream stream(std::ios::out | std::ios::binary);
+		animation.Write(stream);
+		return stream.str();
+	}
+
+	// every element of the packed scene against the scene it was written from, byte for byte
+	static Int32 CountMismatches(const SceneFile& scene, const SceneFile& expected)
+	{
+		Int32 num_mismatches = 0;
+		num_mismatches += scene.string_id_table.strings_size() == expected.string_id_table.strings_size() ? 0 : 1;
+		num_mismatches += scene.material_data.size() == expected.material_data.size() ? 0 : 1;
+		num_mismatches += scene.meshes.size() == expected.meshes.size() ? 0 : 1;
+		num_mismatches += scene.skeletons.size() == expected.skeletons.size() ? 0 : 1;
+		num_mismatches += scene.animations.size() == expected.animations.size() ? 0 : 1;
+		if (num_mismatches > 0)
+			return num_mismatches;
+
+		std::list<gef::MaterialData>::const_iterator expected_material = expected.material_data.begin();
+		for (std::list<gef::MaterialData>::const_iterator material = scene.material_data.begin(); material != scene.material_data.end(); ++material, ++expected_material)
+			num_mismatches += material->name_id == expected_material->name_id && material->diffuse_texture == expected_material->diffuse_texture ? 0 : 1;
+
+		std::list<gef::MeshData>::const_iterator expected_mesh = expected.meshes.begin();
+		for (std::list<gef::MeshData>::const_iterator mesh = scene.meshes.begin(); mesh != scene.meshes.end(); ++mesh, ++expected_mesh)
+		{
+			const gef::VertexData& vertex_data = mesh->vertex_data;
+			const gef::VertexData& expected_vertex_data = expected_mesh->vertex_data;
+			num_mismatches += vertex_data.num_vertices == expected_vertex_data.num_vertices && vertex_data.vertex_byte_size == expected_vertex_data.vertex_byte_size
+				&& memcmp(vertex_data.vertices, expected_vertex_data.vertices, vertex_data.num_vertices*vertex_data.vertex_byte_size) == 0 ? 0 : 1;
+
+			// the blobs are used in place, so they have to be aligned
+			num_mismatches += ((size_t)vertex_data.vertices & 15) == 0 && !vertex_data.owns_vertices ? 0 : 1;
+			num_mismatches += mesh->name_id == expected_mesh->name_id && mesh->primitives.size() == expected_mesh->primitives.size() ? 0 : 1;
+			for (size_t primitive_num = 0; primitive_num < mesh->primitives.size() && primitive_num < expected_mesh->primitives.size(); ++primitive_num)
+			{
+				const gef::PrimitiveData& primitive = *mesh->primitives[primitive_num];
+				const gef::PrimitiveData& expected_primitive = *expected_mesh->primitives[primitive_num];
+				num_mismatches += primitive.type == expected_primitive.type && primitive.material_name_id == expected_primitive.material_name_id
+					&& primitive.num_indices == expected_primitive.num_indices && primitive.index_byte_size == expected_primitive.index_byte_size
+					&& memcmp(primitive.indices, expected_primitive.indices, primitive.num_indices*primitive.index_byte_size) == 0 ? 0 : 1;
+				num_mismatches += ((size_t)primitive.indices & 15) == 0 ? 0 : 1;
+			}
+		}
+
+		for (size_t skeleton_num = 0; skeleton_num < scene.skeletons.size(); ++skeleton_num)
+		{
+			const gef::Skeleton& skeleton = *scene.skeletons[skeleton_num];
+			const gef::Skeleton& expected_skeleton = *expected.skeletons[skeleton_num];
+			num_mismatches += skeleton.joint_count() == expected_skeleton.joint_count()
+				&& memcmp(&skeleton.joint(0), &expected_skeleton.joint(0), skeleton.joint_count()*sizeof(gef::Joint)) == 0 ? 0 : 1;
+		}
+
+		for (size_t animation_num = 0; animation_num < scene.animations.size(); ++animation_num)
+			num_mismatches += WriteToString(*scene.animations[animation_num]) == WriteToString(*expected.animations[animation_num]) ? 0 : 1;
+
+		return num_mismatches;
+	}
+
+	// writes every element of the scenes into one packed scene, with the strings of the first
+	static bool WritePackedScene(const char* filename, const std::vector<const SceneFile*>& scenes)
+	{
+		gef::PackedSceneWriter writer;
+		writer.set_string_id_table(&scenes[0]->string_id_table);
+		for (size_t scene_num = 0; scene_num < scenes.size(); ++scene_num)
+		{
+			const SceneFile& scene = *scenes[scene_num];
+			for (std::list<gef::MaterialData>::const_iterator material = scene.material_data.begin(); material != scene.material_data.end(); ++material)
+				writer.AddMaterial(*material);
+			for (std::list<gef::MeshData>::const_iterator mesh = scene.meshes.begin(); mesh != scene.meshes.end(); ++mesh)
+				writer.AddMesh(*mesh);
+			for (size_t skeleton_num = 0; skeleton_num < scene.skeletons.size(); ++skeleton_num)
+				writer.AddSkeleton(*scene.skeletons[skeleton_num]);
+			for (size_t animation_num = 0; animation_num < scene.animations.size(); ++animation_num)
+				writer.AddAnimation(*scene.animations[animation_num]);
+		}
+
+		std::ofstream stream(filename, std::ios::out | std::ios::binary);
+		return stream.is_open() && writer.Write(stream);
+	}
+
+	// reads one animation out of a packed scene, touching only the header, the table of contents and its chunk
+	static bool ReadPackedAnimation(const char* filename, const gef::StringId name_id, gef::Animation& animation)
+	{
+		gef::MappedFile mapped_file;
+		gef::PackedSceneReader reader;
+		if (!mapped_file.Open(filename) || !reader.Open(mapped_file.data(), mapped_file.size()))
+			return false;
+
+		const Int32 animation_index = reader.Find(gef::kPackedAnimationChunk, name_id);
+		return animation_index >= 0 && reader.ReadAnimation(animation_index, animation);
+	}
+
+	// reads one animation chunk with a seek, without mapping or reading the rest of the file
+	static bool SeekPackedAnimation(const char* filename, const gef::PackedSceneChunk& chunk, gef::Animation& animation)
+	{
+		FILE* file = fopen(filename, "rb");
+		if (!file)
+			return false;
+
+		std::vector<char> chunk_data(chunk.size);
+		bool success = fseek(file, chunk.offset, SEEK_SET) == 0 && fread(&chunk_data[0], 1, chunk.size, file) == chunk.size;
+		fclose(file);
+
+		return success && gef::PackedSceneReader::ReadAnimationChunk(&chunk_data[0], chunk.size, animation);
+	}
+
+	// a character packed with the clips it plays, loading one clip only reads that clip's chunk,
+	// where the stream format has to be parsed from the start of the file to get to any animation
+	static bool RunPartialLoadBenchmarks(const SceneFile& character)
+	{
+		const char* kClipFilenames[] = { "idle.scn", "running_InPlace.scn" };
+		SceneFile clips[2];
+		for (Int32 clip_num = 0; clip_num < 2; ++clip_num)
+		{
+			if (!clips[clip_num].Read(kClipFilenames[clip_num]) || clips[clip_num].animations.empty())
+			{
+				printf("Scene: can't read the animation in %s, skipped\n", kClipFilenames[clip_num]);
+				return true;
+			}
+		}
+
+		const char* packed_filename = "gef_bench_Y_Bot_clips_packed.scn";
+		std::vector<const SceneFile*> packed_scenes;
+		packed_scenes.push_back(&character);
+		packed_scenes.push_back(&clips[0]);
+		packed_scenes.push_back(&clips[1]);
+		if (!WritePackedScene(packed_filename, packed_scenes))
+		{
+			printf("Scene: can't write %s, skipped\n", packed_filename);
+			return true;
+		}
+
+		gef::MappedFile packed_file;
+		gef::PackedSceneReader reader;
+		const bool packed_opened = packed_file.Open(packed_filename) && reader.Open(packed_file.data(), packed_file.size());
+
+		// each clip read on its own matches the one parsed from its stream file
+		Int32 num_mismatches = packed_opened ? 0 : 1;
+		for (Int32 clip_num = 0; clip_num < 2 && packed_opened; ++clip_num)
+		{
+			gef::Animation animation;
+			num_mismatches += reader.ReadAnimation(clip_num, animation)
+				&& WriteToString(animation) == WriteToString(*clips[clip_num].animations[0]) ? 0 : 1;
+		}
+		bool passed = ReportMismatches("Scene packed partial animation matches stream", num_mismatches);
+
+		// both clips are exported as "mixamo.com", finding by name gets the first
+		const gef::StringId idle_name_id = clips[0].animations[0]->name_id();
+		const Int32 idle_index = packed_opened ? reader.Find(gef::kPackedAnimationChunk, idle_name_id) : -1;
+		const gef::PackedSceneChunk* idle_chunk = reader.GetChunk(gef::kPackedAnimationChunk, idle_index);
+		passed = ReportCheck("Scene packed table of contents", packed_opened && idle_index == 0 && idle_chunk && idle_chunk->name_id == idle_name_id
+			&& (idle_chunk->offset & 15) == 0 && reader.Find(gef::kPackedAnimationChunk, GEF_STRING_ID("gef_bench_missing")) == -1
+			&& reader.GetChunk(gef::kPackedAnimationChunk, reader.animation_count()) == NULL
+			&& reader.chunk_count() == (Int32)(character.material_data.size() + character.meshes.size() + character.skeletons.size()) + 2, 0.0) && passed;
+
+		gef::Animation seek_animation;
+		passed = ReportCheck("Scene packed chunk read with a seek", idle_chunk && SeekPackedAnimation(packed_filename, *idle_chunk, seek_animation)
+			&& WriteToString(seek_animation) == WriteToString(*clips[0].animations[0]), 0.0) && passed;
+
+		if (!passed || !idle_chunk)
+		{
+			packed_file.Close();
+			remove(packed_filename);
+			return passed;
+		}
+
+		// getting the idle clip used to mean parsing idle.scn from the start, the packed clip can be read from a file
+		// holding the character and all of its clips without parsing any of the rest
+		const std::string idle_filename = GetMediaFilename(kClipFilenames[0]);
+		const Int32 num_runs = 50;
+		const double stream_time = TimeBestOf(num_runs, [&]()
+		{
+			SceneFile loaded_scene;
+			ReadMappedScene(idle_filename.c_str(), loaded_scene);
+			DoNotOptimise(loaded_scene.animations.empty() ? NULL : loaded_scene.animations[0]);
+		});
+		const double packed_full_time = TimeBestOf(num_runs, [&]()
+		{
+			gef::MappedFile mapped_file;
+			SceneFile loaded_scene;
+			ReadPackedScene(mapped_file, packed_filename, loaded_scene);
+			DoNotOptimise(loaded_scene.animations.empty() ? NULL : loaded_scene.animations[0]);
+		});
+		const double partial_time = TimeBestOf(num_runs, [&]()
+		{
+			gef::Animation animation;
+			ReadPackedAnimation(packed_filename, idle_name_id, animation);
+			DoNotOptimise(&animation);
+		});
+
+		ReportTime("Scene idle clip from idle.scn stream", 1, stream_time, "clips");
+		ReportTime("Scene idle clip from full packed read", 1, packed_full_time, "clips");
+		ReportTime("Scene idle clip from packed chunk", 1, partial_time, "clips");
+		ReportSpeedUp("Scene partial clip load vs stream", stream_time, partial_time);
+		ReportSpeedUp("Scene partial clip load vs full packed read", packed_full_time, partial_time);
+
+		const size_t touched_bytes = sizeof(gef::PackedSceneHeader) + reader.chunk_count()*sizeof(gef::PackedSceneChunk) + idle_chunk->size;
+		ReportMemory("Scene partial clip bytes touched", packed_file.size(), touched_bytes);
+
+		packed_file.Close();
+		remove(packed_filename);
+
+		return passed;
+	}
+
+	bool RunSceneBenchmarks()
+	{
+		const std::string filename = GetMediaFilename("Y_Bot.scn");
+		SceneFile scene;
+		if (!scene.Read("Y_Bot.scn") || scene.meshes.empty())
+		{
+			printf("Scene: can't read %s, skipped\n", filename.c_str());
+			return true;
+		}
+
+		// the packed copy is written next to the benchmark, not into the media directory
+		const char* packed_filename = "gef_bench_Y_Bot_packed.scn";
+		std::vector<const SceneFile*> packed_scenes(1, &scene);
+		if (!WritePackedScene(packed_filename, packed_scenes))
+		{
+			printf("Scene: can't write %s, skipped\n", packed_filename);
+			return true;
+		}
+
+		gef::MappedFile packed_file;
+		SceneFile packed_scene;
+		bool passed = ReadPackedScene(packed_file, packed_filename, packed_scene);
+		passed = ReportMismatches("Scene packed matches stream", passed ? CountMismatches(packed_scene, scene) : 1) && passed;
+
+		gef::MappedFile stream_file;
+		gef::PackedSceneReader reader;
+		const bool stream_file_read = stream_file.Open(filename.c_str());
+		const bool stream_rejected = stream_file_read && !gef::PackedSceneReader::IsPackedScene(stream_file.data(), stream_file.size());
+		const bool truncated_rejected = !reader.Open(packed_file.data(), packed_file.size() - 1);
+		passed = ReportCheck("Scene packed header detected", stream_rejected && truncated_rejected && packed_file.mapped(), 0.0) && passed;
+
+		// files written before the table of contents are still read, through a table of contents built from their tables
+		const char* v2_filename = "gef_bench_Y_Bot_packed_v2.scn";
+		if (reference::WritePackedSceneV2(v2_filename, scene))
+		{
+			gef::MappedFile v2_file;
+			SceneFile v2_scene;
+			const bool v2_read = ReadPackedScene(v2_file, v2_filename, v2_scene);
+			Int32 num_mismatches = v2_read ? CountMismatches(v2_scene, scene) : 1;
+
+			gef::PackedSceneReader v2_reader;
+			const bool v2_opened = v2_reader.Open(v2_file.data(), v2_file.size());
+			for (size_t animation_num = 0; animation_num < scene.animations.size(); ++animation_num)
+			{
+				const gef::StringId name_id = scene.animations[animation_num]->name_id();
+				const gef::PackedSceneChunk* chunk = v2_opened ? v2_reader.GetChunk(gef::kPackedAnimationChunk, v2_reader.Find(gef::kPackedAnimationChunk, name_id)) : NULL;
+				num_mismatches += chunk && chunk->name_id == name_id ? 0 : 1;
+			}
+			passed = ReportMismatches("Scene packed version 2 matches stream", num_mismatches) && passed;
+
+			v2_file.Close();
+			remove(v2_filename);
+		}
+
+		// the reference copies the file into a buffer, then every vertex and index out of it,
+		// the packed scene only copies the skeletons and animations out of the mapping
+		size_t mesh_bytes = 0, packed_copied_bytes = 0;
+		for (std::list<gef::MeshData>::const_iterator mesh = scene.meshes.begin(); mesh != scene.meshes.end(); ++mesh)
+		{
+			mesh_bytes += mesh->vertex_data.num_vertices*mesh->vertex_data.vertex_byte_size;
+			for (size_t primitive_num = 0; primitive_num < mesh->primitives.size(); ++primitive_num)
+				mesh_bytes += mesh->primitives[primitive_num]->num_indices*mesh->primitives[primitive_num]->index_byte_size;
+		}
+
+		// each load includes creating the vertex and index buffers, which reads every mesh byte
+		std::vector<char> upload(mesh_bytes);
+		const Int32 num_runs = 20;
+		const double reference_time = TimeBestOf(num_runs, [&]()
+		{
+			SceneFile loaded_scene;
+			reference::ReadScene(filename.c_str(), loaded_scene);
+			UploadMeshes(loaded_scene, upload);
+			DoNotOptimise(&upload[0]);
+		});
+		const double mapped_time = TimeBestOf(num_runs, [&]()
+		{
+			SceneFile loaded_scene;
+			ReadMappedScene(filename.c_str(), loaded_scene);
+			UploadMeshes(loaded_scene, upload);
+			DoNotOptimise(&upload[0]);
+		});
+		const double packed_time = TimeBestOf(num_runs, [&]()
+		{
+			gef::MappedFile mapped_file;
+			SceneFile loaded_scene;
+			ReadPackedScene(mapped_file, packed_filename, loaded_scene);
+			UploadMeshes(loaded_scene, upload);
+			DoNotOptimise(&upload[0]);
+		});
+
+		ReportTime("Scene Y_Bot.scn load reference", 1, reference_time, "scenes");
+		ReportTime("Scene Y_Bot.scn load mapped", 1, mapped_time, "scenes");
+		ReportSpeedUp("Scene load mapped speed up", reference_time, mapped_time);
+		ReportTime("Scene Y_Bot.scn load packed", 1, packed_time, "scenes");
+		ReportSpeedUp("Scene load packed speed up", reference_time, packed_time);
+		for (size_t skeleton_num = 0; skeleton_num < scene.skeletons.size(); ++skeleton_num)
+			packed_copied_bytes += scene.skeletons[skeleton_num]->joint_count()*sizeof(gef::Joint);
+		for (size_t animation_num = 0; animation_num < scene.animations.size(); ++animation_num)
+			packed_copied_bytes += WriteToString(*scene.animations[animation_num]).size();
+		ReportMemory("Scene load bytes copied", stream_file.size() + mesh_bytes, packed_copied_bytes);
+
+		packed_file.Close();
+		stream_file.Close();
+		remove(packed_filename);
+
+		passed = RunPartialLoadBenchmarks(scene) && passed;
+
+		return passed;
+	}
+}
@@ -0,0 +1,115 @@
+#include "scene_file.h"
+#include "bench.h"
+#include <animation/skeleton.h>
+#include <animation/animation.h>
+#include <graphics/packed_scene.h>
+#include <fstream>
+#include <string>
+
+namespace gef_bench
+{
+	SceneFile::SceneFile()
+	{
+	}
+
+	SceneFile::~SceneFile()
+	{
+		for (size_t skeleton_num = 0; skeleton_num < skeletons.size(); ++skeleton_num)
+			delete skeletons[skeleton_num];
+		for (size_t animation_num = 0; animation_num < animations.size(); ++animation_num)
+			delete animations[animation_num];
+	}
+
+	bool SceneFile::Read(const char* filename)
+	{
+		std::ifstream stream(GetMediaFilename(filename).c_str(), std::ios::in | std::ios::binary);
+		if (!stream.is_open())
+			return false;
+
+		return Read(stream);
+	}
+
+	bool SceneFile::Read(std::istream& stream)
+	{
+		Int32 mesh_count;
+		Int32 material_count;
+		Int32 skeleton_count;
+		Int32 animation_count;
+		Int32 string_count;
+
+		stream.read((char*)&mesh_count, sizeof(Int32));
+		stream.read((char*)&material_count, sizeof(Int32));
+		stream.read((char*)&skeleton_count, sizeof(Int32));
+		stream.read((char*)&animation_count, sizeof(Int32));
+		stream.read((char*)&string_count, sizeof(Int32));
+
+		for (Int32 string_num = 0; string_num < string_count && stream; ++string_num)
+		{
+			std::string the_string;
+			std::getline(stream, the_string, '\0');
+			string_id_table.Add(the_string);
+		}
+
+		for (Int32 material_num = 0; material_num < material_count && stream; ++material_num)
+		{
+			material_data.push_back(gef::MaterialData());
+			material_data.back().Read(stream);
+		}
+
+		for (Int32 mesh_num = 0; mesh_num < mesh_count && stream; ++mesh_num)
+		{
+			meshes.push_back(gef::MeshData());
+			meshes.back().Read(stream);
+		}
+
+		for (Int32 skeleton_num = 0; skeleton_num < skeleton_count && stream; ++skeleton_num)
+		{
+			gef::Skeleton* skeleton = new gef::Skeleton();
+			skeleton->Read(stream);
+			skeletons.push_back(skeleton);
+		}
+
+		for (Int32 animation_num = 0; animation_num < animation_count && stream; ++animation_num)
+		{
+			gef::Animation* animation = new gef::Animation();
+			animation->Read(stream);
+			animations.push_back(animation);
+		}
+
+		return !stream.fail();
+	}
+
+	bool SceneFile::ReadPacked(const gef::PackedSceneReader& reader)
+	{
+		bool success = true;
+		reader.ReadStrings(string_id_table);
+
+		for (Int32 material_num = 0; material_num < reader.material_count() && success; ++material_num)
+		{
+			material_data.push_back(gef::MaterialData());
+			success = reader.ReadMaterial(material_num, material_data.back());
+		}
+
+		for (Int32 mesh_num = 0; mesh_num < reader.mesh_count() && success; ++mesh_num)
+		{
+			meshes.push_back(gef::MeshData());
+			success = reader.ReadMesh(mesh_num, meshes.back());
+		}
+
+		for (Int32 skeleton_num = 0; skeleton_num < reader.skeleton_count() && success; ++skeleton_num)
+		{
+			gef::Skeleton* skeleton = new gef::Skeleton();
+			skeletons.push_back(skeleton);
+			success = reader.ReadSkeleton(skeleton_num, *skeleton);
+		}
+
+		for (Int32 animation_num = 0; animation_num < reader.animation_count() && success; ++animation_num)
+		{
+			gef::Animation* animation = new gef::Animation();
+			animations.push_back(animation);
+			success = reader.ReadAnimation(animation_num, *animation);
+		}
+
+		return success;
+	}
+}
@@ -0,0 +1,52 @@
+#ifndef _GEF_BENCH_SCENE_FILE_H
+#define _GEF_BENCH_SCENE_FILE_H
+
+#include <graphics/mesh_data.h>
+#include <system/string_id.h>
+#include <list>
+#include <vector>
+#include <istream>
+
+namespace gef
+{
+	class Skeleton;
+	class Animation;
+	class PackedSceneReader;
+}
+
+namespace gef_bench
+{
+	/// @brief The mesh, skeleton and animation data of a .scn file.
+	/// @note Read the same way as gef::Scene::ReadScene, without the textures and materials
+	/// gef::Scene creates, which need a Platform the benchmarks don't have.
+	class SceneFile
+	{
+	public:
+		SceneFile();
+		~SceneFile();
+
+		/// @brief Reads a .scn file from the media directory.
+		/// @param[in] filename		The name of the file, relative to the media directory.
+		/// @return true if the file was read
+		bool Read(const char* filename);
+
+		/// @brief Reads a scene in the stream format of gef::Scene::WriteScene.
+		bool Read(std::istream& stream);
+
+		/// @brief Reads every element of a packed scene the same way as gef::Scene::ReadPackedScene.
+		/// @note The meshes point into the reader's data, which must outlive them.
+		bool ReadPacked(const gef::PackedSceneReader& reader);
+
+		std::list<gef::MaterialData> material_data;
+		std::list<gef::MeshData> meshes;
+		std::vector<gef::Skeleton*> skeletons;
+		std::vector<gef::Animation*> animations;
+		gef::StringIdTable string_id_table;
+
+	private:
+		SceneFile(const SceneFile&);
+		SceneFile& operator=(const SceneFile&);
+	};
+}
+
+#endif // _GEF_BENCH_SCENE_FILE_H
@@ -0,0 +1,245 @@
+#include "bench.h"
+#include <graphics/cpu_skinning.h>
+#include <graphics/mesh.h>
+#include <graphics/default_3d_skinning_shader.h>
+#include <system/job_system.h>
+#include <maths/matrix44.h>
+#include <maths/transform_batch.h>
+#include <maths/quaternion.h>
+#include <maths/transform.h>
+#include <maths/vector4.h>
+#include <vector>
+#include <random>
+#include <math.h>
+#include <string.h>
+
+namespace gef_bench
+{
+	namespace reference
+	{
+		// skins each vertex the way Default3DSkinningShader does, transforming by every bone and summing the weighted results
+		static void SkinVertices(const gef::Mesh::SkinnedVertex* vertices, const gef::Matrix44* bone_matrices, gef::Mesh::Vertex* results, const Int32 num_vertices)
+		{
+			for (Int32 vertex_num = 0; vertex_num < num_vertices; ++vertex_num)
+			{
+				const gef::Mesh::SkinnedVertex& vertex = vertices[vertex_num];
+				const gef::Vector4 position(vertex.px, vertex.py, vertex.pz);
+				const gef::Vector4 normal(vertex.nx, vertex.ny, vertex.nz);
+
+				gef::Vector4 skinned_position(0.0f, 0.0f, 0.0f), skinned_normal(0.0f, 0.0f, 0.0f);
+				for (Int32 influence = 0; influence < 4; ++influence)
+				{
+					const gef::Matrix44& bone = bone_matrices[vertex.bone_indices[influence]];
+					skinned_position += position.Transform(bone) * vertex.bone_weights[influence];
+					skinned_normal += normal.TransformNoTranslation(bone) * vertex.bone_weights[influence];
+				}
+
+				gef::Mesh::Vertex& result = results[vertex_num];
+				result.px = skinned_position.x();
+				result.py = skinned_position.y();
+				result.pz = skinned_position.z();
+				result.nx = skinned_normal.x();
+				result.ny = skinned_normal.y();
+				result.nz = skinned_normal.z();
+				result.u = vertex.u;
+				result.v = vertex.v;
+			}
+		}
+
+		// the skinning matrices as SkeletonPoseSoA::CalculateSkinningMatrices calculated them, then transposed
+		// into the skinning shader's array of MAX_NUM_BONE_MATRICES as it uploaded them
+		static void CalculateSkinningPalette(const gef::Matrix44* inv_bind_poses, const gef::Matrix44* global_pose,
+			gef::Matrix44* skinning_matrices, gef::Matrix44* shader_bone_matrices, const Int32 num_bones)
+		{
+			for (Int32 bone_num = 0; bone_num < num_bones; ++bone_num)
+				skinning_matrices[bone_num] = inv_bind_poses[bone_num] * global_pose[bone_num];
+			for (Int32 bone_num = 0; bone_num < num_bones; ++bone_num)
+				shader_bone_matrices[bone_num].Transpose(skinning_matrices[bone_num]);
+		}
+	}
+
+	// a character sized mesh, each vertex weighted to between one and four random bones
+	static void CreateSkinnedVertices(std::mt19937& random, const Int32 num_bones, std::vector<gef::Mesh::SkinnedVertex>& vertices)
+	{
+		std::uniform_real_distribution<float> position_range(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+		std::normal_distribution<float> normal_distribution;
+		std::uniform_int_distribution<Int32> bone_range(0, num_bones - 1);
+		std::uniform_int_distribution<Int32> influence_range(1, 4);
+
+		for (size_t vertex_num = 0; vertex_num < vertices.size(); ++vertex_num)
+		{
+			gef::Mesh::SkinnedVertex& vertex = vertices[vertex_num];
+			vertex.px = position_range(random);
+			vertex.py = position_range(random);
+			vertex.pz = position_range(random);
+
+			gef::Vector4 normal(normal_distribution(random), normal_distribution(random), normal_distribution(random));
+			normal.Normalise();
+			vertex.nx = normal.x();
+			vertex.ny = normal.y();
+			vertex.nz = normal.z();
+			vertex.u = unit(random);
+			vertex.v = unit(random);
+
+			// normalised weights, unused influences have zero weight as in the sample meshes
+			const Int32 num_influences = influence_range(random);
+			float weight_total = 0.0f;
+			for (Int32 influence = 0; influence < 4; ++influence)
+			{
+				vertex.bone_indices[influence] = static_cast<UInt8>(bone_range(random));
+				vertex.bone_weights[influence] = influence < num_influences ? unit(random) + 0.01f : 0.0f;
+				weight_total += vertex.bone_weights[influence];
+			}
+			for (Int32 influence = 0; influence < 4; ++influence)
+				vertex.bone_weights[influence] /= weight_total;
+		}
+	}
+
+	static void CreateBoneMatrices(std::mt19937& random, std::vector<gef::Matrix44>& bone_matrices)
+	{
+		std::normal_distribution<float> normal_distribution;
+		std::uniform_real_distribution<float> translation_range(-50.0f, 50.0f);
+
+		for (size_t bone_num = 0; bone_num < bone_matrices.size(); ++bone_num)
+		{
+			gef::Quaternion rotation(normal_distribution(random), normal_distribution(random), normal_distribution(random), normal_distribution(random));
+			rotation.Normalise();
+
+			gef::Transform transform;
+			transform.set_rotation(rotation);
+			transform.set_scale(gef::Vector4(1.0f, 1.0f, 1.0f));
+			transform.set_translation(gef::Vector4(translation_range(random), translation_range(random), translation_range(random)));
+			bone_matrices[bone_num] = transform.GetMatrix();
+		}
+	}
+
+	// the largest difference between two sets of skinned vertices, relative to the size of the values
+	static float MaxError(const std::vector<gef::Mesh::Vertex>& vertices, const std::vector<gef::Mesh::Vertex>& expected)
+	{
+		float max_error = 0.0f;
+		for (size_t vertex_num = 0; vertex_num < vertices.size(); ++vertex_num)
+		{
+			const float* values = &vertices[vertex_num].px;
+			const float* expected_values = &expected[vertex_num].px;
+			for (Int32 value_num = 0; value_num < 8; ++value_num)
+			{
+				const float scale = fabsf(expected_values[value_num]) > 1.0f ? fabsf(expected_values[value_num]) : 1.0f;
+				const float error = fabsf(values[value_num] - expected_values[value_num]) / scale;
+				max_error = error > max_error ? error : max_error;
+			}
+		}
+		return max_error;
+	}
+
+	// the palette of many characters, fused into one multiply and transpose, against the separate passes it replaces
+	static bool BenchmarkSkinningPalette(const Int32 num_bones)
+	{
+		const Int32 num_characters = 200;
+		const Int32 num_matrices = num_characters*num_bones;
+		std::mt19937 random(9753);
+
+		std::vector<gef::Matrix44> inv_bind_poses(num_matrices), global_poses(num_matrices);
+		CreateBoneMatrices(random, inv_bind_poses);
+		CreateBoneMatrices(random, global_poses);
+
+		std::vector<gef::Matrix44> skinning_matrices(num_bones), shader_bone_matrices(MAX_NUM_BONE_MATRICES);
+		std::vector<gef::Matrix44> palettes(num_matrices);
+		Int32 num_mismatches = 0;
+		for (Int32 character_num = 0; character_num < num_characters; ++character_num)
+		{
+			const Int32 first_bone = character_num*num_bones;
+			reference::CalculateSkinningPalette(&inv_bind_poses[first_bone], &global_poses[first_bone], &skinning_matrices[0], &shader_bone_matrices[0], num_bones);
+			gef::MultiplyTransposeMatricesBatch(&inv_bind_poses[first_bone], &global_poses[first_bone], &palettes[first_bone], num_bones);
+			for (Int32 bone_num = 0; bone_num < num_bones; ++bone_num)
+				num_mismatches += memcmp(&palettes[first_bone + bone_num], &shader_bone_matrices[bone_num], sizeof(gef::Matrix44)) == 0 ? 0 : 1;
+		}
+		bool passed = ReportMismatches("Skinning palette matches shader bone matrices", num_mismatches);
+
+		const Int32 num_runs = 20;
+		const double reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 character_num = 0; character_num < num_characters; ++character_num)
+			{
+				const Int32 first_bone = character_num*num_bones;
+				reference::CalculateSkinningPalette(&inv_bind_poses[first_bone], &global_poses[first_bone], &skinning_matrices[0], &shader_bone_matrices[0], num_bones);
+				DoNotOptimise(&shader_bone_matrices[0]);
+			}
+		});
+		const double fused_time = TimeBestOf(num_runs, [&]()
+		{
+			gef::MultiplyTransposeMatricesBatch(&inv_bind_poses[0], &global_poses[0], &palettes[0], num_matrices);
+			DoNotOptimise(&palettes[0]);
+		});
+
+		ReportTime("Skinning palette reference", num_matrices, reference_time, "bones");
+		ReportTime("Skinning palette fused", num_matrices, fused_time, "bones");
+		ReportSpeedUp("Skinning palette fused speed up", reference_time, fused_time);
+
+		// the skinning shader's vertex constants, wvp, world, invworld and the light positions, then the bones
+		const size_t constant_bytes = 3*sizeof(gef::Matrix44) + MAX_NUM_POINT_LIGHTS*sizeof(gef::Vector4);
+		ReportMemory("Skinning shader upload per draw", constant_bytes + MAX_NUM_BONE_MATRICES*sizeof(gef::Matrix44), constant_bytes + num_bones*sizeof(gef::Matrix44));
+
+		return passed;
+	}
+
+	bool RunSkinningBenchmarks()
+	{
+		const Int32 num_vertices = 50000;
+		const Int32 num_bones = 65;
+		std::mt19937 random(8642);
+
+		std::vector<gef::Mesh::SkinnedVertex> vertices(num_vertices);
+		std::vector<gef::Matrix44> bone_matrices(num_bones);
+		std::vector<gef::Mesh::Vertex> reference_results(num_vertices), results(num_vertices), job_results(num_vertices);
+		CreateSkinnedVertices(random, num_bones, vertices);
+		CreateBoneMatrices(random, bone_matrices);
+
+		// workers even on a single core machine, so the check always runs jobs on other threads
+		gef::JobSystem check_job_system(3);
+		reference::SkinVertices(&vertices[0], &bone_matrices[0], &reference_results[0], num_vertices);
+		gef::SkinVerticesBatch(&vertices[0], &bone_matrices[0], &results[0], num_vertices);
+		gef::SkinVerticesBatch(&vertices[0], &bone_matrices[0], &job_results[0], num_vertices, check_job_system);
+
+		// the batch blends the matrices before transforming, so it only matches the shader order to rounding,
+		// which is relative to the positions and translations of up to 100 that cancel out in positions near zero
+		const float max_error = MaxError(results, reference_results);
+		bool passed = ReportCheck("Skinning matches skinning shader", max_error < 1e-4f, max_error);
+		const float max_job_error = MaxError(job_results, results);
+		passed = ReportCheck("Skinning jobs match one thread", max_job_error == 0.0f, max_job_error) && passed;
+
+		const Int32 num_runs = 10;
+		double reference_time, batch_time, job_time;
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			reference::SkinVertices(&vertices[0], &bone_matrices[0], &reference_results[0], num_vertices);
+			DoNotOptimise(&reference_results[0]);
+		});
+		batch_time = TimeBestOf(num_runs, [&]()
+		{
+			gef::SkinVerticesBatch(&vertices[0], &bone_matrices[0], &results[0], num_vertices);
+			DoNotOptimise(&results[0]);
+		});
+
+		gef::JobSystem job_system;
+		job_time = TimeBestOf(num_runs, [&]()
+		{
+			gef::SkinVerticesBatch(&vertices[0], &bone_matrices[0], &job_results[0], num_vertices, job_system);
+			DoNotOptimise(&job_results[0]);
+		});
+
+		const Int32 vertex_bytes = num_vertices*static_cast<Int32>(sizeof(gef::Mesh::SkinnedVertex) + sizeof(gef::Mesh::Vertex));
+		ReportTime("Skinning reference", num_vertices, reference_time, "vertices");
+		ReportTime("Skinning batch", num_vertices, batch_time, "vertices");
+		ReportThroughput("Skinning batch", vertex_bytes, batch_time);
+		ReportSpeedUp("Skinning batch speed up", reference_time, batch_time);
+		ReportTime("Skinning batch jobs", num_vertices, job_time, "vertices");
+		ReportThroughput("Skinning batch jobs", vertex_bytes, job_time);
+		ReportSpeedUp("Skinning batch jobs speed up", reference_time, job_time);
+
+		passed = BenchmarkSkinningPalette(num_bones) && passed;
+
+		return passed;
+	}
+}
@@ -0,0 +1,146 @@
+#include "bench.h"
+#include <graphics/sprite.h>
+#include <graphics/sprite_batch.h>
+#include <graphics/colour.h>
+#include <maths/matrix44.h>
+#include <maths/math_utils.h>
+#include <vector>
+#include <random>
+#include <math.h>
+
+namespace gef_bench
+{
+	// same as SpriteRenderer::BuildSpriteShaderData, one sprite at a time
+	static void BuildSpriteShaderDataReference(const gef::Sprite& sprite, gef::Matrix44& sprite_data)
+	{
+		sprite_data.set_m(2, 0, sprite.position().x());
+		sprite_data.set_m(2, 1, sprite.position().y());
+		sprite_data.set_m(2, 2, sprite.position().z());
+		sprite_data.set_m(2, 3, 0.0f);
+
+		if (sprite.rotation() == 0)
+		{
+			sprite_data.set_m(0, 0, sprite.width());
+			sprite_data.set_m(0, 1, 0.0f);
+			sprite_data.set_m(1, 0, 0.0f);
+			sprite_data.set_m(1, 1, sprite.height());
+		}
+		else
+		{
+			sprite_data.set_m(0, 0, cosf(sprite.rotation())*sprite.width());
+			sprite_data.set_m(0, 1, sinf(sprite.rotation())*sprite.width());
+			sprite_data.set_m(1, 0, -sinf(sprite.rotation())*sprite.height());
+			sprite_data.set_m(1, 1, cosf(sprite.rotation())*sprite.height());
+		}
+
+		sprite_data.set_m(0, 2, sprite.uv_position().x);
+		sprite_data.set_m(0, 3, sprite.uv_position().y);
+		sprite_data.set_m(1, 2, sprite.uv_width());
+		sprite_data.set_m(1, 3, sprite.uv_height());
+
+		gef::Colour colour;
+		colour.SetFromAGBR(sprite.colour());
+
+		sprite_data.set_m(3, 0, colour.r);
+		sprite_data.set_m(3, 1, colour.g);
+		sprite_data.set_m(3, 2, colour.b);
+		sprite_data.set_m(3, 3, colour.a);
+	}
+
+	static bool RunSpriteBatchBenchmark(const Int32 num_sprites)
+	{
+		std::mt19937 random(num_sprites);
+		std::uniform_real_distribution<float> position_range(0.0f, 960.0f);
+		std::uniform_real_distribution<float> size_range(1.0f, 64.0f);
+		std::uniform_real_distribution<float> rotation_range(-FRAMEWORK_PI, FRAMEWORK_PI);
+		std::uniform_real_distribution<float> uv_range(0.0f, 1.0f);
+
+		// particle style sprites, kept both as gef::Sprite objects and as arrays
+		std::vector<gef::Sprite> sprites(num_sprites);
+		std::vector<gef::Vector4> positions(num_sprites);
+		std::vector<gef::Vector2> sizes(num_sprites);
+		std::vector<float> rotations(num_sprites);
+		std::vector<gef::Vector4> uv_rects(num_sprites);
+		std::vector<UInt32> colours(num_sprites);
+
+		for (Int32 sprite_num = 0; sprite_num < num_sprites; ++sprite_num)
+		{
+			positions[sprite_num] = gef::Vector4(position_range(random), position_range(random), uv_range(random));
+			sizes[sprite_num] = gef::Vector2(size_range(random), size_range(random));
+			rotations[sprite_num] = (sprite_num % 8) == 0 ? 0.0f : rotation_range(random);
+			uv_rects[sprite_num] = gef::Vector4(uv_range(random), uv_range(random), 0.25f, 0.25f);
+			colours[sprite_num] = static_cast<UInt32>(random());
+
+			gef::Sprite& sprite = sprites[sprite_num];
+			sprite.set_position(positions[sprite_num]);
+			sprite.set_width(sizes[sprite_num].x);
+			sprite.set_height(sizes[sprite_num].y);
+			sprite.set_rotation(rotations[sprite_num]);
+			sprite.set_uv_position(gef::Vector2(uv_rects[sprite_num].x(), uv_rects[sprite_num].y()));
+			sprite.set_uv_width(uv_rects[sprite_num].z());
+			sprite.set_uv_height(uv_rects[sprite_num].w());
+			sprite.set_colour(colours[sprite_num]);
+		}
+
+		gef::SpriteBatchData batch;
+		batch.positions = &positions[0];
+		batch.sizes = &sizes[0];
+		batch.rotations = &rotations[0];
+		batch.uv_rects = &uv_rects[0];
+		batch.colours = &colours[0];
+
+		std::vector<gef::Matrix44> reference_data(num_sprites);
+		std::vector<gef::Matrix44> batch_data(num_sprites);
+
+		const Int32 num_runs = 10;
+		const double reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 sprite_num = 0; sprite_num < num_sprites; ++sprite_num)
+				BuildSpriteShaderDataReference(sprites[sprite_num], reference_data[sprite_num]);
+			DoNotOptimise(&reference_data[0]);
+		});
+
+		const double batch_time = TimeBestOf(num_runs, [&]()
+		{
+			gef::BuildSpriteShaderDataBatch(batch, num_sprites, &batch_data[0]);
+			DoNotOptimise(&batch_data[0]);
+		});
+
+		char name[64];
+		sprintf(name, "sprite data reference (%d)", num_sprites);
+		ReportTime(name, num_sprites, reference_time, "sprites");
+		sprintf(name, "sprite data batch (%d)", num_sprites);
+		ReportTime(name, num_sprites, batch_time, "sprites");
+		sprintf(name, "sprite data batch speed up (%d)", num_sprites);
+		ReportSpeedUp(name, reference_time, batch_time);
+
+		// the batch version uses an approximate sincos so allow a small error
+		double max_error = 0.0;
+		for (Int32 sprite_num = 0; sprite_num < num_sprites; ++sprite_num)
+		{
+			for (Int32 row = 0; row < 4; ++row)
+			{
+				for (Int32 column = 0; column < 4; ++column)
+				{
+					const double error = fabs(reference_data[sprite_num].m(row, column) - batch_data[sprite_num].m(row, column));
+					if (error > max_error)
+						max_error = error;
+				}
+			}
+		}
+
+		sprintf(name, "sprite data batch matches reference (%d)", num_sprites);
+		return ReportCheck(name, max_error < 1e-4, max_error);
+	}
+
+	bool RunSpriteBatchBenchmarks()
+	{
+		const Int32 sprite_counts[] = { 10000, 25000, 50000, 100000 };
+		const Int32 num_counts = sizeof(sprite_counts) / sizeof(Int32);
+
+		bool passed = true;
+		for (Int32 count_num = 0; count_num < num_counts; ++count_num)
+			passed = RunSpriteBatchBenchmark(sprite_counts[count_num]) && passed;
+		return passed;
+	}
+}
@@ -0,0 +1,148 @@
+#include "bench.h"
+#include <system/string_id.h>
+#include <system/crc.h>
+#include <vector>
+#include <map>
+#include <string>
+#include <random>
+#include <stdio.h>
+#include <string.h>
+
+namespace gef_bench
+{
+	// the std::map table StringIdTable used to be
+	namespace reference
+	{
+		class StringIdTable
+		{
+		public:
+			gef::StringId Add(const std::string& text)
+			{
+				gef::StringId string_id = gef::GetStringId(text);
+				if (table_.find(string_id) == table_.end())
+					table_[string_id] = text;
+				return string_id;
+			}
+
+			bool Find(const UInt32 string_id, std::string& result) const
+			{
+				std::map<gef::StringId, std::string>::const_iterator iter = table_.find(string_id);
+				if (iter == table_.end())
+					return false;
+				result = iter->second;
+				return true;
+			}
+
+			const std::string* Find(const UInt32 string_id) const
+			{
+				std::map<gef::StringId, std::string>::const_iterator iter = table_.find(string_id);
+				return iter == table_.end() ? NULL : &iter->second;
+			}
+		private:
+			std::map<gef::StringId, std::string> table_;
+		};
+	}
+
+	// the id of a joint name, checked against GEF_STRING_ID by the compiler and GetStringId at run time
+	static const gef::StringId kHipsStringId = 0x0c500a50;
+	static_assert(GEF_STRING_ID("mixamorig:Hips") == kHipsStringId, "GEF_STRING_ID must be evaluated at compile time");
+
+	// joint style names with a mix of cases
+	static std::string MakeName(std::mt19937& random)
+	{
+		static const char* const parts[] = { "Hips", "spine", "Neck", "head", "Left", "right", "Arm", "fore_arm", "Hand", "finger", "Leg", "up_leg", "Foot", "toe_base" };
+		std::uniform_int_distribution<Int32> part_range(0, sizeof(parts) / sizeof(parts[0]) - 1);
+		std::uniform_int_distribution<Int32> number_range(0, 999);
+
+		char number[8];
+		sprintf(number, "%d", number_range(random));
+		return std::string("mixamorig:") + parts[part_range(random)] + parts[part_range(random)] + number;
+	}
+
+	bool RunStringIdBenchmarks()
+	{
+		bool passed = true;
+
+		const bool constant_passed =
+			gef::GetStringId("mixamorig:Hips") == kHipsStringId &&
+			GEF_STRING_ID("Hips") == gef::GetStringId(std::string("hips")) &&
+			GEF_STRING_ID("mixamorig:LeftHand") == gef::GetStringId("mixamorig:LeftHand") &&
+			GEF_STRING_ID("") == gef::CRC::GetICRC("");
+		passed = ReportCheck("StringId literal matches runtime CRC", constant_passed, 0.0) && passed;
+
+		const Int32 num_names = 10000;
+		std::mt19937 random(1357);
+		std::vector<std::string> names(num_names);
+		for (Int32 name_num = 0; name_num < num_names; ++name_num)
+			names[name_num] = MakeName(random);
+
+		gef::StringIdTable table;
+		reference::StringIdTable reference_table;
+		std::vector<gef::StringId> string_ids(num_names);
+		Int32 num_failed = 0;
+		for (Int32 name_num = 0; name_num < num_names; ++name_num)
+		{
+			string_ids[name_num] = table.Add(names[name_num]);
+			num_failed += string_ids[name_num] == reference_table.Add(names[name_num]) ? 0 : 1;
+		}
+		for (Int32 name_num = 0; name_num < num_names; ++name_num)
+		{
+			std::string result, expected;
+			const bool found = table.Find(string_ids[name_num], result);
+			num_failed += found == reference_table.Find(string_ids[name_num], expected) && result == expected ? 0 : 1;
+		}
+		num_failed += table.Find(0x12345678) == NULL ? 0 : 1;
+
+		// the string buffer holds each unique string once, which is what scenes write out
+		Int32 num_buffer_strings = 0;
+		for (UInt32 offset = 0; offset < table.strings_size(); offset += static_cast<UInt32>(strlen(table.strings() + offset)) + 1)
+			++num_buffer_strings;
+		num_failed += num_buffer_strings == table.num_strings() ? 0 : 1;
+		passed = ReportMismatches("StringIdTable matches std::map table", num_failed) && passed;
+
+		std::vector<gef::StringId> lookups(num_names);
+		std::uniform_int_distribution<Int32> name_range(0, num_names - 1);
+		for (Int32 lookup_num = 0; lookup_num < num_names; ++lookup_num)
+			lookups[lookup_num] = string_ids[name_range(random)];
+
+		const Int32 num_runs = 10;
+		double reference_time, table_time;
+		size_t total_length = 0;
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 lookup_num = 0; lookup_num < num_names; ++lookup_num)
+				total_length += (*reference_table.Find(lookups[lookup_num]))[0];
+			DoNotOptimise(&total_length);
+		});
+		table_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 lookup_num = 0; lookup_num < num_names; ++lookup_num)
+				total_length += *table.Find(lookups[lookup_num]);
+			DoNotOptimise(&total_length);
+		});
+		ReportTime("StringId lookup std::map", num_names, reference_time, "lookups");
+		ReportTime("StringId lookup StringIdTable", num_names, table_time, "lookups");
+		ReportSpeedUp("StringId lookup speed up", reference_time, table_time);
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			reference::StringIdTable build_table;
+			for (Int32 name_num = 0; name_num < num_names; ++name_num)
+				build_table.Add(names[name_num]);
+			DoNotOptimise(&build_table);
+		});
+		table_time = TimeBestOf(num_runs, [&]()
+		{
+			gef::StringIdTable build_table;
+			for (Int32 name_num = 0; name_num < num_names; ++name_num)
+				build_table.Add(names[name_num]);
+			DoNotOptimise(&build_table);
+		});
+		ReportTime("StringId add std::map", num_names, reference_time, "strings");
+		ReportTime("StringId add StringIdTable", num_names, table_time, "strings");
+		ReportSpeedUp("StringId add speed up", reference_time, table_time);
+
+		return passed;
+	}
+}
@@ -0,0 +1,317 @@
+#include "bench.h"
+#include <maths/transform_batch.h>
+#include <maths/matrix44.h>
+#include <maths/vector4.h>
+#include <maths/aabb.h>
+#include <maths/sphere.h>
+#include <graphics/mesh.h>
+#include <vector>
+#include <random>
+#include <stdio.h>
+#include <string.h>
+
+namespace gef_bench
+{
+	// one vector at a time, the way mesh bounds and vertex transforms were done before the batch functions
+	namespace reference
+	{
+		static void TransformVertices(const gef::Matrix44& matrix, const std::vector<gef::Mesh::Vertex>& vertices, std::vector<gef::Mesh::Vertex>& results)
+		{
+			for (size_t vertex_num = 0; vertex_num < vertices.size(); ++vertex_num)
+			{
+				const gef::Mesh::Vertex& vertex = vertices[vertex_num];
+				const gef::Vector4 position = gef::Vector4(vertex.px, vertex.py, vertex.pz).Transform(matrix);
+				const gef::Vector4 normal = gef::Vector4(vertex.nx, vertex.ny, vertex.nz).TransformNoTranslation(matrix);
+
+				gef::Mesh::Vertex& result = results[vertex_num];
+				result.px = position.x();
+				result.py = position.y();
+				result.pz = position.z();
+				result.nx = normal.x();
+				result.ny = normal.y();
+				result.nz = normal.z();
+			}
+		}
+
+		static gef::Aabb CalculateBounds(const std::vector<gef::Mesh::Vertex>& vertices)
+		{
+			gef::Aabb bounds;
+			for (size_t vertex_num = 0; vertex_num < vertices.size(); ++vertex_num)
+				bounds.Update(gef::Vector4(vertices[vertex_num].px, vertices[vertex_num].py, vertices[vertex_num].pz));
+			return bounds;
+		}
+
+		// the eight corner version of Aabb::Transform
+		static gef::Aabb TransformAabb(const gef::Aabb& box, const gef::Matrix44& matrix)
+		{
+			gef::Aabb result;
+			for (Int32 corner = 0; corner < 8; ++corner)
+			{
+				const gef::Vector4 position(
+					(corner & 1) ? box.max_vtx().x() : box.min_vtx().x(),
+					(corner & 2) ? box.max_vtx().y() : box.min_vtx().y(),
+					(corner & 4) ? box.max_vtx().z() : box.min_vtx().z());
+				result.Update(position.Transform(matrix));
+			}
+			return result;
+		}
+
+		static gef::Sphere TransformSphere(const gef::Sphere& sphere, const gef::Matrix44& matrix)
+		{
+			gef::Vector4 point_on_sphere(1.0f, 1.0f, 1.0f);
+			point_on_sphere.Normalise();
+			point_on_sphere *= sphere.radius();
+			point_on_sphere = point_on_sphere.TransformNoTranslation(matrix);
+			return gef::Sphere(sphere.position().Transform(matrix), point_on_sphere.Length());
+		}
+	}
+
+	static bool BitEqual(const float a, const float b)
+	{
+		return memcmp(&a, &b, sizeof(float)) == 0;
+	}
+
+	static bool BitEqual(const gef::Mesh::Vertex& a, const gef::Mesh::Vertex& b)
+	{
+		return memcmp(&a, &b, sizeof(gef::Mesh::Vertex)) == 0;
+	}
+
+	static void TransformVerticesBatch(const gef::Matrix44& matrix, const std::vector<gef::Mesh::Vertex>& vertices, std::vector<gef::Mesh::Vertex>& results)
+	{
+		const Int32 num_vertices = static_cast<Int32>(vertices.size());
+		gef::TransformPointsBatch(matrix, &vertices[0].px, sizeof(gef::Mesh::Vertex), &results[0].px, sizeof(gef::Mesh::Vertex), num_vertices);
+		gef::TransformVectorsBatch(matrix, &vertices[0].nx, sizeof(gef::Mesh::Vertex), &results[0].nx, sizeof(gef::Mesh::Vertex), num_vertices);
+	}
+
+	static bool CheckTransformBatch(const gef::Matrix44& matrix, const std::vector<gef::Mesh::Vertex>& vertices)
+	{
+		bool passed = true;
+
+		// odd sizes check the partial last block
+		const Int32 sizes[] = { 1, 3, 4, 7, static_cast<Int32>(vertices.size()) };
+		for (Int32 size_num = 0; size_num < static_cast<Int32>(sizeof(sizes) / sizeof(sizes[0])); ++size_num)
+		{
+			const Int32 num_vertices = sizes[size_num];
+			const std::vector<gef::Mesh::Vertex> input(vertices.begin(), vertices.begin() + num_vertices);
+			std::vector<gef::Mesh::Vertex> expected(input), results(input), in_place(input);
+			reference::TransformVertices(matrix, input, expected);
+			TransformVerticesBatch(matrix, input, results);
+			TransformVerticesBatch(matrix, in_place, in_place);
+
+			std::vector<float> x(num_vertices), y(num_vertices), z(num_vertices), soa_x(num_vertices), soa_y(num_vertices), soa_z(num_vertices);
+			for (Int32 vertex_num = 0; vertex_num < num_vertices; ++vertex_num)
+			{
+				x[vertex_num] = input[vertex_num].px;
+				y[vertex_num] = input[vertex_num].py;
+				z[vertex_num] = input[vertex_num].pz;
+			}
+			gef::TransformPointsBatchSoA(matrix, &x[0], &y[0], &z[0], &soa_x[0], &soa_y[0], &soa_z[0], num_vertices);
+
+			Int32 num_failed = 0;
+			for (Int32 vertex_num = 0; vertex_num < num_vertices; ++vertex_num)
+			{
+				const gef::Mesh::Vertex& expected_vertex = expected[vertex_num];
+				num_failed += BitEqual(results[vertex_num], expected_vertex) ? 0 : 1;
+				num_failed += BitEqual(in_place[vertex_num], expected_vertex) ? 0 : 1;
+				num_failed += BitEqual(soa_x[vertex_num], expected_vertex.px) && BitEqual(soa_y[vertex_num], expected_vertex.py) && BitEqual(soa_z[vertex_num], expected_vertex.pz) ? 0 : 1;
+			}
+
+			gef::TransformVectorsBatchSoA(matrix, &x[0], &y[0], &z[0], &x[0], &y[0], &z[0], num_vertices);
+			for (Int32 vertex_num = 0; vertex_num < num_vertices; ++vertex_num)
+			{
+				const gef::Vector4 expected_vector = gef::Vector4(input[vertex_num].px, input[vertex_num].py, input[vertex_num].pz).TransformNoTranslation(matrix);
+				num_failed += BitEqual(x[vertex_num], expected_vector.x()) && BitEqual(y[vertex_num], expected_vector.y()) && BitEqual(z[vertex_num], expected_vector.z()) ? 0 : 1;
+			}
+
+			const gef::Aabb expected_bounds = reference::CalculateBounds(input);
+			const gef::Aabb bounds = gef::CalculateBoundsBatch(&input[0].px, sizeof(gef::Mesh::Vertex), num_vertices);
+			for (Int32 axis = 0; axis < 3; ++axis)
+			{
+				num_failed += BitEqual(bounds.min_vtx()[axis], expected_bounds.min_vtx()[axis]) ? 0 : 1;
+				num_failed += BitEqual(bounds.max_vtx()[axis], expected_bounds.max_vtx()[axis]) ? 0 : 1;
+			}
+
+			char name[64];
+			sprintf(name, "Transform batch matches Vector4 (%d vertices)", num_vertices);
+			passed = ReportMismatches(name, num_failed) && passed;
+		}
+
+		return passed;
+	}
+
+	static bool BitEqual(const gef::Vector4& a, const gef::Vector4& b)
+	{
+		return BitEqual(a.x(), b.x()) && BitEqual(a.y(), b.y()) && BitEqual(a.z(), b.z()) && BitEqual(a.w(), b.w());
+	}
+
+	static bool CheckBoundsBatch(const std::vector<gef::Matrix44>& matrices, const std::vector<gef::Aabb>& boxes, const std::vector<gef::Sphere>& spheres)
+	{
+		const Int32 num_bounds = static_cast<Int32>(boxes.size());
+		std::vector<gef::Aabb> box_results(num_bounds);
+		std::vector<gef::Sphere> sphere_results(num_bounds);
+
+		Int32 num_failed = 0;
+		gef::TransformAabbsBatch(&matrices[0], &boxes[0], &box_results[0], num_bounds);
+		for (Int32 box_num = 0; box_num < num_bounds; ++box_num)
+		{
+			const gef::Aabb expected = reference::TransformAabb(boxes[box_num], matrices[box_num]);
+			num_failed += BitEqual(box_results[box_num].min_vtx(), expected.min_vtx()) && BitEqual(box_results[box_num].max_vtx(), expected.max_vtx()) ? 0 : 1;
+		}
+		gef::TransformAabbsBatch(matrices[0], &boxes[0], &box_results[0], num_bounds);
+		for (Int32 box_num = 0; box_num < num_bounds; ++box_num)
+		{
+			const gef::Aabb expected = reference::TransformAabb(boxes[box_num], matrices[0]);
+			num_failed += BitEqual(box_results[box_num].min_vtx(), expected.min_vtx()) && BitEqual(box_results[box_num].max_vtx(), expected.max_vtx()) ? 0 : 1;
+		}
+		bool passed = ReportMismatches("Aabb transform matches eight corners", num_failed);
+
+		num_failed = 0;
+		gef::TransformSpheresBatch(&matrices[0], &spheres[0], &sphere_results[0], num_bounds);
+		for (Int32 sphere_num = 0; sphere_num < num_bounds; ++sphere_num)
+		{
+			const gef::Sphere expected = reference::TransformSphere(spheres[sphere_num], matrices[sphere_num]);
+			num_failed += BitEqual(sphere_results[sphere_num].position(), expected.position()) && BitEqual(sphere_results[sphere_num].radius(), expected.radius()) ? 0 : 1;
+		}
+		gef::TransformSpheresBatch(matrices[0], &spheres[0], &sphere_results[0], num_bounds);
+		for (Int32 sphere_num = 0; sphere_num < num_bounds; ++sphere_num)
+		{
+			const gef::Sphere expected = reference::TransformSphere(spheres[sphere_num], matrices[0]);
+			num_failed += BitEqual(sphere_results[sphere_num].position(), expected.position()) && BitEqual(sphere_results[sphere_num].radius(), expected.radius()) ? 0 : 1;
+		}
+		passed = ReportMismatches("Sphere transform matches scalar version", num_failed) && passed;
+
+		return passed;
+	}
+
+	static bool RunBoundsBatchBenchmarks(std::mt19937& random)
+	{
+		const Int32 num_bounds = 10000;
+		std::uniform_real_distribution<float> range(-100.0f, 100.0f);
+		std::uniform_real_distribution<float> size_range(0.1f, 10.0f);
+
+		std::vector<gef::Matrix44> matrices(num_bounds);
+		std::vector<gef::Aabb> boxes(num_bounds), box_results(num_bounds);
+		std::vector<gef::Sphere> spheres(num_bounds), sphere_results(num_bounds);
+		for (Int32 bounds_num = 0; bounds_num < num_bounds; ++bounds_num)
+		{
+			for (Int32 row = 0; row < 4; ++row)
+				for (Int32 column = 0; column < 4; ++column)
+					matrices[bounds_num].set_m(row, column, row < 3 ? range(random)*0.01f : range(random));
+
+			const gef::Vector4 centre(range(random), range(random), range(random));
+			const gef::Vector4 half_size(size_range(random), size_range(random), size_range(random));
+			boxes[bounds_num] = gef::Aabb(centre - half_size, centre + half_size);
+			spheres[bounds_num] = gef::Sphere(boxes[bounds_num]);
+		}
+
+		bool passed = CheckBoundsBatch(matrices, boxes, spheres);
+
+		const Int32 num_runs = 10;
+		double reference_time, batch_time;
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 box_num = 0; box_num < num_bounds; ++box_num)
+				box_results[box_num] = reference::TransformAabb(boxes[box_num], matrices[box_num]);
+			DoNotOptimise(&box_results[0]);
+		});
+		batch_time = TimeBestOf(num_runs, [&]()
+		{
+			gef::TransformAabbsBatch(&matrices[0], &boxes[0], &box_results[0], num_bounds);
+			DoNotOptimise(&box_results[0]);
+		});
+		ReportTime("Aabb transform eight corners", num_bounds, reference_time, "boxes");
+		ReportTime("Aabb transform batch", num_bounds, batch_time, "boxes");
+		ReportSpeedUp("Aabb transform batch speed up", reference_time, batch_time);
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 sphere_num = 0; sphere_num < num_bounds; ++sphere_num)
+				sphere_results[sphere_num] = reference::TransformSphere(spheres[sphere_num], matrices[sphere_num]);
+			DoNotOptimise(&sphere_results[0]);
+		});
+		batch_time = TimeBestOf(num_runs, [&]()
+		{
+			gef::TransformSpheresBatch(&matrices[0], &spheres[0], &sphere_results[0], num_bounds);
+			DoNotOptimise(&sphere_results[0]);
+		});
+		ReportTime("Sphere transform scalar", num_bounds, reference_time, "spheres");
+		ReportTime("Sphere transform batch", num_bounds, batch_time, "spheres");
+		ReportSpeedUp("Sphere transform batch speed up", reference_time, batch_time);
+
+		return passed;
+	}
+
+	bool RunTransformBatchBenchmarks()
+	{
+		const Int32 num_vertices = 100000;
+		std::mt19937 random(4321);
+		std::uniform_real_distribution<float> range(-100.0f, 100.0f);
+
+		std::vector<gef::Mesh::Vertex> vertices(num_vertices), results(num_vertices);
+		std::vector<float> x(num_vertices), y(num_vertices), z(num_vertices), result_x(num_vertices), result_y(num_vertices), result_z(num_vertices);
+		for (Int32 vertex_num = 0; vertex_num < num_vertices; ++vertex_num)
+		{
+			gef::Mesh::Vertex& vertex = vertices[vertex_num];
+			vertex.px = x[vertex_num] = range(random);
+			vertex.py = y[vertex_num] = range(random);
+			vertex.pz = z[vertex_num] = range(random);
+			vertex.nx = range(random);
+			vertex.ny = range(random);
+			vertex.nz = range(random);
+			vertex.u = range(random);
+			vertex.v = range(random);
+		}
+		results = vertices;
+
+		gef::Matrix44 matrix;
+		for (Int32 row = 0; row < 4; ++row)
+			for (Int32 column = 0; column < 4; ++column)
+				matrix.set_m(row, column, range(random));
+
+		bool passed = CheckTransformBatch(matrix, vertices);
+
+		const Int32 num_runs = 10;
+		double reference_time, batch_time;
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			reference::TransformVertices(matrix, vertices, results);
+			DoNotOptimise(&results[0]);
+		});
+		batch_time = TimeBestOf(num_runs, [&]()
+		{
+			TransformVerticesBatch(matrix, vertices, results);
+			DoNotOptimise(&results[0]);
+		});
+		ReportTime("Transform vertices Vector4", num_vertices, reference_time, "vertices");
+		ReportTime("Transform vertices batch", num_vertices, batch_time, "vertices");
+		ReportSpeedUp("Transform vertices batch speed up", reference_time, batch_time);
+
+		batch_time = TimeBestOf(num_runs, [&]()
+		{
+			gef::TransformPointsBatchSoA(matrix, &x[0], &y[0], &z[0], &result_x[0], &result_y[0], &result_z[0], num_vertices);
+			DoNotOptimise(&result_x[0]);
+		});
+		ReportTime("Transform positions batch SoA", num_vertices, batch_time, "vertices");
+
+		gef::Aabb bounds;
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			bounds = reference::CalculateBounds(vertices);
+			DoNotOptimise(&bounds);
+		});
+		batch_time = TimeBestOf(num_runs, [&]()
+		{
+			bounds = gef::CalculateBoundsBatch(&vertices[0].px, sizeof(gef::Mesh::Vertex), num_vertices);
+			DoNotOptimise(&bounds);
+		});
+		ReportTime("Mesh bounds Aabb::Update", num_vertices, reference_time, "vertices");
+		ReportTime("Mesh bounds batch", num_vertices, batch_time, "vertices");
+		ReportSpeedUp("Mesh bounds batch speed up", reference_time, batch_time);
+
+		passed = RunBoundsBatchBenchmarks(random) && passed;
+
+		return passed;
+	}
+}
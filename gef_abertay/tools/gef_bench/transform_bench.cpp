@@ -0,0 +1,102 @@
+#include "bench.h"
+#include <maths/transform.h>
+#include <maths/matrix44.h>
+#include <maths/quaternion.h>
+#include <maths/vector4.h>
+#include <vector>
+#include <random>
+#include <math.h>
+
+namespace gef_bench
+{
+	// a transform with a random rotation, a positive scale and a translation, like a joint in a pose
+	static gef::Transform RandomTransform(std::mt19937& random)
+	{
+		std::normal_distribution<float> normal;
+		std::uniform_real_distribution<float> scale_range(0.5f, 2.0f);
+		std::uniform_real_distribution<float> range(-100.0f, 100.0f);
+
+		gef::Quaternion rotation(normal(random), normal(random), normal(random), normal(random));
+		rotation.Normalise();
+
+		gef::Transform transform;
+		transform.set_rotation(rotation);
+		transform.set_scale(gef::Vector4(scale_range(random), scale_range(random), scale_range(random)));
+		transform.set_translation(gef::Vector4(range(random), range(random), range(random)));
+		return transform;
+	}
+
+	// Transform::Set should recover a matrix built by GetMatrix.
+	// Set reads the rotation straight from the matrix, so the round trip only holds without scale.
+	static bool CheckTransformRoundTrip(const std::vector<gef::Transform>& transforms)
+	{
+		float max_error = 0.0f;
+		for (size_t transform_num = 0; transform_num < transforms.size(); ++transform_num)
+		{
+			gef::Transform transform = transforms[transform_num];
+			transform.set_scale(gef::Vector4(1.0f, 1.0f, 1.0f));
+			const gef::Matrix44 matrix = transform.GetMatrix();
+			const gef::Matrix44 round_trip = gef::Transform(matrix).GetMatrix();
+			for (Int32 row = 0; row < 4; ++row)
+			{
+				for (Int32 column = 0; column < 4; ++column)
+				{
+					// translations are up to 100, so errors are relative to the size of the element
+					const float scale = fabsf(matrix.m(row, column)) > 1.0f ? fabsf(matrix.m(row, column)) : 1.0f;
+					const float error = fabsf(round_trip.m(row, column) - matrix.m(row, column)) / scale;
+					max_error = error > max_error ? error : max_error;
+				}
+			}
+		}
+
+		return ReportCheck("Transform GetMatrix round trip", max_error < 1e-4f, max_error);
+	}
+
+	bool RunTransformBenchmarks()
+	{
+		const Int32 num_transforms = 10000;
+		std::mt19937 random(1122);
+		std::uniform_real_distribution<float> time_range(0.0f, 1.0f);
+
+		std::vector<gef::Transform> start(num_transforms), end(num_transforms), results(num_transforms);
+		std::vector<gef::Matrix44> matrices(num_transforms);
+		std::vector<float> times(num_transforms);
+		for (Int32 transform_num = 0; transform_num < num_transforms; ++transform_num)
+		{
+			start[transform_num] = RandomTransform(random);
+			end[transform_num] = RandomTransform(random);
+			times[transform_num] = time_range(random);
+		}
+
+		bool passed = CheckTransformRoundTrip(start);
+
+		const Int32 num_runs = 10;
+		double time;
+
+		time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 transform_num = 0; transform_num < num_transforms; ++transform_num)
+				matrices[transform_num] = start[transform_num].GetMatrix();
+			DoNotOptimise(&matrices[0]);
+		});
+		ReportTime("Transform GetMatrix", num_transforms, time, "transforms");
+
+		time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 transform_num = 0; transform_num < num_transforms; ++transform_num)
+				results[transform_num].Set(matrices[transform_num]);
+			DoNotOptimise(&results[0]);
+		});
+		ReportTime("Transform Set", num_transforms, time, "transforms");
+
+		time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 transform_num = 0; transform_num < num_transforms; ++transform_num)
+				results[transform_num].Linear2TransformBlend(start[transform_num], end[transform_num], times[transform_num]);
+			DoNotOptimise(&results[0]);
+		});
+		ReportTime("Transform Linear2TransformBlend", num_transforms, time, "transforms");
+
+		return passed;
+	}
+}
@@ -0,0 +1,232 @@
+#include "bench.h"
+#include <maths/vector4.h>
+#include <maths/matrix44.h>
+#include <maths/math_utils.h>
+#include <vector>
+#include <random>
+#include <math.h>
+#include <string.h>
+
+namespace gef_bench
+{
+	// scalar versions of the Vector4 operations, as they were before they were vectorised
+	namespace reference
+	{
+		static gef::Vector4 Add(const gef::Vector4& a, const gef::Vector4& b)
+		{
+			return gef::Vector4(a.x() + b.x(), a.y() + b.y(), a.z() + b.z());
+		}
+
+		static gef::Vector4 Sub(const gef::Vector4& a, const gef::Vector4& b)
+		{
+			return gef::Vector4(a.x() - b.x(), a.y() - b.y(), a.z() - b.z());
+		}
+
+		static gef::Vector4 Mul(const gef::Vector4& a, const float s)
+		{
+			return gef::Vector4(a.x() * s, a.y() * s, a.z() * s);
+		}
+
+		static gef::Vector4 Div(const gef::Vector4& a, const float s)
+		{
+			return gef::Vector4(a.x() / s, a.y() / s, a.z() / s);
+		}
+
+		static gef::Vector4 AddAssign(const gef::Vector4& a, const gef::Vector4& b)
+		{
+			return gef::Vector4(a.x() + b.x(), a.y() + b.y(), a.z() + b.z(), a.w());
+		}
+
+		static gef::Vector4 SubAssign(const gef::Vector4& a, const gef::Vector4& b)
+		{
+			return gef::Vector4(a.x() - b.x(), a.y() - b.y(), a.z() - b.z(), a.w());
+		}
+
+		static gef::Vector4 MulAssign(const gef::Vector4& a, const float s)
+		{
+			return gef::Vector4(a.x() * s, a.y() * s, a.z() * s, a.w());
+		}
+
+		static gef::Vector4 DivAssign(const gef::Vector4& a, const float s)
+		{
+			return gef::Vector4(a.x() / s, a.y() / s, a.z() / s, a.w());
+		}
+
+		static gef::Vector4 Normalise(const gef::Vector4& a)
+		{
+			const float length = sqrtf(a.x()*a.x() + a.y()*a.y() + a.z()*a.z());
+			return gef::Vector4(a.x() / length, a.y() / length, a.z() / length, a.w());
+		}
+
+		static gef::Vector4 CrossProduct(const gef::Vector4& a, const gef::Vector4& b)
+		{
+			return gef::Vector4(a.y()*b.z() - a.z()*b.y(), a.z()*b.x() - a.x()*b.z(), a.x()*b.y() - a.y()*b.x());
+		}
+
+		static gef::Vector4 Transform(const gef::Vector4& v, const gef::Matrix44& m)
+		{
+			return gef::Vector4(
+				v.x()*m.m(0, 0) + v.y()*m.m(1, 0) + v.z()*m.m(2, 0) + m.m(3, 0),
+				v.x()*m.m(0, 1) + v.y()*m.m(1, 1) + v.z()*m.m(2, 1) + m.m(3, 1),
+				v.x()*m.m(0, 2) + v.y()*m.m(1, 2) + v.z()*m.m(2, 2) + m.m(3, 2));
+		}
+
+		static gef::Vector4 TransformNoTranslation(const gef::Vector4& v, const gef::Matrix44& m)
+		{
+			return gef::Vector4(
+				v.x()*m.m(0, 0) + v.y()*m.m(1, 0) + v.z()*m.m(2, 0),
+				v.x()*m.m(0, 1) + v.y()*m.m(1, 1) + v.z()*m.m(2, 1),
+				v.x()*m.m(0, 2) + v.y()*m.m(1, 2) + v.z()*m.m(2, 2));
+		}
+
+		static gef::Vector4 TransformW(const gef::Vector4& v, const gef::Matrix44& m)
+		{
+			return gef::Vector4(
+				v.x()*m.m(0, 0) + v.y()*m.m(1, 0) + v.z()*m.m(2, 0) + v.w()*m.m(3, 0),
+				v.x()*m.m(0, 1) + v.y()*m.m(1, 1) + v.z()*m.m(2, 1) + v.w()*m.m(3, 1),
+				v.x()*m.m(0, 2) + v.y()*m.m(1, 2) + v.z()*m.m(2, 2) + v.w()*m.m(3, 2),
+				v.x()*m.m(0, 3) + v.y()*m.m(1, 3) + v.z()*m.m(2, 3) + v.w()*m.m(3, 3));
+		}
+
+		static gef::Vector4 Lerp(const gef::Vector4& start, const gef::Vector4& end, const float time, const float w)
+		{
+			return gef::Vector4(gef::Lerp(start.x(), end.x(), time), gef::Lerp(start.y(), end.y(), time), gef::Lerp(start.z(), end.z(), time), w);
+		}
+	}
+
+	static bool BitEqual(const gef::Vector4& a, const gef::Vector4& b)
+	{
+		const float values_a[4] = { a.x(), a.y(), a.z(), a.w() };
+		const float values_b[4] = { b.x(), b.y(), b.z(), b.w() };
+		return memcmp(values_a, values_b, sizeof(values_a)) == 0;
+	}
+
+	static bool CheckVector4Operators(const std::vector<gef::Vector4>& a, const std::vector<gef::Vector4>& b, const std::vector<float>& scalars, const gef::Matrix44& matrix)
+	{
+		Int32 num_failed = 0;
+		const Int32 num_vectors = static_cast<Int32>(a.size());
+		for (Int32 i = 0; i < num_vectors; ++i)
+		{
+			const gef::Vector4& va = a[i];
+			const gef::Vector4& vb = b[i];
+			const float s = scalars[i];
+
+			gef::Vector4 v;
+			num_failed += BitEqual(va + vb, reference::Add(va, vb)) ? 0 : 1;
+			num_failed += BitEqual(va - vb, reference::Sub(va, vb)) ? 0 : 1;
+			num_failed += BitEqual(va * s, reference::Mul(va, s)) ? 0 : 1;
+			num_failed += BitEqual(va / s, reference::Div(va, s)) ? 0 : 1;
+			v = va; v += vb;
+			num_failed += BitEqual(v, reference::AddAssign(va, vb)) ? 0 : 1;
+			v = va; v -= vb;
+			num_failed += BitEqual(v, reference::SubAssign(va, vb)) ? 0 : 1;
+			v = va; v *= s;
+			num_failed += BitEqual(v, reference::MulAssign(va, s)) ? 0 : 1;
+			v = va; v /= s;
+			num_failed += BitEqual(v, reference::DivAssign(va, s)) ? 0 : 1;
+			v = va; v.Normalise();
+			num_failed += BitEqual(v, reference::Normalise(va)) ? 0 : 1;
+			num_failed += BitEqual(va.CrossProduct(vb), reference::CrossProduct(va, vb)) ? 0 : 1;
+			num_failed += BitEqual(va.Transform(matrix), reference::Transform(va, matrix)) ? 0 : 1;
+			num_failed += BitEqual(va.TransformNoTranslation(matrix), reference::TransformNoTranslation(va, matrix)) ? 0 : 1;
+			num_failed += BitEqual(va.TransformW(matrix), reference::TransformW(va, matrix)) ? 0 : 1;
+			v = gef::Vector4(0.0f, 0.0f, 0.0f, s);
+			v.Lerp(va, vb, 0.25f);
+			num_failed += BitEqual(v, reference::Lerp(va, vb, 0.25f, s)) ? 0 : 1;
+		}
+
+		return ReportMismatches("Vector4 operators match scalar versions", num_failed);
+	}
+
+	bool RunVector4Benchmarks()
+	{
+		const Int32 num_vectors = 100000;
+		std::mt19937 random(1234);
+		std::uniform_real_distribution<float> range(-100.0f, 100.0f);
+
+		std::vector<gef::Vector4> a(num_vectors), b(num_vectors), results(num_vectors);
+		std::vector<float> scalars(num_vectors);
+		for (Int32 i = 0; i < num_vectors; ++i)
+		{
+			a[i] = gef::Vector4(range(random), range(random), range(random), range(random));
+			b[i] = gef::Vector4(range(random), range(random), range(random), range(random));
+			scalars[i] = range(random);
+		}
+
+		gef::Matrix44 matrix;
+		for (Int32 row = 0; row < 4; ++row)
+			for (Int32 column = 0; column < 4; ++column)
+				matrix.set_m(row, column, range(random));
+
+		bool passed = CheckVector4Operators(a, b, scalars, matrix);
+
+		const Int32 num_runs = 10;
+		double reference_time, simd_time;
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_vectors; ++i)
+				results[i] = reference::Add(reference::Mul(a[i], scalars[i]), b[i]);
+			DoNotOptimise(&results[0]);
+		});
+		simd_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_vectors; ++i)
+				results[i] = a[i] * scalars[i] + b[i];
+			DoNotOptimise(&results[0]);
+		});
+		ReportTime("Vector4 a*s + b scalar", num_vectors, reference_time, "vectors");
+		ReportTime("Vector4 a*s + b", num_vectors, simd_time, "vectors");
+		ReportSpeedUp("Vector4 a*s + b speed up", reference_time, simd_time);
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_vectors; ++i)
+				results[i] = reference::CrossProduct(a[i], b[i]);
+			DoNotOptimise(&results[0]);
+		});
+		simd_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_vectors; ++i)
+				results[i] = a[i].CrossProduct(b[i]);
+			DoNotOptimise(&results[0]);
+		});
+		ReportTime("Vector4 CrossProduct scalar", num_vectors, reference_time, "vectors");
+		ReportTime("Vector4 CrossProduct", num_vectors, simd_time, "vectors");
+		ReportSpeedUp("Vector4 CrossProduct speed up", reference_time, simd_time);
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_vectors; ++i)
+				results[i] = reference::Transform(a[i], matrix);
+			DoNotOptimise(&results[0]);
+		});
+		simd_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_vectors; ++i)
+				results[i] = a[i].Transform(matrix);
+			DoNotOptimise(&results[0]);
+		});
+		ReportTime("Vector4 Transform scalar", num_vectors, reference_time, "vectors");
+		ReportTime("Vector4 Transform", num_vectors, simd_time, "vectors");
+		ReportSpeedUp("Vector4 Transform speed up", reference_time, simd_time);
+
+		reference_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_vectors; ++i)
+				results[i] = reference::Lerp(a[i], b[i], 0.25f, 0.0f);
+			DoNotOptimise(&results[0]);
+		});
+		simd_time = TimeBestOf(num_runs, [&]()
+		{
+			for (Int32 i = 0; i < num_vectors; ++i)
+				results[i].Lerp(a[i], b[i], 0.25f);
+			DoNotOptimise(&results[0]);
+		});
+		ReportTime("Vector4 Lerp scalar", num_vectors, reference_time, "vectors");
+		ReportTime("Vector4 Lerp", num_vectors, simd_time, "vectors");
+		ReportSpeedUp("Vector4 Lerp speed up", reference_time, simd_time);
+
+		return passed;
+	}
+}